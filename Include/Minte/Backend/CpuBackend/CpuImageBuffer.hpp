@@ -0,0 +1,57 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../ImageBuffer.hpp"
+#include "CpuInstance.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * CPU image buffer class.
+		 * This is a block of host memory, which the render targets write to directly. Mapping it does not copy anything.
+		 */
+		class CpuImageBuffer final : public ImageBuffer
+		{
+		public:
+			/**
+			 * Explicit constructor.
+			 *
+			 * @param pInstance The instance pointer.
+			 * @param size The size of the buffer.
+			 * @param category The resource category of the buffer. Default is attachment.
+			 */
+			explicit CpuImageBuffer(const std::shared_ptr<CpuInstance>& pInstance, uint64_t size, ResourceCategory category = ResourceCategory::Attachment);
+
+			/**
+			 * Destructor.
+			 */
+			~CpuImageBuffer() override;
+
+			/**
+			 * Map the buffer memory to the local address space.
+			 *
+			 * @return The accessed bytes.
+			 */
+			[[nodiscard]] std::byte* mapMemory() override;
+
+			/**
+			 * Unmap the mapped memory.
+			 */
+			void unmapMemory() override;
+
+			/**
+			 * Get the buffer memory without mapping it.
+			 *
+			 * @return The memory pointer.
+			 */
+			[[nodiscard]] std::byte* getData() const { return m_pData.get(); }
+
+		private:
+			std::unique_ptr<std::byte[]> m_pData = nullptr;
+			ResourceCategory m_Category = ResourceCategory::Attachment;
+		};
+	}
+}
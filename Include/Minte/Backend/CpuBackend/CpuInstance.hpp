@@ -0,0 +1,53 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../Instance.hpp"
+#include "../../ThreadPool.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * CPU instance class.
+		 * This is the instance of the software rendering backend, which does not need a GPU or a Vulkan driver. All the resources live in host
+		 * memory, and the render targets share the instance's thread pool to rasterize in parallel.
+		 */
+		class CpuInstance final : public backend::Instance
+		{
+		public:
+			/**
+			 * Explicit constructor.
+			 *
+			 * @param threadCount The number of threads used to rasterize, including the drawing thread. Default is the number of hardware threads.
+			 */
+			explicit CpuInstance(uint32_t threadCount = std::thread::hardware_concurrency());
+
+			/**
+			 * Get the memory statistics of the instance.
+			 * The backend has a single host heap, which contains all the allocations of the instance.
+			 *
+			 * @return The memory statistics.
+			 */
+			[[nodiscard]] MemoryStatistics getMemoryStatistics() const override;
+
+			/**
+			 * Get the thread pool used to rasterize.
+			 *
+			 * @return The thread pool pointer. This is nullptr if the instance rasterizes on the drawing thread only.
+			 */
+			[[nodiscard]] ThreadPool* getThreadPool() const { return m_pThreadPool.get(); }
+
+			/**
+			 * Get the number of threads used to rasterize.
+			 *
+			 * @return The thread count, including the drawing thread.
+			 */
+			[[nodiscard]] uint32_t getThreadCount() const { return m_pThreadPool ? m_pThreadPool->getThreadCount() + 1 : 1; }
+
+		private:
+			std::unique_ptr<ThreadPool> m_pThreadPool = nullptr;
+		};
+	}
+}
@@ -0,0 +1,241 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../RenderTarget.hpp"
+#include "CpuTexture.hpp"
+
+#include <atomic>
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * CPU render target class.
+		 * This is a tiled software rasterizer which follows the rules of the Vulkan backend, so both produce the same output within rounding.
+		 *
+		 * Every draw call bins the triangles to 64x64 pixel tiles on the drawing thread, clamped to their command's scissor, and then rasterizes
+		 * the tiles in parallel using the instance's thread pool. Positions are snapped to 1/256 of a pixel, and the coverage is tested using
+		 * exact edge functions with the top left fill rule, four pixels at a time where SIMD is available. The color is alpha blended and stored
+		 * after every triangle, like an 8 bit color attachment. The opaque triangles of a tile are drawn front to back first, writing a 16 bit
+		 * depth, so the pixels they hide are skipped by the triangles behind them.
+		 *
+		 * The tiles are written straight to the color, entity and depth buffers, so there is nothing to read back. Other output formats are
+		 * rendered to an intermediate image and converted tile by tile. Only x1 anti-aliasing is supported.
+		 */
+		class CpuRenderTarget final : public backend::RenderTarget
+		{
+			/**
+			 * Triangle structure.
+			 * This contains everything needed to rasterize a triangle, set up while binning.
+			 */
+			struct Triangle final
+			{
+				// The edge functions are A * x + B * y + C, in 1/256 of a pixel. The values are integers, which a double holds exactly.
+				std::array<double, 3> m_EdgeA = {};
+				std::array<double, 3> m_EdgeB = {};
+				std::array<double, 3> m_EdgeC = {};
+
+				// The attribute planes, which are value + gradientX * (x - originX) + gradientY * (y - originY) in pixels.
+				std::array<float, 6> m_Values = {};	// Red, green, blue, alpha, U and V.
+				std::array<float, 6> m_GradientX = {};
+				std::array<float, 6> m_GradientY = {};
+				float m_OriginX = 0.0f;
+				float m_OriginY = 0.0f;
+
+				int32_t m_MinX = 0;
+				int32_t m_MinY = 0;
+				int32_t m_MaxX = 0;	// Inclusive.
+				int32_t m_MaxY = 0;	// Inclusive.
+
+				uint32_t m_Command = 0;	// The index of the draw command.
+				uint32_t m_EntityID = 0;	// The entity ID of the first vertex.
+				uint16_t m_Depth = 0;
+				bool m_IsOpaque = false;
+			};
+
+			/**
+			 * Upscale taps structure.
+			 * This is where a row or a column of the upscaled image is sampled from.
+			 */
+			struct UpscaleTaps final
+			{
+				std::array<uint32_t, 4> m_Indices = {};	// The source pixels of the bicubic filter, clamped to the edge.
+				std::array<float, 4> m_Weights = {};
+				uint32_t m_Nearest = 0;	// The source pixel the entity ID and depth are copied from.
+			};
+
+		public:
+			static constexpr uint32_t TileSize = 64;
+
+			/**
+			 * Explicit constructor.
+			 * This will throw a BackendError if the anti-aliasing is not x1.
+			 *
+			 * @param pInstance The CPU instance pointer.
+			 * @param width The width of the render target.
+			 * @param height The height of the render target.
+			 * @param antiAliasing The anti aliasing to use. Default is x1.
+			 */
+			explicit CpuRenderTarget(const std::shared_ptr<CpuInstance>& pInstance, uint32_t width, uint32_t height, AntiAliasing antiAliasing = AntiAliasing::X1);
+
+			/**
+			 * Destructor.
+			 */
+			~CpuRenderTarget() override;
+
+			/**
+			 * Draw all the entities that are bound to the render target.
+			 */
+			void draw() override;
+
+			/**
+			 * Update a range of the vertex buffer.
+			 *
+			 * @param offset The offset of the first vertex.
+			 * @param vertices The vertices to write.
+			 */
+			void updateVertices(uint64_t offset, std::span<const Vertex> vertices) override;
+
+			/**
+			 * Update a range of the index buffer.
+			 *
+			 * @param offset The offset of the first index.
+			 * @param indices The indices to write.
+			 */
+			void updateIndices(uint64_t offset, std::span<const Index> indices) override;
+
+			/**
+			 * Set the output format of the color buffer.
+			 *
+			 * @param format The output format.
+			 */
+			void setOutputFormat(OutputFormat format) override;
+
+		private:
+			/**
+			 * Create a new image buffer.
+			 *
+			 * @param size The size of the buffer.
+			 * @return The created buffer.
+			 */
+			[[nodiscard]] std::shared_ptr<ImageBuffer> createImageBuffer(uint64_t size) override;
+
+			/**
+			 * Set up the triangles of the draw commands and bin them to the tiles of the current pass.
+			 *
+			 * @param bNativeResolution Whether to bin the commands drawn at the native resolution, or the rest.
+			 */
+			void binTriangles(bool bNativeResolution);
+
+			/**
+			 * Set up a single triangle and add it to the tiles it overlaps.
+			 *
+			 * @param first The first vertex.
+			 * @param second The second vertex.
+			 * @param third The third vertex.
+			 * @param command The index of the draw command.
+			 * @param scale The scale of the vertex positions.
+			 */
+			void binTriangle(const Vertex& first, const Vertex& second, const Vertex& third, uint32_t command, float scale);
+
+			/**
+			 * Begin a rasterization pass.
+			 * This sets up the tile grid to cover the area of the pass.
+			 *
+			 * @param width The width of the area to draw to.
+			 * @param height The height of the area to draw to.
+			 * @param bUpscale Whether the tiles are upscaled from the scaled image instead of cleared.
+			 */
+			void beginPass(uint32_t width, uint32_t height, bool bUpscale);
+
+			/**
+			 * Rasterize all the tiles of the current pass, using the instance's thread pool.
+			 */
+			void rasterizePass();
+
+			/**
+			 * Rasterize tiles till there are none left.
+			 * This is executed by all the threads of a draw call.
+			 */
+			void rasterizeTiles();
+
+			/**
+			 * Copy the scaled image aside and set up the filter taps to upscale it.
+			 */
+			void prepareUpscale();
+
+			/**
+			 * Upscale the scaled image to a tile.
+			 *
+			 * @param minX The first column of the tile.
+			 * @param minY The first row of the tile.
+			 * @param maxX The last column of the tile.
+			 * @param maxY The last row of the tile.
+			 */
+			void upscaleTile(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY);
+
+			/**
+			 * Rasterize a single tile.
+			 *
+			 * @param tile The tile index.
+			 */
+			void rasterizeTile(uint32_t tile);
+
+			/**
+			 * Rasterize a triangle to a tile.
+			 *
+			 * @param triangle The triangle.
+			 * @param minX The first column of the tile.
+			 * @param minY The first row of the tile.
+			 * @param maxX The last column of the tile.
+			 * @param maxY The last row of the tile.
+			 */
+			void rasterizeTriangle(const Triangle& triangle, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY);
+
+			/**
+			 * Resize a geometry buffer and update its allocation.
+			 *
+			 * @tparam Type The element type.
+			 * @param buffer The buffer.
+			 * @param size The required element count.
+			 */
+			template<class Type>
+			void growGeometryBuffer(std::vector<Type>& buffer, uint64_t size);
+
+		private:
+			std::vector<Vertex> m_Vertices;
+			std::vector<Index> m_Indices;
+
+			std::vector<Triangle> m_Triangles;
+			std::vector<std::vector<uint32_t>> m_TileBins;	// The triangles overlapping each tile, in draw order.
+			uint32_t m_TileCountX = 0;	// The tile columns of the current pass.
+			uint32_t m_TileCount = 0;	// The tiles of the current pass.
+
+			uint32_t m_PassWidth = 0;
+			uint32_t m_PassHeight = 0;
+			bool m_IsUpscaling = false;	// Whether the current pass upscales the scaled image instead of clearing the tiles.
+			bool m_IsFinalPass = false;	// Whether the current pass converts the tiles to the output format.
+
+			std::vector<uint8_t> m_ColorImage;	// The RGBA image used when the output needs to be converted.
+
+			// The scaled image, copied aside to be upscaled. These are allocated the first time the render scale is used.
+			std::vector<uint8_t> m_ScaledColor;
+			std::vector<uint32_t> m_ScaledEntities;
+			std::vector<uint16_t> m_ScaledDepth;
+			std::vector<UpscaleTaps> m_UpscaleColumns;
+			std::vector<UpscaleTaps> m_UpscaleRows;
+			uint32_t m_ScaledWidth = 0;
+			uint32_t m_ScaledHeight = 0;
+
+			std::array<const CpuTexture*, MaxTextures> m_SlotTextures = {};	// The textures of the current draw call.
+			uint8_t* m_pColor = nullptr;	// The RGBA pixels written by the current draw call.
+			uint8_t* m_pOutput = nullptr;	// The color buffer of the current draw call, if the output is converted.
+			uint32_t* m_pEntities = nullptr;
+			uint16_t* m_pDepth = nullptr;
+
+			std::atomic<uint32_t> m_NextTile = 0;
+		};
+	}
+}
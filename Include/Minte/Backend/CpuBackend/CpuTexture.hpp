@@ -0,0 +1,69 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../Texture.hpp"
+#include "CpuInstance.hpp"
+
+#include <vector>
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * CPU texture class.
+		 * The pixels are kept in host memory and sampled by the render targets with the same filtering as the Vulkan backend (bilinear, clamped
+		 * to the edges, and blended between the mip levels). The mip chain is filtered like a linear blit from each level to the next.
+		 */
+		class CpuTexture final : public Texture
+		{
+		public:
+			/**
+			 * Explicit constructor.
+			 *
+			 * @param pInstance The CPU instance pointer.
+			 * @param width The width of the texture.
+			 * @param height The height of the texture.
+			 * @param format The texture format.
+			 * @param bMipmaps Whether to create a full mip chain. Default is false.
+			 */
+			explicit CpuTexture(const std::shared_ptr<CpuInstance>& pInstance, uint32_t width, uint32_t height, TextureFormat format, bool bMipmaps = false);
+
+			/**
+			 * Destructor.
+			 */
+			~CpuTexture() override;
+
+			/**
+			 * Get the pixels of a mip level.
+			 * The rows are tightly packed.
+			 *
+			 * @param level The mip level. Default is 0.
+			 * @return The pixels.
+			 */
+			[[nodiscard]] const std::vector<uint8_t>& getPixels(uint32_t level = 0) const { return m_Levels[level]; }
+
+		protected:
+			/**
+			 * Upload regions to the texture.
+			 * This will throw a BackendError if a region is outside the texture or its pixels are outside the data. The mip chain is regenerated
+			 * after the regions are written.
+			 *
+			 * @param regions The regions to upload.
+			 * @param data The pixel data of all the regions.
+			 */
+			void upload(std::span<const TextureRegion> regions, std::span<const std::byte> data) override;
+
+		private:
+			/**
+			 * Generate the mip chain from the first level.
+			 */
+			void generateMipmaps();
+
+		private:
+			std::vector<std::vector<uint8_t>> m_Levels;
+			uint64_t m_AllocationSize = 0;
+		};
+	}
+}
@@ -4,6 +4,8 @@
 
 #include "InstanceBoundObject.hpp"
 
+#include <atomic>
+
 namespace minte
 {
 	namespace backend
@@ -11,6 +13,9 @@ namespace minte
 		/**
 		 * Image buffer class.
 		 * This is used to submit image data from the backend to the frontend and vice versa.
+		 *
+		 * Render targets give their buffers out through handles made by Retain(). The buffer counts the handles itself, and the count is
+		 * released by the last copy of each handle, so a render target only writes to a buffer once every reader is done with it.
 		 */
 		class ImageBuffer : public InstanceBoundObject
 		{
@@ -59,9 +64,36 @@ namespace minte
 			 */
 			[[nodiscard]] bool isMapped() const { return m_IsMapped; }
 
+			/**
+			 * Check if a handle made by Retain() still refers to the buffer.
+			 * This synchronizes with the handles being destroyed, so everything done through them happens before the caller writes to the buffer.
+			 *
+			 * @return Whether the buffer is retained.
+			 */
+			[[nodiscard]] bool isRetained() const { return m_RetainCount.load(std::memory_order_acquire) > 0; }
+
+			/**
+			 * Create a handle which retains a buffer.
+			 * The handle keeps the buffer alive, and the buffer stays retained till the last copy of the handle is destroyed.
+			 *
+			 * @param pBuffer The buffer to retain. This can be nullptr, in which case nullptr is returned.
+			 * @return The handle.
+			 */
+			[[nodiscard]] static std::shared_ptr<ImageBuffer> Retain(const std::shared_ptr<ImageBuffer>& pBuffer)
+			{
+				if (pBuffer == nullptr)
+					return nullptr;
+
+				pBuffer->m_RetainCount.fetch_add(1, std::memory_order_relaxed);
+				return std::shared_ptr<ImageBuffer>(pBuffer.get(), [pBuffer](ImageBuffer* pRetained) { pRetained->m_RetainCount.fetch_sub(1, std::memory_order_release); });
+			}
+
 		protected:
 			uint64_t m_Size = 0;
 			bool m_IsMapped = false;
+
+		private:
+			std::atomic<uint32_t> m_RetainCount = 0;
 		};
 	}
 }
\ No newline at end of file
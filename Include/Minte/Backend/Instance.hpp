@@ -2,28 +2,110 @@
 
 #pragma once
 
+#include "MemoryStatistics.hpp"
+
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <span>
 
 namespace minte
 {
 	namespace backend
 	{
+		class Texture;
+		struct TextureRegion;
+
+		using TextureUpdateCallback = std::function<void(const Texture&, std::span<const TextureRegion>, std::span<const std::byte>)>;
+
 		/**
 		 * Instance class.
 		 */
 		class Instance
 		{
 		public:
+			static constexpr uint64_t BudgetCheckInterval = 1024 * 1024;	// The bytes allocated or freed between two budget checks.
+
 			/**
 			 * Default constructor.
 			 */
-			constexpr Instance() = default;
+			Instance() = default;
 
 			/**
 			 * Virtual default destructor.
 			 */
 			virtual ~Instance() = default;
 
+			/**
+			 * Get the memory statistics of the instance.
+			 *
+			 * @return The memory statistics.
+			 */
+			[[nodiscard]] virtual MemoryStatistics getMemoryStatistics() const = 0;
+
+			/**
+			 * Set the memory budget callback.
+			 * The callback is called once when the usage reaches the threshold of the budget, and is re-armed when the usage drops below it. The
+			 * usage is checked at the end of every layer update, and after every BudgetCheckInterval bytes allocated or freed.
+			 *
+			 * @param budget The memory budget in bytes. If 0, the budget reported by the device-local heaps is used.
+			 * @param threshold The fraction of the budget at which the callback is called.
+			 * @param callback The callback function.
+			 */
+			void setMemoryBudgetCallback(uint64_t budget, float threshold, MemoryBudgetCallback&& callback)
+			{
+				auto lock = std::scoped_lock(m_BudgetMutex);
+				m_MemoryBudget = budget;
+				m_BudgetThreshold = threshold;
+				m_BudgetCallback = std::move(callback);
+				m_BudgetExceeded = false;
+			}
+
+			/**
+			 * Set the texture update callback.
+			 * The callback is called after every successful update of a texture created with this instance, on the thread that updated it. This
+			 * is used to capture the texture uploads, and can be cleared by passing an empty callback.
+			 *
+			 * @param callback The callback function.
+			 */
+			void setTextureUpdateCallback(TextureUpdateCallback&& callback)
+			{
+				auto lock = std::scoped_lock(m_TextureUpdateMutex);
+				m_TextureUpdateCallback = std::move(callback);
+			}
+
+			/**
+			 * Notify the texture update callback.
+			 * This is called by Texture::update() once the backend has uploaded the regions.
+			 *
+			 * @param texture The updated texture.
+			 * @param regions The updated regions.
+			 * @param data The pixel data of the regions.
+			 */
+			void notifyTextureUpdate(const Texture& texture, std::span<const TextureRegion> regions, std::span<const std::byte> data) const
+			{
+				auto lock = std::unique_lock(m_TextureUpdateMutex);
+				if (!m_TextureUpdateCallback)
+					return;
+
+				const auto callback = m_TextureUpdateCallback;
+				lock.unlock();
+				callback(texture, regions, data);
+			}
+
+			/**
+			 * Advance the per-frame allocation counters, and check the memory budget.
+			 * Layer::update() calls this once it's done with the render target. If several layers share the instance, each of their updates ends a
+			 * frame.
+			 */
+			void advanceFrame()
+			{
+				m_PreviousFrameAllocations = m_FrameAllocations.exchange(0);
+				m_PreviousFrameDeallocations = m_FrameDeallocations.exchange(0);
+
+				checkBudget();
+			}
+
 			/**
 			 * Get this object casted to another type.
 			 *
@@ -41,6 +123,134 @@ namespace minte
 			 */
 			template<class Type>
 			[[nodiscard]] const Type* as() const { return static_cast<const Type*>(this); }
+
+			/**
+			 * Register a new allocation.
+			 * This is used by the backend objects to report their allocations, and is thread safe.
+			 *
+			 * @param category The resource category.
+			 * @param size The size of the allocation in bytes.
+			 */
+			void registerAllocation(ResourceCategory category, uint64_t size) const
+			{
+				auto& counter = m_ResourceCounters[static_cast<uint8_t>(category)];
+				counter.m_Count++;
+				counter.m_Bytes += size;
+				m_FrameAllocations++;
+
+				// Querying the statistics can be expensive, so the budget is only checked once enough memory has changed.
+				if (m_UncheckedBytes.fetch_add(size) + size >= BudgetCheckInterval)
+					checkBudget();
+			}
+
+			/**
+			 * Unregister an allocation.
+			 *
+			 * @param category The resource category.
+			 * @param size The size of the allocation in bytes.
+			 */
+			void unregisterAllocation(ResourceCategory category, uint64_t size) const
+			{
+				auto& counter = m_ResourceCounters[static_cast<uint8_t>(category)];
+				counter.m_Count--;
+				counter.m_Bytes -= size;
+				m_FrameDeallocations++;
+
+				// Querying the statistics can be expensive, so the budget is only checked once enough memory has changed.
+				if (m_UncheckedBytes.fetch_add(size) + size >= BudgetCheckInterval)
+					checkBudget();
+			}
+
+		protected:
+			/**
+			 * Fill the library tracked statistics.
+			 * The derived class is expected to call this and then fill in the heap information.
+			 *
+			 * @param statistics The statistics to fill.
+			 */
+			void fillTrackedStatistics(MemoryStatistics& statistics) const
+			{
+				for (uint8_t i = 0; i < static_cast<uint8_t>(ResourceCategory::Count); i++)
+				{
+					statistics.m_Resources[i].m_Count = m_ResourceCounters[i].m_Count;
+					statistics.m_Resources[i].m_Bytes = m_ResourceCounters[i].m_Bytes;
+				}
+
+				statistics.m_FrameAllocations = m_FrameAllocations;
+				statistics.m_FrameDeallocations = m_FrameDeallocations;
+				statistics.m_PreviousFrameAllocations = m_PreviousFrameAllocations;
+				statistics.m_PreviousFrameDeallocations = m_PreviousFrameDeallocations;
+			}
+
+		private:
+			/**
+			 * Check the memory usage against the budget and notify the user if needed.
+			 */
+			void checkBudget() const
+			{
+				auto lock = std::unique_lock(m_BudgetMutex);
+				m_UncheckedBytes = 0;
+
+				if (!m_BudgetCallback)
+					return;
+
+				const auto statistics = getMemoryStatistics();
+
+				// Resolve the usage and budget. If the user has not given a budget, we use the device-local heaps.
+				uint64_t usage = statistics.getTotalBytes();
+				uint64_t budget = m_MemoryBudget;
+				if (budget == 0)
+				{
+					usage = 0;
+					for (const auto& heap : statistics.m_Heaps)
+					{
+						if (heap.m_IsDeviceLocal)
+						{
+							usage += heap.m_Usage;
+							budget += heap.m_Budget;
+						}
+					}
+				}
+
+				const bool bExceeded = budget > 0 && static_cast<double>(usage) >= static_cast<double>(budget) * m_BudgetThreshold;
+				const bool bNotify = bExceeded && !m_BudgetExceeded;
+				m_BudgetExceeded = bExceeded;
+
+				// Call the callback outside the lock so that the user can free resources in it.
+				if (bNotify)
+				{
+					const auto callback = m_BudgetCallback;
+					lock.unlock();
+					callback(statistics);
+				}
+			}
+
+		private:
+			/**
+			 * Resource counter structure.
+			 */
+			struct ResourceCounter final
+			{
+				std::atomic<uint64_t> m_Count = 0;
+				std::atomic<uint64_t> m_Bytes = 0;
+			};
+
+			mutable std::array<ResourceCounter, static_cast<uint8_t>(ResourceCategory::Count)> m_ResourceCounters;
+
+			mutable std::atomic<uint64_t> m_FrameAllocations = 0;
+			mutable std::atomic<uint64_t> m_FrameDeallocations = 0;
+			std::atomic<uint64_t> m_PreviousFrameAllocations = 0;
+			std::atomic<uint64_t> m_PreviousFrameDeallocations = 0;
+			mutable std::atomic<uint64_t> m_UncheckedBytes = 0;	// The bytes allocated or freed since the budget was last checked.
+
+			mutable std::mutex m_BudgetMutex;
+			MemoryBudgetCallback m_BudgetCallback;
+			uint64_t m_MemoryBudget = 0;
+			float m_BudgetThreshold = 0.9f;
+			mutable bool m_BudgetExceeded = false;
+
+			mutable std::mutex m_TextureUpdateMutex;
+			TextureUpdateCallback m_TextureUpdateCallback;
 		};
 	}
-}
\ No newline at end of file
+}
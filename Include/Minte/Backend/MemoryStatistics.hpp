@@ -0,0 +1,98 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <functional>
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * Resource category enum.
+		 * This is used to group the allocations made by the backend.
+		 */
+		enum class ResourceCategory : uint8_t
+		{
+			Attachment,		// Render target attachments.
+			Readback,		// Buffers used to copy data from the device to the host.
+			Staging,		// Buffers used to copy data from the host to the device.
+			Texture,		// Sampled images.
+			Geometry,		// Vertex and index buffers.
+
+			Count
+		};
+
+		/**
+		 * Memory heap statistics structure.
+		 * This contains the usage information of a single memory heap.
+		 */
+		struct MemoryHeapStatistics final
+		{
+			uint64_t m_Size = 0;		// The total size of the heap.
+			uint64_t m_Usage = 0;		// The number of bytes currently used by the process.
+			uint64_t m_Budget = 0;		// The number of bytes the process can use without degrading performance.
+			uint64_t m_Allocated = 0;	// The number of bytes allocated by the library.
+
+			bool m_IsDeviceLocal = false;
+		};
+
+		/**
+		 * Resource statistics structure.
+		 * This contains the allocation information of a single resource category.
+		 */
+		struct ResourceStatistics final
+		{
+			uint64_t m_Count = 0;
+			uint64_t m_Bytes = 0;
+		};
+
+		/**
+		 * Memory statistics structure.
+		 * This contains the memory usage of an instance.
+		 */
+		struct MemoryStatistics final
+		{
+			std::vector<MemoryHeapStatistics> m_Heaps;
+			std::array<ResourceStatistics, static_cast<uint8_t>(ResourceCategory::Count)> m_Resources = {};
+
+			uint64_t m_FrameAllocations = 0;			// The number of allocations made in the current frame.
+			uint64_t m_FrameDeallocations = 0;			// The number of deallocations made in the current frame.
+			uint64_t m_PreviousFrameAllocations = 0;	// The number of allocations made in the previous frame.
+			uint64_t m_PreviousFrameDeallocations = 0;	// The number of deallocations made in the previous frame.
+
+			bool m_HasDeviceBudget = false;	// Whether the heap usage and budget are reported by the device or estimated.
+
+			/**
+			 * Get the statistics of a single resource category.
+			 *
+			 * @param category The resource category.
+			 * @return The statistics.
+			 */
+			[[nodiscard]] const ResourceStatistics& getResource(ResourceCategory category) const { return m_Resources[static_cast<uint8_t>(category)]; }
+
+			/**
+			 * Get the total number of bytes allocated by the library.
+			 *
+			 * @return The byte count.
+			 */
+			[[nodiscard]] uint64_t getTotalBytes() const
+			{
+				uint64_t bytes = 0;
+				for (const auto& resource : m_Resources)
+					bytes += resource.m_Bytes;
+
+				return bytes;
+			}
+		};
+
+		/**
+		 * Memory budget callback.
+		 * This is called when the memory usage approaches the configured budget.
+		 */
+		using MemoryBudgetCallback = std::function<void(const MemoryStatistics&)>;
+	}
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../ImageBuffer.hpp"
+#include "NullInstance.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * Null image buffer class.
+		 * The memory is only allocated (and zeroed) the first time the buffer is mapped, so buffers that are never read cost nothing.
+		 */
+		class NullImageBuffer final : public ImageBuffer
+		{
+		public:
+			/**
+			 * Explicit constructor.
+			 *
+			 * @param pInstance The instance pointer.
+			 * @param size The size of the buffer.
+			 */
+			explicit NullImageBuffer(const std::shared_ptr<NullInstance>& pInstance, uint64_t size);
+
+			/**
+			 * Destructor.
+			 */
+			~NullImageBuffer() override;
+
+			/**
+			 * Map the buffer memory to the local address space.
+			 *
+			 * @return The accessed bytes.
+			 */
+			[[nodiscard]] std::byte* mapMemory() override;
+
+			/**
+			 * Unmap the mapped memory.
+			 */
+			void unmapMemory() override;
+
+		private:
+			std::unique_ptr<std::byte[]> m_pData = nullptr;
+		};
+	}
+}
@@ -0,0 +1,33 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../Instance.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * Null instance class.
+		 * This is the instance of the null backend, which accepts everything and draws nothing. It's used to measure the cost of the frontend
+		 * without the driver, and to run layers where no output is needed.
+		 */
+		class NullInstance final : public backend::Instance
+		{
+		public:
+			/**
+			 * Default constructor.
+			 */
+			NullInstance() = default;
+
+			/**
+			 * Get the memory statistics of the instance.
+			 * The backend has a single host heap, which only contains the image buffers that were mapped.
+			 *
+			 * @return The memory statistics.
+			 */
+			[[nodiscard]] MemoryStatistics getMemoryStatistics() const override;
+		};
+	}
+}
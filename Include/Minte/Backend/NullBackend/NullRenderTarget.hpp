@@ -0,0 +1,138 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../RenderTarget.hpp"
+#include "NullInstance.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * Null frame statistics structure.
+		 * This is the work a render target was given for a single frame, from the end of the previous draw call to the end of this one.
+		 */
+		struct NullFrameStatistics final
+		{
+			uint64_t m_DrawCommands = 0;
+			uint64_t m_OpaqueCommands = 0;	// The number of draw commands which can be drawn front to back.
+			uint64_t m_Triangles = 0;
+
+			uint64_t m_VertexUpdates = 0;	// The number of vertex buffer updates.
+			uint64_t m_IndexUpdates = 0;	// The number of index buffer updates.
+			uint64_t m_VertexBytes = 0;	// The bytes written to the vertex buffer.
+			uint64_t m_IndexBytes = 0;	// The bytes written to the index buffer.
+
+			uint64_t m_CommandListChanges = 0;	// The number of times the draw commands were replaced.
+			uint64_t m_TextureChanges = 0;	// The number of texture slots bound to a different texture.
+			uint64_t m_ScissorChanges = 0;	// The number of times the scissor changed between draw commands.
+			uint64_t m_BufferReplacements = 0;	// The number of draw calls which replaced a buffer retained by the user.
+		};
+
+		/**
+		 * Null render target class.
+		 * This accepts all the geometry and draw commands and draws nothing, so the frontend can be measured on its own. The output buffers
+		 * are the right size, but only contain zeros.
+		 *
+		 * The render target can record what it was given for each frame. Recording only counts, so it does not allocate.
+		 */
+		class NullRenderTarget final : public backend::RenderTarget
+		{
+		public:
+			/**
+			 * Explicit constructor.
+			 *
+			 * @param pInstance The null instance pointer.
+			 * @param width The width of the render target.
+			 * @param height The height of the render target.
+			 * @param antiAliasing The anti aliasing to use. Default is x1.
+			 */
+			explicit NullRenderTarget(const std::shared_ptr<NullInstance>& pInstance, uint32_t width, uint32_t height, AntiAliasing antiAliasing = AntiAliasing::X1);
+
+			/**
+			 * Draw all the entities that are bound to the render target.
+			 * This finishes the frame's statistics if recording is enabled.
+			 */
+			void draw() override;
+
+			/**
+			 * Update a range of the vertex buffer.
+			 *
+			 * @param offset The offset of the first vertex.
+			 * @param vertices The vertices to write.
+			 */
+			void updateVertices(uint64_t offset, std::span<const Vertex> vertices) override;
+
+			/**
+			 * Update a range of the index buffer.
+			 *
+			 * @param offset The offset of the first index.
+			 * @param indices The indices to write.
+			 */
+			void updateIndices(uint64_t offset, std::span<const Index> indices) override;
+
+			/**
+			 * Set the output format of the color buffer.
+			 *
+			 * @param format The output format.
+			 */
+			void setOutputFormat(OutputFormat format) override;
+
+			/**
+			 * Enable or disable recording the frame statistics.
+			 *
+			 * @param bEnable Whether to record.
+			 */
+			void setRecording(bool bEnable);
+
+			/**
+			 * Check if the frame statistics are recorded.
+			 *
+			 * @return Whether it's recording.
+			 */
+			[[nodiscard]] bool isRecording() const { return m_IsRecording; }
+
+			/**
+			 * Get the statistics of the last frame drawn while recording.
+			 *
+			 * @return The frame statistics.
+			 */
+			[[nodiscard]] const NullFrameStatistics& getFrameStatistics() const { return m_FrameStatistics; }
+
+			/**
+			 * Get the statistics of all the frames drawn while recording.
+			 *
+			 * @return The total statistics.
+			 */
+			[[nodiscard]] const NullFrameStatistics& getTotalStatistics() const { return m_TotalStatistics; }
+
+			/**
+			 * Get the number of frames drawn while recording.
+			 *
+			 * @return The frame count.
+			 */
+			[[nodiscard]] uint64_t getRecordedFrameCount() const { return m_RecordedFrameCount; }
+
+		private:
+			/**
+			 * Create a new image buffer.
+			 *
+			 * @param size The size of the buffer.
+			 * @return The created buffer.
+			 */
+			[[nodiscard]] std::shared_ptr<ImageBuffer> createImageBuffer(uint64_t size) override;
+
+		private:
+			NullFrameStatistics m_PendingStatistics;	// The statistics of the frame being recorded.
+			NullFrameStatistics m_FrameStatistics;
+			NullFrameStatistics m_TotalStatistics;
+			uint64_t m_RecordedFrameCount = 0;
+
+			std::array<const Texture*, MaxTextures> m_BoundTextures = {};	// The textures of the previous draw call, to find the changed slots.
+			uint64_t m_DrawCommandGeneration = 0;	// The draw command generation of the previous draw call.
+
+			bool m_IsRecording = false;
+		};
+	}
+}
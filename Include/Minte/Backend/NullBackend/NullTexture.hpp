@@ -0,0 +1,51 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../Texture.hpp"
+#include "NullInstance.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * Null texture class.
+		 * Updates are validated like the other backends, and then discarded.
+		 */
+		class NullTexture final : public Texture
+		{
+		public:
+			/**
+			 * Explicit constructor.
+			 *
+			 * @param pInstance The instance pointer.
+			 * @param width The width of the texture.
+			 * @param height The height of the texture.
+			 * @param format The texture format.
+			 * @param bMipmaps Whether to create a full mip chain. Default is false.
+			 */
+			explicit NullTexture(const std::shared_ptr<NullInstance>& pInstance, uint32_t width, uint32_t height, TextureFormat format, bool bMipmaps = false);
+
+			/**
+			 * Get the number of bytes uploaded to the texture since it was created.
+			 *
+			 * @return The byte count.
+			 */
+			[[nodiscard]] uint64_t getUploadedBytes() const { return m_UploadedBytes; }
+
+		protected:
+			/**
+			 * Upload regions to the texture.
+			 * This will throw a BackendError if a region is outside the texture or the data.
+			 *
+			 * @param regions The regions to upload.
+			 * @param data The pixel data of the regions.
+			 */
+			void upload(std::span<const TextureRegion> regions, std::span<const std::byte> data) override;
+
+		private:
+			uint64_t m_UploadedBytes = 0;
+		};
+	}
+}
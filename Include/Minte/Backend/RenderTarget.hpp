@@ -3,6 +3,18 @@
 #pragma once
 
 #include "ImageBuffer.hpp"
+#include "Texture.hpp"
+#include "BackendError.hpp"
+
+#include "../DataTypes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <span>
 
 namespace minte
 {
@@ -22,21 +34,108 @@ namespace minte
 			X64
 		};
 
+		/**
+		 * Output format of the color buffer.
+		 * Anything other than RGBA is converted on the device before it's copied to the color buffer.
+		 */
+		enum class OutputFormat : uint8_t
+		{
+			RGBA,				// R8G8B8A8, straight alpha.
+			BGRA,				// B8G8R8A8, straight alpha.
+			PremultipliedRGBA,	// R8G8B8A8, premultiplied alpha.
+			PremultipliedBGRA,	// B8G8R8A8, premultiplied alpha.
+			NV12,				// 8 bit Y plane followed by an interleaved UV plane at half resolution. Alpha is discarded.
+			YUV420				// 8 bit Y, U and V planes (I420), the chroma planes at half resolution. Alpha is discarded.
+		};
+
+		/**
+		 * Sample mode enum.
+		 * This is how a draw command uses its texture.
+		 */
+		enum class SampleMode : uint8_t
+		{
+			Color,			// The texture is not sampled, the vertex color is used as is.
+			Image,			// The vertex color is multiplied by the texture color.
+			Coverage,		// The vertex alpha is multiplied by the texture's red channel.
+			DistanceField	// The texture's red channel is a signed distance field, with the edge at 0.5.
+		};
+
+		/**
+		 * Scissor rectangle structure.
+		 * This is the region of the render target a draw command can write to, in pixels. It's clamped to the render target, so the default
+		 * covers all of it.
+		 */
+		struct ScissorRectangle final
+		{
+			uint16_t m_X = 0;
+			uint16_t m_Y = 0;
+			uint16_t m_Width = std::numeric_limits<uint16_t>::max();
+			uint16_t m_Height = std::numeric_limits<uint16_t>::max();
+
+			/**
+			 * Compare two scissor rectangles.
+			 *
+			 * @param other The other rectangle.
+			 * @return Whether the rectangles are equal.
+			 */
+			[[nodiscard]] bool operator==(const ScissorRectangle& other) const = default;
+		};
+
+		/**
+		 * Draw command structure.
+		 * This draws a range of the index buffer. The indices are relative to the vertex offset. The entity IDs come from the vertices, so
+		 * the geometry of multiple entities can be drawn with a single command.
+		 */
+		struct DrawCommand final
+		{
+			uint32_t m_IndexOffset = 0;
+			uint32_t m_IndexCount = 0;
+			uint32_t m_VertexOffset = 0;
+
+			uint8_t m_TextureSlot = 0;	// The texture slot sampled by the command.
+			SampleMode m_SampleMode = SampleMode::Color;
+			bool m_IsOpaque = false;	// Whether every pixel the command covers is written with full alpha.
+			uint8_t m_Padding = 0;
+
+			ScissorRectangle m_Scissor;	// Pixels outside the scissor are not written.
+		};
+
 		/**
 		 * Render Target.
 		 * This class renders a layer and it's elements and returns the resulting image to the user.
 		 *
 		 * The render target contains 3 buffer, the color, entity and depth buffers.
 		 * * Color buffer is the actual rendered output.
-		 * * Entity buffer contains the entity IDs of all the drawn elements, and can be used for mouse picking.
-		 * * The depth buffer contains, well, the depth information.
+		 * * Entity buffer contains the entity IDs (32 bit element handles, 0 where nothing was drawn) of all the drawn elements, and can be used for mouse picking.
+		 * * The depth buffer contains the depth of the opaque draw commands. See GetDrawCommandDepth().
 		 *
 		 * The derived class is expected to initialize these members using the three protected functions set*Buffer(). And should contain the
 		 * respective data at the end of the draw call. And the buffer size(s) should be equal to (width * height * pixel_size).
+		 *
+		 * Geometry is retained by the render target. The vertex and index buffers are updated in ranges, and grow as needed while keeping their
+		 * contents, so the frontend only needs to upload what changed. The draw commands are drawn as if they were drawn in order every draw call.
+		 *
+		 * Backends can draw the opaque commands front to back first, writing and testing their depth, and then the rest back to front, only
+		 * testing it. The output is the same as drawing in order, but the pixels hidden behind opaque commands are rejected before they're
+		 * shaded. This is only done if there are at most MaxDepthOrderedCommands commands, so that each gets a depth of its own.
+		 *
+		 * Draw commands sample textures through a fixed set of texture slots. Slots without a texture sample an opaque white pixel. Each command
+		 * has its own scissor rectangle, which backends should only change when it differs from the previous command's.
+		 *
+		 * The render target can draw at a lower resolution than its extent. The commands are drawn to the top left of the attachments, scaled by
+		 * the render scale, and then upscaled to the full extent before they're copied to the buffers. The scale can be set by hand, or adjusted
+		 * from the measured frame time by setting a frame time budget. Text and distance field commands can be drawn at the native resolution on
+		 * top of the upscaled image, see setNativeResolutionText().
 		 */
 		class RenderTarget : public InstanceBoundObject
 		{
 		public:
+			static constexpr uint32_t MaxTextures = 16;
+			static constexpr uint64_t MaxDepthOrderedCommands = 65534;	// The 16 bit depth buffer can tell this many commands apart.
+
+			static constexpr float RenderScaleStep = 0.05f;	// The render scale is a multiple of this, so that small changes don't resize the render area.
+			static constexpr uint32_t RenderScaleSettleFrames = 8;	// The frames to measure after the render scale changed, before changing it again.
+
 			/**
 			 * Default constructor.
 			 */
@@ -63,6 +162,91 @@ namespace minte
 			 */
 			virtual void draw() = 0;
 
+			/**
+			 * Update a range of the vertex buffer.
+			 * The buffer is grown if the range does not fit.
+			 *
+			 * @param offset The offset of the first vertex.
+			 * @param vertices The vertices to write.
+			 */
+			virtual void updateVertices(uint64_t offset, std::span<const Vertex> vertices) = 0;
+
+			/**
+			 * Update a range of the index buffer.
+			 * The buffer is grown if the range does not fit.
+			 *
+			 * @param offset The offset of the first index.
+			 * @param indices The indices to write.
+			 */
+			virtual void updateIndices(uint64_t offset, std::span<const Index> indices) = 0;
+
+			/**
+			 * Set the draw commands.
+			 * These are used by every draw call till they are replaced.
+			 *
+			 * @param commands The draw commands.
+			 */
+			void setDrawCommands(std::vector<DrawCommand>&& commands) { m_DrawCommands = std::move(commands); m_DrawCommandGeneration++; }
+
+			/**
+			 * Set the draw commands by copying them.
+			 * The render target's storage is reused, so replacing the commands every frame does not allocate once it's large enough.
+			 *
+			 * @param commands The draw commands.
+			 */
+			void setDrawCommands(std::span<const DrawCommand> commands) { m_DrawCommands.assign(commands.begin(), commands.end()); m_DrawCommandGeneration++; }
+
+			/**
+			 * Get the draw command generation.
+			 * This is incremented every time the draw commands are set, so backends can tell when they changed.
+			 *
+			 * @return The generation.
+			 */
+			[[nodiscard]] uint64_t getDrawCommandGeneration() const { return m_DrawCommandGeneration; }
+
+			/**
+			 * Get the state generation.
+			 * This is incremented every time a setting which changes the drawn image is changed, like the output format, a texture binding or the
+			 * render scale. The contents of the buffers and attachments are stale till the next draw call after that.
+			 *
+			 * @return The generation.
+			 */
+			[[nodiscard]] uint64_t getStateGeneration() const { return m_StateGeneration; }
+
+			/**
+			 * Get the draw commands.
+			 *
+			 * @return The draw commands.
+			 */
+			[[nodiscard]] const std::vector<DrawCommand>& getDrawCommands() const { return m_DrawCommands; }
+
+			/**
+			 * Bind a texture to a texture slot.
+			 * The texture must be created using the same instance as the render target.
+			 *
+			 * @param slot The texture slot. This must be less than MaxTextures.
+			 * @param pTexture The texture. Set this to nullptr to clear the slot.
+			 */
+			void setTexture(uint32_t slot, std::shared_ptr<Texture> pTexture)
+			{
+				if (slot >= MaxTextures)
+					throw BackendError("The texture slot is out of range!");
+
+				if (m_Textures[slot] != pTexture)
+				{
+					m_Textures[slot] = std::move(pTexture);
+					invalidateState();
+				}
+			}
+
+			/**
+			 * Get the texture bound to a texture slot.
+			 *
+			 * @param slot The texture slot.
+			 * @return The texture pointer. This is nullptr if the slot is empty.
+			 */
+			[[nodiscard]] const std::shared_ptr<Texture>& getTexture(uint32_t slot) const { return m_Textures[slot]; }
+
 			/**
 			 * Get the width of the render target.
 			 *
@@ -84,35 +268,289 @@ namespace minte
 			 */
 			[[nodiscard]] AntiAliasing getAntiAliasing() const { return m_AntiAliasing; }
 
+			/**
+			 * Set the output format of the color buffer.
+			 * The YUV formats require the width to be a multiple of 8 and the height to be a multiple of 2.
+			 *
+			 * @param format The output format.
+			 */
+			virtual void setOutputFormat(OutputFormat format) = 0;
+
+			/**
+			 * Get the output format of the color buffer.
+			 *
+			 * @return The output format.
+			 */
+			[[nodiscard]] OutputFormat getOutputFormat() const { return m_OutputFormat; }
+
+			/**
+			 * Get the size of the color output in bytes.
+			 *
+			 * @return The size.
+			 */
+			[[nodiscard]] uint64_t getOutputSize() const
+			{
+				const uint64_t pixelCount = static_cast<uint64_t>(m_Width) * m_Height;
+				switch (m_OutputFormat)
+				{
+				case OutputFormat::NV12:
+				case OutputFormat::YUV420:
+					return pixelCount + pixelCount / 2;
+
+				default:
+					return pixelCount * 4;
+				}
+			}
+
+			/**
+			 * Enable or disable copying the output to the buffers.
+			 * Backends which draw on the GPU can skip the readback when the output is only presented on the GPU, in which case the buffers keep
+			 * their previous contents. Backends which draw on the host always write the buffers.
+			 *
+			 * @param bEnable Whether to copy the output to the buffers. Default is true.
+			 */
+			void setHostOutput(bool bEnable)
+			{
+				if (m_IsHostOutput != bEnable)
+				{
+					m_IsHostOutput = bEnable;
+					invalidateState();
+				}
+			}
+
+			/**
+			 * Check if the output is copied to the buffers.
+			 *
+			 * @return Whether the output is copied.
+			 */
+			[[nodiscard]] bool isHostOutput() const { return m_IsHostOutput; }
+
 			/**
 			 * Get the color buffer.
+			 * A handle from ImageBuffer::Retain() can be kept after the draw call, in which case the render target will write the next frame to a
+			 * different buffer.
 			 *
 			 * @return The color buffer.
 			 */
-			[[nodiscard]] const ImageBuffer* getColorBuffer() const { return m_pColorBuffer.get(); }
+			[[nodiscard]] const std::shared_ptr<ImageBuffer>& getColorBuffer() const { return m_pColorBuffer; }
 
 			/**
 			 * Get the entity buffer.
+			 * A handle from ImageBuffer::Retain() can be kept after the draw call, in which case the render target will write the next frame to a
+			 * different buffer.
 			 *
 			 * @return The entity buffer.
 			 */
-			[[nodiscard]] const ImageBuffer* getEntityBuffer() const { return m_pEntityBuffer.get(); }
+			[[nodiscard]] const std::shared_ptr<ImageBuffer>& getEntityBuffer() const { return m_pEntityBuffer; }
 
 			/**
 			 * Get the depth buffer.
+			 * A handle from ImageBuffer::Retain() can be kept after the draw call, in which case the render target will write the next frame to a
+			 * different buffer.
 			 *
 			 * @return The depth buffer.
 			 */
-			[[nodiscard]] const ImageBuffer* getDepthBuffer() const { return m_pDepthBuffer.get(); }
+			[[nodiscard]] const std::shared_ptr<ImageBuffer>& getDepthBuffer() const { return m_pDepthBuffer; }
+
+			/**
+			 * Get the depth of a draw command.
+			 * The depth decreases in draw order, so the last command is the closest. The depth buffer is cleared to 1.
+			 *
+			 * @param command The index of the draw command.
+			 * @param commandCount The number of draw commands.
+			 * @return The depth, between 0 and 1.
+			 */
+			[[nodiscard]] static float GetDrawCommandDepth(uint64_t command, uint64_t commandCount) { return static_cast<float>(commandCount - command) / static_cast<float>(commandCount + 1); }
+
+			/**
+			 * Set the render scale.
+			 * This is the fraction of the extent the commands are drawn at, and is overwritten by the frame time budget if one is set.
+			 * Scaling requires the anti-aliasing to be x1.
+			 *
+			 * @param scale The render scale. This is clamped between the minimum render scale and 1, and rounded to a multiple of RenderScaleStep.
+			 */
+			void setRenderScale(float scale)
+			{
+				if (scale < 1.0f && m_AntiAliasing != AntiAliasing::X1)
+					throw BackendError("Scaling the render resolution requires the anti-aliasing to be x1!");
+
+				const auto renderScale = std::clamp(std::round(scale / RenderScaleStep) * RenderScaleStep, m_MinimumRenderScale, 1.0f);
+				if (renderScale != m_RenderScale)
+				{
+					m_RenderScale = renderScale;
+					invalidateState();
+				}
+			}
+
+			/**
+			 * Get the render scale.
+			 *
+			 * @return The render scale.
+			 */
+			[[nodiscard]] float getRenderScale() const { return m_RenderScale; }
+
+			/**
+			 * Set the lowest render scale the frame time budget can scale down to.
+			 *
+			 * @param scale The minimum scale. This is clamped between RenderScaleStep and 1.
+			 */
+			void setMinimumRenderScale(float scale)
+			{
+				m_MinimumRenderScale = std::clamp(scale, RenderScaleStep, 1.0f);
+				if (m_RenderScale < m_MinimumRenderScale)
+				{
+					m_RenderScale = m_MinimumRenderScale;
+					invalidateState();
+				}
+			}
+
+			/**
+			 * Get the minimum render scale.
+			 *
+			 * @return The minimum scale.
+			 */
+			[[nodiscard]] float getMinimumRenderScale() const { return m_MinimumRenderScale; }
+
+			/**
+			 * Set the frame time budget.
+			 * If set, the render scale is lowered when the draw calls take longer than the budget, and raised again once they're well within it.
+			 * Scaling requires the anti-aliasing to be x1.
+			 *
+			 * @param budget The time a draw call should take. Set this to zero to stop adjusting the render scale.
+			 */
+			void setFrameTimeBudget(std::chrono::nanoseconds budget)
+			{
+				if (budget.count() > 0 && m_AntiAliasing != AntiAliasing::X1)
+					throw BackendError("Scaling the render resolution requires the anti-aliasing to be x1!");
+
+				m_FrameTimeBudget = budget;
+				m_AverageFrameTime = 0.0;
+				m_FramesSinceScaleChange = 0;
+			}
+
+			/**
+			 * Get the frame time budget.
+			 *
+			 * @return The budget. This is zero if the render scale is not adjusted.
+			 */
+			[[nodiscard]] std::chrono::nanoseconds getFrameTimeBudget() const { return m_FrameTimeBudget; }
+
+			/**
+			 * Draw text and distance field commands at the native resolution while the render scale is less than 1.
+			 * These commands are drawn after the rest are upscaled, so they stay sharp. They're still hidden by the opaque commands drawn after
+			 * them, but are drawn over the translucent ones.
+			 *
+			 * @param bEnable Whether to draw them at the native resolution.
+			 */
+			void setNativeResolutionText(bool bEnable)
+			{
+				if (m_IsNativeResolutionText != bEnable)
+				{
+					m_IsNativeResolutionText = bEnable;
+					invalidateState();
+				}
+			}
+
+			/**
+			 * Check if text and distance field commands are drawn at the native resolution.
+			 *
+			 * @return Whether they are.
+			 */
+			[[nodiscard]] bool isNativeResolutionText() const { return m_IsNativeResolutionText; }
+
+			/**
+			 * Get the width the commands are drawn at.
+			 *
+			 * @return The scaled width.
+			 */
+			[[nodiscard]] uint32_t getRenderWidth() const { return std::max(static_cast<uint32_t>(std::ceil(static_cast<float>(m_Width) * m_RenderScale)), 1u); }
+
+			/**
+			 * Get the height the commands are drawn at.
+			 *
+			 * @return The scaled height.
+			 */
+			[[nodiscard]] uint32_t getRenderHeight() const { return std::max(static_cast<uint32_t>(std::ceil(static_cast<float>(m_Height) * m_RenderScale)), 1u); }
+
+			/**
+			 * Check if the commands are drawn at a lower resolution.
+			 *
+			 * @return Whether the render scale is less than 1.
+			 */
+			[[nodiscard]] bool isScaled() const { return m_RenderScale < 1.0f; }
+
+			/**
+			 * Check if a draw command is drawn at the native resolution after upscaling.
+			 *
+			 * @param command The draw command.
+			 * @return Whether the command is drawn at the native resolution.
+			 */
+			[[nodiscard]] bool isDrawnAtNativeResolution(const DrawCommand& command) const
+			{
+				return m_IsNativeResolutionText && isScaled() && (command.m_SampleMode == SampleMode::Coverage || command.m_SampleMode == SampleMode::DistanceField);
+			}
 
 		protected:
 			/**
-			 * Set the entity buffer.
+			 * Mark the drawn image as stale.
+			 * Derived classes call this when a setting of theirs changes what the next draw call produces.
+			 */
+			void invalidateState() { m_StateGeneration++; }
+
+			/**
+			 * Validate an output format against the render target's extent.
+			 * This will throw a BackendError if the format cannot be used.
+			 *
+			 * @param format The output format.
+			 */
+			void validateOutputFormat(OutputFormat format) const
+			{
+				if ((format == OutputFormat::NV12 || format == OutputFormat::YUV420) && (m_Width % 8 != 0 || m_Height % 2 != 0))
+					throw BackendError("The YUV output formats require the width to be a multiple of 8 and the height to be a multiple of 2!");
+			}
+
+			/**
+			 * Update the render scale from the time a draw call took.
+			 * The time is averaged over a few frames. The scale is lowered in proportion to how far over the budget the average is, since the cost
+			 * of a frame scales with its area, and raised a step at a time while the average is under three quarters of the budget.
+			 *
+			 * @param frameTime The time the draw call took.
+			 */
+			void updateRenderScale(std::chrono::nanoseconds frameTime)
+			{
+				if (m_FrameTimeBudget.count() <= 0)
+					return;
+
+				const auto time = static_cast<double>(frameTime.count());
+				m_AverageFrameTime = m_AverageFrameTime == 0.0 ? time : m_AverageFrameTime + (time - m_AverageFrameTime) * 0.25;
+
+				// Give the average time to settle after the scale changed.
+				if (++m_FramesSinceScaleChange < RenderScaleSettleFrames)
+					return;
+
+				const auto budget = static_cast<double>(m_FrameTimeBudget.count());
+				float scale = m_RenderScale;
+				if (m_AverageFrameTime > budget)
+					scale = std::floor(m_RenderScale * static_cast<float>(std::sqrt(budget / m_AverageFrameTime)) / RenderScaleStep) * RenderScaleStep;
+				else if (m_AverageFrameTime < budget * 0.75)
+					scale = m_RenderScale + RenderScaleStep;
+
+				scale = std::clamp(scale, m_MinimumRenderScale, 1.0f);
+				if (scale != m_RenderScale)
+				{
+					m_RenderScale = scale;
+					m_AverageFrameTime = 0.0;
+					m_FramesSinceScaleChange = 0;
+				}
+			}
+
+			/**
+			 * Set the color buffer.
 			 * This is required to be set by the derived class.
 			 *
 			 * @param pBuffer The buffer to set.
 			 */
-			void setColorBuffer(std::unique_ptr<ImageBuffer>&& pBuffer) { m_pColorBuffer = std::move(pBuffer); }
+			void setColorBuffer(std::shared_ptr<ImageBuffer>&& pBuffer) { m_pColorBuffer = std::move(pBuffer); }
 
 			/**
 			 * Set the entity buffer.
@@ -120,25 +558,109 @@ namespace minte
 			 *
 			 * @param pBuffer The buffer to set.
 			 */
-			void setEntityBuffer(std::unique_ptr<ImageBuffer>&& pBuffer) { m_pEntityBuffer = std::move(pBuffer); }
+			void setEntityBuffer(std::shared_ptr<ImageBuffer>&& pBuffer) { m_pEntityBuffer = std::move(pBuffer); }
 
 			/**
-			 * Set the entity buffer.
+			 * Set the depth buffer.
 			 * This is required to be set by the derived class.
 			 *
 			 * @param pBuffer The buffer to set.
 			 */
-			void setDepthBuffer(std::unique_ptr<ImageBuffer>&& pBuffer) { m_pDepthBuffer = std::move(pBuffer); }
+			void setDepthBuffer(std::shared_ptr<ImageBuffer>&& pBuffer) { m_pDepthBuffer = std::move(pBuffer); }
+
+			/**
+			 * Create a new image buffer.
+			 * This is used to replace the buffers that are retained by the user.
+			 *
+			 * @param size The size of the buffer.
+			 * @return The created buffer.
+			 */
+			[[nodiscard]] virtual std::shared_ptr<ImageBuffer> createImageBuffer(uint64_t size) = 0;
+
+			/**
+			 * Acquire the buffers to be written by the next draw call.
+			 * Buffers that are still retained outside the render target are replaced with a released buffer of the same size, or a new one.
+			 *
+			 * @return Whether any of the buffers were replaced.
+			 */
+			bool acquireBuffers()
+			{
+				// Make sure not to short circuit, all the buffers need to be acquired.
+				const bool bReplaced = acquireBuffer(m_pColorBuffer) | acquireBuffer(m_pEntityBuffer) | acquireBuffer(m_pDepthBuffer);
+
+				// Drop the released buffers that can no longer be reused.
+				std::erase_if(m_BufferPool, [this](const std::shared_ptr<ImageBuffer>& pBuffer)
+					{
+						const auto size = pBuffer->getSize();
+						return !pBuffer->isRetained() && size != m_pColorBuffer->getSize() && size != m_pEntityBuffer->getSize() && size != m_pDepthBuffer->getSize();
+					}
+				);
+
+				return bReplaced;
+			}
 
 		private:
-			std::unique_ptr<ImageBuffer> m_pColorBuffer = nullptr;
-			std::unique_ptr<ImageBuffer> m_pEntityBuffer = nullptr;
-			std::unique_ptr<ImageBuffer> m_pDepthBuffer = nullptr;
+			/**
+			 * Acquire a single buffer.
+			 *
+			 * @param pBuffer The buffer to acquire.
+			 * @return Whether the buffer was replaced.
+			 */
+			bool acquireBuffer(std::shared_ptr<ImageBuffer>& pBuffer)
+			{
+				// Nobody else is holding the buffer, so we can write to it.
+				if (pBuffer == nullptr || !pBuffer->isRetained())
+					return false;
+
+				// Keep track of the retained buffer so that we can reuse it once it's released.
+				const auto size = pBuffer->getSize();
+				auto pRetained = std::move(pBuffer);
+
+				for (auto& pCandidate : m_BufferPool)
+				{
+					if (!pCandidate->isRetained() && pCandidate->getSize() == size)
+					{
+						pBuffer = std::move(pCandidate);
+						break;
+					}
+				}
+
+				// Remove the slot we took from the pool, and create a new buffer if we didn't find one.
+				std::erase(m_BufferPool, nullptr);
+				if (pBuffer == nullptr)
+					pBuffer = createImageBuffer(size);
+
+				m_BufferPool.emplace_back(std::move(pRetained));
+				return true;
+			}
+
+		protected:
+			OutputFormat m_OutputFormat = OutputFormat::RGBA;
+
+		private:
+			std::shared_ptr<ImageBuffer> m_pColorBuffer = nullptr;
+			std::shared_ptr<ImageBuffer> m_pEntityBuffer = nullptr;
+			std::shared_ptr<ImageBuffer> m_pDepthBuffer = nullptr;
+
+			std::vector<std::shared_ptr<ImageBuffer>> m_BufferPool;
+			std::vector<DrawCommand> m_DrawCommands;
+			uint64_t m_DrawCommandGeneration = 0;
+			uint64_t m_StateGeneration = 0;
+			std::array<std::shared_ptr<Texture>, MaxTextures> m_Textures;
 
 			uint32_t m_Width = 0;
 			uint32_t m_Height = 0;
 
+			float m_RenderScale = 1.0f;
+			float m_MinimumRenderScale = 0.5f;
+			std::chrono::nanoseconds m_FrameTimeBudget = std::chrono::nanoseconds(0);
+			double m_AverageFrameTime = 0.0;	// In nanoseconds.
+			uint32_t m_FramesSinceScaleChange = 0;
+
 			AntiAliasing m_AntiAliasing = AntiAliasing::X1;
+
+			bool m_IsNativeResolutionText = false;
+			bool m_IsHostOutput = true;
 		};
 	}
 }
\ No newline at end of file
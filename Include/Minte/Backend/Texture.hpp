@@ -0,0 +1,177 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "InstanceBoundObject.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <span>
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * Texture format enum.
+		 */
+		enum class TextureFormat : uint8_t
+		{
+			R8,		// Single 8 bit channel, used for glyph coverage and distance fields.
+			RGBA8	// R8G8B8A8, straight alpha.
+		};
+
+		/**
+		 * Texture region structure.
+		 * This is a rectangle of a texture, and where its pixels are in the data given to the texture. The rows of a region are tightly packed.
+		 */
+		struct TextureRegion final
+		{
+			uint64_t m_Offset = 0;	// The byte offset of the region's pixels in the data.
+
+			uint32_t m_X = 0;
+			uint32_t m_Y = 0;
+			uint32_t m_Width = 0;
+			uint32_t m_Height = 0;
+		};
+
+		/**
+		 * Texture class.
+		 * This is a sampled image which is created once and updated in regions, so a texture atlas only uploads the regions that changed.
+		 *
+		 * Textures can have a full mip chain, which is regenerated from the first level after every update and sampled with trilinear filtering,
+		 * so images drawn smaller than their size don't alias. Atlases should not use mipmaps, as the smaller levels blend the neighbouring
+		 * regions.
+		 */
+		class Texture : public InstanceBoundObject
+		{
+		public:
+			/**
+			 * Default constructor.
+			 */
+			Texture() = default;
+
+			/**
+			 * Explicit constructor.
+			 *
+			 * @param pInstance The instance pointer.
+			 * @param width The width of the texture.
+			 * @param height The height of the texture.
+			 * @param format The texture format.
+			 * @param bMipmaps Whether to create a full mip chain. Default is false.
+			 */
+			explicit Texture(const std::shared_ptr<Instance>& pInstance, uint32_t width, uint32_t height, TextureFormat format, bool bMipmaps = false)
+				: InstanceBoundObject(pInstance), m_Width(width), m_Height(height), m_MipLevels(bMipmaps ? static_cast<uint32_t>(std::bit_width(std::max(width, height))) : 1), m_Format(format) {}
+
+			/**
+			 * Default virtual destructor.
+			 */
+			virtual ~Texture() = default;
+
+			/**
+			 * Update regions of the texture.
+			 * All the regions are uploaded at once, and the texture can be sampled by the next draw call. The regions are written to the first
+			 * level, and the rest of the mip chain is regenerated from it. The instance's texture update callback is notified afterwards.
+			 *
+			 * @param regions The regions to update.
+			 * @param data The pixel data of all the regions.
+			 */
+			void update(std::span<const TextureRegion> regions, std::span<const std::byte> data)
+			{
+				upload(regions, data);
+				getInstance()->notifyTextureUpdate(*this, regions, data);
+			}
+
+			/**
+			 * Get the unique ID of the texture.
+			 * This is unique among all the textures of the process and is never reused, unlike the texture's address.
+			 *
+			 * @return The unique ID. This is never 0.
+			 */
+			[[nodiscard]] uint64_t getUniqueID() const { return m_UniqueID; }
+
+			/**
+			 * Get the width of the texture.
+			 *
+			 * @return The width.
+			 */
+			[[nodiscard]] uint32_t getWidth() const { return m_Width; }
+
+			/**
+			 * Get the height of the texture.
+			 *
+			 * @return The height.
+			 */
+			[[nodiscard]] uint32_t getHeight() const { return m_Height; }
+
+			/**
+			 * Get the number of mip levels.
+			 *
+			 * @return The mip level count. This is 1 if the texture has no mipmaps.
+			 */
+			[[nodiscard]] uint32_t getMipLevels() const { return m_MipLevels; }
+
+			/**
+			 * Get the width of a mip level.
+			 *
+			 * @param level The mip level.
+			 * @return The width.
+			 */
+			[[nodiscard]] uint32_t getMipWidth(uint32_t level) const { return std::max(m_Width >> level, 1u); }
+
+			/**
+			 * Get the height of a mip level.
+			 *
+			 * @param level The mip level.
+			 * @return The height.
+			 */
+			[[nodiscard]] uint32_t getMipHeight(uint32_t level) const { return std::max(m_Height >> level, 1u); }
+
+			/**
+			 * Get the texture format.
+			 *
+			 * @return The format.
+			 */
+			[[nodiscard]] TextureFormat getFormat() const { return m_Format; }
+
+			/**
+			 * Get the size of a single pixel.
+			 *
+			 * @return The size in bytes.
+			 */
+			[[nodiscard]] uint32_t getPixelSize() const { return m_Format == TextureFormat::R8 ? 1 : 4; }
+
+		protected:
+			/**
+			 * Upload regions to the texture.
+			 * This is implemented by the backends, and is called by update().
+			 *
+			 * @param regions The regions to upload.
+			 * @param data The pixel data of all the regions.
+			 */
+			virtual void upload(std::span<const TextureRegion> regions, std::span<const std::byte> data) = 0;
+
+		private:
+			/**
+			 * Generate a new unique ID.
+			 *
+			 * @return The unique ID.
+			 */
+			[[nodiscard]] static uint64_t GenerateUniqueID()
+			{
+				static std::atomic<uint64_t> counter = 0;
+				return ++counter;
+			}
+
+		private:
+			uint64_t m_UniqueID = GenerateUniqueID();
+
+			uint32_t m_Width = 0;
+			uint32_t m_Height = 0;
+			uint32_t m_MipLevels = 1;
+
+			TextureFormat m_Format = TextureFormat::RGBA8;
+		};
+	}
+}
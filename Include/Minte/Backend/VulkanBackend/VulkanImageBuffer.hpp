@@ -25,8 +25,9 @@ namespace minte
 			 *
 			 * @param pInstance The instance pointer.
 			 * @param size The size of the buffer.
+			 * @param category The resource category of the buffer. Default is readback.
 			 */
-			explicit VulkanImageBuffer(const std::shared_ptr<VulkanInstance>& pInstance, uint64_t size);
+			explicit VulkanImageBuffer(const std::shared_ptr<VulkanInstance>& pInstance, uint64_t size, ResourceCategory category = ResourceCategory::Readback);
 
 			/**
 			 * Destructor.
@@ -55,6 +56,9 @@ namespace minte
 		private:
 			VkBuffer m_Buffer = VK_NULL_HANDLE;
 			VmaAllocation m_Allocation = nullptr;
+
+			uint64_t m_AllocationSize = 0;
+			ResourceCategory m_Category = ResourceCategory::Readback;
 		};
 	}
 }
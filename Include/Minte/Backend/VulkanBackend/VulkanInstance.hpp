@@ -8,6 +8,7 @@
 #include <vk_mem_alloc.h>
 
 #include <vector>
+#include <span>
 
 namespace minte
 {
@@ -38,6 +39,14 @@ namespace minte
 			 */
 			~VulkanInstance() override;
 
+			/**
+			 * Get the memory statistics of the instance.
+			 * The heap usage and budget are reported by the device if VK_EXT_memory_budget is supported, else it's estimated by VMA.
+			 *
+			 * @return The memory statistics.
+			 */
+			[[nodiscard]] MemoryStatistics getMemoryStatistics() const override;
+
 			/**
 			 * Get the instance.
 			 *
@@ -59,6 +68,13 @@ namespace minte
 			 */
 			[[nodsicard]] VkPhysicalDevice getPhysicalDevice() const { return m_PhysicalDevice; }
 
+			/**
+			 * Get the physical device properties.
+			 *
+			 * @return The properties.
+			 */
+			[[nodiscard]] const VkPhysicalDeviceProperties& getPhysicalDeviceProperties() const { return m_PhysicalDeviceProperties; }
+
 			/**
 			 * Get the device table.
 			 *
@@ -94,6 +110,48 @@ namespace minte
 			 */
 			[[nodiscard]] VulaknQueue getComputeQueue() const { return m_ComputeQueue; }
 
+			/**
+			 * Check if the device supports the memory budget extension.
+			 *
+			 * @return Whether the extension is enabled or not.
+			 */
+			[[nodiscard]] bool hasMemoryBudget() const { return m_HasMemoryBudget; }
+
+			/**
+			 * Check if the device supports waiting for presentation, using the present ID and present wait extensions.
+			 *
+			 * @return Whether the extensions are enabled or not.
+			 */
+			[[nodiscard]] bool hasPresentWait() const { return m_HasPresentWait; }
+
+			/**
+			 * Check if the device can export memory and semaphores as file descriptors.
+			 *
+			 * @return Whether the extensions are enabled or not.
+			 */
+			[[nodiscard]] bool hasExternalMemory() const { return m_HasExternalMemory; }
+
+			/**
+			 * Check if the device can export memory as dma-bufs.
+			 *
+			 * @return Whether the extension is enabled or not.
+			 */
+			[[nodiscard]] bool hasDmaBufMemory() const { return m_HasDmaBufMemory; }
+
+			/**
+			 * Check if the device can import host pointers as memory.
+			 *
+			 * @return Whether the extension is enabled or not.
+			 */
+			[[nodiscard]] bool hasHostMemoryImport() const { return m_HasHostMemoryImport; }
+
+			/**
+			 * Get the alignment of the host pointers and sizes which can be imported.
+			 *
+			 * @return The alignment in bytes. This is 0 if host pointers can't be imported.
+			 */
+			[[nodiscard]] uint64_t getHostPointerAlignment() const { return m_HostPointerAlignment; }
+
 			/**
 			 * Change the image layout of an image.
 			 *
@@ -104,8 +162,17 @@ namespace minte
 			 * @param aspectFlags The image aspect flags.
 			 * @param mipLevels The image mip levels. Default is 1.
 			 * @param layers The image layers. Default is 1.
+			 * @param baseMipLevel The first mip level to change. Default is 0.
 			 */
-			void changeImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout currentLayout, VkImageLayout newLayout, VkImageAspectFlags aspectFlags, uint32_t mipLevels = 1, uint32_t layers = 1) const;
+			void changeImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout currentLayout, VkImageLayout newLayout, VkImageAspectFlags aspectFlags, uint32_t mipLevels = 1, uint32_t layers = 1, uint32_t baseMipLevel = 0) const;
+
+			/**
+			 * Create a new shader module.
+			 *
+			 * @param code The SPIR-V code.
+			 * @return The created shader module.
+			 */
+			[[nodiscard]] VkShaderModule createShaderModule(std::span<const uint32_t> code) const;
 
 		private:
 			/**
@@ -141,6 +208,14 @@ namespace minte
 			VulaknQueue m_GraphicsQueue = {};
 			VulaknQueue m_TransferQueue = {};
 			VulaknQueue m_ComputeQueue = {};
+
+			uint64_t m_HostPointerAlignment = 0;
+
+			bool m_HasMemoryBudget = false;
+			bool m_HasPresentWait = false;
+			bool m_HasExternalMemory = false;
+			bool m_HasDmaBufMemory = false;
+			bool m_HasHostMemoryImport = false;
 		};
 	}
 }
\ No newline at end of file
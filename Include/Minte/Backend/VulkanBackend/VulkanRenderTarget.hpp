@@ -3,14 +3,59 @@
 #pragma once
 
 #include "../RenderTarget.hpp"
-#include "VulkanInstance.hpp"
+#include "VulkanTexture.hpp"
 
 namespace minte
 {
 	namespace backend
 	{
+		/**
+		 * Vulkan external memory enum.
+		 * This is how the attachments are exported to other APIs and devices.
+		 */
+		enum class VulkanExternalMemory : uint8_t
+		{
+			None,
+			OpaqueFD,	// An opaque file descriptor of an optimally tiled image. It can only be imported by the same driver and device.
+			DmaBuf		// A linearly tiled dma-buf, which can be imported by other drivers and devices.
+		};
+
+		/**
+		 * Vulkan exported image structure.
+		 * This has everything needed to import an exported attachment. The memory is a dedicated allocation, so the importer has to bind it to
+		 * an image created with the same parameters, using VkMemoryDedicatedAllocateInfo.
+		 */
+		struct VulkanExportedImage final
+		{
+			int32_t m_FileDescriptor = -1;	// The memory file descriptor. The caller owns it.
+			uint64_t m_Size = 0;	// The size of the memory.
+
+			VkExternalMemoryHandleTypeFlagBits m_HandleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+			uint32_t m_MemoryTypeIndex = 0;	// The exporter's memory type. Opaque file descriptors have to be imported to the same type.
+
+			VkFormat m_Format = VK_FORMAT_UNDEFINED;
+			VkImageTiling m_Tiling = VK_IMAGE_TILING_OPTIMAL;
+			VkImageUsageFlags m_Usage = 0;
+			VkImageLayout m_Layout = VK_IMAGE_LAYOUT_UNDEFINED;	// The layout of the image after a draw call.
+
+			uint64_t m_RowPitch = 0;	// The bytes between two rows of a linearly tiled image.
+			uint32_t m_Width = 0;
+			uint32_t m_Height = 0;
+		};
+
 		/**
 		 * Vulkan render target class.
+		 *
+		 * When the render scale is less than 1, the geometry is drawn to the top left of the attachments, which is then copied to a set of
+		 * sampled images. A second render pass upscales them back over the whole attachments, and draws the native resolution commands on top.
+		 *
+		 * The color attachment, and optionally the entity attachment, can be allocated as exportable memory so another API or device can sample
+		 * them without a copy. The exported images are released to the external queue family after every draw call, and the draw call signals
+		 * a semaphore which can be taken as a sync file descriptor.
+		 *
+		 * The UI can be drawn on top of a background instead of a cleared image. The background is either an image view of the same device, or
+		 * a frame in host memory which is imported as a texel buffer. Either way it's read straight from where it is by the first draw of the
+		 * render pass, without being copied.
 		 */
 		class VulkanRenderTarget final : public backend::RenderTarget
 		{
@@ -23,7 +68,29 @@ namespace minte
 				VkImageView m_ImageView = VK_NULL_HANDLE;
 
 				VmaAllocation m_ImageAllocation = nullptr;
+				VmaPool m_ExportPool = nullptr;	// The pool of the exportable memory. This is only used by exported attachments.
 				VkImageLayout m_CurrentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+				VkFormat m_Format = VK_FORMAT_UNDEFINED;
+				VkImageTiling m_Tiling = VK_IMAGE_TILING_OPTIMAL;
+				VkImageUsageFlags m_Usage = 0;
+
+				uint64_t m_AllocationSize = 0;
+			};
+
+			/**
+			 * Vulkan geometry buffer structure.
+			 * Geometry buffers are persistently mapped, so updating a range is a single copy.
+			 */
+			struct VulkanGeometryBuffer final
+			{
+				VkBuffer m_Buffer = VK_NULL_HANDLE;
+				VmaAllocation m_Allocation = nullptr;
+
+				std::byte* m_pMappedData = nullptr;
+
+				uint64_t m_Size = 0;
+				uint64_t m_AllocationSize = 0;
 			};
 
 		public:
@@ -47,7 +114,139 @@ namespace minte
 			 */
 			void draw() override;
 
+			/**
+			 * Update a range of the vertex buffer.
+			 *
+			 * @param offset The offset of the first vertex.
+			 * @param vertices The vertices to write.
+			 */
+			void updateVertices(uint64_t offset, std::span<const Vertex> vertices) override;
+
+			/**
+			 * Update a range of the index buffer.
+			 *
+			 * @param offset The offset of the first index.
+			 * @param indices The indices to write.
+			 */
+			void updateIndices(uint64_t offset, std::span<const Index> indices) override;
+
+			/**
+			 * Set the output format of the color buffer.
+			 * Converting the output requires the anti-aliasing to be x1.
+			 *
+			 * @param format The output format.
+			 */
+			void setOutputFormat(OutputFormat format) override;
+
+			/**
+			 * Get the color attachment image.
+			 * The image is in the layout returned by getColorImageLayout() after a draw call, and contains the RGBA output at the full resolution.
+			 *
+			 * @return The image.
+			 */
+			[[nodiscard]] VkImage getColorImage() const { return m_ColorAttachment.m_Image; }
+
+			/**
+			 * Get the layout of the color attachment image after a draw call.
+			 * The host output conversion leaves the image in the general layout, unless it's moved back to be released to the external queue family.
+			 *
+			 * @return The image layout.
+			 */
+			[[nodiscard]] VkImageLayout getColorImageLayout() const
+			{
+				return isHostOutput() && getOutputFormat() != OutputFormat::RGBA && m_ExternalMemory == VulkanExternalMemory::None
+					? VK_IMAGE_LAYOUT_GENERAL
+					: VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			}
+
+			/**
+			 * Set how the attachments are exported.
+			 * The attachments are recreated, so the previously exported images will not be written to anymore. Exported render targets should
+			 * not be presented by a window, as the images are released to the external queue family.
+			 *
+			 * This will throw a BackendError if the device does not support the memory type, or if the anti-aliasing is not x1.
+			 *
+			 * @param type The external memory type. None stops exporting.
+			 * @param bExportEntities Whether to export the entity attachment as well. Default is false.
+			 */
+			void setExternalMemory(VulkanExternalMemory type, bool bExportEntities = false);
+
+			/**
+			 * Get the external memory type of the attachments.
+			 *
+			 * @return The memory type.
+			 */
+			[[nodiscard]] VulkanExternalMemory getExternalMemory() const { return m_ExternalMemory; }
+
+			/**
+			 * Export the color attachment.
+			 * Every call returns a new file descriptor. The memory changes when the output format or the external memory type changes.
+			 * This will throw a BackendError if the attachment is not exported.
+			 *
+			 * @return The exported image.
+			 */
+			[[nodiscard]] VulkanExportedImage exportColorImage() const { return exportAttachment(m_ColorAttachment); }
+
+			/**
+			 * Export the entity attachment.
+			 * Every call returns a new file descriptor. This will throw a BackendError if the attachment is not exported.
+			 *
+			 * @return The exported image.
+			 */
+			[[nodiscard]] VulkanExportedImage exportEntityImage() const { return exportAttachment(m_EntityAttachment); }
+
+			/**
+			 * Take the sync file descriptor which is signaled when the last draw call finishes.
+			 * The caller owns the file descriptor. If it's not taken, it's closed by the next draw call.
+			 *
+			 * @return The file descriptor. This is -1 if there is none, or if the draw call had already finished when it was exported.
+			 */
+			[[nodiscard]] int32_t takeCompletionFileDescriptor();
+
+			/**
+			 * Draw on top of an image.
+			 * The image is stretched over the render target. It can be imported from external memory, as long as the view belongs to the render
+			 * target's device. Its writes must be made visible to the fragment shader before a draw call, by a submission to the same queue or
+			 * one which was waited on.
+			 *
+			 * @param imageView The image view to sample. VK_NULL_HANDLE removes the background.
+			 * @param layout The layout the image is in while drawing. Default is shader read only.
+			 */
+			void setBackgroundImage(VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+			/**
+			 * Draw on top of a frame in host memory.
+			 * The memory is imported, so the GPU reads it directly. It must stay valid till the background is changed or the render target is
+			 * destroyed, and can be written between the draw calls.
+			 *
+			 * This will throw a BackendError if the device can't import host memory, or if the pointer or the row pitch is not 4 byte aligned.
+			 *
+			 * @param pPixels The RGBA pixels, the same size as the render target. nullptr removes the background.
+			 * @param rowPitch The bytes between two rows.
+			 */
+			void setBackgroundPixels(const std::byte* pPixels, uint64_t rowPitch);
+
+			/**
+			 * Remove the background, so the render target is cleared before drawing.
+			 */
+			void clearBackground();
+
+			/**
+			 * Check if the render target has a background.
+			 *
+			 * @return Whether there is a background.
+			 */
+			[[nodiscard]] bool hasBackground() const { return m_BackgroundImageView != VK_NULL_HANDLE || m_BackgroundBufferView != VK_NULL_HANDLE; }
+
 		private:
+			/**
+			 * Create a new image buffer.
+			 *
+			 * @param size The size of the buffer.
+			 * @return The created buffer.
+			 */
+			[[nodiscard]] std::shared_ptr<ImageBuffer> createImageBuffer(uint64_t size) override;
+
 			/**
 			 * Create a new attachment.
 			 *
@@ -56,9 +255,10 @@ namespace minte
 			 * @param usageFlags The image usage flags.
 			 * @param tiling The image tiling.
 			 * @param aspectFlags The image view aspect flags.
+			 * @param bExportable Whether to allocate exportable memory of the current external memory type. Default is false.
 			 * @return The created attachment.
 			 */
-			[[nodiscard]] VulkanAttachment createAttachment(VkFormat format, VkSampleCountFlagBits sampleCount, VkImageUsageFlags usageFlags, VkImageTiling tiling, VkImageAspectFlags aspectFlags) const;
+			[[nodiscard]] VulkanAttachment createAttachment(VkFormat format, VkSampleCountFlagBits sampleCount, VkImageUsageFlags usageFlags, VkImageTiling tiling, VkImageAspectFlags aspectFlags, bool bExportable = false) const;
 
 			/**
 			 * Destroy an attachment.
@@ -68,7 +268,25 @@ namespace minte
 			void destroyAttachment(const VulkanAttachment& attachment) const;
 
 			/**
-			 * Setup the render pass.
+			 * Export an attachment's memory.
+			 *
+			 * @param attachment The attachment to export.
+			 * @return The exported image.
+			 */
+			[[nodiscard]] VulkanExportedImage exportAttachment(const VulkanAttachment& attachment) const;
+
+			/**
+			 * Record the commands to release the exported attachments to the external queue family.
+			 */
+			void recordExternalRelease() const;
+
+			/**
+			 * Setup the color attachment and the color buffer for the current output format.
+			 */
+			void setupColorOutput();
+
+			/**
+			 * Setup the render passes.
 			 */
 			void setupRenderPass();
 
@@ -82,6 +300,120 @@ namespace minte
 			 */
 			void setupCommandBuffer();
 
+			/**
+			 * Setup the graphics pipeline used to draw the geometry.
+			 */
+			void setupGeometryPipeline();
+
+			/**
+			 * Setup the descriptor sets used to sample the textures.
+			 * Each texture slot has its own descriptor set, so that the slots can be bound without descriptor indexing.
+			 */
+			void setupTextureDescriptors();
+
+			/**
+			 * Update the descriptor sets of the texture slots that changed since the last draw call.
+			 */
+			void updateTextureDescriptors();
+
+			/**
+			 * Record the commands to draw the geometry.
+			 * The opaque commands are drawn front to back first, and then the translucent commands back to front.
+			 *
+			 * @param bNativeResolution Whether to draw the commands drawn at the native resolution, or the rest at the render scale.
+			 */
+			void recordGeometry(bool bNativeResolution) const;
+
+			/**
+			 * Write data to a geometry buffer.
+			 * The buffer is recreated with a larger size if the data does not fit.
+			 *
+			 * @param buffer The buffer to write to.
+			 * @param usage The buffer usage.
+			 * @param offset The byte offset to write to.
+			 * @param data The data to write.
+			 */
+			void writeGeometryBuffer(VulkanGeometryBuffer& buffer, VkBufferUsageFlags usage, uint64_t offset, std::span<const std::byte> data) const;
+
+			/**
+			 * Create a new geometry buffer.
+			 *
+			 * @param size The size of the buffer.
+			 * @param usage The buffer usage.
+			 * @return The created buffer.
+			 */
+			[[nodiscard]] VulkanGeometryBuffer createGeometryBuffer(uint64_t size, VkBufferUsageFlags usage) const;
+
+			/**
+			 * Destroy a geometry buffer.
+			 *
+			 * @param buffer The buffer to destroy.
+			 */
+			void destroyGeometryBuffer(const VulkanGeometryBuffer& buffer) const;
+
+			/**
+			 * Setup the compute pipeline used to convert the color output.
+			 */
+			void setupConversionPipeline();
+
+			/**
+			 * Update the conversion descriptor set with the current color attachment and buffer.
+			 */
+			void updateConversionDescriptor() const;
+
+			/**
+			 * Record the commands to convert the color attachment to the color buffer.
+			 */
+			void recordConversion() const;
+
+			/**
+			 * Record the commands to copy the attachments to the buffers, and make them visible to the host.
+			 */
+			void recordReadback() const;
+
+			/**
+			 * Destroy the conversion pipeline and its resources.
+			 */
+			void destroyConversionPipeline() const;
+
+			/**
+			 * Setup the images, render pass and pipeline used to upscale the scaled geometry.
+			 * These are created the first time the render scale is used.
+			 */
+			void setupUpscale();
+
+			/**
+			 * Record the commands to upscale the scaled geometry, and draw the native resolution commands on top.
+			 */
+			void recordUpscale() const;
+
+			/**
+			 * Destroy the upscale resources.
+			 */
+			void destroyUpscale() const;
+
+			/**
+			 * Setup the pipeline used to draw the background.
+			 *
+			 * @param bPixels Whether the background is read from host pixels, or sampled from an image.
+			 */
+			void setupBackground(bool bPixels);
+
+			/**
+			 * Record the commands to draw the background.
+			 */
+			void recordBackground() const;
+
+			/**
+			 * Release the imported background pixels.
+			 */
+			void releaseBackgroundPixels();
+
+			/**
+			 * Destroy the background pipeline and its resources.
+			 */
+			void destroyBackground();
+
 			/**
 			 * Wait for the fence to finish execution.
 			 */
@@ -98,6 +430,60 @@ namespace minte
 			VkCommandPool m_CommandPool = VK_NULL_HANDLE;
 			VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
 			VkFence m_Fence = VK_NULL_HANDLE;
+
+			VkExportMemoryAllocateInfo m_ExportMemoryAllocateInfo = {};	// The export pools point to this.
+			VkSemaphore m_CompletionSemaphore = VK_NULL_HANDLE;	// This is signaled by the draw calls while exporting, if sync file descriptors are supported.
+			int32_t m_CompletionFileDescriptor = -1;
+			VulkanExternalMemory m_ExternalMemory = VulkanExternalMemory::None;
+			bool m_IsExportingEntities = false;
+
+			VulkanGeometryBuffer m_VertexBuffer = {};
+			VulkanGeometryBuffer m_IndexBuffer = {};
+
+			VkPipelineLayout m_GeometryPipelineLayout = VK_NULL_HANDLE;
+			VkPipeline m_GeometryPipeline = VK_NULL_HANDLE;	// This draws the translucent commands.
+			VkPipeline m_OpaqueGeometryPipeline = VK_NULL_HANDLE;
+
+			std::shared_ptr<VulkanTexture> m_pDefaultTexture = nullptr;	// This is sampled by the empty texture slots.
+			std::array<std::shared_ptr<Texture>, MaxTextures> m_BoundTextures;	// The textures written to the descriptor sets.
+			std::array<VkDescriptorSet, MaxTextures> m_TextureDescriptorSets = {};
+			VkDescriptorSetLayout m_TextureDescriptorSetLayout = VK_NULL_HANDLE;
+			VkDescriptorPool m_TextureDescriptorPool = VK_NULL_HANDLE;
+
+			VkDescriptorSetLayout m_ConversionDescriptorSetLayout = VK_NULL_HANDLE;
+			VkPipelineLayout m_ConversionPipelineLayout = VK_NULL_HANDLE;
+			VkPipeline m_ConversionPipeline = VK_NULL_HANDLE;
+			VkDescriptorPool m_ConversionDescriptorPool = VK_NULL_HANDLE;
+			VkDescriptorSet m_ConversionDescriptorSet = VK_NULL_HANDLE;
+
+			// The scaled geometry is copied to these, and then upscaled back to the attachments.
+			VulkanAttachment m_ScaledColorImage = {};
+			VulkanAttachment m_ScaledEntityImage = {};
+			VulkanAttachment m_ScaledDepthImage = {};
+
+			VkRenderPass m_UpscaleRenderPass = VK_NULL_HANDLE;	// This is compatible with the render pass, but does not clear the attachments.
+			VkSampler m_UpscaleSampler = VK_NULL_HANDLE;
+			VkDescriptorSetLayout m_UpscaleDescriptorSetLayout = VK_NULL_HANDLE;
+			VkPipelineLayout m_UpscalePipelineLayout = VK_NULL_HANDLE;
+			VkPipeline m_UpscalePipeline = VK_NULL_HANDLE;
+			VkDescriptorPool m_UpscaleDescriptorPool = VK_NULL_HANDLE;
+			VkDescriptorSet m_UpscaleDescriptorSet = VK_NULL_HANDLE;
+
+			// Only one of the image view and the imported pixels is used at a time.
+			VkImageView m_BackgroundImageView = VK_NULL_HANDLE;
+			VkBuffer m_BackgroundBuffer = VK_NULL_HANDLE;
+			VkDeviceMemory m_BackgroundMemory = VK_NULL_HANDLE;
+			VkBufferView m_BackgroundBufferView = VK_NULL_HANDLE;
+			uint32_t m_BackgroundRowLength = 0;	// The texels between two rows of the pixels.
+			uint32_t m_BackgroundFirstTexel = 0;	// The first pixel's texel, as the imported memory starts at an aligned address.
+
+			VkSampler m_BackgroundSampler = VK_NULL_HANDLE;
+			VkDescriptorSetLayout m_BackgroundDescriptorSetLayout = VK_NULL_HANDLE;
+			VkPipelineLayout m_BackgroundPipelineLayout = VK_NULL_HANDLE;
+			VkPipeline m_BackgroundPipeline = VK_NULL_HANDLE;
+			VkDescriptorPool m_BackgroundDescriptorPool = VK_NULL_HANDLE;
+			VkDescriptorSet m_BackgroundDescriptorSet = VK_NULL_HANDLE;
+			bool m_IsBackgroundPixels = false;	// Whether the background pipeline reads host pixels.
 		};
 	}
 }
\ No newline at end of file
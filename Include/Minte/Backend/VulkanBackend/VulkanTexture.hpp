@@ -0,0 +1,107 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "../Texture.hpp"
+#include "VulkanImageBuffer.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		/**
+		 * Vulkan texture class.
+		 * The image is kept in the shader read layout. Updates are copied to a staging buffer, and all the regions of an update are copied to the
+		 * image with a single submission. Mipmapped textures blit the mip chain from the first level in the same submission.
+		 */
+		class VulkanTexture final : public Texture
+		{
+		public:
+			/**
+			 * Explicit constructor.
+			 * This will throw a BackendError if mipmaps are requested, but the device can't blit and linearly filter the format.
+			 *
+			 * @param pInstance The Vulkan instance pointer.
+			 * @param width The width of the texture.
+			 * @param height The height of the texture.
+			 * @param format The texture format.
+			 * @param bMipmaps Whether to create a full mip chain. Default is false.
+			 */
+			explicit VulkanTexture(const std::shared_ptr<VulkanInstance>& pInstance, uint32_t width, uint32_t height, TextureFormat format, bool bMipmaps = false);
+
+			/**
+			 * Destructor.
+			 */
+			~VulkanTexture() override;
+
+			/**
+			 * Get the image view.
+			 *
+			 * @return The image view.
+			 */
+			[[nodiscard]] VkImageView getImageView() const { return m_ImageView; }
+
+			/**
+			 * Get the sampler.
+			 *
+			 * @return The sampler.
+			 */
+			[[nodiscard]] VkSampler getSampler() const { return m_Sampler; }
+
+		protected:
+			/**
+			 * Upload regions to the texture.
+			 *
+			 * @param regions The regions to upload.
+			 * @param data The pixel data of all the regions.
+			 */
+			void upload(std::span<const TextureRegion> regions, std::span<const std::byte> data) override;
+
+		private:
+			/**
+			 * Setup the image and the image view.
+			 */
+			void setupImage();
+
+			/**
+			 * Setup the sampler.
+			 */
+			void setupSampler();
+
+			/**
+			 * Record the commands to generate the mip chain by blitting each level to the next one.
+			 * The first level must be in the transfer destination layout, and all the levels are left in the shader read layout.
+			 */
+			void recordMipmaps() const;
+
+			/**
+			 * Setup the command pool and buffer.
+			 */
+			void setupCommandBuffer();
+
+			/**
+			 * Begin recording the command buffer.
+			 */
+			void beginCommandBuffer() const;
+
+			/**
+			 * End recording the command buffer, submit it and wait till it's executed.
+			 */
+			void submitCommandBuffer() const;
+
+		private:
+			std::unique_ptr<VulkanImageBuffer> m_pStagingBuffer = nullptr;
+
+			VkImage m_Image = VK_NULL_HANDLE;
+			VkImageView m_ImageView = VK_NULL_HANDLE;
+			VkSampler m_Sampler = VK_NULL_HANDLE;
+			VmaAllocation m_Allocation = nullptr;
+
+			VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+			VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+			VkFence m_Fence = VK_NULL_HANDLE;
+
+			uint64_t m_AllocationSize = 0;
+		};
+	}
+}
@@ -3,20 +3,86 @@
 #pragma once
 
 #include "../Window.hpp"
-#include "VulkanInstance.hpp"
+#include "VulkanRenderTarget.hpp"
 
 #include <SDL.h>
 
+#include <chrono>
+#include <vector>
+
 namespace minte
 {
+	class Layer;
+
 	namespace backend
 	{
 		/**
 		 * Vulkan window class.
+		 *
+		 * The swapchain has as many images as the surface recommends, each with its own view and framebuffer. The CPU can record a limited
+		 * number of frames ahead of the GPU, and each of these frames in flight has its own command buffer, acquire semaphore and fence. The
+		 * number of frames in flight bounds the frame latency: beginFrame() blocks only when the oldest of them has not finished yet.
+		 *
+		 * The swapchain is recreated inside beginFrame() when the window was resized, or when acquiring or presenting reports it's out of date
+		 * or suboptimal. The new swapchain is created from the old one, which is retired instead of destroyed. Its images, views and framebuffers
+		 * are destroyed once every frame in flight submitted before it was retired is done, so resizing never waits for the device to go idle.
+		 *
+		 * The present policy picks the present mode, the swapchain image count and the default number of frames in flight. When the device
+		 * supports present wait, every present gets an ID and the low latency policy waits for the previous present to be shown before
+		 * beginning a new frame, so no more than one frame is ever queued for the display.
+		 *
+		 * The window measures the latency from the oldest input event polled before a frame to that frame being shown. With present wait this
+		 * is when the window notices the present completed, which is accurate to about a frame. Without it, the frame's commands finishing is
+		 * used instead, which leaves out the time the image waits in the presentation queue.
+		 *
+		 * Layers drawn with the window's instance can be presented without leaving the GPU. Their color attachment is blitted straight to the
+		 * swapchain image, so the render target does not need to copy its output to the host, see RenderTarget::setHostOutput().
 		 */
 		class VulkanWindow final : public Window
 		{
+			/**
+			 * Frame structure.
+			 * This contains the objects used by a single frame in flight.
+			 */
+			struct Frame final
+			{
+				VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+				VkSemaphore m_ImageAvailableSemaphore = VK_NULL_HANDLE;
+				VkFence m_InFlightFence = VK_NULL_HANDLE;	// This is signaled when the frame's commands finish executing.
+
+				std::chrono::steady_clock::time_point m_InputTime = {};	// The oldest input shown by the frame. Zero once it's measured.
+				uint64_t m_PresentID = 0;
+			};
+
+			/**
+			 * Swapchain image structure.
+			 */
+			struct SwapchainImage final
+			{
+				VkImage m_Image = VK_NULL_HANDLE;
+				VkImageView m_ImageView = VK_NULL_HANDLE;
+				VkFramebuffer m_Framebuffer = VK_NULL_HANDLE;
+
+				// The presentation engine waits on this, so it is per image rather than per frame. A frame's fence does not tell when the
+				// presentation is done with it.
+				VkSemaphore m_RenderFinishedSemaphore = VK_NULL_HANDLE;
+				VkFence m_InFlightFence = VK_NULL_HANDLE;	// The fence of the last frame that rendered to the image.
+			};
+
+			/**
+			 * Retired swapchain structure.
+			 * This is a swapchain which was replaced, waiting for the frames using it to finish.
+			 */
+			struct RetiredSwapchain final
+			{
+				std::vector<SwapchainImage> m_Images;
+				VkSwapchainKHR m_Swapchain = VK_NULL_HANDLE;
+				uint64_t m_FrameCount = 0;	// The number of frames submitted before the swapchain was retired.
+			};
+
 		public:
+			static constexpr uint32_t MaxFramesInFlight = 3;
+
 			/**
 			 * Default constructor.
 			 */
@@ -29,14 +95,149 @@ namespace minte
 			 * @param title The title of the window.
 			 * @param width The window width.
 			 * @param height The window height.
+			 * @param policy The present policy. Default is low latency.
+			 * @param framesInFlight The number of frames the CPU can record ahead of the GPU. This is clamped to [1, MaxFramesInFlight]. Default
+			 * is 0, which uses 1 for low latency and power saving, and 2 for vsync.
 			 */
-			explicit VulkanWindow(const std::shared_ptr<VulkanInstance>& pInstance, std::string&& title, uint32_t width, uint32_t height);
+			explicit VulkanWindow(const std::shared_ptr<VulkanInstance>& pInstance, std::string&& title, uint32_t width, uint32_t height, PresentPolicy policy = PresentPolicy::LowLatency, uint32_t framesInFlight = 0);
 
 			/**
 			 * Destructor.
 			 */
 			~VulkanWindow() override;
 
+			/**
+			 * Poll the window's events.
+			 * The input events are translated, time stamped and pushed to the queue. This should be called by the thread that created the window.
+			 *
+			 * @param queue The input queue to push the events to.
+			 * @return Whether the window is still open.
+			 */
+			bool pollEvents(InputQueue& queue) override;
+
+			/**
+			 * Begin a new frame.
+			 * This waits till the frame in flight using the same objects is done, acquires the next swapchain image and begins the frame's command
+			 * buffer. The render pass is not begun. With the low latency policy and present wait, this also waits till the last frame is shown.
+			 *
+			 * The swapchain is recreated first if it's out of date. Nothing can be drawn while the window is minimized, in which case this waits
+			 * for the next window event for a short while, so that a render loop does not spin, and there is no frame to end.
+			 *
+			 * @return The command buffer to record the frame to. This is VK_NULL_HANDLE if the window is minimized.
+			 */
+			[[nodiscard]] VkCommandBuffer beginFrame();
+
+			/**
+			 * End the current frame.
+			 * This submits the frame's command buffer and queues the image for presentation. It does not wait for the GPU.
+			 */
+			void endFrame();
+
+			/**
+			 * Present a layer to the window.
+			 * The layer's last image is copied to the top left of the window on the GPU. The rest of the window is cleared to black. Nothing is
+			 * presented while the window is minimized.
+			 *
+			 * @param layer The layer to present. Its render target must be created using the window's instance, with x1 anti-aliasing.
+			 */
+			void present(const Layer& layer);
+
+			/**
+			 * Present a render target's last image to the window.
+			 * The image is copied to the top left of the window on the GPU. The rest of the window is cleared to black. Nothing is presented while
+			 * the window is minimized.
+			 *
+			 * This will throw a BackendError if the swapchain format cannot be blitted to.
+			 *
+			 * @param renderTarget The render target to present. It must be created using the window's instance, with x1 anti-aliasing.
+			 */
+			void present(const RenderTarget& renderTarget);
+
+			/**
+			 * Get the number of frames in flight.
+			 *
+			 * @return The frame count.
+			 */
+			[[nodiscard]] uint32_t getFramesInFlight() const { return static_cast<uint32_t>(m_Frames.size()); }
+
+			/**
+			 * Get the number of swapchain images.
+			 *
+			 * @return The image count.
+			 */
+			[[nodiscard]] uint32_t getImageCount() const { return static_cast<uint32_t>(m_SwapchainImages.size()); }
+
+			/**
+			 * Get the render pass which draws to the swapchain images.
+			 * The image is in the present layout after the pass.
+			 *
+			 * @return The render pass.
+			 */
+			[[nodiscard]] VkRenderPass getRenderPass() const { return m_RenderPass; }
+
+			/**
+			 * Get the swapchain image acquired by the current frame.
+			 *
+			 * @return The image.
+			 */
+			[[nodiscard]] VkImage getCurrentImage() const { return m_SwapchainImages[m_ImageIndex].m_Image; }
+
+			/**
+			 * Get the framebuffer of the swapchain image acquired by the current frame.
+			 *
+			 * @return The framebuffer.
+			 */
+			[[nodiscard]] VkFramebuffer getCurrentFramebuffer() const { return m_SwapchainImages[m_ImageIndex].m_Framebuffer; }
+
+			/**
+			 * Get the swapchain image format.
+			 *
+			 * @return The format.
+			 */
+			[[nodiscard]] VkFormat getSwapchainFormat() const { return m_SwapchainFormat; }
+
+			/**
+			 * Get the present policy.
+			 *
+			 * @return The policy.
+			 */
+			[[nodiscard]] PresentPolicy getPresentPolicy() const { return m_PresentPolicy; }
+
+			/**
+			 * Get the present mode chosen for the policy.
+			 *
+			 * @return The present mode.
+			 */
+			[[nodiscard]] VkPresentModeKHR getPresentMode() const { return m_PresentMode; }
+
+			/**
+			 * Check if the latency is measured when the frames are shown, or when their commands finish.
+			 *
+			 * @return Whether present wait is used.
+			 */
+			[[nodiscard]] bool isPresentWaitEnabled() const { return m_IsPresentWaitEnabled; }
+
+			/**
+			 * Get the input to present latency of the last measured frame.
+			 *
+			 * @return The latency.
+			 */
+			[[nodiscard]] std::chrono::nanoseconds getLastLatency() const { return m_LastLatency; }
+
+			/**
+			 * Get the moving average of the input to present latency.
+			 *
+			 * @return The latency.
+			 */
+			[[nodiscard]] std::chrono::nanoseconds getAverageLatency() const { return std::chrono::nanoseconds(static_cast<int64_t>(m_AverageLatency)); }
+
+			/**
+			 * Get the number of frames the latency was measured for.
+			 *
+			 * @return The sample count.
+			 */
+			[[nodiscard]] uint64_t getLatencySampleCount() const { return m_LatencySampleCount; }
+
 		private:
 			/**
 			 * Refresh the window extent.
@@ -45,11 +246,35 @@ namespace minte
 
 			/**
 			 * Setup the swapchain.
+			 * The extent is taken from the surface if it decides it, so the window extent is updated.
+			 *
+			 * @param oldSwapchain The swapchain being replaced. Default is VK_NULL_HANDLE.
+			 */
+			void setupSwapchain(VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
+
+			/**
+			 * Replace the swapchain with one matching the current window extent.
+			 * The old swapchain is retired, and destroyed later by releaseRetiredSwapchains().
+			 *
+			 * @return Whether a swapchain was created. This is false while the window is minimized, after waiting for the next window event.
+			 */
+			[[nodiscard]] bool recreateSwapchain();
+
+			/**
+			 * Destroy the retired swapchains which are no longer used by any frame in flight.
 			 */
-			void setupSwapchain();
+			void releaseRetiredSwapchains();
 
 			/**
-			 * Clear the swapchain data.
+			 * Destroy a swapchain and the objects of its images.
+			 *
+			 * @param swapchain The swapchain.
+			 * @param images The swapchain images.
+			 */
+			void destroySwapchain(VkSwapchainKHR swapchain, const std::vector<SwapchainImage>& images) const;
+
+			/**
+			 * Clear the swapchain data, including the retired swapchains.
 			 */
 			void clearSwapchain();
 
@@ -59,31 +284,55 @@ namespace minte
 			void setupRenderPass();
 
 			/**
-			 * Setup the frame buffer.
+			 * Setup the frame buffers.
 			 */
-			void setupFramebuffer();
+			void setupFramebuffers();
 
 			/**
-			 * Setup the sync objects.
+			 * Setup the command buffers and the sync objects of the frames in flight.
+			 *
+			 * @param framesInFlight The number of frames in flight.
 			 */
-			void setupSyncObjects();
+			void setupFrames(uint32_t framesInFlight);
+
+			/**
+			 * Measure the latency of a frame if it has been shown.
+			 *
+			 * @param frame The frame to measure.
+			 */
+			void measureLatency(Frame& frame);
 
 		private:
 			SDL_Window* m_pWindow = nullptr;
 
-			VkImage m_SwapchainImage = VK_NULL_HANDLE;
-			VkImageView m_SwapchainImageView = VK_NULL_HANDLE;
-
-			VkSemaphore m_InFlightSemaphore = VK_NULL_HANDLE;
-			VkSemaphore m_RenderFinishedSemaphore = VK_NULL_HANDLE;
+			std::vector<SwapchainImage> m_SwapchainImages;
+			std::vector<RetiredSwapchain> m_RetiredSwapchains;
+			std::vector<Frame> m_Frames;
 
 			VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
 			VkSwapchainKHR m_Swapchain = VK_NULL_HANDLE;
 
 			VkRenderPass m_RenderPass = VK_NULL_HANDLE;
-			VkFramebuffer m_Framebuffer = VK_NULL_HANDLE;
+			VkCommandPool m_CommandPool = VK_NULL_HANDLE;
 
 			VkFormat m_SwapchainFormat = VK_FORMAT_UNDEFINED;
+			VkPresentModeKHR m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+
+			std::chrono::steady_clock::time_point m_PendingInputTime = {};	// The oldest input polled since the last present. Zero if there is none.
+			std::chrono::nanoseconds m_LastLatency = {};
+			double m_AverageLatency = 0.0;	// In nanoseconds.
+			uint64_t m_LatencySampleCount = 0;
+			uint64_t m_PresentID = 0;	// The ID of the last present.
+			uint64_t m_RetiredPresentID = 0;	// The ID of the last present to a retired swapchain. Only later IDs can be waited on.
+			uint64_t m_FrameCount = 0;	// The number of frames submitted.
+
+			uint32_t m_FrameIndex = 0;	// The index of the current frame in flight.
+			uint32_t m_ImageIndex = 0;	// The index of the swapchain image acquired by the current frame.
+
+			PresentPolicy m_PresentPolicy = PresentPolicy::LowLatency;
+			bool m_IsPresentWaitEnabled = false;
+			bool m_IsSwapchainOutdated = false;	// Whether the swapchain has to be recreated before the next frame.
+			bool m_CanBlitToSwapchain = false;	// Whether the swapchain format can be a blit destination, which presenting a render target needs.
 		};
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "InstanceBoundObject.hpp"
+#include "../InputQueue.hpp"
 
 #include <string>
 
@@ -10,6 +11,17 @@ namespace minte
 {
 	namespace backend
 	{
+		/**
+		 * Present policy enum.
+		 * This decides how a window trades latency for smoothness and power.
+		 */
+		enum class PresentPolicy : uint8_t
+		{
+			LowLatency,		// Show frames as soon as possible, tearing only if there is no other way to avoid waiting. One frame is queued at a time.
+			VSync,			// Show every frame, locked to the display's refresh rate.
+			PowerSaving		// Like vsync, but with as few images and frames queued as possible so the GPU can idle.
+		};
+
 		/**
 		 * Window class.
 		 * This can be used to render content to the screen.
@@ -38,6 +50,15 @@ namespace minte
 			 */
 			virtual ~Window() = default;
 
+			/**
+			 * Poll the window's events.
+			 * The input events are translated and pushed to the queue. This should be called by the thread that created the window.
+			 *
+			 * @param queue The input queue to push the events to.
+			 * @return Whether the window is still open.
+			 */
+			virtual bool pollEvents(InputQueue& queue) = 0;
+
 			/**
 			 * Get the title of the window.
 			 *
@@ -0,0 +1,79 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Drawable.hpp"
+
+namespace minte
+{
+	/**
+	 * Box class.
+	 * This draws a solid colored rectangle.
+	 */
+	class Box : public Drawable
+	{
+	public:
+		/**
+		 * Default constructor.
+		 */
+		Box() = default;
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param size The size of the box in pixels.
+		 * @param color The color of the box (R8G8B8A8).
+		 */
+		explicit Box(Point2D<float> size, uint32_t color);
+
+		/**
+		 * Set the size of the box.
+		 * The size is replaced by the layout if the box is sized by its parent.
+		 *
+		 * @param size The size in pixels.
+		 */
+		void setSize(Point2D<float> size);
+
+		/**
+		 * Get the size of the box.
+		 *
+		 * @return The size.
+		 */
+		[[nodiscard]] Point2D<float> getSize() const { return m_Size; }
+
+		/**
+		 * Set the color of the box.
+		 *
+		 * @param color The color (R8G8B8A8).
+		 */
+		void setColor(uint32_t color);
+
+		/**
+		 * Get the color of the box.
+		 *
+		 * @return The color.
+		 */
+		[[nodiscard]] uint32_t getColor() const { return m_Color; }
+
+	protected:
+		/**
+		 * Generate the geometry of the box.
+		 *
+		 * @param vertices The vertices to write to.
+		 * @param indices The indices to write to.
+		 * @param batches The batches to write to.
+		 */
+		void generateGeometry(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<DrawBatch>& batches) const override;
+
+		/**
+		 * Resize the box to the size given by the layout.
+		 *
+		 * @param size The new size.
+		 */
+		void applyLayoutSize(Point2D_F32 size) override { setSize(size); }
+
+	private:
+		Point2D<float> m_Size;
+		uint32_t m_Color = 0;
+	};
+}
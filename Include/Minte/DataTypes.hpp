@@ -103,9 +103,11 @@ namespace minte
 
 	using Point2D_UI32 = Point2D<uint32_t>;
 	using Point3D_UI32 = Point3D<uint32_t>;
+	using Point2D_F32 = Point2D<float>;
 
 	using Rectangle2D = Rectangle<Point2D_UI32>;
 	using Rectangle3D = Rectangle<Point3D_UI32>;
+	using Rectangle2D_F32 = Rectangle<Point2D_F32>;
 
 	/**
 	 * Vertex structure.
@@ -116,6 +118,7 @@ namespace minte
 		Point2D<float> m_Position;			// X32Y32
 		Point2D<float> m_TextureCoordinate;	// U32V32
 		uint32_t m_Color;					// R8G8B8A8
+		uint32_t m_EntityID = 0;			// The value written to the entity buffer. The first vertex of a triangle decides its entity.
 	};
 
 	using Index = uint32_t;	// Index type used by the index buffer.
@@ -0,0 +1,397 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "DataTypes.hpp"
+#include "MappedFile.hpp"
+
+#include "Backend/RenderTarget.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace minte
+{
+	/**
+	 * Draw stream chunk type enum.
+	 *
+	 * A draw stream is a binary capture of everything the frontend submits to the backend. The file starts with a DrawStreamHeader which is
+	 * followed by a list of chunks. Each chunk starts with a DrawStreamChunkHeader, followed by a fixed size chunk structure and any trailing
+	 * data. All the values are stored in the host's (little endian) byte order.
+	 */
+	enum class DrawStreamChunkType : uint32_t
+	{
+		LayerCreate,	// DrawStreamLayerCreate.
+		FrameBegin,		// DrawStreamFrameBegin.
+		LayerUpdate,	// DrawStreamLayerUpdate.
+		Geometry,		// DrawStreamGeometry, followed by the vertices and then the indices.
+		TextureUpload,	// DrawStreamTextureUpload, followed by the pixel data.
+		DrawCommands,	// DrawStreamDrawCommands, followed by the draw commands.
+		TextureCreate,	// DrawStreamTextureCreate.
+		TextureBind		// DrawStreamTextureBind.
+	};
+
+	/**
+	 * Draw stream file header structure.
+	 */
+	struct DrawStreamHeader final
+	{
+		static constexpr uint32_t Magic = 0x43544E4D;	// "MNTC"
+		static constexpr uint32_t CurrentVersion = 5;	// Version 2 added the texture slot and sample mode to the draw commands, version 3 the scissor, version 4 the texture creates and binds, and version 5 moved the entity ID from the draw commands to the vertices.
+
+		uint32_t m_Magic = Magic;
+		uint32_t m_Version = CurrentVersion;
+	};
+
+	/**
+	 * Draw stream chunk header structure.
+	 */
+	struct DrawStreamChunkHeader final
+	{
+		DrawStreamChunkType m_Type = DrawStreamChunkType::LayerCreate;
+		uint32_t m_Size = 0;	// The size of the chunk, excluding this header.
+	};
+
+	/**
+	 * Layer create chunk.
+	 * This registers a new layer with the stream.
+	 */
+	struct DrawStreamLayerCreate final
+	{
+		uint32_t m_LayerID = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+
+		backend::AntiAliasing m_AntiAliasing = backend::AntiAliasing::X1;
+		backend::OutputFormat m_OutputFormat = backend::OutputFormat::RGBA;
+		uint8_t m_Padding[2] = {};
+	};
+
+	/**
+	 * Frame begin chunk.
+	 * Everything till the next frame begin chunk belongs to this frame.
+	 */
+	struct DrawStreamFrameBegin final
+	{
+		uint64_t m_Timestamp = 0;	// Nanoseconds since the capture was started.
+	};
+
+	/**
+	 * Layer update chunk.
+	 * This is recorded every time a layer is drawn.
+	 */
+	struct DrawStreamLayerUpdate final
+	{
+		uint32_t m_LayerID = 0;
+	};
+
+	/**
+	 * Geometry chunk.
+	 * This updates a range of the layer's vertex and index buffers.
+	 */
+	struct DrawStreamGeometry final
+	{
+		uint64_t m_VertexOffset = 0;	// The offset in vertices.
+		uint64_t m_IndexOffset = 0;		// The offset in indices.
+
+		uint32_t m_LayerID = 0;
+		uint32_t m_VertexCount = 0;
+		uint32_t m_IndexCount = 0;
+		uint32_t m_Padding = 0;
+	};
+
+	/**
+	 * Texture create chunk.
+	 * This registers a new texture with the stream. It's recorded before the first upload or bind of the texture.
+	 */
+	struct DrawStreamTextureCreate final
+	{
+		uint32_t m_TextureID = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+
+		backend::TextureFormat m_Format = backend::TextureFormat::RGBA8;
+		uint8_t m_Mipmaps = 0;	// Whether the texture has a full mip chain.
+		uint8_t m_Padding[2] = {};
+	};
+
+	/**
+	 * Texture upload chunk.
+	 * This updates a region of a texture. The rows of the pixel data are tightly packed.
+	 */
+	struct DrawStreamTextureUpload final
+	{
+		uint32_t m_TextureID = 0;
+		uint32_t m_X = 0;
+		uint32_t m_Y = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_Size = 0;	// The size of the pixel data in bytes.
+	};
+
+	/**
+	 * Texture bind chunk.
+	 * This binds a texture to one of the layer's texture slots.
+	 */
+	struct DrawStreamTextureBind final
+	{
+		static constexpr uint32_t NoTexture = ~0u;
+
+		uint32_t m_LayerID = 0;
+		uint32_t m_Slot = 0;
+		uint32_t m_TextureID = NoTexture;	// The bound texture, or NoTexture if the slot is cleared.
+	};
+
+	/**
+	 * Draw commands chunk.
+	 * This replaces the layer's draw commands.
+	 */
+	struct DrawStreamDrawCommands final
+	{
+		uint32_t m_LayerID = 0;
+		uint32_t m_Count = 0;
+	};
+
+	static_assert(sizeof(DrawStreamLayerCreate) == 16 && sizeof(DrawStreamGeometry) == 32 && sizeof(DrawStreamTextureCreate) == 16 && sizeof(DrawStreamTextureUpload) == 24 && sizeof(Vertex) == 24 && sizeof(backend::DrawCommand) == 24, "The draw stream chunks must not contain implicit padding!");
+
+	/**
+	 * Draw stream writer class.
+	 * This writes the draw stream to a file through a large in-memory buffer, so recording a frame costs a few copies and an occasional write.
+	 *
+	 * The writer is thread safe, and a single writer can be shared among multiple layers. A new frame begins when a layer starts its update for the
+	 * second time, so the layers sharing a writer are grouped into the frames they're updated in.
+	 *
+	 * Textures are captured through the instance's texture update callback, so only the uploads made after the writer was attached to a layer of
+	 * the instance are in the stream. The writer must be owned by a std::shared_ptr to capture textures.
+	 */
+	class DrawStreamWriter final : public std::enable_shared_from_this<DrawStreamWriter>
+	{
+	public:
+		/**
+		 * Explicit constructor.
+		 * This will throw a FrontendError if the file could not be opened.
+		 *
+		 * @param path The capture file path.
+		 * @param bufferSize The size of the write buffer. Default is 4 MiB.
+		 */
+		explicit DrawStreamWriter(const std::filesystem::path& path, uint64_t bufferSize = 4 * 1024 * 1024);
+
+		/**
+		 * Destructor.
+		 * This will write the remaining data and close the file.
+		 */
+		~DrawStreamWriter();
+
+		DrawStreamWriter(const DrawStreamWriter&) = delete;
+		DrawStreamWriter& operator=(const DrawStreamWriter&) = delete;
+
+		/**
+		 * Register a new layer.
+		 *
+		 * @param width The width of the layer.
+		 * @param height The height of the layer.
+		 * @param antiAliasing The anti-aliasing used by the layer.
+		 * @param format The output format of the layer.
+		 * @return The layer ID.
+		 */
+		uint32_t registerLayer(uint32_t width, uint32_t height, backend::AntiAliasing antiAliasing, backend::OutputFormat format);
+
+		/**
+		 * Capture the texture uploads of an instance.
+		 * This replaces the instance's texture update callback. The callback does nothing once the writer is destroyed.
+		 *
+		 * @param instance The instance.
+		 */
+		void captureTextures(backend::Instance& instance);
+
+		/**
+		 * Begin a new frame.
+		 */
+		void beginFrame();
+
+		/**
+		 * Begin recording the update of a layer.
+		 * This begins a new frame if the layer was already updated in the current frame.
+		 *
+		 * @param layerID The layer ID.
+		 */
+		void beginLayerUpdate(uint32_t layerID);
+
+		/**
+		 * Record a layer update.
+		 * This is recorded every time a layer is drawn.
+		 *
+		 * @param layerID The layer ID.
+		 */
+		void recordLayerUpdate(uint32_t layerID);
+
+		/**
+		 * Record a geometry update.
+		 *
+		 * @param layerID The layer ID.
+		 * @param vertexOffset The offset of the first vertex in the vertex buffer.
+		 * @param vertices The vertices to write.
+		 * @param indexOffset The offset of the first index in the index buffer.
+		 * @param indices The indices to write.
+		 */
+		void recordGeometry(uint32_t layerID, uint64_t vertexOffset, std::span<const Vertex> vertices, uint64_t indexOffset, std::span<const Index> indices);
+
+		/**
+		 * Record a texture upload.
+		 * Each region is recorded as a separate chunk.
+		 *
+		 * @param texture The updated texture.
+		 * @param regions The updated regions.
+		 * @param data The pixel data of all the regions.
+		 */
+		void recordTextureUpload(const backend::Texture& texture, std::span<const backend::TextureRegion> regions, std::span<const std::byte> data);
+
+		/**
+		 * Record a texture bind.
+		 *
+		 * @param layerID The layer ID.
+		 * @param slot The texture slot.
+		 * @param pTexture The bound texture. This is nullptr if the slot is cleared.
+		 */
+		void recordTextureBind(uint32_t layerID, uint32_t slot, const backend::Texture* pTexture);
+
+		/**
+		 * Record the draw commands of a layer.
+		 *
+		 * @param layerID The layer ID.
+		 * @param commands The draw commands.
+		 */
+		void recordDrawCommands(uint32_t layerID, std::span<const backend::DrawCommand> commands);
+
+		/**
+		 * Write the buffered data to the file.
+		 */
+		void flush();
+
+	private:
+		/**
+		 * Write a chunk header.
+		 *
+		 * @param type The chunk type.
+		 * @param size The size of the chunk.
+		 */
+		void writeHeader(DrawStreamChunkType type, uint64_t size);
+
+		/**
+		 * Write a frame begin chunk.
+		 * The mutex must be locked when calling this.
+		 */
+		void writeFrameBegin();
+
+		/**
+		 * Get the stream ID of a texture, and register the texture if it's not registered yet.
+		 * The mutex must be locked when calling this.
+		 *
+		 * @param texture The texture.
+		 * @return The texture ID.
+		 */
+		uint32_t registerTexture(const backend::Texture& texture);
+
+		/**
+		 * Write data to the buffer.
+		 * Data larger than the buffer is written to the file directly.
+		 *
+		 * @param pData The data pointer.
+		 * @param size The size of the data.
+		 */
+		void write(const void* pData, uint64_t size);
+
+		/**
+		 * Write the buffered data to the file.
+		 * The mutex must be locked when calling this.
+		 */
+		void flushBuffer();
+
+	private:
+		std::mutex m_Mutex;
+
+		std::vector<std::byte> m_Buffer;
+		uint64_t m_BufferUsage = 0;
+
+		std::chrono::steady_clock::time_point m_StartTime;
+		std::FILE* m_pFile = nullptr;
+
+		std::unordered_map<uint64_t, uint32_t> m_TextureIDs;	// The stream IDs of the textures, keyed by their unique IDs.
+		std::vector<bool> m_FrameLayers;	// Whether each layer was updated in the current frame.
+
+		uint32_t m_LayerCount = 0;
+		uint32_t m_TextureCount = 0;
+		bool m_IsFrameOpen = false;
+	};
+
+	/**
+	 * Draw stream chunk structure.
+	 * This is a view of a single chunk in a mapped draw stream.
+	 */
+	struct DrawStreamChunk final
+	{
+		DrawStreamChunkType m_Type = DrawStreamChunkType::LayerCreate;
+		std::span<const std::byte> m_Payload;
+
+		/**
+		 * Read the fixed size chunk structure.
+		 * The payload is not guaranteed to be aligned, so the structure is copied out.
+		 *
+		 * @tparam Type The chunk structure type.
+		 * @return The chunk structure.
+		 */
+		template<class Type>
+		[[nodiscard]] Type read() const
+		{
+			Type value = {};
+			std::memcpy(&value, m_Payload.data(), std::min(sizeof(Type), m_Payload.size()));
+			return value;
+		}
+
+		/**
+		 * Get the data trailing the fixed size chunk structure.
+		 *
+		 * @tparam Type The chunk structure type.
+		 * @return The trailing data.
+		 */
+		template<class Type>
+		[[nodiscard]] std::span<const std::byte> getTrailingData() const { return m_Payload.size() > sizeof(Type) ? m_Payload.subspan(sizeof(Type)) : std::span<const std::byte>(); }
+	};
+
+	/**
+	 * Draw stream reader class.
+	 * This maps the capture file and iterates over its chunks without copying them.
+	 */
+	class DrawStreamReader final
+	{
+	public:
+		/**
+		 * Explicit constructor.
+		 * This will throw a FrontendError if the file is not a valid draw stream.
+		 *
+		 * @param path The capture file path.
+		 */
+		explicit DrawStreamReader(const std::filesystem::path& path);
+
+		/**
+		 * Read the next chunk.
+		 *
+		 * @param chunk The chunk to read to.
+		 * @return Whether a chunk was read. This is false at the end of the stream, or if the stream is truncated.
+		 */
+		bool next(DrawStreamChunk& chunk);
+
+		/**
+		 * Move back to the first chunk.
+		 */
+		void rewind() { m_Offset = sizeof(DrawStreamHeader); }
+
+	private:
+		MappedFile m_File;
+		uint64_t m_Offset = sizeof(DrawStreamHeader);
+	};
+}
@@ -2,16 +2,66 @@
 
 #pragma once
 
-#include "MinteObject.hpp"
+#include "ElementStorage.hpp"
+#include "InputEvent.hpp"
+#include "Layout.hpp"
+
+#include "Backend/RenderTarget.hpp"
+
+#include <vector>
+#include <memory>
 
 namespace minte
 {
+	class Layer;
+
+	/**
+	 * Draw batch structure.
+	 * This is a range of a drawable's indices which is drawn using the same texture. Batches are drawn in order, starting from the first index.
+	 */
+	struct DrawBatch final
+	{
+		uint32_t m_IndexCount = 0;
+		uint8_t m_TextureSlot = 0;	// The render target's texture slot.
+		backend::SampleMode m_SampleMode = backend::SampleMode::Color;
+
+		/**
+		 * Compare two batches.
+		 *
+		 * @param other The other batch.
+		 * @return Whether the batches are equal.
+		 */
+		[[nodiscard]] bool operator==(const DrawBatch& other) const = default;
+	};
+
 	/**
 	 * Drawable class.
 	 * This contains information to draw something to a layer.
+	 *
+	 * Drawables form a retained tree. Each drawable generates its geometry in its local space, which is cached and kept in the layer's
+	 * geometry buffers till it changes. Changing a drawable marks it dirty, and the dirty state is propagated up to the root drawable, so the
+	 * layer only visits the branches that changed.
+	 *
+	 * A drawable gets an element handle when it's attached to a layer, and loses it when it's detached. The handle is also the entity ID of the
+	 * drawable in the layer's entity buffer.
 	 */
-	class Drawable : public MinteObject
+	class Drawable
 	{
+		friend Layer;
+		friend LayoutEngine;
+
+		/**
+		 * Dirty flags.
+		 */
+		enum DirtyFlags : uint8_t
+		{
+			None = 0,
+			Content = 1 << 0,		// The geometry needs to be regenerated.
+			Transform = 1 << 1,		// The geometry needs to be uploaded again, at a different position.
+			Structure = 1 << 2,		// The children have changed.
+			Descendant = 1 << 3		// One or more descendants are dirty.
+		};
+
 	public:
 		/**
 		 * Default constructor.
@@ -19,15 +69,269 @@ namespace minte
 		Drawable() = default;
 
 		/**
-		 * Explicit constructor.
+		 * Default virtual destructor.
+		 */
+		virtual ~Drawable() = default;
+
+		Drawable(const Drawable&) = delete;
+		Drawable& operator=(const Drawable&) = delete;
+
+		/**
+		 * Create a new child drawable.
+		 * The child is allocated from the layer's pools if this drawable is attached to a layer.
 		 *
-		 * @param parent The parent to which the object belongs to.
+		 * @tparam Element The drawable type.
+		 * @tparam Arguments The constructor arguments.
+		 * @param arguments The arguments required by the Element's constructor.
+		 * @return The created drawable.
 		 */
-		explicit Drawable(Minte parent) : MinteObject(parent) {}
+		template<class Element, class... Arguments>
+		std::shared_ptr<Element> createChild(Arguments&&... arguments)
+		{
+			auto pChild = m_pStorage ? m_pStorage->allocate<Element>(std::forward<Arguments>(arguments)...) : std::make_shared<Element>(std::forward<Arguments>(arguments)...);
+			addChild(pChild);
+			return pChild;
+		}
 
 		/**
-		 * Default virtual destructor.
+		 * Add a child drawable.
+		 * This will throw a FrontendError if the drawable already has a parent.
+		 *
+		 * @param pChild The child to add.
 		 */
-		virtual ~Drawable() = default;
+		void addChild(std::shared_ptr<Drawable> pChild);
+
+		/**
+		 * Remove a child drawable.
+		 *
+		 * @param pChild The child to remove.
+		 */
+		void removeChild(const Drawable* pChild);
+
+		/**
+		 * Get the children of this drawable.
+		 *
+		 * @return The children.
+		 */
+		[[nodiscard]] const std::vector<std::shared_ptr<Drawable>>& getChildren() const { return m_Children; }
+
+		/**
+		 * Get the parent drawable.
+		 *
+		 * @return The parent drawable pointer. This is nullptr if the drawable is not attached to another drawable.
+		 */
+		[[nodiscard]] Drawable* getParentDrawable() const { return m_pParentDrawable; }
+
+		/**
+		 * Set the position of the drawable relative to its parent.
+		 *
+		 * @param position The position in pixels.
+		 */
+		void setPosition(Point2D<float> position);
+
+		/**
+		 * Get the position of the drawable relative to its parent.
+		 *
+		 * @return The position.
+		 */
+		[[nodiscard]] Point2D<float> getPosition() const { return m_Position; }
+
+		/**
+		 * Set whether the drawable and its children are drawn.
+		 *
+		 * @param bVisible Whether the drawable is visible.
+		 */
+		void setVisible(bool bVisible);
+
+		/**
+		 * Check if the drawable is visible.
+		 *
+		 * @return Whether the drawable is visible.
+		 */
+		[[nodiscard]] bool isVisible() const { return m_IsVisible; }
+
+		/**
+		 * Set the clip rectangle of the drawable.
+		 * The children and their descendants are only drawn inside it, and are not hit outside it. This does not clip the drawable itself.
+		 * Clip rectangles of nested drawables are intersected, and the elements that are clipped away entirely are not uploaded.
+		 *
+		 * @param rectangle The rectangle in the drawable's local space.
+		 */
+		void setClipRectangle(const Rectangle2D_F32& rectangle);
+
+		/**
+		 * Remove the clip rectangle of the drawable.
+		 */
+		void clearClipRectangle();
+
+		/**
+		 * Get the clip rectangle of the drawable.
+		 *
+		 * @return The rectangle pointer. This is nullptr if the drawable does not clip its children.
+		 */
+		[[nodiscard]] const Rectangle2D_F32* getClipRectangle() const { return m_IsClipping ? &m_ClipRectangle : nullptr; }
+
+		/**
+		 * Set the layout style of the drawable.
+		 * Drawables with a layout style are sized and placed by their parent, if the parent has a layout style as well. The position of a drawable
+		 * whose parent does not have a layout style is not changed.
+		 *
+		 * @param style The layout style.
+		 */
+		void setLayoutStyle(const LayoutStyle& style);
+
+		/**
+		 * Get the layout style of the drawable.
+		 *
+		 * @return The style pointer. This is nullptr if the drawable does not take part in the layout.
+		 */
+		[[nodiscard]] const LayoutStyle* getLayoutStyle() const { return m_pLayoutNode ? &m_pLayoutNode->m_Style : nullptr; }
+
+		/**
+		 * Get the size given to the drawable by the layout.
+		 *
+		 * @return The size.
+		 */
+		[[nodiscard]] Point2D_F32 getLayoutSize() const { return m_pLayoutNode ? m_pLayoutNode->m_Size : Point2D_F32(); }
+
+		/**
+		 * Get the element handle of the drawable.
+		 *
+		 * @return The handle. This is invalid if the drawable is not attached to a layer.
+		 */
+		[[nodiscard]] ElementHandle getHandle() const { return m_Handle; }
+
+		/**
+		 * Check if the drawable or any of its descendants need to be updated.
+		 *
+		 * @return Whether the drawable is dirty or not.
+		 */
+		[[nodiscard]] bool isDirty() const { return m_DirtyFlags != DirtyFlags::None; }
+
+	protected:
+		/**
+		 * Generate the geometry of the drawable.
+		 * This is only called when the drawable is marked dirty. The vertices are in the drawable's local space, and the indices are relative to the
+		 * first vertex.
+		 *
+		 * @param vertices The vertices to write to. This is empty when called.
+		 * @param indices The indices to write to. This is empty when called.
+		 * @param batches The batches to write to. This is empty when called. If left empty, all the indices are drawn using the vertex colors.
+		 */
+		virtual void generateGeometry(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<DrawBatch>& batches) const {}
+
+		/**
+		 * Handle an input event.
+		 * Pointer events are sent to the top most drawable under the pointer, and key events to the drawable that was last pressed. Events that
+		 * are not handled are sent to the parent.
+		 *
+		 * @param event The input event.
+		 * @return Whether the event was handled.
+		 */
+		virtual bool onInputEvent(const InputEvent& event) { return false; }
+
+		/**
+		 * Measure the content of the drawable.
+		 * This is only used by the layout if the drawable does not have any children with a layout style.
+		 *
+		 * @return The size required by the content, excluding the padding.
+		 */
+		[[nodiscard]] virtual Point2D_F32 measureContent() const { return Point2D_F32(); }
+
+		/**
+		 * Apply the size given by the layout.
+		 *
+		 * @param size The new size.
+		 */
+		virtual void applyLayoutSize(Point2D_F32 size) {}
+
+		/**
+		 * Check if the drawable's geometry uses the layer's glyph atlas.
+		 * These drawables are regenerated every time the atlas changes, so that they can use the glyphs that were added, and so that the glyphs
+		 * they use are not evicted.
+		 *
+		 * @return Whether the glyph atlas is used.
+		 */
+		[[nodiscard]] virtual bool usesGlyphAtlas() const { return false; }
+
+		/**
+		 * Get the glyph atlas of the layer the drawable is attached to.
+		 *
+		 * @return The glyph atlas pointer. This is nullptr if the drawable is not attached, or if the layer does not have an atlas.
+		 */
+		[[nodiscard]] GlyphAtlas* getGlyphAtlas() const { return m_pStorage ? m_pStorage->getGlyphAtlas() : nullptr; }
+
+		/**
+		 * Get the text layout cache of the layer the drawable is attached to.
+		 *
+		 * @return The text layout cache pointer. This is nullptr if the drawable is not attached.
+		 */
+		[[nodiscard]] TextLayoutCache* getTextLayoutCache() const { return m_pStorage ? m_pStorage->getTextLayoutCache() : nullptr; }
+
+		/**
+		 * Mark the drawable's layout dirty.
+		 * This should be called by the derived class when anything that affects its measured content size changes.
+		 */
+		void invalidateLayout();
+
+		/**
+		 * Mark the drawable's content dirty.
+		 * This should be called by the derived class when anything that affects its geometry changes.
+		 */
+		void markDirty() { setDirty(DirtyFlags::Content); }
+
+	private:
+		/**
+		 * Set dirty flags and propagate them to the ancestors.
+		 *
+		 * @param flags The flags to set.
+		 */
+		void setDirty(uint8_t flags);
+
+		/**
+		 * Mark this drawable and all of its descendants to be uploaded again.
+		 */
+		void setTransformDirty();
+
+		/**
+		 * Check if the drawable is the root of a layout tree.
+		 *
+		 * @return Whether the drawable has a layout style, and its parent does not.
+		 */
+		[[nodiscard]] bool isLayoutRoot() const { return m_pLayoutNode && !(m_pParentDrawable && m_pParentDrawable->m_pLayoutNode); }
+
+		/**
+		 * Attach this drawable and its descendants to a layer's element storage.
+		 *
+		 * @param pStorage The element storage.
+		 */
+		void attach(ElementStorage* pStorage);
+
+		/**
+		 * Detach this drawable and its descendants from the element storage.
+		 * This releases the element handles and the geometry ranges.
+		 */
+		void detach();
+
+	private:
+		std::vector<std::shared_ptr<Drawable>> m_Children;
+		Drawable* m_pParentDrawable = nullptr;
+		ElementStorage* m_pStorage = nullptr;
+		std::unique_ptr<LayoutNode> m_pLayoutNode = nullptr;
+
+		Point2D<float> m_Position;
+		Rectangle2D_F32 m_ClipRectangle;
+
+		// The geometry cache, in the drawable's local space.
+		std::vector<Vertex> m_Vertices;
+		std::vector<Index> m_Indices;
+		std::vector<DrawBatch> m_Batches;
+
+		ElementHandle m_Handle;
+
+		uint8_t m_DirtyFlags = DirtyFlags::Content;
+		bool m_IsLayerRoot = false;
+		bool m_IsVisible = true;
+		bool m_IsClipping = false;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include <cstdint>
+
+namespace minte
+{
+	/**
+	 * Element handle class.
+	 * This is a compact generational handle to an element in a layer, and is also the entity ID written to the entity buffer.
+	 *
+	 * The lower bits contain the slot index and the upper bits contain the generation of the slot. The generation is incremented every time
+	 * the slot is released, so a stale handle can be detected with a single comparison. A value of 0 is never a valid handle.
+	 */
+	class ElementHandle final
+	{
+	public:
+		static constexpr uint32_t IndexBits = 20;
+		static constexpr uint32_t GenerationBits = 32 - IndexBits;
+
+		static constexpr uint32_t MaxIndex = (1u << IndexBits) - 1;
+		static constexpr uint32_t MaxGeneration = (1u << GenerationBits) - 1;
+
+		/**
+		 * Default constructor.
+		 */
+		constexpr ElementHandle() = default;
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param value The raw handle value, as read from the entity buffer.
+		 */
+		explicit constexpr ElementHandle(uint32_t value) : m_Value(value) {}
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param index The slot index.
+		 * @param generation The slot generation.
+		 */
+		explicit constexpr ElementHandle(uint32_t index, uint32_t generation) : m_Value((generation << IndexBits) | (index & MaxIndex)) {}
+
+		/**
+		 * Get the slot index.
+		 *
+		 * @return The index.
+		 */
+		[[nodiscard]] constexpr uint32_t getIndex() const { return m_Value & MaxIndex; }
+
+		/**
+		 * Get the slot generation.
+		 *
+		 * @return The generation.
+		 */
+		[[nodiscard]] constexpr uint32_t getGeneration() const { return m_Value >> IndexBits; }
+
+		/**
+		 * Get the raw handle value.
+		 *
+		 * @return The value.
+		 */
+		[[nodiscard]] constexpr uint32_t getValue() const { return m_Value; }
+
+		/**
+		 * Check if the handle refers to an element.
+		 * This does not check if the element is still alive.
+		 *
+		 * @return Whether the handle is set or not.
+		 */
+		[[nodiscard]] constexpr bool isValid() const { return m_Value != 0; }
+
+		/**
+		 * Equality operator.
+		 *
+		 * @param other The other handle.
+		 * @return Whether the handles are equal.
+		 */
+		[[nodiscard]] constexpr bool operator==(const ElementHandle& other) const = default;
+
+	private:
+		uint32_t m_Value = 0;
+	};
+}
@@ -0,0 +1,386 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "ElementHandle.hpp"
+#include "DataTypes.hpp"
+#include "RangeAllocator.hpp"
+#include "SpatialIndex.hpp"
+
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <typeindex>
+#include <unordered_map>
+
+namespace minte
+{
+	class Drawable;
+	class GlyphAtlas;
+	class TextLayoutCache;
+
+	/**
+	 * Pool allocator class.
+	 * This allocates from a shared pool resource. The resource is kept alive by the allocator, so objects can outlive the storage that created them.
+	 *
+	 * @tparam Type The value type.
+	 */
+	template<class Type>
+	class PoolAllocator final
+	{
+	public:
+		using value_type = Type;
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param pResource The pool resource.
+		 */
+		explicit PoolAllocator(std::shared_ptr<std::pmr::memory_resource> pResource) : m_pResource(std::move(pResource)) {}
+
+		/**
+		 * Rebind constructor.
+		 *
+		 * @param other The other allocator.
+		 */
+		template<class Other>
+		PoolAllocator(const PoolAllocator<Other>& other) : m_pResource(other.getResource()) {}
+
+		/**
+		 * Allocate memory.
+		 *
+		 * @param count The number of objects.
+		 * @return The allocated memory.
+		 */
+		[[nodiscard]] Type* allocate(std::size_t count) { return static_cast<Type*>(m_pResource->allocate(count * sizeof(Type), alignof(Type))); }
+
+		/**
+		 * Deallocate memory.
+		 *
+		 * @param pPointer The memory to deallocate.
+		 * @param count The number of objects.
+		 */
+		void deallocate(Type* pPointer, std::size_t count) { m_pResource->deallocate(pPointer, count * sizeof(Type), alignof(Type)); }
+
+		/**
+		 * Get the pool resource.
+		 *
+		 * @return The resource.
+		 */
+		[[nodiscard]] const std::shared_ptr<std::pmr::memory_resource>& getResource() const { return m_pResource; }
+
+		/**
+		 * Equality operator.
+		 *
+		 * @param other The other allocator.
+		 * @return Whether both allocators use the same resource.
+		 */
+		template<class Other>
+		[[nodiscard]] bool operator==(const PoolAllocator<Other>& other) const { return m_pResource == other.getResource(); }
+
+	private:
+		std::shared_ptr<std::pmr::memory_resource> m_pResource = nullptr;
+	};
+
+	/**
+	 * Element storage class.
+	 * This owns the per-element data of a layer as a structure of arrays, indexed by the element handle's slot index.
+	 *
+	 * The drawables themselves are allocated from per-type pools, so elements of the same type are packed together. The data used every frame
+	 * (positions, bounds, geometry ranges and flags) lives in the arrays, so passes over all the elements iterate linearly. The storage is not
+	 * thread safe and is expected to be used by the thread that updates the layer.
+	 */
+	class ElementStorage final
+	{
+	public:
+		/**
+		 * Geometry range structure.
+		 * This is a range of the layer's vertex or index buffer.
+		 */
+		struct GeometryRange final
+		{
+			uint64_t m_Offset = 0;
+			uint64_t m_Capacity = 0;
+		};
+
+		/**
+		 * Element flags.
+		 */
+		enum ElementFlags : uint8_t
+		{
+			None = 0,
+			Visible = 1 << 0,
+			UsesGlyphAtlas = 1 << 1,	// The geometry needs to be regenerated when the glyph atlas changes.
+			Opaque = 1 << 2	// All the vertices have full alpha.
+		};
+
+		/**
+		 * Allocate a new drawable from the pool of its type.
+		 *
+		 * @tparam Element The drawable type.
+		 * @tparam Arguments The constructor arguments.
+		 * @param arguments The arguments required by the Element's constructor.
+		 * @return The created drawable.
+		 */
+		template<class Element, class... Arguments>
+		[[nodiscard]] std::shared_ptr<Element> allocate(Arguments&&... arguments)
+		{
+			auto& pResource = m_Pools[typeid(Element)];
+			if (pResource == nullptr)
+				pResource = std::make_shared<std::pmr::unsynchronized_pool_resource>();
+
+			return std::allocate_shared<Element>(PoolAllocator<Element>(pResource), std::forward<Arguments>(arguments)...);
+		}
+
+		/**
+		 * Create a new element.
+		 * This will throw a FrontendError if the storage is full.
+		 *
+		 * @param pDrawable The drawable of the element.
+		 * @return The element handle.
+		 */
+		[[nodiscard]] ElementHandle create(Drawable* pDrawable);
+
+		/**
+		 * Destroy an element.
+		 * This releases its geometry ranges and invalidates all the handles to it.
+		 *
+		 * @param handle The element handle.
+		 */
+		void destroy(ElementHandle handle);
+
+		/**
+		 * Check if a handle refers to a live element.
+		 *
+		 * @param handle The element handle.
+		 * @return Whether the element is alive or not.
+		 */
+		[[nodiscard]] bool isAlive(ElementHandle handle) const
+		{
+			const auto index = handle.getIndex();
+			return handle.isValid() && index < m_Generations.size() && m_Generations[index] == handle.getGeneration() && m_Drawables[index] != nullptr;
+		}
+
+		/**
+		 * Get the drawable of an element.
+		 *
+		 * @param handle The element handle.
+		 * @return The drawable pointer. This is nullptr if the handle is stale.
+		 */
+		[[nodiscard]] Drawable* getDrawable(ElementHandle handle) const { return isAlive(handle) ? m_Drawables[handle.getIndex()] : nullptr; }
+
+		/**
+		 * Reserve a vertex range for an element.
+		 * The range is moved with some headroom if it's too small, so that content that grows a little does not move every update.
+		 *
+		 * @param index The slot index.
+		 * @param count The required number of vertices.
+		 * @return Whether the range was moved.
+		 */
+		bool reserveVertices(uint32_t index, uint64_t count) { return reserveRange(m_VertexAllocator, m_VertexRanges[index], count); }
+
+		/**
+		 * Reserve an index range for an element.
+		 *
+		 * @param index The slot index.
+		 * @param count The required number of indices.
+		 * @return Whether the range was moved.
+		 */
+		bool reserveIndices(uint32_t index, uint64_t count) { return reserveRange(m_IndexAllocator, m_IndexRanges[index], count); }
+
+		/**
+		 * Add the root of a layout tree that needs to be updated.
+		 *
+		 * @param handle The handle of the root.
+		 */
+		void addLayoutRoot(ElementHandle handle) { m_LayoutRoots.emplace_back(handle); }
+
+		/**
+		 * Take the layout roots that need to be updated.
+		 * Some of the handles might be stale, if the roots were destroyed after they were added.
+		 *
+		 * @param handles The vector to move the handles to. Its previous contents are discarded.
+		 */
+		void takeLayoutRoots(std::vector<ElementHandle>& handles)
+		{
+			handles.clear();
+			handles.swap(m_LayoutRoots);
+		}
+
+		/**
+		 * Set the text resources of the layer.
+		 *
+		 * @param pGlyphAtlas The glyph atlas pointer. This can be nullptr.
+		 * @param pTextLayoutCache The text layout cache pointer. This can be nullptr.
+		 */
+		void setTextResources(GlyphAtlas* pGlyphAtlas, TextLayoutCache* pTextLayoutCache)
+		{
+			m_pGlyphAtlas = pGlyphAtlas;
+			m_pTextLayoutCache = pTextLayoutCache;
+		}
+
+		/**
+		 * Get the glyph atlas of the layer.
+		 *
+		 * @return The glyph atlas pointer. This is nullptr if the layer does not have an atlas.
+		 */
+		[[nodiscard]] GlyphAtlas* getGlyphAtlas() const { return m_pGlyphAtlas; }
+
+		/**
+		 * Get the text layout cache of the layer.
+		 *
+		 * @return The text layout cache pointer.
+		 */
+		[[nodiscard]] TextLayoutCache* getTextLayoutCache() const { return m_pTextLayoutCache; }
+
+		/**
+		 * Get the number of slots.
+		 * Slots that are not in use have a null drawable.
+		 *
+		 * @return The slot count.
+		 */
+		[[nodiscard]] uint32_t getSlotCount() const { return static_cast<uint32_t>(m_Drawables.size()); }
+
+		/**
+		 * Get the handle of a slot.
+		 *
+		 * @param index The slot index.
+		 * @return The handle.
+		 */
+		[[nodiscard]] ElementHandle getHandle(uint32_t index) const { return ElementHandle(index, m_Generations[index]); }
+
+		/**
+		 * Get the drawables.
+		 *
+		 * @return The drawables.
+		 */
+		[[nodiscard]] std::span<Drawable* const> getDrawables() const { return m_Drawables; }
+
+		/**
+		 * Get the element positions in layer space.
+		 *
+		 * @return The positions.
+		 */
+		[[nodiscard]] std::span<Point2D_F32> getPositions() { return m_Positions; }
+
+		/**
+		 * Get the element clip rectangles in layer space.
+		 * This is the intersection of the clip rectangles of the element's ancestors.
+		 *
+		 * @return The clip rectangles.
+		 */
+		[[nodiscard]] std::span<Rectangle2D_F32> getClipRectangles() { return m_ClipRectangles; }
+
+		/**
+		 * Get the clip rectangle of an element which is not clipped.
+		 *
+		 * @return The rectangle, which covers all of layer space.
+		 */
+		[[nodiscard]] static Rectangle2D_F32 GetUnclippedRectangle() { return Rectangle2D_F32(Point2D_F32(std::numeric_limits<float>::lowest()), Point2D_F32(std::numeric_limits<float>::max())); }
+
+		/**
+		 * Set the bounds of an element.
+		 * This updates the element in the spatial index.
+		 *
+		 * @param index The slot index.
+		 * @param bounds The bounds in layer space.
+		 */
+		void setBounds(uint32_t index, const Rectangle2D_F32& bounds)
+		{
+			m_Bounds[index] = bounds;
+			m_SpatialIndex.update(index, bounds);
+		}
+
+		/**
+		 * Clear the bounds of an element which has no geometry.
+		 * This removes the element from the spatial index.
+		 *
+		 * @param index The slot index.
+		 * @param position The position of the element in layer space.
+		 */
+		void clearBounds(uint32_t index, Point2D_F32 position)
+		{
+			m_Bounds[index] = Rectangle2D_F32(position, position);
+			m_SpatialIndex.remove(index);
+		}
+
+		/**
+		 * Get the element bounds in layer space.
+		 *
+		 * @return The bounds.
+		 */
+		[[nodiscard]] std::span<const Rectangle2D_F32> getBounds() const { return m_Bounds; }
+
+		/**
+		 * Get the element flags.
+		 *
+		 * @return The flags.
+		 */
+		[[nodiscard]] std::span<uint8_t> getFlags() { return m_Flags; }
+
+		/**
+		 * Get the number of indices drawn by the elements.
+		 *
+		 * @return The index counts.
+		 */
+		[[nodiscard]] std::span<uint32_t> getIndexCounts() { return m_IndexCounts; }
+
+		/**
+		 * Get the vertex ranges of the elements.
+		 *
+		 * @return The ranges.
+		 */
+		[[nodiscard]] std::span<const GeometryRange> getVertexRanges() const { return m_VertexRanges; }
+
+		/**
+		 * Get the index ranges of the elements.
+		 *
+		 * @return The ranges.
+		 */
+		[[nodiscard]] std::span<const GeometryRange> getIndexRanges() const { return m_IndexRanges; }
+
+		/**
+		 * Get the spatial index of the elements.
+		 * Only the elements with geometry are in the index.
+		 *
+		 * @return The spatial index.
+		 */
+		[[nodiscard]] const SpatialIndex& getSpatialIndex() const { return m_SpatialIndex; }
+
+	private:
+		/**
+		 * Make sure a range can hold a number of elements.
+		 *
+		 * @param allocator The allocator of the range.
+		 * @param range The range.
+		 * @param count The required number of elements.
+		 * @return Whether the range was moved.
+		 */
+		static bool reserveRange(RangeAllocator& allocator, GeometryRange& range, uint64_t count);
+
+	private:
+		std::unordered_map<std::type_index, std::shared_ptr<std::pmr::memory_resource>> m_Pools;
+
+		std::vector<uint16_t> m_Generations;
+		std::vector<Drawable*> m_Drawables;
+		std::vector<Point2D_F32> m_Positions;
+		std::vector<Rectangle2D_F32> m_ClipRectangles;
+		std::vector<Rectangle2D_F32> m_Bounds;
+		std::vector<GeometryRange> m_VertexRanges;
+		std::vector<GeometryRange> m_IndexRanges;
+		std::vector<uint32_t> m_IndexCounts;
+		std::vector<uint8_t> m_Flags;
+
+		std::vector<uint32_t> m_FreeSlots;
+		std::vector<ElementHandle> m_LayoutRoots;
+
+		GlyphAtlas* m_pGlyphAtlas = nullptr;
+		TextLayoutCache* m_pTextLayoutCache = nullptr;
+
+		RangeAllocator m_VertexAllocator;
+		RangeAllocator m_IndexAllocator;
+
+		SpatialIndex m_SpatialIndex;
+	};
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "DataTypes.hpp"
+#include "MappedFile.hpp"
+
+#include <memory>
+#include <vector>
+
+struct stbtt_fontinfo;
+
+namespace minte
+{
+	/**
+	 * Font metrics structure.
+	 * The metrics are in pixels, for a single font size.
+	 */
+	struct FontMetrics final
+	{
+		float m_Ascent = 0.0f;		// The distance from the baseline to the top of the tallest glyph.
+		float m_Descent = 0.0f;		// The distance from the baseline to the bottom of the lowest glyph. This is usually negative.
+		float m_LineGap = 0.0f;		// The space between two lines.
+	};
+
+	/**
+	 * Glyph bitmap structure.
+	 * This is a single channel image of a rasterized glyph.
+	 */
+	struct GlyphBitmap final
+	{
+		std::vector<std::byte> m_Pixels;	// The pixels, with tightly packed rows.
+		Point2D_F32 m_Offset;				// The offset of the top left corner from the pen position, in pixels.
+
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+	};
+
+	/**
+	 * Font class.
+	 * This maps a TrueType or OpenType font file, and reads the glyph metrics and outlines from the mapped memory.
+	 *
+	 * All the functions are const and do not modify the font, so glyphs can be rasterized on multiple threads at once.
+	 */
+	class Font final
+	{
+	public:
+		/**
+		 * Explicit constructor.
+		 * This will throw a FrontendError if the file could not be mapped, or if it's not a valid font.
+		 *
+		 * @param path The font file path.
+		 * @param index The index of the font in a font collection. Default is 0.
+		 */
+		explicit Font(const std::filesystem::path& path, uint32_t index = 0);
+
+		/**
+		 * Destructor.
+		 */
+		~Font();
+
+		Font(const Font&) = delete;
+		Font& operator=(const Font&) = delete;
+
+		/**
+		 * Get the glyph index of a code point.
+		 *
+		 * @param codePoint The Unicode code point.
+		 * @return The glyph index. This is 0 (the missing glyph) if the font does not have the code point.
+		 */
+		[[nodiscard]] uint32_t getGlyphIndex(char32_t codePoint) const;
+
+		/**
+		 * Get the vertical metrics of the font.
+		 *
+		 * @param size The font size (the size of the em square) in pixels.
+		 * @return The metrics.
+		 */
+		[[nodiscard]] FontMetrics getMetrics(float size) const;
+
+		/**
+		 * Get the horizontal advance of a glyph.
+		 *
+		 * @param glyphIndex The glyph index.
+		 * @param size The font size in pixels.
+		 * @return The advance in pixels.
+		 */
+		[[nodiscard]] float getAdvance(uint32_t glyphIndex, float size) const;
+
+		/**
+		 * Get the kerning between two glyphs.
+		 *
+		 * @param firstGlyph The first glyph index.
+		 * @param secondGlyph The glyph index that follows the first glyph.
+		 * @param size The font size in pixels.
+		 * @return The adjustment to the advance of the first glyph, in pixels.
+		 */
+		[[nodiscard]] float getKerning(uint32_t firstGlyph, uint32_t secondGlyph, float size) const;
+
+		/**
+		 * Rasterize the coverage of a glyph.
+		 *
+		 * @param glyphIndex The glyph index.
+		 * @param size The font size in pixels.
+		 * @param bitmap The bitmap to write to. The bitmap is empty if the glyph does not have an outline.
+		 */
+		void rasterize(uint32_t glyphIndex, float size, GlyphBitmap& bitmap) const;
+
+		/**
+		 * Rasterize the signed distance field of a glyph.
+		 * The edge of the glyph is at 128, and the value changes by 128 / padding per pixel.
+		 *
+		 * @param glyphIndex The glyph index.
+		 * @param size The font size in pixels.
+		 * @param padding The number of pixels around the glyph's outline.
+		 * @param bitmap The bitmap to write to. The bitmap is empty if the glyph does not have an outline.
+		 */
+		void rasterizeDistanceField(uint32_t glyphIndex, float size, uint32_t padding, GlyphBitmap& bitmap) const;
+
+		/**
+		 * Get the unique ID of the font.
+		 * This is never reused by another font, so it can be used as a cache key.
+		 *
+		 * @return The font ID.
+		 */
+		[[nodiscard]] uint32_t getID() const { return m_ID; }
+
+	private:
+		/**
+		 * Get the scale from font units to pixels.
+		 *
+		 * @param size The font size in pixels.
+		 * @return The scale.
+		 */
+		[[nodiscard]] float getScale(float size) const;
+
+	private:
+		MappedFile m_File;
+		std::unique_ptr<stbtt_fontinfo> m_pFontInfo;
+
+		uint32_t m_ID = 0;
+	};
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Layer.hpp"
+#include "ThreadPool.hpp"
+
+#include <filesystem>
+#include <cstdio>
+
+namespace minte
+{
+	/**
+	 * Frame format enum.
+	 * This specifies how the recorded frames are stored.
+	 */
+	enum class FrameFormat : uint8_t
+	{
+		PNG,	// One PNG file per frame.
+		QOI,	// One QOI file per frame.
+		Y4M		// A single raw YUV4MPEG2 (4:2:0) stream.
+	};
+
+	/**
+	 * Recording policy enum.
+	 * This specifies what to do when the encoder falls behind.
+	 */
+	enum class RecordingPolicy : uint8_t
+	{
+		Block,	// Block the caller till a frame slot is free.
+		Drop	// Drop the frame.
+	};
+
+	/**
+	 * Frame recorder statistics structure.
+	 */
+	struct FrameRecorderStatistics final
+	{
+		uint64_t m_SubmittedFrames = 0;
+		uint64_t m_WrittenFrames = 0;
+		uint64_t m_DroppedFrames = 0;
+		uint64_t m_WrittenBytes = 0;
+	};
+
+	/**
+	 * Frame recorder class.
+	 * This writes layer outputs to disk without blocking the render loop.
+	 *
+	 * The recorder does not copy the color buffer, instead it retains it till the frame is written, which makes the layer render the next frames
+	 * to a different buffer. The frames are encoded on a worker pool and are written using a single large write per frame. The number of frames in
+	 * flight is bounded, and the recording policy decides whether to block the caller or to drop the frame when the disk falls behind.
+	 */
+	class FrameRecorder final
+	{
+	public:
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param path The output path. This is a directory for the PNG and QOI formats, and a file for the Y4M format.
+		 * @param format The frame format.
+		 * @param policy The recording policy. Default is drop.
+		 * @param maxPendingFrames The maximum number of frames that can be in flight. Default is 4.
+		 * @param threadCount The number of encoder threads. Default is 2.
+		 * @param frameRate The frame rate written to the Y4M stream header. Default is 60.
+		 */
+		explicit FrameRecorder(std::filesystem::path path, FrameFormat format, RecordingPolicy policy = RecordingPolicy::Drop, uint32_t maxPendingFrames = 4, uint32_t threadCount = 2, uint32_t frameRate = 60);
+
+		/**
+		 * Destructor.
+		 * This will write all the pending frames before returning.
+		 */
+		~FrameRecorder();
+
+		/**
+		 * Record a layer output.
+		 *
+		 * @param output The output to record.
+		 * @return Whether the frame was accepted. This is false if the frame was dropped.
+		 */
+		bool record(const LayerOutput& output);
+
+		/**
+		 * Wait till all the pending frames are written.
+		 */
+		void flush();
+
+		/**
+		 * Get the recorder statistics.
+		 *
+		 * @return The statistics.
+		 */
+		[[nodiscard]] FrameRecorderStatistics getStatistics() const;
+
+	private:
+		/**
+		 * Encode and write a single frame.
+		 * This is called by the worker threads.
+		 *
+		 * @param pColorBuffer The color buffer to write.
+		 * @param width The width of the frame.
+		 * @param height The height of the frame.
+		 * @param format The format of the color buffer.
+		 * @param sequence The sequence number of the frame.
+		 */
+		void writeFrame(const std::shared_ptr<backend::ImageBuffer>& pColorBuffer, uint32_t width, uint32_t height, backend::OutputFormat format, uint64_t sequence);
+
+		/**
+		 * Append a frame to the Y4M stream.
+		 * Frames are appended in the order they were recorded.
+		 *
+		 * @param data The encoded frame data.
+		 * @param sequence The sequence number of the frame.
+		 * @return Whether the frame was written.
+		 */
+		bool appendToStream(const std::vector<uint8_t>& data, uint64_t sequence);
+
+	private:
+		std::filesystem::path m_Path;
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_PendingCondition;
+		std::condition_variable m_StreamCondition;
+
+		FrameRecorderStatistics m_Statistics = {};
+
+		std::FILE* m_pStream = nullptr;
+		uint64_t m_NextSequence = 0;
+		uint64_t m_NextStreamSequence = 0;
+
+		uint32_t m_PendingFrames = 0;
+		uint32_t m_MaxPendingFrames = 0;
+		uint32_t m_FrameRate = 0;
+
+		uint32_t m_StreamWidth = 0;
+		uint32_t m_StreamHeight = 0;
+
+		FrameFormat m_Format = FrameFormat::PNG;
+		RecordingPolicy m_Policy = RecordingPolicy::Drop;
+
+		ThreadPool m_ThreadPool;	// This is declared last so that the workers are joined first.
+	};
+}
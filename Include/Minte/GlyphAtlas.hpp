@@ -0,0 +1,233 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Font.hpp"
+#include "ThreadPool.hpp"
+
+#include "Backend/RenderTarget.hpp"
+
+#include <unordered_map>
+
+namespace minte
+{
+	/**
+	 * Glyph mode enum.
+	 */
+	enum class GlyphMode : uint8_t
+	{
+		Coverage,		// The glyph is rasterized for each size. This is the sharpest at small sizes.
+		DistanceField	// The glyph is rasterized once as a signed distance field, which is scaled to any size.
+	};
+
+	/**
+	 * Glyph quad structure.
+	 * This is where a glyph is drawn, and where it's in the atlas.
+	 */
+	struct GlyphQuad final
+	{
+		Rectangle2D_F32 m_Bounds;				// The bounds relative to the pen position, in pixels.
+		Rectangle2D_F32 m_TextureCoordinates;	// The texture coordinates in the atlas page.
+
+		uint8_t m_TextureSlot = 0;	// The texture slot the page is bound to.
+		backend::SampleMode m_SampleMode = backend::SampleMode::Coverage;
+	};
+
+	/**
+	 * Glyph atlas class.
+	 * This rasterizes glyphs on worker threads and packs them into single channel atlas pages.
+	 *
+	 * Glyphs are requested while generating geometry. A glyph that is not in the atlas yet is queued to be rasterized, and is packed in a later
+	 * update, which only uploads the new glyphs to the pages. Distance field glyphs are rasterized once at a fixed size and serve every size, while
+	 * coverage glyphs are rasterized for each size.
+	 *
+	 * The number of pages is bounded. When the pages are full, the least recently used page which was not used since the last update is cleared.
+	 * Every change to the atlas bumps its generation, so text using the atlas should be regenerated when the generation changes. Regenerating the
+	 * text requests its glyphs again, which marks their pages as used.
+	 */
+	class GlyphAtlas final
+	{
+		/**
+		 * Glyph state enum.
+		 */
+		enum class GlyphState : uint8_t
+		{
+			Pending,	// The glyph is being rasterized, or is waiting for space in the atlas.
+			Ready
+		};
+
+		/**
+		 * Glyph structure.
+		 */
+		struct Glyph final
+		{
+			Rectangle2D_F32 m_Bounds;
+			Rectangle2D_F32 m_TextureCoordinates;
+
+			uint32_t m_Page = 0;
+			GlyphState m_State = GlyphState::Pending;
+		};
+
+		/**
+		 * Rasterized glyph structure.
+		 */
+		struct RasterizedGlyph final
+		{
+			GlyphBitmap m_Bitmap;
+			uint64_t m_Key = 0;
+		};
+
+		/**
+		 * Atlas shelf structure.
+		 * A shelf is a row of glyphs with similar heights.
+		 */
+		struct Shelf final
+		{
+			uint32_t m_Y = 0;
+			uint32_t m_Height = 0;
+			uint32_t m_Width = 0;	// The used width.
+		};
+
+		/**
+		 * Atlas page structure.
+		 */
+		struct Page final
+		{
+			std::shared_ptr<backend::Texture> m_pTexture = nullptr;
+
+			std::vector<Shelf> m_Shelves;
+			std::vector<uint64_t> m_Glyphs;	// The keys of the glyphs in the page.
+
+			// The pending upload.
+			std::vector<backend::TextureRegion> m_Regions;
+			std::vector<std::byte> m_UploadData;
+
+			uint64_t m_LastUsedFrame = 0;
+			uint32_t m_ShelfTop = 0;	// The top of the free space below the shelves.
+		};
+
+	public:
+		using TextureFactory = std::function<std::shared_ptr<backend::Texture>(uint32_t width, uint32_t height, backend::TextureFormat format)>;
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param factory The function used to create the atlas pages.
+		 * @param pageSize The width and height of a page. Default is 1024.
+		 * @param maxPages The maximum number of pages. Default is 4.
+		 * @param firstTextureSlot The texture slot of the first page. The pages are bound to consecutive slots. Default is 1.
+		 * @param distanceFieldSize The font size the distance fields are rasterized at. Default is 32.
+		 * @param threadCount The number of rasterizer threads. Default is 2.
+		 */
+		explicit GlyphAtlas(TextureFactory&& factory, uint32_t pageSize = 1024, uint32_t maxPages = 4, uint32_t firstTextureSlot = 1, float distanceFieldSize = 32.0f, uint32_t threadCount = 2);
+
+		/**
+		 * Destructor.
+		 * This waits till the queued glyphs are rasterized.
+		 */
+		~GlyphAtlas();
+
+		GlyphAtlas(const GlyphAtlas&) = delete;
+		GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+		/**
+		 * Get a glyph from the atlas.
+		 * If the glyph is not in the atlas, it's queued to be rasterized.
+		 *
+		 * @param pFont The font of the glyph.
+		 * @param glyphIndex The glyph index.
+		 * @param size The font size in pixels.
+		 * @param mode The glyph mode.
+		 * @param quad The quad to write to. The bounds are empty for glyphs without an outline.
+		 * @return Whether the glyph is in the atlas.
+		 */
+		bool getGlyph(const std::shared_ptr<Font>& pFont, uint32_t glyphIndex, float size, GlyphMode mode, GlyphQuad& quad);
+
+		/**
+		 * Pack the rasterized glyphs and upload them to the pages.
+		 * This should be called once per frame, before the text using the atlas is generated.
+		 *
+		 * @return Whether the atlas changed, in which case the generation is bumped.
+		 */
+		bool update();
+
+		/**
+		 * Bind the atlas pages to a render target's texture slots.
+		 *
+		 * @param renderTarget The render target.
+		 */
+		void bind(backend::RenderTarget& renderTarget) const;
+
+		/**
+		 * Get the generation of the atlas.
+		 * This changes every time glyphs are added to or removed from the atlas.
+		 *
+		 * @return The generation.
+		 */
+		[[nodiscard]] uint64_t getGeneration() const { return m_Generation; }
+
+		/**
+		 * Get the number of pages.
+		 *
+		 * @return The page count.
+		 */
+		[[nodiscard]] uint32_t getPageCount() const { return static_cast<uint32_t>(m_Pages.size()); }
+
+		/**
+		 * Get the number of pages that were cleared to make space.
+		 *
+		 * @return The eviction count.
+		 */
+		[[nodiscard]] uint64_t getEvictionCount() const { return m_EvictionCount; }
+
+	private:
+		/**
+		 * Find space for a glyph in a page.
+		 *
+		 * @param page The page.
+		 * @param width The width of the space.
+		 * @param height The height of the space.
+		 * @param position The position of the space.
+		 * @return Whether the space was found.
+		 */
+		[[nodiscard]] bool allocate(Page& page, uint32_t width, uint32_t height, Point2D_UI32& position) const;
+
+		/**
+		 * Pack a rasterized glyph.
+		 *
+		 * @param rasterizedGlyph The rasterized glyph.
+		 * @return Whether the glyph was packed. This is false if all the pages are full and in use.
+		 */
+		bool pack(const RasterizedGlyph& rasterizedGlyph);
+
+		/**
+		 * Clear the least recently used page which was not used since the last update.
+		 *
+		 * @return The page index. This is the page count if all the pages are in use.
+		 */
+		uint32_t evict();
+
+	private:
+		TextureFactory m_Factory;
+
+		std::unordered_map<uint64_t, Glyph> m_Glyphs;
+		std::vector<Page> m_Pages;
+
+		std::mutex m_Mutex;
+		std::vector<RasterizedGlyph> m_RasterizedGlyphs;	// Written by the workers.
+		std::vector<RasterizedGlyph> m_PackingGlyphs;
+
+		uint64_t m_Frame = 1;
+		uint64_t m_Generation = 0;
+		uint64_t m_EvictionCount = 0;
+
+		float m_DistanceFieldSize = 32.0f;
+		uint32_t m_DistanceFieldPadding = 4;
+
+		uint32_t m_PageSize = 1024;
+		uint32_t m_MaxPages = 4;
+		uint32_t m_FirstTextureSlot = 1;
+
+		ThreadPool m_ThreadPool;	// This is declared last so that the workers are joined first.
+	};
+}
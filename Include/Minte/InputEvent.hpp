@@ -0,0 +1,54 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "DataTypes.hpp"
+
+#include <chrono>
+
+namespace minte
+{
+	/**
+	 * Input event type enum.
+	 */
+	enum class InputEventType : uint8_t
+	{
+		MouseMove,
+		MouseButtonDown,
+		MouseButtonUp,
+		MouseWheel,
+		KeyDown,
+		KeyUp
+	};
+
+	/**
+	 * Mouse button enum.
+	 */
+	enum class MouseButton : uint8_t
+	{
+		None,
+		Left,
+		Middle,
+		Right,
+		X1,
+		X2
+	};
+
+	/**
+	 * Input event structure.
+	 * This is a single input event, either read from the window or injected by the host application.
+	 */
+	struct InputEvent final
+	{
+		Point2D_F32 m_Position;	// The pointer position in layer space.
+		Point2D_F32 m_Delta;	// The pointer movement for mouse moves, and the scroll amount for the mouse wheel.
+
+		uint32_t m_KeyCode = 0;		// The platform key code of key events.
+		uint16_t m_Modifiers = 0;	// The platform key modifiers.
+
+		InputEventType m_Type = InputEventType::MouseMove;
+		MouseButton m_Button = MouseButton::None;
+
+		std::chrono::steady_clock::time_point m_Timestamp = {};	// When the platform received the event. Zero if it's not known.
+	};
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "InputEvent.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace minte
+{
+	/**
+	 * Input queue class.
+	 * This is a bounded lock-free multiple producer, single consumer queue of input events.
+	 *
+	 * Any thread can push events to the queue, and the layer that owns it drains it once per update. Mouse moves are dropped once the queue is
+	 * three quarters full, so a high rate input device cannot push out the button and key events. Consecutive mouse moves are merged when
+	 * they are drained, so the layer only dispatches the latest pointer position of a burst.
+	 */
+	class InputQueue final
+	{
+		/**
+		 * Queue cell structure.
+		 */
+		struct Cell final
+		{
+			std::atomic<uint64_t> m_Sequence = 0;
+			InputEvent m_Event;
+		};
+
+	public:
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param capacity The maximum number of events in the queue. This is rounded up to a power of two. Default is 1024.
+		 */
+		explicit InputQueue(uint32_t capacity = 1024);
+
+		InputQueue(const InputQueue&) = delete;
+		InputQueue& operator=(const InputQueue&) = delete;
+
+		/**
+		 * Push an event to the queue.
+		 * This can be called from any thread.
+		 *
+		 * @param event The event to push.
+		 * @return Whether the event was queued. This is false if the queue is full, in which case the event is dropped.
+		 */
+		bool push(const InputEvent& event);
+
+		/**
+		 * Drain the queued events.
+		 * This must only be called by the consumer. At most one queue's worth of events are read, so producers that keep pushing cannot keep
+		 * the consumer here.
+		 *
+		 * @param events The vector to append the events to.
+		 * @return The number of events read from the queue, before merging.
+		 */
+		uint32_t drain(std::vector<InputEvent>& events);
+
+		/**
+		 * Get the approximate number of queued events.
+		 *
+		 * @return The event count.
+		 */
+		[[nodiscard]] uint64_t getSize() const { return m_EnqueuePosition.load(std::memory_order_relaxed) - m_DequeuePosition.load(std::memory_order_relaxed); }
+
+		/**
+		 * Get the capacity of the queue.
+		 *
+		 * @return The capacity.
+		 */
+		[[nodiscard]] uint64_t getCapacity() const { return m_Mask + 1; }
+
+		/**
+		 * Get the number of events dropped because the queue was full.
+		 *
+		 * @return The dropped event count.
+		 */
+		[[nodiscard]] uint64_t getDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+
+	private:
+		std::unique_ptr<Cell[]> m_pCells = nullptr;
+		uint64_t m_Mask = 0;
+
+		// The positions are on separate cache lines so that the producers and the consumer do not contend.
+		alignas(64) std::atomic<uint64_t> m_EnqueuePosition = 0;
+		alignas(64) std::atomic<uint64_t> m_DequeuePosition = 0;
+		alignas(64) std::atomic<uint64_t> m_DroppedCount = 0;
+	};
+}
@@ -4,6 +4,11 @@
 
 #include "MinteObject.hpp"
 #include "DataTypes.hpp"
+#include "Drawable.hpp"
+#include "DrawStream.hpp"
+#include "GlyphAtlas.hpp"
+#include "InputQueue.hpp"
+#include "TextLayout.hpp"
 
 #include "Backend/RenderTarget.hpp"
 
@@ -12,17 +17,33 @@ namespace minte
 	/**
 	 * Layer output structure.
 	 * This contains the layer's rendered output.
+	 *
+	 * The buffers can be retained after the next update, in which case the layer will render to different buffers.
 	 */
 	struct LayerOutput final
 	{
-		const backend::ImageBuffer* m_pColorBuffer = nullptr;
-		const backend::ImageBuffer* m_pEntityBuffer = nullptr;
-		const backend::ImageBuffer* m_pDepthBuffer = nullptr;
+		std::shared_ptr<backend::ImageBuffer> m_pColorBuffer = nullptr;
+		std::shared_ptr<backend::ImageBuffer> m_pEntityBuffer = nullptr;
+		std::shared_ptr<backend::ImageBuffer> m_pDepthBuffer = nullptr;
+
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		backend::OutputFormat m_ColorFormat = backend::OutputFormat::RGBA;
+
+		bool m_IsUnchanged = false;	// Whether the buffers contain the same image as the previous update, so their uploads can be skipped.
 	};
 
 	/**
 	 * Layer class.
 	 * This class contains a single image which can be retrieved after drawing.
+	 *
+	 * The layer retains a tree of drawables. Every drawable owns a range of the render target's vertex and index buffers, and only the drawables
+	 * that changed since the last update are regenerated and uploaded to their ranges. The drawables are allocated from the layer's pools and
+	 * their per-frame data is kept in the layer's element storage. The element bounds are kept in a spatial index, which is used to cull the
+	 * elements outside the viewport and to hit test without reading back the entity buffer.
+	 *
+	 * The layer keeps a change generation, which is bumped whenever an update finds something to regenerate. If nothing changed since the
+	 * last draw, the update returns the previous buffers without drawing, so a static layer costs next to nothing.
 	 */
 	class Layer : public MinteObject
 	{
@@ -41,38 +62,323 @@ namespace minte
 		explicit Layer(Minte parent, std::unique_ptr<backend::RenderTarget>&& pRenderTarget);
 
 		/**
-		 * Default virtual destructor.
+		 * Move constructor.
+		 *
+		 * @param other The other layer.
 		 */
-		virtual ~Layer() = default;
+		Layer(Layer&& other) noexcept = default;
+
+		/**
+		 * Virtual destructor.
+		 * This detaches all the drawables from the layer.
+		 */
+		virtual ~Layer();
+
+		/**
+		 * Move assignment operator.
+		 *
+		 * @param other The other layer.
+		 * @return The moved layer.
+		 */
+		Layer& operator=(Layer&& other) noexcept;
 
 		/**
 		 * Create a new element to this layer.
-		 * If the element is derived from MinteObject, the parent will be provided.
+		 * Drawables are allocated from the layer's pool of their type, but are not added to the layer. If the element is derived from
+		 * MinteObject, the parent will be provided.
 		 *
 		 * @tparam Element The element type.
 		 * @tparam Arguments The constructor arguments.
 		 * @param arguments The arguments required by the Element's constructor.
-		 * @return The created element.
+		 * @return The created element. This is a shared pointer for drawables.
 		 */
 		template<class Element, class... Arguments>
-		[[nodiscard]] Element createElement(Arguments&&... arguments)
+		[[nodiscard]] auto createElement(Arguments&&... arguments)
 		{
-			if constexpr (std::is_base_of_v<MinteObject, Element>)
+			if constexpr (std::is_base_of_v<Drawable, Element>)
+				return m_pStorage->allocate<Element>(std::forward<Arguments>(arguments)...);
+
+			else if constexpr (std::is_base_of_v<MinteObject, Element>)
 				return Element(getParent(), std::forward<Arguments>(arguments)...);
 
 			else
 				return Element(std::forward<Arguments>(arguments)...);
 		}
 
+		/**
+		 * Create a new drawable and add it to the layer.
+		 *
+		 * @tparam Element The drawable type.
+		 * @tparam Arguments The constructor arguments.
+		 * @param arguments The arguments required by the Element's constructor.
+		 * @return The created drawable.
+		 */
+		template<class Element, class... Arguments>
+		std::shared_ptr<Element> createDrawable(Arguments&&... arguments)
+		{
+			auto pDrawable = createElement<Element>(std::forward<Arguments>(arguments)...);
+			addDrawable(pDrawable);
+			return pDrawable;
+		}
+
+		/**
+		 * Add a drawable to the layer.
+		 * Drawables are drawn in the order they are added, and children are drawn on top of their parents.
+		 * This will throw a FrontendError if the drawable already has a parent.
+		 *
+		 * @param pDrawable The drawable to add.
+		 */
+		void addDrawable(std::shared_ptr<Drawable> pDrawable);
+
+		/**
+		 * Remove a drawable from the layer.
+		 *
+		 * @param pDrawable The drawable to remove.
+		 */
+		void removeDrawable(const Drawable* pDrawable);
+
+		/**
+		 * Get the drawables of the layer.
+		 *
+		 * @return The drawables.
+		 */
+		[[nodiscard]] const std::vector<std::shared_ptr<Drawable>>& getDrawables() const { return m_Drawables; }
+
+		/**
+		 * Get a drawable using its element handle.
+		 * The handle can be one read from the entity buffer.
+		 *
+		 * @param handle The element handle.
+		 * @return The drawable pointer. This is nullptr if the handle is stale.
+		 */
+		[[nodiscard]] Drawable* getDrawable(ElementHandle handle) const { return m_pStorage->getDrawable(handle); }
+
+		/**
+		 * Find the top most element at a point.
+		 * This uses the layer's spatial index and the draw order of the last update, so it does not need the entity buffer.
+		 *
+		 * @param point The point in layer space.
+		 * @return The element handle. This is invalid if there are no elements at the point.
+		 */
+		[[nodiscard]] ElementHandle hitTest(Point2D_F32 point) const;
+
+		/**
+		 * Find all the elements overlapping a rectangle.
+		 * Hidden elements are skipped.
+		 *
+		 * @param rectangle The rectangle in layer space.
+		 * @param handles The vector to append the handles to, in draw order.
+		 */
+		void queryElements(const Rectangle2D_F32& rectangle, std::vector<ElementHandle>& handles) const;
+
+		/**
+		 * Get the element storage of the layer.
+		 *
+		 * @return The element storage.
+		 */
+		[[nodiscard]] const ElementStorage& getElementStorage() const { return *m_pStorage; }
+
 		/**
 		 * Update the layer.
-		 * This will first draw all the UI elements and then handle inputs.
+		 * This will first draw all the UI elements and then dispatch the events queued in the input queue. The draw is skipped if neither the
+		 * elements nor the render target's settings changed since the last one, in which case the output is flagged as unchanged.
 		 *
 		 * @return The rendered images.
 		 */
 		[[nodiscard]] LayerOutput update();
 
+		/**
+		 * Make the next update draw, even if none of the elements changed.
+		 * This is needed for changes the layer can't see, like the contents of a texture updated in place.
+		 */
+		void invalidate() { m_ChangeGeneration++; }
+
+		/**
+		 * Get the change generation of the layer.
+		 * This changes every time an update finds something that needs to be drawn again.
+		 *
+		 * @return The generation.
+		 */
+		[[nodiscard]] uint64_t getChangeGeneration() const { return m_ChangeGeneration; }
+
+		/**
+		 * Get the render target of the layer.
+		 * Settings which change the image, like the output format, make the next update draw again.
+		 *
+		 * @return The render target.
+		 */
+		[[nodiscard]] backend::RenderTarget& getRenderTarget() { return *m_pRenderTarget; }
+
+		/**
+		 * Get the render target of the layer.
+		 *
+		 * @return The render target.
+		 */
+		[[nodiscard]] const backend::RenderTarget& getRenderTarget() const { return *m_pRenderTarget; }
+
+		/**
+		 * Get the input queue of the layer.
+		 * Events can be pushed to the queue from any thread, and are dispatched to the drawables in the next update.
+		 *
+		 * @return The input queue.
+		 */
+		[[nodiscard]] const std::shared_ptr<InputQueue>& getInputQueue() const { return m_pInputQueue; }
+
+		/**
+		 * Capture the layer's draw stream.
+		 * The layer is registered with the writer, and everything it submits to the backend is recorded from then on. The writer captures the
+		 * texture uploads of the layer's backend instance as well, so textures should be updated after this to have their contents recorded.
+		 *
+		 * @param pWriter The draw stream writer. Set this to nullptr to stop capturing.
+		 */
+		void setDrawStreamWriter(std::shared_ptr<DrawStreamWriter> pWriter);
+
+		/**
+		 * Set the glyph atlas used by the layer's text.
+		 * The atlas is updated at the beginning of every layer update, and its pages are bound to the render target.
+		 *
+		 * @param pAtlas The glyph atlas. This can be shared with other layers of the same backend instance.
+		 */
+		void setGlyphAtlas(std::shared_ptr<GlyphAtlas> pAtlas);
+
+		/**
+		 * Get the glyph atlas used by the layer's text.
+		 *
+		 * @return The glyph atlas pointer. This is nullptr if an atlas was not set.
+		 */
+		[[nodiscard]] const std::shared_ptr<GlyphAtlas>& getGlyphAtlas() const { return m_pGlyphAtlas; }
+
+		/**
+		 * Set the text layout cache used by the layer's text.
+		 * Each layer has its own cache by default. The cache is trimmed at the end of every layer update.
+		 *
+		 * @param pCache The text layout cache. This can be shared with other layers that are updated on the same thread.
+		 */
+		void setTextLayoutCache(std::shared_ptr<TextLayoutCache> pCache);
+
+		/**
+		 * Get the text layout cache used by the layer's text.
+		 *
+		 * @return The text layout cache.
+		 */
+		[[nodiscard]] const std::shared_ptr<TextLayoutCache>& getTextLayoutCache() const { return m_pTextLayoutCache; }
+
+	private:
+		/**
+		 * Detach all the drawables from the layer.
+		 */
+		void detachDrawables();
+
+		/**
+		 * Update the glyph atlas, and mark the drawables using it dirty if it changed.
+		 */
+		void updateGlyphAtlas();
+
+		/**
+		 * Mark all the drawables using the glyph atlas dirty.
+		 */
+		void invalidateGlyphAtlasUsers();
+
+		/**
+		 * Record the texture slots that changed since the last update to the draw stream.
+		 */
+		void recordTextureBinds();
+
+		/**
+		 * Regenerate and upload the dirty drawables.
+		 * This bumps the change generation if anything was dirty.
+		 */
+		void updateDrawables();
+
+		/**
+		 * Update a single dirty drawable and its dirty descendants.
+		 *
+		 * @param drawable The drawable to update.
+		 * @param parentPosition The position of the parent in the layer.
+		 * @param clip The clip rectangle of the drawable in the layer, from the top of the clip stack.
+		 * @param bCommandsDirty This is set to true if the draw commands need to be rebuilt.
+		 */
+		void updateDrawable(Drawable& drawable, Point2D<float> parentPosition, const Rectangle2D_F32& clip, bool& bCommandsDirty);
+
+		/**
+		 * Upload a drawable's cached geometry to its ranges.
+		 * The vertices are tagged with the drawable's entity ID, and the indices are made absolute. The rest of the index range is filled with
+		 * degenerate triangles, so that a draw command can span it.
+		 *
+		 * @param drawable The drawable to upload.
+		 * @param position The position of the drawable in the layer.
+		 * @param clip The clip rectangle of the drawable in the layer. The geometry is not uploaded if it's entirely outside.
+		 * @param bCommandsDirty This is set to true if the ranges were moved, or if the drawable was clipped or culled.
+		 */
+		void uploadGeometry(Drawable& drawable, Point2D<float> position, const Rectangle2D_F32& clip, bool& bCommandsDirty);
+
+		/**
+		 * Rebuild the draw order from the drawable tree, and the draw commands from the draw order.
+		 * Consecutive commands with the same state are merged when their index ranges are adjacent, or only separated by degenerate triangles.
+		 */
+		void updateDrawCommands();
+
+		/**
+		 * Dispatch the queued input events to the drawables.
+		 */
+		void handleInputs();
+
+		/**
+		 * Dispatch an input event to a drawable, and to its ancestors till it's handled.
+		 *
+		 * @param handle The handle of the first drawable.
+		 * @param event The input event.
+		 */
+		void dispatchInputEvent(ElementHandle handle, const InputEvent& event);
+
+		/**
+		 * Get the viewport of the layer.
+		 *
+		 * @return The viewport rectangle in layer space.
+		 */
+		[[nodiscard]] Rectangle2D_F32 getViewport() const;
+
+		/**
+		 * Check if a rectangle is inside the viewport.
+		 *
+		 * @param bounds The rectangle in layer space.
+		 * @return Whether any part of the rectangle is visible.
+		 */
+		[[nodiscard]] bool isOnScreen(const Rectangle2D_F32& bounds) const;
+
 	private:
 		std::unique_ptr<backend::RenderTarget> m_pRenderTarget = nullptr;
+
+		std::unique_ptr<ElementStorage> m_pStorage = std::make_unique<ElementStorage>();	// This is declared before the drawables so that it outlives them.
+		std::vector<std::shared_ptr<Drawable>> m_Drawables;
+
+		std::vector<uint32_t> m_DrawOrder;	// The slot indices of the visible elements, in draw order.
+		std::vector<uint32_t> m_DrawRanks;	// The position of each slot in the draw order, starting from 1. Hidden elements are 0.
+		std::vector<uint32_t> m_VisibleElements;	// The slot indices of the elements inside the viewport, in draw order.
+		std::vector<Vertex> m_VertexScratch;
+		std::vector<Index> m_IndexScratch;
+		std::vector<DrawBatch> m_BatchScratch;
+		std::vector<const Drawable*> m_DrawStack;
+		std::vector<backend::DrawCommand> m_CommandScratch;
+
+		LayoutEngine m_LayoutEngine;
+		std::vector<ElementHandle> m_LayoutRoots;
+
+		uint64_t m_ChangeGeneration = 1;
+		uint64_t m_DrawnGeneration = 0;	// The change generation of the last draw.
+		uint64_t m_DrawnStateGeneration = 0;	// The render target's state generation after the last draw.
+		bool m_IsStructureDirty = false;
+
+		std::shared_ptr<InputQueue> m_pInputQueue = std::make_shared<InputQueue>();
+		std::vector<InputEvent> m_InputEvents;
+		ElementHandle m_FocusedElement;
+
+		std::shared_ptr<GlyphAtlas> m_pGlyphAtlas = nullptr;
+		std::shared_ptr<TextLayoutCache> m_pTextLayoutCache = std::make_shared<TextLayoutCache>();
+		uint64_t m_GlyphAtlasGeneration = 0;
+
+		std::shared_ptr<DrawStreamWriter> m_pDrawStreamWriter = nullptr;
+		std::array<uint64_t, backend::RenderTarget::MaxTextures> m_DrawStreamTextures = {};	// The unique IDs of the textures recorded in each slot.
+		uint32_t m_DrawStreamLayerID = 0;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,165 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "DataTypes.hpp"
+
+#include <limits>
+#include <vector>
+
+namespace minte
+{
+	class Drawable;
+
+	/**
+	 * Layout direction enum.
+	 * This is the main axis along which a container places its children.
+	 */
+	enum class LayoutDirection : uint8_t
+	{
+		Row,
+		Column
+	};
+
+	/**
+	 * Layout alignment enum.
+	 */
+	enum class LayoutAlignment : uint8_t
+	{
+		Start,
+		Center,
+		End,
+		SpaceBetween,	// Only used to justify the children along the main axis.
+		Stretch			// Only used to align the children along the cross axis.
+	};
+
+	/**
+	 * Layout unit enum.
+	 */
+	enum class LayoutUnit : uint8_t
+	{
+		Auto,
+		Pixels,
+		Percent
+	};
+
+	/**
+	 * Layout length structure.
+	 */
+	struct LayoutLength final
+	{
+		float m_Value = 0.0f;
+		LayoutUnit m_Unit = LayoutUnit::Auto;
+
+		/**
+		 * Create an automatic length.
+		 * This uses the measured size of the element.
+		 *
+		 * @return The length.
+		 */
+		[[nodiscard]] static constexpr LayoutLength Auto() { return LayoutLength{ 0.0f, LayoutUnit::Auto }; }
+
+		/**
+		 * Create a length in pixels.
+		 *
+		 * @param value The number of pixels.
+		 * @return The length.
+		 */
+		[[nodiscard]] static constexpr LayoutLength Pixels(float value) { return LayoutLength{ value, LayoutUnit::Pixels }; }
+
+		/**
+		 * Create a length relative to the parent's content size.
+		 *
+		 * @param value The percentage.
+		 * @return The length.
+		 */
+		[[nodiscard]] static constexpr LayoutLength Percent(float value) { return LayoutLength{ value, LayoutUnit::Percent }; }
+	};
+
+	/**
+	 * Layout edges structure.
+	 */
+	struct LayoutEdges final
+	{
+		float m_Left = 0.0f;
+		float m_Top = 0.0f;
+		float m_Right = 0.0f;
+		float m_Bottom = 0.0f;
+	};
+
+	/**
+	 * Layout style structure.
+	 * This describes how an element is sized and how it places its children.
+	 */
+	struct LayoutStyle final
+	{
+		LayoutLength m_Width;
+		LayoutLength m_Height;
+
+		Point2D_F32 m_MinimumSize = Point2D_F32(0.0f);
+		Point2D_F32 m_MaximumSize = Point2D_F32(std::numeric_limits<float>::max());
+
+		LayoutEdges m_Padding;
+		float m_Gap = 0.0f;		// The space between the children.
+		float m_Grow = 0.0f;	// The share of the parent's free space given to this element.
+
+		LayoutDirection m_Direction = LayoutDirection::Row;
+		LayoutAlignment m_JustifyContent = LayoutAlignment::Start;
+		LayoutAlignment m_AlignItems = LayoutAlignment::Start;
+	};
+
+	/**
+	 * Layout node structure.
+	 * This is the layout state of a single drawable.
+	 */
+	struct LayoutNode final
+	{
+		LayoutStyle m_Style;
+
+		Point2D_F32 m_MeasuredSize;	// The cached size required by the content.
+		Point2D_F32 m_Size;			// The size given by the parent.
+
+		bool m_IsMeasureDirty = true;
+		bool m_IsLayoutDirty = true;
+	};
+
+	/**
+	 * Layout engine class.
+	 * This is a flexbox style layout over a tree of drawables.
+	 *
+	 * The layout is done in two passes. The measure pass computes the size each element needs bottom up, and the arrange pass gives each
+	 * element its final size and position top down. Measured sizes are cached in the layout nodes, and changing an element invalidates only
+	 * its ancestors, so a relayout only measures the changed branch and only arranges the children whose size changed.
+	 */
+	class LayoutEngine final
+	{
+	public:
+		/**
+		 * Update the layout of a tree.
+		 *
+		 * @param root The root of the tree. Its parent must not have a layout.
+		 * @param viewport The size of the viewport, which is used to resolve the root's percentage sizes.
+		 */
+		void update(Drawable& root, Point2D_F32 viewport);
+
+	private:
+		/**
+		 * Measure a drawable.
+		 *
+		 * @param drawable The drawable to measure.
+		 * @return The measured size, including the padding.
+		 */
+		Point2D_F32 measure(Drawable& drawable);
+
+		/**
+		 * Size and place the children of a drawable.
+		 *
+		 * @param drawable The drawable to arrange.
+		 * @param size The final size of the drawable.
+		 */
+		void arrange(Drawable& drawable, Point2D_F32 size);
+
+	private:
+		std::vector<Point2D_F32> m_ChildSizes;
+	};
+}
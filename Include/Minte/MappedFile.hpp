@@ -0,0 +1,90 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+namespace minte
+{
+	/**
+	 * Mapped file class.
+	 * This maps a whole file to the address space as read-only memory.
+	 */
+	class MappedFile final
+	{
+	public:
+		/**
+		 * Default constructor.
+		 */
+		MappedFile() = default;
+
+		/**
+		 * Explicit constructor.
+		 * This will throw a FrontendError if the file could not be mapped.
+		 *
+		 * @param path The file path.
+		 */
+		explicit MappedFile(const std::filesystem::path& path);
+
+		/**
+		 * Move constructor.
+		 *
+		 * @param other The other file.
+		 */
+		MappedFile(MappedFile&& other) noexcept;
+
+		/**
+		 * Destructor.
+		 */
+		~MappedFile();
+
+		/**
+		 * Move assignment operator.
+		 *
+		 * @param other The other file.
+		 * @return The moved file.
+		 */
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * Get the mapped data.
+		 *
+		 * @return The data.
+		 */
+		[[nodiscard]] std::span<const std::byte> getData() const { return { m_pData, m_Size }; }
+
+		/**
+		 * Get the size of the file.
+		 *
+		 * @return The size in bytes.
+		 */
+		[[nodiscard]] uint64_t getSize() const { return m_Size; }
+
+		/**
+		 * Check if the file is mapped.
+		 *
+		 * @return Whether the file is mapped or not.
+		 */
+		[[nodiscard]] bool isMapped() const { return m_pData != nullptr; }
+
+	private:
+		/**
+		 * Unmap the file.
+		 */
+		void unmap();
+
+	private:
+		const std::byte* m_pData = nullptr;
+		uint64_t m_Size = 0;
+
+#if defined(MINTE_PLATFORM_WINDOWS)
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+
+#endif
+	};
+}
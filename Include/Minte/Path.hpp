@@ -0,0 +1,167 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "DataTypes.hpp"
+
+#include <span>
+#include <vector>
+
+namespace minte
+{
+	/**
+	 * Path verb enum.
+	 */
+	enum class PathVerb : uint8_t
+	{
+		MoveTo,			// Uses 1 point.
+		LineTo,			// Uses 1 point.
+		QuadraticTo,	// Uses 2 points, the control point and the end point.
+		CubicTo,		// Uses 3 points, the two control points and the end point.
+		Close			// Uses no points.
+	};
+
+	/**
+	 * Path class.
+	 * This is a sequence of contours made of lines and Bézier curves, in pixels.
+	 *
+	 * Drawing to a path without a current point starts a new contour at the origin. Curves are only flattened when the path is tessellated, so
+	 * the same path can be drawn at any scale.
+	 */
+	class Path final
+	{
+	public:
+		/**
+		 * Default constructor.
+		 */
+		Path() = default;
+
+		/**
+		 * Start a new contour.
+		 *
+		 * @param point The first point of the contour.
+		 * @return This path.
+		 */
+		Path& moveTo(Point2D_F32 point);
+
+		/**
+		 * Add a line from the current point.
+		 *
+		 * @param point The end point.
+		 * @return This path.
+		 */
+		Path& lineTo(Point2D_F32 point);
+
+		/**
+		 * Add a quadratic Bézier curve from the current point.
+		 *
+		 * @param control The control point.
+		 * @param point The end point.
+		 * @return This path.
+		 */
+		Path& quadraticTo(Point2D_F32 control, Point2D_F32 point);
+
+		/**
+		 * Add a cubic Bézier curve from the current point.
+		 *
+		 * @param firstControl The first control point.
+		 * @param secondControl The second control point.
+		 * @param point The end point.
+		 * @return This path.
+		 */
+		Path& cubicTo(Point2D_F32 firstControl, Point2D_F32 secondControl, Point2D_F32 point);
+
+		/**
+		 * Add a circular arc.
+		 * A line is added from the current point to the start of the arc. If there is no current point, the arc starts a new contour.
+		 *
+		 * @param center The center of the circle.
+		 * @param radius The radius.
+		 * @param startAngle The angle of the start point in radians, clockwise from the X axis (since Y points down).
+		 * @param sweepAngle The angle to sweep in radians. Negative angles sweep counter clockwise.
+		 * @return This path.
+		 */
+		Path& arc(Point2D_F32 center, float radius, float startAngle, float sweepAngle);
+
+		/**
+		 * Close the current contour with a line to its first point.
+		 *
+		 * @return This path.
+		 */
+		Path& close();
+
+		/**
+		 * Add a closed rectangle.
+		 *
+		 * @param rectangle The rectangle.
+		 * @return This path.
+		 */
+		Path& addRectangle(const Rectangle2D_F32& rectangle);
+
+		/**
+		 * Add a closed rectangle with rounded corners.
+		 *
+		 * @param rectangle The rectangle.
+		 * @param radius The corner radius. This is clamped to half of the smaller side.
+		 * @return This path.
+		 */
+		Path& addRoundedRectangle(const Rectangle2D_F32& rectangle, float radius);
+
+		/**
+		 * Add a closed circle.
+		 *
+		 * @param center The center.
+		 * @param radius The radius.
+		 * @return This path.
+		 */
+		Path& addCircle(Point2D_F32 center, float radius);
+
+		/**
+		 * Remove all the contours.
+		 * The memory is kept, so the path can be built again without allocating.
+		 */
+		void clear();
+
+		/**
+		 * Get the verbs.
+		 *
+		 * @return The verbs.
+		 */
+		[[nodiscard]] std::span<const PathVerb> getVerbs() const { return m_Verbs; }
+
+		/**
+		 * Get the points used by the verbs.
+		 *
+		 * @return The points.
+		 */
+		[[nodiscard]] std::span<const Point2D_F32> getPoints() const { return m_Points; }
+
+		/**
+		 * Get the number of segments (lines and curves) in the path.
+		 *
+		 * @return The segment count.
+		 */
+		[[nodiscard]] uint64_t getSegmentCount() const { return m_SegmentCount; }
+
+		/**
+		 * Check if the path is empty.
+		 *
+		 * @return Whether the path has no segments.
+		 */
+		[[nodiscard]] bool isEmpty() const { return m_SegmentCount == 0; }
+
+	private:
+		/**
+		 * Make sure there is a current point, starting a contour at the origin if there isn't one.
+		 */
+		void ensureContour();
+
+	private:
+		std::vector<PathVerb> m_Verbs;
+		std::vector<Point2D_F32> m_Points;
+
+		Point2D_F32 m_ContourStart;
+		uint64_t m_SegmentCount = 0;
+		bool m_HasCurrentPoint = false;
+	};
+}
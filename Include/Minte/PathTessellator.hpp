@@ -0,0 +1,219 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Path.hpp"
+
+#include <limits>
+
+namespace minte
+{
+	/**
+	 * Fill rule enum.
+	 * This decides which areas of a path with overlapping contours are inside.
+	 */
+	enum class FillRule : uint8_t
+	{
+		NonZero,
+		EvenOdd
+	};
+
+	/**
+	 * Line join enum.
+	 */
+	enum class LineJoin : uint8_t
+	{
+		Miter,
+		Round,
+		Bevel
+	};
+
+	/**
+	 * Line cap enum.
+	 */
+	enum class LineCap : uint8_t
+	{
+		Butt,
+		Round,
+		Square
+	};
+
+	/**
+	 * Stroke style structure.
+	 */
+	struct StrokeStyle final
+	{
+		float m_Width = 1.0f;
+		LineJoin m_Join = LineJoin::Miter;
+		LineCap m_Cap = LineCap::Butt;
+		float m_MiterLimit = 4.0f;	// The longest miter allowed, relative to the width. Longer miters are beveled.
+	};
+
+	/**
+	 * Path tessellator class.
+	 * This converts paths to triangles, appending them straight to a drawable's vertex and index buffers.
+	 *
+	 * Curves are flattened adaptively so that the lines are never further than the tolerance from the curve, four points at a time where SIMD
+	 * is available. Fills are split into horizontal trapezoids at every vertex and edge crossing, which handles self intersecting paths and both
+	 * fill rules. Convex contours skip the sweep and are drawn as a fan. Strokes are drawn as a quad per line, with joins and caps added
+	 * between them.
+	 *
+	 * The tessellator keeps its scratch buffers between calls, so tessellating paths of similar sizes does not allocate. It's not thread safe.
+	 */
+	class PathTessellator final
+	{
+		/**
+		 * Contour structure.
+		 * This is a range of flattened points.
+		 */
+		struct Contour final
+		{
+			uint32_t m_FirstPoint = 0;
+			uint32_t m_PointCount = 0;
+			bool m_IsClosed = false;
+		};
+
+		/**
+		 * Edge structure.
+		 * This is a non horizontal line of a fill, going down from its top point.
+		 */
+		struct Edge final
+		{
+			float m_Top = 0.0f;
+			float m_Bottom = 0.0f;
+			float m_X = 0.0f;	// The X coordinate at the top.
+			float m_Slope = 0.0f;	// The change of X per unit of Y.
+			int32_t m_Winding = 0;	// 1 if the line goes down, -1 if it goes up.
+
+			Index m_LastVertex = 0;	// The last vertex emitted on the edge, which is shared with the next trapezoid.
+			float m_LastVertexY = -std::numeric_limits<float>::infinity();
+
+			/**
+			 * Get the X coordinate of the edge at a height.
+			 *
+			 * @param y The Y coordinate.
+			 * @return The X coordinate.
+			 */
+			[[nodiscard]] float getX(float y) const { return m_X + (y - m_Top) * m_Slope; }
+		};
+
+	public:
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param tolerance The largest distance allowed between a curve and its lines, in pixels.
+		 */
+		explicit PathTessellator(float tolerance = 0.25f);
+
+		/**
+		 * Set the flattening tolerance.
+		 *
+		 * @param tolerance The largest distance allowed between a curve and its lines, in pixels. This is clamped to at least 0.01.
+		 */
+		void setTolerance(float tolerance);
+
+		/**
+		 * Get the flattening tolerance.
+		 *
+		 * @return The tolerance.
+		 */
+		[[nodiscard]] float getTolerance() const { return m_Tolerance; }
+
+		/**
+		 * Tessellate the inside of a path.
+		 * Open contours are closed with a line to their first point.
+		 *
+		 * @param path The path to fill.
+		 * @param rule The fill rule.
+		 * @param color The color of the vertices (R8G8B8A8).
+		 * @param vertices The vertices to append to.
+		 * @param indices The indices to append to. The indices are relative to the beginning of the vertices.
+		 */
+		void fill(const Path& path, FillRule rule, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices);
+
+		/**
+		 * Tessellate the outline of a path.
+		 * The triangles of neighboring lines overlap at the joins, so translucent strokes should be drawn to a layer of their own.
+		 *
+		 * @param path The path to stroke.
+		 * @param style The stroke style.
+		 * @param color The color of the vertices (R8G8B8A8).
+		 * @param vertices The vertices to append to.
+		 * @param indices The indices to append to. The indices are relative to the beginning of the vertices.
+		 */
+		void stroke(const Path& path, const StrokeStyle& style, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices);
+
+	private:
+		/**
+		 * Flatten the path to the point scratch.
+		 *
+		 * @param path The path to flatten.
+		 */
+		void flatten(const Path& path);
+
+		/**
+		 * Flatten a cubic curve, appending all but its first point.
+		 *
+		 * @param p0 The start point.
+		 * @param p1 The first control point.
+		 * @param p2 The second control point.
+		 * @param p3 The end point.
+		 */
+		void flattenCubic(Point2D_F32 p0, Point2D_F32 p1, Point2D_F32 p2, Point2D_F32 p3);
+
+		/**
+		 * Fill a convex contour with a triangle fan.
+		 *
+		 * @param contour The contour.
+		 * @param color The vertex color.
+		 * @param vertices The vertices to append to.
+		 * @param indices The indices to append to.
+		 */
+		void fillConvex(const Contour& contour, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices) const;
+
+		/**
+		 * Fill the flattened contours using a trapezoid sweep.
+		 *
+		 * @param rule The fill rule.
+		 * @param color The vertex color.
+		 * @param vertices The vertices to append to.
+		 * @param indices The indices to append to.
+		 */
+		void fillSweep(FillRule rule, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices);
+
+		/**
+		 * Stroke a single flattened contour.
+		 *
+		 * @param contour The contour.
+		 * @param style The stroke style.
+		 * @param color The vertex color.
+		 * @param vertices The vertices to append to.
+		 * @param indices The indices to append to.
+		 */
+		void strokeContour(const Contour& contour, const StrokeStyle& style, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices) const;
+
+		/**
+		 * Add a round fan around a point, from one offset to another.
+		 *
+		 * @param center The center point.
+		 * @param fromX The X coordinate of the first offset.
+		 * @param fromY The Y coordinate of the first offset.
+		 * @param angle The angle to sweep, in radians. Positive angles sweep clockwise.
+		 * @param halfWidth The radius of the fan.
+		 * @param color The vertex color.
+		 * @param vertices The vertices to append to.
+		 * @param indices The indices to append to.
+		 */
+		void addFan(Point2D_F32 center, float fromX, float fromY, float angle, float halfWidth, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices) const;
+
+	private:
+		std::vector<Point2D_F32> m_Points;
+		std::vector<Contour> m_Contours;
+
+		std::vector<Edge> m_Edges;
+		std::vector<float> m_Events;
+		std::vector<uint32_t> m_ActiveEdges;
+
+		float m_Tolerance = 0.25f;
+	};
+}
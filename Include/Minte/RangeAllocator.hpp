@@ -0,0 +1,106 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace minte
+{
+	/**
+	 * Range allocator class.
+	 * This hands out ranges of a linear buffer, reusing freed ranges using a first fit search.
+	 */
+	class RangeAllocator final
+	{
+		/**
+		 * Free range structure.
+		 */
+		struct FreeRange final
+		{
+			uint64_t m_Offset = 0;
+			uint64_t m_Count = 0;
+		};
+
+	public:
+		/**
+		 * Allocate a new range.
+		 *
+		 * @param count The number of elements in the range.
+		 * @return The offset of the range.
+		 */
+		[[nodiscard]] uint64_t allocate(uint64_t count)
+		{
+			for (auto itr = m_FreeRanges.begin(); itr != m_FreeRanges.end(); ++itr)
+			{
+				if (itr->m_Count >= count)
+				{
+					const uint64_t offset = itr->m_Offset;
+					itr->m_Offset += count;
+					itr->m_Count -= count;
+
+					if (itr->m_Count == 0)
+						m_FreeRanges.erase(itr);
+
+					return offset;
+				}
+			}
+
+			// Nothing fits, so append it to the end.
+			const uint64_t offset = m_Size;
+			m_Size += count;
+			return offset;
+		}
+
+		/**
+		 * Free a range.
+		 *
+		 * @param offset The offset of the range.
+		 * @param count The number of elements in the range.
+		 */
+		void free(uint64_t offset, uint64_t count)
+		{
+			if (count == 0)
+				return;
+
+			// Insert the range sorted by the offset, and merge it with its neighbors.
+			auto itr = std::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), offset, [](const FreeRange& range, uint64_t value) { return range.m_Offset < value; });
+			itr = m_FreeRanges.insert(itr, FreeRange{ offset, count });
+
+			if (auto next = itr + 1; next != m_FreeRanges.end() && itr->m_Offset + itr->m_Count == next->m_Offset)
+			{
+				itr->m_Count += next->m_Count;
+				m_FreeRanges.erase(next);
+			}
+
+			if (itr != m_FreeRanges.begin())
+			{
+				auto previous = itr - 1;
+				if (previous->m_Offset + previous->m_Count == itr->m_Offset)
+				{
+					previous->m_Count += itr->m_Count;
+					itr = m_FreeRanges.erase(itr) - 1;
+				}
+			}
+
+			// Give the last range back to the end of the buffer.
+			if (itr->m_Offset + itr->m_Count == m_Size)
+			{
+				m_Size = itr->m_Offset;
+				m_FreeRanges.erase(itr);
+			}
+		}
+
+		/**
+		 * Get the size of the buffer required to hold all the ranges.
+		 *
+		 * @return The size.
+		 */
+		[[nodiscard]] uint64_t getSize() const { return m_Size; }
+
+	private:
+		std::vector<FreeRange> m_FreeRanges;
+		uint64_t m_Size = 0;
+	};
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Drawable.hpp"
+#include "PathTessellator.hpp"
+
+namespace minte
+{
+	/**
+	 * Shape class.
+	 * This draws a vector path, filled and/or stroked with solid colors.
+	 *
+	 * The path is in the shape's local space, in pixels. It's tessellated when the shape is regenerated, so changing the path or the style
+	 * marks the shape dirty.
+	 */
+	class Shape : public Drawable
+	{
+	public:
+		/**
+		 * Default constructor.
+		 */
+		Shape() = default;
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param path The path to draw.
+		 * @param fillColor The fill color (R8G8B8A8).
+		 * @param rule The fill rule.
+		 */
+		explicit Shape(Path path, uint32_t fillColor, FillRule rule = FillRule::NonZero);
+
+		/**
+		 * Set the path of the shape.
+		 *
+		 * @param path The path.
+		 */
+		void setPath(Path path);
+
+		/**
+		 * Get the path of the shape.
+		 *
+		 * @return The path.
+		 */
+		[[nodiscard]] const Path& getPath() const { return m_Path; }
+
+		/**
+		 * Fill the inside of the path.
+		 *
+		 * @param color The fill color (R8G8B8A8).
+		 * @param rule The fill rule.
+		 */
+		void setFill(uint32_t color, FillRule rule = FillRule::NonZero);
+
+		/**
+		 * Stop filling the inside of the path.
+		 */
+		void clearFill();
+
+		/**
+		 * Stroke the outline of the path.
+		 *
+		 * @param style The stroke style.
+		 * @param color The stroke color (R8G8B8A8).
+		 */
+		void setStroke(const StrokeStyle& style, uint32_t color);
+
+		/**
+		 * Stop stroking the outline of the path.
+		 */
+		void clearStroke();
+
+	protected:
+		/**
+		 * Generate the geometry of the shape.
+		 * The stroke is drawn on top of the fill.
+		 *
+		 * @param vertices The vertices to write to.
+		 * @param indices The indices to write to.
+		 * @param batches The batches to write to.
+		 */
+		void generateGeometry(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<DrawBatch>& batches) const override;
+
+		/**
+		 * Measure the shape.
+		 * This is the bottom right corner of the path's points, including the control points.
+		 *
+		 * @return The size in pixels.
+		 */
+		[[nodiscard]] Point2D_F32 measureContent() const override;
+
+	private:
+		Path m_Path;
+		StrokeStyle m_StrokeStyle;
+
+		uint32_t m_FillColor = 0;
+		uint32_t m_StrokeColor = 0;
+		FillRule m_FillRule = FillRule::NonZero;
+
+		bool m_HasFill = false;
+		bool m_HasStroke = false;
+	};
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "DataTypes.hpp"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace minte
+{
+	/**
+	 * Spatial index class.
+	 * This is a dynamic AABB tree over the bounds of a layer's elements, keyed by the element's slot index.
+	 *
+	 * The leaves store the bounds enlarged by a small margin, so an element that moves a little does not need to be reinserted. The tree is
+	 * kept balanced using rotations, so point and rectangle queries only visit a logarithmic number of nodes. The index is not thread safe and
+	 * is expected to be used by the thread that updates the layer.
+	 */
+	class SpatialIndex final
+	{
+		static constexpr uint32_t NullNode = ~0u;
+		static constexpr float Margin = 4.0f;
+
+		/**
+		 * Tree node structure.
+		 */
+		struct Node final
+		{
+			Rectangle2D_F32 m_Bounds;
+
+			uint32_t m_Parent = NullNode;	// This is the next free node if the node is not in use.
+			uint32_t m_Left = NullNode;
+			uint32_t m_Right = NullNode;
+			uint32_t m_Element = NullNode;
+
+			int32_t m_Height = -1;	// Leaves have a height of 0, and the free nodes -1.
+
+			/**
+			 * Check if the node is a leaf.
+			 *
+			 * @return Whether the node is a leaf.
+			 */
+			[[nodiscard]] bool isLeaf() const { return m_Left == NullNode; }
+		};
+
+	public:
+		/**
+		 * Insert or update the bounds of an element.
+		 * The element is only reinserted if the bounds moved out of its enlarged bounds.
+		 *
+		 * @param element The element's slot index.
+		 * @param bounds The bounds of the element.
+		 */
+		void update(uint32_t element, const Rectangle2D_F32& bounds);
+
+		/**
+		 * Remove an element from the index.
+		 *
+		 * @param element The element's slot index.
+		 */
+		void remove(uint32_t element);
+
+		/**
+		 * Check if an element is in the index.
+		 *
+		 * @param element The element's slot index.
+		 * @return Whether the element is in the index.
+		 */
+		[[nodiscard]] bool contains(uint32_t element) const { return element < m_Leaves.size() && m_Leaves[element] != NullNode; }
+
+		/**
+		 * Query all the elements whose enlarged bounds overlap a rectangle.
+		 * The results are conservative, so the caller should test the exact bounds if it needs to.
+		 *
+		 * @tparam Function The callback type.
+		 * @param rectangle The rectangle to query.
+		 * @param function The function to call with each element's slot index.
+		 */
+		template<class Function>
+		void query(const Rectangle2D_F32& rectangle, Function&& function) const
+		{
+			if (m_Root == NullNode)
+				return;
+
+			// The tree is balanced, so the stack can never be deeper than the height of the tree.
+			std::array<uint32_t, 64> stack;
+			uint32_t stackSize = 0;
+			stack[stackSize++] = m_Root;
+
+			while (stackSize > 0)
+			{
+				const auto& node = m_Nodes[stack[--stackSize]];
+				if (!Overlaps(node.m_Bounds, rectangle))
+					continue;
+
+				if (node.isLeaf())
+				{
+					function(node.m_Element);
+				}
+				else
+				{
+					stack[stackSize++] = node.m_Left;
+					stack[stackSize++] = node.m_Right;
+				}
+			}
+		}
+
+		/**
+		 * Query all the elements whose enlarged bounds contain a point.
+		 *
+		 * @tparam Function The callback type.
+		 * @param point The point to query.
+		 * @param function The function to call with each element's slot index.
+		 */
+		template<class Function>
+		void query(Point2D_F32 point, Function&& function) const { query(Rectangle2D_F32(point, point), std::forward<Function>(function)); }
+
+		/**
+		 * Get the height of the tree.
+		 *
+		 * @return The height. This is 0 if the tree is empty or has a single element.
+		 */
+		[[nodiscard]] uint32_t getHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].m_Height; }
+
+		/**
+		 * Check if two rectangles overlap.
+		 * Touching edges are considered to overlap.
+		 *
+		 * @param lhs The first rectangle.
+		 * @param rhs The second rectangle.
+		 * @return Whether the rectangles overlap.
+		 */
+		[[nodiscard]] static bool Overlaps(const Rectangle2D_F32& lhs, const Rectangle2D_F32& rhs)
+		{
+			return lhs.m_MinPoint.m_X <= rhs.m_MaxPoint.m_X && rhs.m_MinPoint.m_X <= lhs.m_MaxPoint.m_X &&
+				lhs.m_MinPoint.m_Y <= rhs.m_MaxPoint.m_Y && rhs.m_MinPoint.m_Y <= lhs.m_MaxPoint.m_Y;
+		}
+
+	private:
+		/**
+		 * Allocate a new node.
+		 *
+		 * @return The node index.
+		 */
+		[[nodiscard]] uint32_t allocateNode();
+
+		/**
+		 * Release a node.
+		 *
+		 * @param node The node index.
+		 */
+		void freeNode(uint32_t node);
+
+		/**
+		 * Insert a leaf into the tree.
+		 *
+		 * @param leaf The leaf node index.
+		 */
+		void insertLeaf(uint32_t leaf);
+
+		/**
+		 * Remove a leaf from the tree.
+		 * The leaf node itself is not released.
+		 *
+		 * @param leaf The leaf node index.
+		 */
+		void removeLeaf(uint32_t leaf);
+
+		/**
+		 * Refit and rebalance the ancestors of a node.
+		 *
+		 * @param node The first node to refit.
+		 */
+		void refit(uint32_t node);
+
+		/**
+		 * Rotate a node if its subtrees are not balanced.
+		 *
+		 * @param node The node index.
+		 * @return The index of the node that took its place.
+		 */
+		[[nodiscard]] uint32_t balance(uint32_t node);
+
+	private:
+		std::vector<Node> m_Nodes;
+		std::vector<uint32_t> m_Leaves;	// The leaf node of each element, indexed by the slot index.
+
+		uint32_t m_Root = NullNode;
+		uint32_t m_FreeList = NullNode;
+	};
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Drawable.hpp"
+#include "GlyphAtlas.hpp"
+#include "TextLayout.hpp"
+
+namespace minte
+{
+	/**
+	 * Text class.
+	 * This draws a block of text using the layer's glyph atlas.
+	 *
+	 * The layout of the text is looked up in the layer's text layout cache, so labels with the same text share their shaped glyphs. Text that is
+	 * edited using replaceText() owns its layout instead, so that edits only reflow the changed lines.
+	 */
+	class Text : public Drawable
+	{
+	public:
+		/**
+		 * Default constructor.
+		 */
+		Text() = default;
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param pFont The font.
+		 * @param text The UTF-8 text.
+		 * @param size The font size in pixels.
+		 * @param color The color of the text (R8G8B8A8).
+		 * @param mode The glyph mode. Default is coverage.
+		 */
+		explicit Text(std::shared_ptr<Font> pFont, std::string text, float size, uint32_t color, GlyphMode mode = GlyphMode::Coverage);
+
+		/**
+		 * Set the text.
+		 *
+		 * @param text The UTF-8 text.
+		 */
+		void setText(std::string text);
+
+		/**
+		 * Replace a part of the text.
+		 * This will throw a FrontendError if the range is outside the text, or does not start and end at code point boundaries.
+		 *
+		 * @param offset The byte offset of the range.
+		 * @param count The number of bytes to replace.
+		 * @param text The UTF-8 text to insert.
+		 */
+		void replaceText(uint32_t offset, uint32_t count, std::string_view text);
+
+		/**
+		 * Get the text.
+		 *
+		 * @return The text.
+		 */
+		[[nodiscard]] const std::string& getText() const { return m_pParagraph ? m_pParagraph->getText() : m_Text; }
+
+		/**
+		 * Set the font size.
+		 *
+		 * @param size The size in pixels.
+		 */
+		void setFontSize(float size);
+
+		/**
+		 * Get the font size.
+		 *
+		 * @return The size in pixels.
+		 */
+		[[nodiscard]] float getFontSize() const { return m_Size; }
+
+		/**
+		 * Set the width the lines are wrapped at.
+		 *
+		 * @param wrapWidth The wrap width in pixels. Set this to 0 to only break the lines at line feeds.
+		 */
+		void setWrapWidth(float wrapWidth);
+
+		/**
+		 * Get the width the lines are wrapped at.
+		 *
+		 * @return The wrap width.
+		 */
+		[[nodiscard]] float getWrapWidth() const { return m_WrapWidth; }
+
+		/**
+		 * Set the color of the text.
+		 *
+		 * @param color The color (R8G8B8A8).
+		 */
+		void setColor(uint32_t color);
+
+		/**
+		 * Get the color of the text.
+		 *
+		 * @return The color.
+		 */
+		[[nodiscard]] uint32_t getColor() const { return m_Color; }
+
+	protected:
+		/**
+		 * Generate the quads of the glyphs.
+		 * The quads are batched by their atlas page. Glyphs that are not in the atlas yet are skipped, and are drawn once the atlas changes.
+		 *
+		 * @param vertices The vertices to write to.
+		 * @param indices The indices to write to.
+		 * @param batches The batches to write to.
+		 */
+		void generateGeometry(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<DrawBatch>& batches) const override;
+
+		/**
+		 * Measure the size of the text.
+		 *
+		 * @return The size of the laid out lines.
+		 */
+		[[nodiscard]] Point2D_F32 measureContent() const override;
+
+		/**
+		 * Text uses the glyph atlas.
+		 *
+		 * @return True.
+		 */
+		[[nodiscard]] bool usesGlyphAtlas() const override { return true; }
+
+	private:
+		/**
+		 * Get the layout of the text.
+		 *
+		 * @param layout The layout to write to.
+		 * @return Whether the layout is available. This is false if the text uses the layer's cache and is not attached.
+		 */
+		bool getLayout(TextLayout& layout) const;
+
+		/**
+		 * Mark the content and the layout dirty.
+		 */
+		void invalidate();
+
+	private:
+		std::shared_ptr<Font> m_pFont = nullptr;
+		std::string m_Text;
+		std::unique_ptr<ParagraphLayout> m_pParagraph = nullptr;
+
+		mutable std::vector<uint8_t> m_QuadSlots;	// Scratch used to batch the quads.
+
+		float m_Size = 0.0f;
+		float m_WrapWidth = 0.0f;
+		uint32_t m_Color = 0;
+		GlyphMode m_Mode = GlyphMode::Coverage;
+	};
+}
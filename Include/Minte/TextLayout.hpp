@@ -0,0 +1,264 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Font.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace minte
+{
+	/**
+	 * Shaped glyph structure.
+	 * This is a single glyph of a shaped run.
+	 */
+	struct ShapedGlyph final
+	{
+		/**
+		 * Glyph flags.
+		 */
+		enum Flags : uint8_t
+		{
+			None = 0,
+			Whitespace = 1 << 0,	// The glyph is not drawn, and does not count towards the width at the end of a line.
+			BreakAfter = 1 << 1,	// A line can be broken after the glyph.
+			LineFeed = 1 << 2		// A line must be broken after the glyph.
+		};
+
+		float m_Advance = 0.0f;		// The advance in pixels, including the kerning with the next glyph.
+		uint32_t m_GlyphIndex = 0;
+		uint32_t m_Offset = 0;		// The byte offset of the glyph's code point in the text.
+		uint8_t m_Flags = Flags::None;
+	};
+
+	/**
+	 * Text line structure.
+	 */
+	struct TextLine final
+	{
+		uint32_t m_FirstGlyph = 0;
+		uint32_t m_GlyphCount = 0;
+		float m_Width = 0.0f;	// The width in pixels, excluding the trailing whitespace.
+	};
+
+	/**
+	 * Text layout structure.
+	 * This is a view of shaped and line broken text. It's valid till the owner of the glyphs and lines changes.
+	 */
+	struct TextLayout final
+	{
+		std::span<const ShapedGlyph> m_Glyphs;
+		std::span<const TextLine> m_Lines;
+
+		FontMetrics m_Metrics;
+		float m_LineHeight = 0.0f;
+		Point2D_F32 m_Size;	// The width of the widest line, and the height of all the lines.
+	};
+
+	/**
+	 * Text layout cache class.
+	 * This caches the shaped runs of text, and the lines they are broken to.
+	 *
+	 * Shaped runs (the glyph indices, advances and break opportunities) are cached by the text, font and size, and the lines are cached by the
+	 * run and the wrap width, so resizing text only breaks it again. Looking up cached text does not allocate. Entries that were not used
+	 * recently are removed by the update once the cache grows past its capacity.
+	 */
+	class TextLayoutCache final
+	{
+		/**
+		 * Shaped run structure.
+		 */
+		struct Run final
+		{
+			std::string m_Text;
+			std::vector<ShapedGlyph> m_Glyphs;
+
+			uint64_t m_LastUsedFrame = 0;
+			uint64_t m_Version = 0;	// This is changed when the run is shaped again for another text with the same key.
+			uint32_t m_FontID = 0;
+			float m_Size = 0.0f;
+		};
+
+		/**
+		 * Line break structure.
+		 */
+		struct Lines final
+		{
+			std::vector<TextLine> m_Lines;
+			float m_Width = 0.0f;
+
+			uint64_t m_RunKey = 0;
+			uint64_t m_RunVersion = 0;
+			uint64_t m_LastUsedFrame = 0;
+			float m_WrapWidth = 0.0f;
+		};
+
+	public:
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param capacity The number of runs kept after an update. Default is 4096.
+		 */
+		explicit TextLayoutCache(uint32_t capacity = 4096) : m_Capacity(capacity) {}
+
+		/**
+		 * Get the layout of a text.
+		 * The text is shaped and broken to lines if it's not in the cache.
+		 *
+		 * @param pFont The font.
+		 * @param text The UTF-8 text.
+		 * @param size The font size in pixels.
+		 * @param wrapWidth The width the lines are wrapped at. Set this to 0 to only break the lines at line feeds.
+		 * @return The layout. This is valid till the next update.
+		 */
+		[[nodiscard]] TextLayout getLayout(const std::shared_ptr<Font>& pFont, std::string_view text, float size, float wrapWidth);
+
+		/**
+		 * Remove the least recently used entries if the cache is over capacity.
+		 * This should be called once per frame.
+		 */
+		void update();
+
+		/**
+		 * Get the number of cached runs.
+		 *
+		 * @return The run count.
+		 */
+		[[nodiscard]] uint64_t getRunCount() const { return m_Runs.size(); }
+
+		/**
+		 * Get the number of lookups that were found in the cache.
+		 *
+		 * @return The hit count.
+		 */
+		[[nodiscard]] uint64_t getHitCount() const { return m_HitCount; }
+
+		/**
+		 * Get the number of lookups that had to shape or break the text.
+		 *
+		 * @return The miss count.
+		 */
+		[[nodiscard]] uint64_t getMissCount() const { return m_MissCount; }
+
+	private:
+		/**
+		 * Remove the least recently used entries of a map.
+		 *
+		 * @tparam Entry The entry type.
+		 * @param entries The entries.
+		 * @param capacity The number of entries to keep.
+		 */
+		template<class Entry>
+		void trim(std::unordered_map<uint64_t, Entry>& entries, uint64_t capacity);
+
+	private:
+		std::unordered_map<uint64_t, Run> m_Runs;
+		std::unordered_map<uint64_t, Lines> m_Lines;
+		std::vector<uint64_t> m_Frames;	// Scratch used when trimming.
+
+		uint64_t m_Frame = 1;
+		uint64_t m_Version = 0;
+		uint64_t m_HitCount = 0;
+		uint64_t m_MissCount = 0;
+
+		uint32_t m_Capacity = 4096;
+	};
+
+	/**
+	 * Paragraph layout class.
+	 * This owns an editable text and its layout.
+	 *
+	 * Edits only shape the changed glyphs, and only break the lines from the line before the edit till the new lines meet the old ones again,
+	 * so typing into a long paragraph costs about the same as typing into a short one. Editable text is not put in the layout cache, since
+	 * every edit would add a new entry.
+	 */
+	class ParagraphLayout final
+	{
+	public:
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param pFont The font.
+		 * @param size The font size in pixels.
+		 * @param wrapWidth The width the lines are wrapped at. Set this to 0 to only break the lines at line feeds.
+		 */
+		explicit ParagraphLayout(std::shared_ptr<Font> pFont, float size, float wrapWidth);
+
+		/**
+		 * Replace the whole text.
+		 *
+		 * @param text The UTF-8 text.
+		 */
+		void setText(std::string_view text);
+
+		/**
+		 * Replace a part of the text.
+		 * This will throw a FrontendError if the range is outside the text, or does not start and end at code point boundaries.
+		 *
+		 * @param offset The byte offset of the range.
+		 * @param count The number of bytes to replace.
+		 * @param text The UTF-8 text to insert.
+		 */
+		void replace(uint32_t offset, uint32_t count, std::string_view text);
+
+		/**
+		 * Set the width the lines are wrapped at.
+		 * This breaks all the lines again, without shaping the text.
+		 *
+		 * @param wrapWidth The wrap width.
+		 */
+		void setWrapWidth(float wrapWidth);
+
+		/**
+		 * Get the text.
+		 *
+		 * @return The text.
+		 */
+		[[nodiscard]] const std::string& getText() const { return m_Text; }
+
+		/**
+		 * Get the layout of the text.
+		 *
+		 * @return The layout. This is valid till the text is changed.
+		 */
+		[[nodiscard]] TextLayout getLayout() const;
+
+		/**
+		 * Get the number of lines that were broken by the last change.
+		 *
+		 * @return The line count.
+		 */
+		[[nodiscard]] uint32_t getReflowedLineCount() const { return m_ReflowedLineCount; }
+
+	private:
+		/**
+		 * Break the lines from a line onwards.
+		 * The lines after the change which start at the same glyph as before are reused.
+		 *
+		 * @param firstLine The first line to break.
+		 * @param changeEnd The first glyph after the changed glyphs.
+		 * @param glyphDelta The change in the glyph count.
+		 */
+		void reflow(uint32_t firstLine, uint32_t changeEnd, int64_t glyphDelta);
+
+	private:
+		std::shared_ptr<Font> m_pFont = nullptr;
+		std::string m_Text;
+
+		std::vector<ShapedGlyph> m_Glyphs;
+		std::vector<TextLine> m_Lines;
+
+		// Scratch used by the edits.
+		std::vector<ShapedGlyph> m_GlyphScratch;
+		std::vector<TextLine> m_LineScratch;
+
+		float m_Size = 0.0f;
+		float m_WrapWidth = 0.0f;
+		float m_Width = 0.0f;
+
+		uint32_t m_ReflowedLineCount = 0;
+	};
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+
+namespace minte
+{
+	/**
+	 * Thread pool class.
+	 * This contains a set of worker threads which execute the submitted jobs in the order they were submitted.
+	 */
+	class ThreadPool final
+	{
+	public:
+		using Job = std::function<void()>;
+
+		/**
+		 * Explicit constructor.
+		 *
+		 * @param threadCount The number of worker threads. Default is the number of hardware threads.
+		 */
+		explicit ThreadPool(uint32_t threadCount = std::thread::hardware_concurrency());
+
+		/**
+		 * Destructor.
+		 * This will execute all the remaining jobs before returning.
+		 */
+		~ThreadPool();
+
+		/**
+		 * Submit a new job to the pool.
+		 *
+		 * @param job The job to execute.
+		 */
+		void submit(Job&& job);
+
+		/**
+		 * Wait till all the submitted jobs are executed.
+		 */
+		void wait();
+
+		/**
+		 * Get the number of worker threads.
+		 *
+		 * @return The thread count.
+		 */
+		[[nodiscard]] uint32_t getThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+	private:
+		/**
+		 * Worker function.
+		 * This is executed by all the worker threads.
+		 *
+		 * @param stopToken The stop token used to stop the worker.
+		 */
+		void worker(std::stop_token stopToken);
+
+	private:
+		std::vector<std::jthread> m_Workers;
+		std::deque<Job> m_Jobs;
+
+		std::mutex m_Mutex;
+		std::condition_variable_any m_JobCondition;
+		std::condition_variable m_IdleCondition;
+
+		uint32_t m_ActiveJobs = 0;
+	};
+}
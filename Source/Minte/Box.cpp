@@ -0,0 +1,33 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Box.hpp"
+
+namespace minte
+{
+	Box::Box(Point2D<float> size, uint32_t color)
+		: m_Size(size), m_Color(color)
+	{
+	}
+
+	void Box::setSize(Point2D<float> size)
+	{
+		m_Size = size;
+		markDirty();
+	}
+
+	void Box::setColor(uint32_t color)
+	{
+		m_Color = color;
+		markDirty();
+	}
+
+	void Box::generateGeometry(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<DrawBatch>& batches) const
+	{
+		vertices.emplace_back(Vertex{ Point2D<float>(0.0f, 0.0f), Point2D<float>(0.0f, 0.0f), m_Color });
+		vertices.emplace_back(Vertex{ Point2D<float>(m_Size.m_X, 0.0f), Point2D<float>(1.0f, 0.0f), m_Color });
+		vertices.emplace_back(Vertex{ Point2D<float>(m_Size.m_X, m_Size.m_Y), Point2D<float>(1.0f, 1.0f), m_Color });
+		vertices.emplace_back(Vertex{ Point2D<float>(0.0f, m_Size.m_Y), Point2D<float>(0.0f, 1.0f), m_Color });
+
+		indices.insert(indices.end(), { 0, 1, 2, 2, 3, 0 });
+	}
+}
@@ -0,0 +1,31 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/CpuBackend/CpuImageBuffer.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		CpuImageBuffer::CpuImageBuffer(const std::shared_ptr<CpuInstance>& pInstance, uint64_t size, ResourceCategory category /*= ResourceCategory::Attachment*/)
+			: ImageBuffer(pInstance, size), m_pData(std::make_unique<std::byte[]>(size)), m_Category(category)
+		{
+			pInstance->registerAllocation(m_Category, m_Size);
+		}
+
+		CpuImageBuffer::~CpuImageBuffer()
+		{
+			getInstance()->unregisterAllocation(m_Category, m_Size);
+		}
+
+		std::byte* CpuImageBuffer::mapMemory()
+		{
+			m_IsMapped = true;
+			return m_pData.get();
+		}
+
+		void CpuImageBuffer::unmapMemory()
+		{
+			m_IsMapped = false;
+		}
+	}
+}
@@ -0,0 +1,28 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/CpuBackend/CpuInstance.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		CpuInstance::CpuInstance(uint32_t threadCount /*= std::thread::hardware_concurrency()*/)
+		{
+			// The drawing thread rasterizes too, so the pool only needs the other threads.
+			if (threadCount > 1)
+				m_pThreadPool = std::make_unique<ThreadPool>(threadCount - 1);
+		}
+
+		MemoryStatistics CpuInstance::getMemoryStatistics() const
+		{
+			MemoryStatistics statistics;
+			fillTrackedStatistics(statistics);
+
+			auto& heap = statistics.m_Heaps.emplace_back();
+			heap.m_Allocated = statistics.getTotalBytes();
+			heap.m_Usage = heap.m_Allocated;
+
+			return statistics;
+		}
+	}
+}
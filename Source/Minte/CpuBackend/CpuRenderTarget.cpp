@@ -0,0 +1,1008 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/CpuBackend/CpuRenderTarget.hpp"
+#include "Minte/Backend/CpuBackend/CpuImageBuffer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINTE_CPU_SSE2
+#include <emmintrin.h>
+
+#endif
+
+namespace /* anonymous */
+{
+	constexpr int32_t SubpixelScale = 256;
+	constexpr float MaximumCoordinate = 32768.0f;
+
+	using Color = std::array<float, 4>;
+
+	/**
+	 * Snap a coordinate to the subpixel grid.
+	 * Coordinates are clamped to +-32768 pixels, which keeps the edge functions exact.
+	 *
+	 * @param value The coordinate in pixels.
+	 * @return The coordinate in 1/256 of a pixel.
+	 */
+	double SnapCoordinate(float value)
+	{
+		// NaN fails both comparisons of the clamp, so it's replaced by the origin.
+		if (std::isnan(value))
+			return 0.0;
+
+		return std::nearbyint(static_cast<double>(std::clamp(value, -MaximumCoordinate, MaximumCoordinate)) * SubpixelScale);
+	}
+
+	/**
+	 * Convert a value in the [0, 1] range to 8 bits, the way a UNORM attachment stores it.
+	 *
+	 * @param value The value.
+	 * @return The 8 bit value.
+	 */
+	uint8_t ToUnorm8(float value)
+	{
+		return static_cast<uint8_t>(std::nearbyint(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+	}
+
+	/**
+	 * Sample the red channel of a mip level using bilinear filtering and clamp to edge addressing.
+	 *
+	 * @param pTexture The texture.
+	 * @param level The mip level.
+	 * @param u The horizontal texture coordinate.
+	 * @param v The vertical texture coordinate.
+	 * @return The red channel in the [0, 1] range.
+	 */
+	float SampleLevelRed(const minte::backend::CpuTexture* pTexture, uint32_t level, float u, float v)
+	{
+		const auto width = static_cast<int32_t>(pTexture->getMipWidth(level));
+		const auto height = static_cast<int32_t>(pTexture->getMipHeight(level));
+		const auto pixelSize = pTexture->getPixelSize();
+		const auto& pixels = pTexture->getPixels(level);
+
+		const auto x = std::clamp(u * width - 0.5f, -1.0f, static_cast<float>(width));
+		const auto y = std::clamp(v * height - 0.5f, -1.0f, static_cast<float>(height));
+		const auto left = static_cast<int32_t>(std::floor(x));
+		const auto top = static_cast<int32_t>(std::floor(y));
+		const auto fractionX = x - left;
+		const auto fractionY = y - top;
+
+		const auto x0 = std::clamp(left, 0, width - 1), x1 = std::clamp(left + 1, 0, width - 1);
+		const auto y0 = std::clamp(top, 0, height - 1), y1 = std::clamp(top + 1, 0, height - 1);
+		const auto texel = [&](int32_t column, int32_t row) { return pixels[(static_cast<size_t>(row) * width + column) * pixelSize] / 255.0f; };
+
+		const auto upper = texel(x0, y0) + (texel(x1, y0) - texel(x0, y0)) * fractionX;
+		const auto lower = texel(x0, y1) + (texel(x1, y1) - texel(x0, y1)) * fractionX;
+		return upper + (lower - upper) * fractionY;
+	}
+
+	/**
+	 * Sample all the channels of an RGBA mip level using bilinear filtering and clamp to edge addressing.
+	 *
+	 * @param pTexture The texture.
+	 * @param level The mip level.
+	 * @param u The horizontal texture coordinate.
+	 * @param v The vertical texture coordinate.
+	 * @return The color in the [0, 1] range.
+	 */
+	Color SampleLevelColor(const minte::backend::CpuTexture* pTexture, uint32_t level, float u, float v)
+	{
+		const auto width = static_cast<int32_t>(pTexture->getMipWidth(level));
+		const auto height = static_cast<int32_t>(pTexture->getMipHeight(level));
+		const auto& pixels = pTexture->getPixels(level);
+
+		const auto x = std::clamp(u * width - 0.5f, -1.0f, static_cast<float>(width));
+		const auto y = std::clamp(v * height - 0.5f, -1.0f, static_cast<float>(height));
+		const auto left = static_cast<int32_t>(std::floor(x));
+		const auto top = static_cast<int32_t>(std::floor(y));
+		const auto fractionX = x - left;
+		const auto fractionY = y - top;
+
+		const auto x0 = std::clamp(left, 0, width - 1), x1 = std::clamp(left + 1, 0, width - 1);
+		const auto y0 = std::clamp(top, 0, height - 1), y1 = std::clamp(top + 1, 0, height - 1);
+		const auto* pTopLeft = pixels.data() + (static_cast<size_t>(y0) * width + x0) * 4;
+		const auto* pTopRight = pixels.data() + (static_cast<size_t>(y0) * width + x1) * 4;
+		const auto* pBottomLeft = pixels.data() + (static_cast<size_t>(y1) * width + x0) * 4;
+		const auto* pBottomRight = pixels.data() + (static_cast<size_t>(y1) * width + x1) * 4;
+
+		Color color = {};
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			const auto upper = pTopLeft[channel] + (pTopRight[channel] - pTopLeft[channel]) * fractionX;
+			const auto lower = pBottomLeft[channel] + (pBottomRight[channel] - pBottomLeft[channel]) * fractionX;
+			color[channel] = (upper + (lower - upper) * fractionY) / 255.0f;
+		}
+
+		return color;
+	}
+
+	/**
+	 * Get the level of detail of a texture for a triangle, like the Vulkan backend's implicit level of detail.
+	 * The texture coordinates are interpolated linearly, so the level is the same over the whole triangle.
+	 *
+	 * @param pTexture The texture.
+	 * @param gradientX The change of the texture coordinates per pixel to the right.
+	 * @param gradientY The change of the texture coordinates per pixel down.
+	 * @return The level of detail. Levels up to 0 are magnified, and use the first level.
+	 */
+	float GetLevelOfDetail(const minte::backend::CpuTexture* pTexture, minte::Point2D_F32 gradientX, minte::Point2D_F32 gradientY)
+	{
+		if (pTexture == nullptr || pTexture->getMipLevels() == 1)
+			return 0.0f;
+
+		const auto width = static_cast<float>(pTexture->getWidth());
+		const auto height = static_cast<float>(pTexture->getHeight());
+		const auto scale = std::max(std::hypot(gradientX.m_X * width, gradientX.m_Y * height), std::hypot(gradientY.m_X * width, gradientY.m_Y * height));
+		return scale > 0.0f ? std::log2(scale) : 0.0f;
+	}
+
+	/**
+	 * Sample the red channel of a texture using trilinear filtering and clamp to edge addressing.
+	 *
+	 * @param pTexture The texture. Empty slots sample an opaque white pixel.
+	 * @param u The horizontal texture coordinate.
+	 * @param v The vertical texture coordinate.
+	 * @param lod The level of detail. Default is 0.
+	 * @return The red channel in the [0, 1] range.
+	 */
+	float SampleRed(const minte::backend::CpuTexture* pTexture, float u, float v, float lod = 0.0f)
+	{
+		if (pTexture == nullptr)
+			return 1.0f;
+
+		if (lod <= 0.0f)
+			return SampleLevelRed(pTexture, 0, u, v);
+
+		// Blend the two closest levels.
+		const auto level = std::min(lod, static_cast<float>(pTexture->getMipLevels() - 1));
+		const auto upper = static_cast<uint32_t>(level);
+		const auto fraction = level - upper;
+		const auto sample = SampleLevelRed(pTexture, upper, u, v);
+		if (fraction == 0.0f)
+			return sample;
+
+		return sample + (SampleLevelRed(pTexture, upper + 1, u, v) - sample) * fraction;
+	}
+
+	/**
+	 * Sample all the channels of a texture using trilinear filtering and clamp to edge addressing.
+	 * R8 textures sample as (r, 0, 0, 1), like the Vulkan backend.
+	 *
+	 * @param pTexture The texture. Empty slots sample an opaque white pixel.
+	 * @param u The horizontal texture coordinate.
+	 * @param v The vertical texture coordinate.
+	 * @param lod The level of detail. Default is 0.
+	 * @return The color in the [0, 1] range.
+	 */
+	Color SampleColor(const minte::backend::CpuTexture* pTexture, float u, float v, float lod = 0.0f)
+	{
+		if (pTexture == nullptr)
+			return { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		if (pTexture->getFormat() == minte::backend::TextureFormat::R8)
+			return { SampleRed(pTexture, u, v, lod), 0.0f, 0.0f, 1.0f };
+
+		if (lod <= 0.0f)
+			return SampleLevelColor(pTexture, 0, u, v);
+
+		// Blend the two closest levels.
+		const auto level = std::min(lod, static_cast<float>(pTexture->getMipLevels() - 1));
+		const auto upper = static_cast<uint32_t>(level);
+		const auto fraction = level - upper;
+		auto color = SampleLevelColor(pTexture, upper, u, v);
+		if (fraction == 0.0f)
+			return color;
+
+		const auto lower = SampleLevelColor(pTexture, upper + 1, u, v);
+		for (uint32_t channel = 0; channel < 4; channel++)
+			color[channel] += (lower[channel] - color[channel]) * fraction;
+
+		return color;
+	}
+
+	/**
+	 * Blend a color over a pixel and store it.
+	 * The color is (source * alpha + destination * (1 - alpha)), and the alpha is (alpha + destination * (1 - alpha)), like the Vulkan
+	 * pipeline's blend state.
+	 *
+	 * @param pPixel The RGBA pixel.
+	 * @param color The source color.
+	 */
+	void BlendPixel(uint8_t* pPixel, const Color& color)
+	{
+#ifdef MINTE_CPU_SSE2
+		const auto zero = _mm_setzero_ps();
+		const auto one = _mm_set1_ps(1.0f);
+		const auto source = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(color.data()), zero), one);
+		const auto alpha = _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3));
+
+		// The alpha channel is multiplied by one instead of itself.
+		const auto alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+		const auto sourceFactor = _mm_or_ps(_mm_andnot_ps(alphaMask, alpha), _mm_and_ps(alphaMask, one));
+
+		int32_t packed = 0;
+		std::memcpy(&packed, pPixel, sizeof(packed));
+		auto destination = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), _mm_setzero_si128());
+		destination = _mm_unpacklo_epi16(destination, _mm_setzero_si128());
+
+		const auto scale = _mm_set1_ps(255.0f);
+		const auto blended = _mm_add_ps(_mm_mul_ps(source, sourceFactor), _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(destination), _mm_set1_ps(1.0f / 255.0f)), _mm_sub_ps(one, alpha)));
+
+		// The conversion rounds to nearest even, which is what std::nearbyint does in the scalar path.
+		auto result = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(blended, one), scale));
+		result = _mm_packs_epi32(result, result);
+		result = _mm_packus_epi16(result, result);
+
+		packed = _mm_cvtsi128_si32(result);
+		std::memcpy(pPixel, &packed, sizeof(packed));
+
+#else
+		const auto alpha = std::clamp(color[3], 0.0f, 1.0f);
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			const auto source = std::clamp(color[channel], 0.0f, 1.0f) * (channel == 3 ? 1.0f : alpha);
+			pPixel[channel] = ToUnorm8(source + pPixel[channel] * (1.0f / 255.0f) * (1.0f - alpha));
+		}
+
+#endif
+	}
+
+	/**
+	 * Add a weighted RGBA pixel to a color.
+	 *
+	 * @param color The color to add to.
+	 * @param pPixel The RGBA pixel.
+	 * @param weight The weight of the pixel.
+	 */
+	void AccumulatePixel(Color& color, const uint8_t* pPixel, float weight)
+	{
+#ifdef MINTE_CPU_SSE2
+		int32_t packed = 0;
+		std::memcpy(&packed, pPixel, sizeof(packed));
+		auto pixel = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), _mm_setzero_si128());
+		pixel = _mm_unpacklo_epi16(pixel, _mm_setzero_si128());
+
+		_mm_storeu_ps(color.data(), _mm_add_ps(_mm_loadu_ps(color.data()), _mm_mul_ps(_mm_cvtepi32_ps(pixel), _mm_set1_ps(weight))));
+
+#else
+		for (uint32_t channel = 0; channel < 4; channel++)
+			color[channel] += pPixel[channel] * weight;
+
+#endif
+	}
+
+	/**
+	 * Add a weighted color to another.
+	 *
+	 * @param color The color to add to.
+	 * @param source The color to add.
+	 * @param weight The weight of the source color.
+	 */
+	void AccumulateColor(Color& color, const Color& source, float weight)
+	{
+#ifdef MINTE_CPU_SSE2
+		_mm_storeu_ps(color.data(), _mm_add_ps(_mm_loadu_ps(color.data()), _mm_mul_ps(_mm_loadu_ps(source.data()), _mm_set1_ps(weight))));
+
+#else
+		for (uint32_t channel = 0; channel < 4; channel++)
+			color[channel] += source[channel] * weight;
+
+#endif
+	}
+
+	/**
+	 * Store a color to a pixel.
+	 *
+	 * @param pPixel The RGBA pixel.
+	 * @param color The color, in the [0, 255] range. Values outside of it are clamped.
+	 */
+	void StorePixel(uint8_t* pPixel, const Color& color)
+	{
+#ifdef MINTE_CPU_SSE2
+		// The conversion rounds to nearest even like std::nearbyint, and the packs saturate.
+		auto result = _mm_cvtps_epi32(_mm_loadu_ps(color.data()));
+		result = _mm_packs_epi32(result, result);
+		result = _mm_packus_epi16(result, result);
+
+		const auto packed = _mm_cvtsi128_si32(result);
+		std::memcpy(pPixel, &packed, sizeof(packed));
+
+#else
+		for (uint32_t channel = 0; channel < 4; channel++)
+			pPixel[channel] = ToUnorm8(color[channel] * (1.0f / 255.0f));
+
+#endif
+	}
+
+	/**
+	 * Get the coverage of four horizontally adjacent pixels.
+	 *
+	 * @param edgeA The A coefficients of the edge functions.
+	 * @param edgeB The B coefficients of the edge functions.
+	 * @param edgeC The C coefficients of the edge functions.
+	 * @param x The X coordinate of the first pixel center, in 1/256 of a pixel.
+	 * @param y The Y coordinate of the pixel centers, in 1/256 of a pixel.
+	 * @return The coverage mask, a bit per pixel.
+	 */
+	uint32_t GetCoverage(const std::array<double, 3>& edgeA, const std::array<double, 3>& edgeB, const std::array<double, 3>& edgeC, double x, double y)
+	{
+#ifdef MINTE_CPU_SSE2
+		const auto zero = _mm_setzero_pd();
+		uint32_t mask = 0xF;
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			const auto step = edgeA[i] * SubpixelScale;
+			const auto first = _mm_add_pd(_mm_set1_pd(edgeA[i] * x + edgeB[i] * y + edgeC[i]), _mm_set_pd(step, 0.0));
+			const auto second = _mm_add_pd(first, _mm_set1_pd(step * 2.0));
+
+			mask &= static_cast<uint32_t>(_mm_movemask_pd(_mm_cmpge_pd(first, zero)) | (_mm_movemask_pd(_mm_cmpge_pd(second, zero)) << 2));
+		}
+
+		return mask;
+
+#else
+		uint32_t mask = 0;
+		for (uint32_t pixel = 0; pixel < 4; pixel++)
+		{
+			const auto sampleX = x + static_cast<double>(pixel) * SubpixelScale;
+			if (edgeA[0] * sampleX + edgeB[0] * y + edgeC[0] >= 0.0 && edgeA[1] * sampleX + edgeB[1] * y + edgeC[1] >= 0.0 && edgeA[2] * sampleX + edgeB[2] * y + edgeC[2] >= 0.0)
+				mask |= 1u << pixel;
+		}
+
+		return mask;
+
+#endif
+	}
+
+	/**
+	 * Set up the taps to upscale a row or a column.
+	 * The color uses a Catmull-Rom filter, which is sharper than bilinear filtering and does not ring as much as other bicubic filters.
+	 *
+	 * @param position The destination pixel.
+	 * @param sourceSize The number of source pixels.
+	 * @param destinationSize The number of destination pixels.
+	 * @return The taps.
+	 */
+	template<class Taps>
+	Taps GetUpscaleTaps(uint32_t position, uint32_t sourceSize, uint32_t destinationSize)
+	{
+		const auto ratio = static_cast<float>(sourceSize) / static_cast<float>(destinationSize);
+		const auto center = (static_cast<float>(position) + 0.5f) * ratio;
+		const auto sample = center - 0.5f;
+		const auto first = static_cast<int32_t>(std::floor(sample)) - 1;
+		const auto t = sample - std::floor(sample);
+
+		Taps taps;
+		taps.m_Weights = {
+			((-0.5f * t + 1.0f) * t - 0.5f) * t,
+			(1.5f * t - 2.5f) * t * t + 1.0f,
+			((-1.5f * t + 2.0f) * t + 0.5f) * t,
+			(0.5f * t - 0.5f) * t * t
+		};
+
+		const auto last = static_cast<int32_t>(sourceSize) - 1;
+		for (int32_t i = 0; i < 4; i++)
+			taps.m_Indices[i] = static_cast<uint32_t>(std::clamp(first + i, 0, last));
+
+		taps.m_Nearest = std::min(static_cast<uint32_t>(center), sourceSize - 1);
+		return taps;
+	}
+
+	/**
+	 * Convert a range of RGBA pixels to one of the packed 32 bit formats.
+	 *
+	 * @param pSource The source pixels.
+	 * @param pDestination The destination pixels.
+	 * @param count The number of pixels.
+	 * @param format The output format.
+	 */
+	void ConvertPacked(const uint8_t* pSource, uint8_t* pDestination, uint32_t count, minte::backend::OutputFormat format)
+	{
+		const bool bPremultiply = format == minte::backend::OutputFormat::PremultipliedRGBA || format == minte::backend::OutputFormat::PremultipliedBGRA;
+		const bool bSwizzle = format == minte::backend::OutputFormat::BGRA || format == minte::backend::OutputFormat::PremultipliedBGRA;
+
+		for (uint32_t i = 0; i < count; i++, pSource += 4, pDestination += 4)
+		{
+			std::array<uint8_t, 4> pixel = { pSource[0], pSource[1], pSource[2], pSource[3] };
+			if (bPremultiply)
+			{
+				const auto alpha = pixel[3] / 255.0f;
+				for (uint32_t channel = 0; channel < 3; channel++)
+					pixel[channel] = ToUnorm8(pixel[channel] / 255.0f * alpha);
+			}
+
+			if (bSwizzle)
+				std::swap(pixel[0], pixel[2]);
+
+			std::memcpy(pDestination, pixel.data(), pixel.size());
+		}
+	}
+
+	/**
+	 * Load a pixel composited over black, which is what the YUV formats store.
+	 *
+	 * @param pPixel The RGBA pixel.
+	 * @return The color.
+	 */
+	std::array<float, 3> LoadPremultiplied(const uint8_t* pPixel)
+	{
+		const auto alpha = pPixel[3] / 255.0f;
+		return { pPixel[0] / 255.0f * alpha, pPixel[1] / 255.0f * alpha, pPixel[2] / 255.0f * alpha };
+	}
+
+	// BT.709 limited range conversion.
+	float ToY(const std::array<float, 3>& color) { return color[0] * 0.1826f + color[1] * 0.6142f + color[2] * 0.0620f + 16.0f / 255.0f; }
+	float ToU(const std::array<float, 3>& color) { return color[0] * -0.1006f + color[1] * -0.3386f + color[2] * 0.4392f + 128.0f / 255.0f; }
+	float ToV(const std::array<float, 3>& color) { return color[0] * 0.4392f + color[1] * -0.3989f + color[2] * -0.0403f + 128.0f / 255.0f; }
+
+	/**
+	 * Convert a block of 8x2 RGBA pixels to one of the YUV formats.
+	 * The layout matches the Vulkan backend's conversion shader.
+	 *
+	 * @param pSource The source image.
+	 * @param pDestination The output buffer.
+	 * @param width The image width.
+	 * @param height The image height.
+	 * @param blockX The first column of the block.
+	 * @param blockY The first row of the block.
+	 * @param format The output format.
+	 */
+	void ConvertYUV(const uint8_t* pSource, uint8_t* pDestination, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, minte::backend::OutputFormat format)
+	{
+		const auto lumaSize = static_cast<size_t>(width) * height;
+		auto* pTopLuma = pDestination + static_cast<size_t>(blockY) * width + blockX;
+		auto* pBottomLuma = pTopLuma + width;
+
+		const auto chromaRow = blockY / 2;
+		auto* pChroma = pDestination + lumaSize + static_cast<size_t>(chromaRow) * width + blockX;
+		auto* pU = pDestination + lumaSize + static_cast<size_t>(chromaRow) * (width / 2) + blockX / 2;
+		auto* pV = pU + lumaSize / 4;
+
+		// Each 2x2 quad shares a single chroma sample.
+		for (uint32_t quad = 0; quad < 4; quad++)
+		{
+			const auto* pTop = pSource + (static_cast<size_t>(blockY) * width + blockX + quad * 2) * 4;
+			const auto* pBottom = pTop + static_cast<size_t>(width) * 4;
+
+			const auto topLeft = LoadPremultiplied(pTop);
+			const auto topRight = LoadPremultiplied(pTop + 4);
+			const auto bottomLeft = LoadPremultiplied(pBottom);
+			const auto bottomRight = LoadPremultiplied(pBottom + 4);
+
+			pTopLuma[quad * 2] = ToUnorm8(ToY(topLeft));
+			pTopLuma[quad * 2 + 1] = ToUnorm8(ToY(topRight));
+			pBottomLuma[quad * 2] = ToUnorm8(ToY(bottomLeft));
+			pBottomLuma[quad * 2 + 1] = ToUnorm8(ToY(bottomRight));
+
+			std::array<float, 3> average = {};
+			for (uint32_t channel = 0; channel < 3; channel++)
+				average[channel] = (topLeft[channel] + topRight[channel] + bottomLeft[channel] + bottomRight[channel]) * 0.25f;
+
+			if (format == minte::backend::OutputFormat::NV12)
+			{
+				pChroma[quad * 2] = ToUnorm8(ToU(average));
+				pChroma[quad * 2 + 1] = ToUnorm8(ToV(average));
+			}
+			else
+			{
+				pU[quad] = ToUnorm8(ToU(average));
+				pV[quad] = ToUnorm8(ToV(average));
+			}
+		}
+	}
+}
+
+namespace minte
+{
+	namespace backend
+	{
+		CpuRenderTarget::CpuRenderTarget(const std::shared_ptr<CpuInstance>& pInstance, uint32_t width, uint32_t height, AntiAliasing antiAliasing /*= AntiAliasing::X1*/)
+			: RenderTarget(pInstance, width, height, antiAliasing)
+		{
+			if (antiAliasing != AntiAliasing::X1)
+				throw BackendError("The CPU backend only supports x1 anti-aliasing!");
+
+			m_TileBins.resize(static_cast<size_t>((width + TileSize - 1) / TileSize) * ((height + TileSize - 1) / TileSize));
+
+			const auto pixelCount = static_cast<uint64_t>(width) * height;
+			setColorBuffer(createImageBuffer(pixelCount * 4));
+			setEntityBuffer(createImageBuffer(pixelCount * sizeof(uint32_t)));
+			setDepthBuffer(createImageBuffer(pixelCount * sizeof(uint16_t)));
+		}
+
+		CpuRenderTarget::~CpuRenderTarget()
+		{
+			getInstance()->unregisterAllocation(ResourceCategory::Geometry, m_Vertices.capacity() * sizeof(Vertex) + m_Indices.capacity() * sizeof(Index));
+			getInstance()->unregisterAllocation(ResourceCategory::Attachment, m_ColorImage.capacity());
+			getInstance()->unregisterAllocation(ResourceCategory::Attachment, m_ScaledColor.capacity() + m_ScaledEntities.capacity() * sizeof(uint32_t) + m_ScaledDepth.capacity() * sizeof(uint16_t));
+		}
+
+		void CpuRenderTarget::draw()
+		{
+			const auto startTime = std::chrono::steady_clock::now();
+			acquireBuffers();
+
+			auto* pColorBuffer = reinterpret_cast<uint8_t*>(getColorBuffer()->as<CpuImageBuffer>()->getData());
+			m_pOutput = pColorBuffer;
+			m_pColor = getOutputFormat() == OutputFormat::RGBA ? pColorBuffer : m_ColorImage.data();
+			m_pEntities = reinterpret_cast<uint32_t*>(getEntityBuffer()->as<CpuImageBuffer>()->getData());
+			m_pDepth = reinterpret_cast<uint16_t*>(getDepthBuffer()->as<CpuImageBuffer>()->getData());
+
+			// Textures are bound by the instance, so they can only be CPU textures.
+			for (uint32_t slot = 0; slot < MaxTextures; slot++)
+				m_SlotTextures[slot] = static_cast<const CpuTexture*>(getTexture(slot).get());
+
+			// Draw the scaled commands to the top left of the buffers, and then upscale them and draw the rest on top if we're scaling.
+			beginPass(getRenderWidth(), getRenderHeight(), false);
+			binTriangles(false);
+			rasterizePass();
+
+			if (isScaled())
+			{
+				prepareUpscale();
+				beginPass(getWidth(), getHeight(), true);
+				binTriangles(true);
+				rasterizePass();
+			}
+
+			updateRenderScale(std::chrono::steady_clock::now() - startTime);
+		}
+
+		void CpuRenderTarget::updateVertices(uint64_t offset, std::span<const Vertex> vertices)
+		{
+			growGeometryBuffer(m_Vertices, offset + vertices.size());
+			std::copy(vertices.begin(), vertices.end(), m_Vertices.begin() + offset);
+		}
+
+		void CpuRenderTarget::updateIndices(uint64_t offset, std::span<const Index> indices)
+		{
+			growGeometryBuffer(m_Indices, offset + indices.size());
+			std::copy(indices.begin(), indices.end(), m_Indices.begin() + offset);
+		}
+
+		void CpuRenderTarget::setOutputFormat(OutputFormat format)
+		{
+			if (format == getOutputFormat())
+				return;
+
+			validateOutputFormat(format);
+			m_OutputFormat = format;
+			invalidateState();
+
+			setColorBuffer(createImageBuffer(getOutputSize()));
+
+			// Converted formats are rendered to an intermediate image first.
+			const auto pInstance = getInstance();
+			if (format == OutputFormat::RGBA)
+			{
+				pInstance->unregisterAllocation(ResourceCategory::Attachment, m_ColorImage.capacity());
+				m_ColorImage = std::vector<uint8_t>();
+			}
+			else if (m_ColorImage.empty())
+			{
+				m_ColorImage.resize(static_cast<size_t>(getWidth()) * getHeight() * 4);
+				pInstance->registerAllocation(ResourceCategory::Attachment, m_ColorImage.capacity());
+			}
+		}
+
+		std::shared_ptr<ImageBuffer> CpuRenderTarget::createImageBuffer(uint64_t size)
+		{
+			return std::make_shared<CpuImageBuffer>(std::static_pointer_cast<CpuInstance>(getInstancePointer()), size);
+		}
+
+		void CpuRenderTarget::binTriangles(bool bNativeResolution)
+		{
+			m_Triangles.clear();
+			for (auto& bin : m_TileBins)
+				bin.clear();
+
+			const auto scale = bNativeResolution ? 1.0f : getRenderScale();
+			const auto& commands = getDrawCommands();
+			for (uint32_t commandIndex = 0; commandIndex < commands.size(); commandIndex++)
+			{
+				// Skip the commands which read outside the buffers, the device would read garbage there.
+				const auto& command = commands[commandIndex];
+				if (static_cast<uint64_t>(command.m_IndexOffset) + command.m_IndexCount > m_Indices.size() || isDrawnAtNativeResolution(command) != bNativeResolution)
+					continue;
+
+				for (uint32_t i = 0; i + 2 < command.m_IndexCount; i += 3)
+				{
+					const auto* pIndices = m_Indices.data() + command.m_IndexOffset + i;
+					const auto first = static_cast<uint64_t>(command.m_VertexOffset) + pIndices[0];
+					const auto second = static_cast<uint64_t>(command.m_VertexOffset) + pIndices[1];
+					const auto third = static_cast<uint64_t>(command.m_VertexOffset) + pIndices[2];
+
+					if (first < m_Vertices.size() && second < m_Vertices.size() && third < m_Vertices.size())
+						binTriangle(m_Vertices[first], m_Vertices[second], m_Vertices[third], commandIndex, scale);
+				}
+			}
+		}
+
+		void CpuRenderTarget::binTriangle(const Vertex& first, const Vertex& second, const Vertex& third, uint32_t command, float scale)
+		{
+			std::array<const Vertex*, 3> pVertices = { &first, &second, &third };
+			std::array<double, 3> x = {}, y = {};
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				x[i] = SnapCoordinate(pVertices[i]->m_Position.m_X * scale);
+				y[i] = SnapCoordinate(pVertices[i]->m_Position.m_Y * scale);
+			}
+
+			// Make the winding consistent, since nothing is culled. Degenerate triangles cover nothing.
+			auto area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+			if (area == 0.0)
+				return;
+
+			if (area < 0.0)
+			{
+				std::swap(pVertices[1], pVertices[2]);
+				std::swap(x[1], x[2]);
+				std::swap(y[1], y[2]);
+				area = -area;
+			}
+
+			// Find the pixels whose centers could be inside, and skip the triangle if it's outside the pass or the scissor. The scissor is
+			// scaled outwards, so that scaled commands don't lose the pixels at their edges.
+			const auto& scissor = getDrawCommands()[command].m_Scissor;
+			const auto scissorMinX = static_cast<int32_t>(std::floor(scissor.m_X * scale));
+			const auto scissorMinY = static_cast<int32_t>(std::floor(scissor.m_Y * scale));
+			const auto scissorMaxX = static_cast<int32_t>(std::ceil((scissor.m_X + scissor.m_Width) * scale)) - 1;
+			const auto scissorMaxY = static_cast<int32_t>(std::ceil((scissor.m_Y + scissor.m_Height) * scale)) - 1;
+
+			const auto minX = std::max(static_cast<int32_t>(std::ceil((std::min({ x[0], x[1], x[2] }) - SubpixelScale / 2) / SubpixelScale)), scissorMinX);
+			const auto minY = std::max(static_cast<int32_t>(std::ceil((std::min({ y[0], y[1], y[2] }) - SubpixelScale / 2) / SubpixelScale)), scissorMinY);
+			const auto maxX = std::min({ static_cast<int32_t>(std::floor((std::max({ x[0], x[1], x[2] }) - SubpixelScale / 2) / SubpixelScale)), static_cast<int32_t>(m_PassWidth) - 1, scissorMaxX });
+			const auto maxY = std::min({ static_cast<int32_t>(std::floor((std::max({ y[0], y[1], y[2] }) - SubpixelScale / 2) / SubpixelScale)), static_cast<int32_t>(m_PassHeight) - 1, scissorMaxY });
+			if (minX > maxX || minY > maxY)
+				return;
+
+			// The depth is quantized like the Vulkan backend's 16 bit depth attachment.
+			const auto commandCount = getDrawCommands().size();
+			const auto bDepthOrdered = commandCount <= MaxDepthOrderedCommands;
+
+			auto& triangle = m_Triangles.emplace_back();
+			triangle.m_MinX = minX;
+			triangle.m_MinY = minY;
+			triangle.m_MaxX = maxX;
+			triangle.m_MaxY = maxY;
+			triangle.m_Command = command;
+			triangle.m_EntityID = first.m_EntityID;
+			triangle.m_Depth = bDepthOrdered ? static_cast<uint16_t>(std::lround(GetDrawCommandDepth(command, commandCount) * 65535.0f)) : 0;
+			triangle.m_IsOpaque = bDepthOrdered && getDrawCommands()[command].m_IsOpaque;
+
+			// Setup the edge functions. Pixels exactly on an edge belong to the triangle only if it's a top or a left edge, so that triangles
+			// sharing an edge never draw a pixel twice.
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				const auto next = (i + 1) % 3;
+				const auto deltaX = x[next] - x[i];
+				const auto deltaY = y[next] - y[i];
+				const bool bTopLeft = (deltaY == 0.0 && deltaX > 0.0) || deltaY < 0.0;
+
+				triangle.m_EdgeA[i] = -deltaY;
+				triangle.m_EdgeB[i] = deltaX;
+				triangle.m_EdgeC[i] = deltaY * x[i] - deltaX * y[i] - (bTopLeft ? 0.0 : 1.0);
+			}
+
+			// Setup the attribute planes from the snapped positions.
+			std::array<std::array<float, 6>, 3> attributes = {};
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				const auto color = pVertices[i]->m_Color;
+				attributes[i] = {
+					(color & 0xFF) / 255.0f,
+					((color >> 8) & 0xFF) / 255.0f,
+					((color >> 16) & 0xFF) / 255.0f,
+					((color >> 24) & 0xFF) / 255.0f,
+					pVertices[i]->m_TextureCoordinate.m_X,
+					pVertices[i]->m_TextureCoordinate.m_Y
+				};
+			}
+
+			constexpr auto Scale = 1.0 / SubpixelScale;
+			const auto firstX = (x[1] - x[0]) * Scale, firstY = (y[1] - y[0]) * Scale;
+			const auto secondX = (x[2] - x[0]) * Scale, secondY = (y[2] - y[0]) * Scale;
+			const auto pixelArea = area * Scale * Scale;
+
+			triangle.m_OriginX = static_cast<float>(x[0] * Scale);
+			triangle.m_OriginY = static_cast<float>(y[0] * Scale);
+			for (uint32_t i = 0; i < 6; i++)
+			{
+				const double firstDelta = attributes[1][i] - attributes[0][i];
+				const double secondDelta = attributes[2][i] - attributes[0][i];
+
+				triangle.m_Values[i] = attributes[0][i];
+				triangle.m_GradientX[i] = static_cast<float>((firstDelta * secondY - secondDelta * firstY) / pixelArea);
+				triangle.m_GradientY[i] = static_cast<float>((secondDelta * firstX - firstDelta * secondX) / pixelArea);
+			}
+
+			// Add the triangle to all the tiles its bounding box overlaps.
+			const auto triangleIndex = static_cast<uint32_t>(m_Triangles.size() - 1);
+			for (auto tileY = static_cast<uint32_t>(minY) / TileSize; tileY <= static_cast<uint32_t>(maxY) / TileSize; tileY++)
+				for (auto tileX = static_cast<uint32_t>(minX) / TileSize; tileX <= static_cast<uint32_t>(maxX) / TileSize; tileX++)
+					m_TileBins[static_cast<size_t>(tileY) * m_TileCountX + tileX].emplace_back(triangleIndex);
+		}
+
+		void CpuRenderTarget::beginPass(uint32_t width, uint32_t height, bool bUpscale)
+		{
+			m_PassWidth = width;
+			m_PassHeight = height;
+			m_IsUpscaling = bUpscale;
+			m_IsFinalPass = bUpscale || !isScaled();
+
+			m_TileCountX = (width + TileSize - 1) / TileSize;
+			m_TileCount = m_TileCountX * ((height + TileSize - 1) / TileSize);
+		}
+
+		void CpuRenderTarget::rasterizePass()
+		{
+			// The drawing thread rasterizes too, and there is no point in waking more threads than there are tiles.
+			auto* pThreadPool = getInstance()->as<CpuInstance>()->getThreadPool();
+			const auto jobCount = pThreadPool ? std::min(pThreadPool->getThreadCount(), m_TileCount > 0 ? m_TileCount - 1 : 0) : 0;
+
+			m_NextTile = 0;
+			for (uint32_t i = 0; i < jobCount; i++)
+				pThreadPool->submit([this] { rasterizeTiles(); });
+
+			rasterizeTiles();
+
+			if (jobCount > 0)
+				pThreadPool->wait();
+		}
+
+		void CpuRenderTarget::rasterizeTiles()
+		{
+			for (auto tile = m_NextTile.fetch_add(1); tile < m_TileCount; tile = m_NextTile.fetch_add(1))
+				rasterizeTile(tile);
+		}
+
+		void CpuRenderTarget::prepareUpscale()
+		{
+			// The scaled image is at most as large as the render target, so allocate that once.
+			const auto width = getWidth();
+			const auto height = getHeight();
+			if (m_ScaledDepth.empty())
+			{
+				const auto pixelCount = static_cast<size_t>(width) * height;
+				m_ScaledColor.resize(pixelCount * 4);
+				m_ScaledEntities.resize(pixelCount);
+				m_ScaledDepth.resize(pixelCount);
+				m_UpscaleColumns.resize(width);
+				m_UpscaleRows.resize(height);
+
+				getInstance()->registerAllocation(ResourceCategory::Attachment, m_ScaledColor.capacity() + m_ScaledEntities.capacity() * sizeof(uint32_t) + m_ScaledDepth.capacity() * sizeof(uint16_t));
+			}
+
+			// Copy the scaled image aside, since the upscaled tiles overwrite it.
+			m_ScaledWidth = m_PassWidth;
+			m_ScaledHeight = m_PassHeight;
+			for (uint32_t y = 0; y < m_ScaledHeight; y++)
+			{
+				const auto source = static_cast<size_t>(y) * width;
+				const auto destination = static_cast<size_t>(y) * m_ScaledWidth;
+				std::memcpy(m_ScaledColor.data() + destination * 4, m_pColor + source * 4, static_cast<size_t>(m_ScaledWidth) * 4);
+				std::copy_n(m_pEntities + source, m_ScaledWidth, m_ScaledEntities.data() + destination);
+				std::copy_n(m_pDepth + source, m_ScaledWidth, m_ScaledDepth.data() + destination);
+			}
+
+			// The filter is separable, so the taps only depend on the row or the column.
+			for (uint32_t x = 0; x < width; x++)
+				m_UpscaleColumns[x] = GetUpscaleTaps<UpscaleTaps>(x, m_ScaledWidth, width);
+
+			for (uint32_t y = 0; y < height; y++)
+				m_UpscaleRows[y] = GetUpscaleTaps<UpscaleTaps>(y, m_ScaledHeight, height);
+		}
+
+		void CpuRenderTarget::upscaleTile(uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY)
+		{
+			const auto width = static_cast<size_t>(getWidth());
+			const auto columns = maxX - minX + 1;
+
+			// Filter the source rows the tile needs horizontally first. The scaled image is never larger than the render target, so a tile
+			// needs at most its own height plus the filter's rows.
+			std::array<std::array<Color, TileSize>, TileSize + 4> filteredRows;
+			const auto firstRow = m_UpscaleRows[minY].m_Indices[0];
+			const auto lastRow = m_UpscaleRows[maxY].m_Indices[3];
+
+			for (auto row = firstRow; row <= lastRow; row++)
+			{
+				const auto* pRow = m_ScaledColor.data() + static_cast<size_t>(row) * m_ScaledWidth * 4;
+				auto& filteredRow = filteredRows[row - firstRow];
+
+				for (uint32_t x = 0; x < columns; x++)
+				{
+					const auto& column = m_UpscaleColumns[minX + x];
+					Color color = {};
+					for (uint32_t i = 0; i < 4; i++)
+						AccumulatePixel(color, pRow + static_cast<size_t>(column.m_Indices[i]) * 4, column.m_Weights[i]);
+
+					filteredRow[x] = color;
+				}
+			}
+
+			// Then filter them vertically. The entity IDs and the depth can't be blended, so they're copied from the nearest pixel.
+			for (auto y = minY; y <= maxY; y++)
+			{
+				const auto& row = m_UpscaleRows[y];
+				const auto nearestRow = static_cast<size_t>(row.m_Nearest) * m_ScaledWidth;
+
+				for (uint32_t x = 0; x < columns; x++)
+				{
+					const auto offset = y * width + minX + x;
+					const auto nearest = nearestRow + m_UpscaleColumns[minX + x].m_Nearest;
+					m_pEntities[offset] = m_ScaledEntities[nearest];
+					m_pDepth[offset] = m_ScaledDepth[nearest];
+
+					Color color = {};
+					for (uint32_t j = 0; j < 4; j++)
+						AccumulateColor(color, filteredRows[row.m_Indices[j] - firstRow][x], row.m_Weights[j]);
+
+					StorePixel(m_pColor + offset * 4, color);
+				}
+			}
+		}
+
+		void CpuRenderTarget::rasterizeTile(uint32_t tile)
+		{
+			const auto width = getWidth();
+			const auto minX = (tile % m_TileCountX) * TileSize;
+			const auto minY = (tile / m_TileCountX) * TileSize;
+			const auto maxX = std::min(minX + TileSize, m_PassWidth) - 1;
+			const auto maxY = std::min(minY + TileSize, m_PassHeight) - 1;
+			const auto columns = maxX - minX + 1;
+
+			// Clear the tile like the render pass does, or upscale the scaled image to it.
+			if (m_IsUpscaling)
+			{
+				upscaleTile(minX, minY, maxX, maxY);
+			}
+			else
+			{
+				for (auto y = minY; y <= maxY; y++)
+				{
+					const auto offset = static_cast<size_t>(y) * width + minX;
+					std::memset(m_pColor + offset * 4, 0, static_cast<size_t>(columns) * 4);
+					std::fill_n(m_pEntities + offset, columns, 0u);
+					std::fill_n(m_pDepth + offset, columns, static_cast<uint16_t>(0xFFFF));
+				}
+			}
+
+			// Draw the opaque triangles front to back, and then the translucent triangles back to front on top of them.
+			const auto& bin = m_TileBins[tile];
+			for (auto i = bin.size(); i > 0; i--)
+			{
+				if (m_Triangles[bin[i - 1]].m_IsOpaque)
+					rasterizeTriangle(m_Triangles[bin[i - 1]], minX, minY, maxX, maxY);
+			}
+
+			for (const auto triangle : bin)
+			{
+				if (!m_Triangles[triangle].m_IsOpaque)
+					rasterizeTriangle(m_Triangles[triangle], minX, minY, maxX, maxY);
+			}
+
+			// Convert the tile if needed. The tiles are a multiple of the YUV block size, except at the edges which the format requires to
+			// be a multiple too.
+			const auto format = getOutputFormat();
+			if (!m_IsFinalPass)
+				return;
+
+			if (format == OutputFormat::NV12 || format == OutputFormat::YUV420)
+			{
+				for (auto y = minY; y <= maxY; y += 2)
+					for (auto x = minX; x <= maxX; x += 8)
+						ConvertYUV(m_pColor, m_pOutput, width, getHeight(), x, y, format);
+			}
+			else if (format != OutputFormat::RGBA)
+			{
+				for (auto y = minY; y <= maxY; y++)
+				{
+					const auto offset = (static_cast<size_t>(y) * width + minX) * 4;
+					ConvertPacked(m_pColor + offset, m_pOutput + offset, columns, format);
+				}
+			}
+		}
+
+		void CpuRenderTarget::rasterizeTriangle(const Triangle& triangle, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY)
+		{
+			const auto startX = std::max(triangle.m_MinX, minX);
+			const auto startY = std::max(triangle.m_MinY, minY);
+			const auto endX = std::min(triangle.m_MaxX, maxX);
+			const auto endY = std::min(triangle.m_MaxY, maxY);
+			if (startX > endX || startY > endY)
+				return;
+
+			const auto& command = getDrawCommands()[triangle.m_Command];
+			const auto* pTexture = m_SlotTextures[std::min<uint32_t>(command.m_TextureSlot, MaxTextures - 1)];
+			const auto width = static_cast<size_t>(getWidth());
+			const auto lod = GetLevelOfDetail(pTexture, Point2D_F32(triangle.m_GradientX[4], triangle.m_GradientX[5]), Point2D_F32(triangle.m_GradientY[4], triangle.m_GradientY[5]));
+
+			for (auto y = startY; y <= endY; y++)
+			{
+				const auto sampleY = static_cast<double>(y) * SubpixelScale + SubpixelScale / 2;
+				const auto pixelY = y + 0.5f - triangle.m_OriginY;
+
+				for (auto x = startX; x <= endX; x += 4)
+				{
+					auto mask = GetCoverage(triangle.m_EdgeA, triangle.m_EdgeB, triangle.m_EdgeC, static_cast<double>(x) * SubpixelScale + SubpixelScale / 2, sampleY);
+					if (endX - x < 3)
+						mask &= (1u << (endX - x + 1)) - 1;
+
+					for (; mask != 0; mask &= mask - 1)
+					{
+						const auto column = x + static_cast<int32_t>(std::countr_zero(mask));
+						const auto offset = static_cast<size_t>(y) * width + column;
+
+						// Skip the pixels hidden behind an opaque triangle before shading them.
+						if (triangle.m_Depth >= m_pDepth[offset])
+							continue;
+
+						const auto pixelX = column + 0.5f - triangle.m_OriginX;
+
+						Color color = {};
+						for (uint32_t channel = 0; channel < 4; channel++)
+							color[channel] = triangle.m_Values[channel] + triangle.m_GradientX[channel] * pixelX + triangle.m_GradientY[channel] * pixelY;
+
+						const auto u = triangle.m_Values[4] + triangle.m_GradientX[4] * pixelX + triangle.m_GradientY[4] * pixelY;
+						const auto v = triangle.m_Values[5] + triangle.m_GradientX[5] * pixelX + triangle.m_GradientY[5] * pixelY;
+
+						switch (command.m_SampleMode)
+						{
+						case SampleMode::Image:
+						{
+							const auto sample = SampleColor(pTexture, u, v, lod);
+							for (uint32_t channel = 0; channel < 4; channel++)
+								color[channel] *= sample[channel];
+
+							break;
+						}
+
+						case SampleMode::Coverage:
+							color[3] *= SampleRed(pTexture, u, v, lod);
+							break;
+
+						case SampleMode::DistanceField:
+						{
+							// Keep the edge about a pixel wide at any scale, using the change of the distance to the next pixels.
+							const auto distance = SampleRed(pTexture, u, v, lod);
+							const auto deltaX = SampleRed(pTexture, u + triangle.m_GradientX[4], v + triangle.m_GradientX[5], lod) - distance;
+							const auto deltaY = SampleRed(pTexture, u + triangle.m_GradientY[4], v + triangle.m_GradientY[5], lod) - distance;
+							const auto edgeWidth = std::max((std::abs(deltaX) + std::abs(deltaY)) * 0.5f, 1.0f / 255.0f);
+
+							const auto t = std::clamp((distance - (0.5f - edgeWidth)) / (2.0f * edgeWidth), 0.0f, 1.0f);
+							color[3] *= t * t * (3.0f - 2.0f * t);
+							break;
+						}
+
+						default:
+							break;
+						}
+
+						BlendPixel(m_pColor + offset * 4, color);
+						m_pEntities[offset] = triangle.m_EntityID;
+
+						if (triangle.m_IsOpaque)
+							m_pDepth[offset] = triangle.m_Depth;
+					}
+				}
+			}
+		}
+
+		template<class Type>
+		void CpuRenderTarget::growGeometryBuffer(std::vector<Type>& buffer, uint64_t size)
+		{
+			if (size <= buffer.size())
+				return;
+
+			const auto pInstance = getInstance();
+			pInstance->unregisterAllocation(ResourceCategory::Geometry, buffer.capacity() * sizeof(Type));
+			buffer.resize(size);
+			pInstance->registerAllocation(ResourceCategory::Geometry, buffer.capacity() * sizeof(Type));
+		}
+	}
+}
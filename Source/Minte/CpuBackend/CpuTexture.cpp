@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/CpuBackend/CpuTexture.hpp"
+#include "Minte/Backend/BackendError.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace minte
+{
+	namespace backend
+	{
+		CpuTexture::CpuTexture(const std::shared_ptr<CpuInstance>& pInstance, uint32_t width, uint32_t height, TextureFormat format, bool bMipmaps /*= false*/)
+			: Texture(pInstance, width, height, format, bMipmaps)
+		{
+			m_Levels.resize(getMipLevels());
+			for (uint32_t level = 0; level < getMipLevels(); level++)
+			{
+				m_Levels[level].resize(static_cast<size_t>(getMipWidth(level)) * getMipHeight(level) * getPixelSize());
+				m_AllocationSize += m_Levels[level].size();
+			}
+
+			pInstance->registerAllocation(ResourceCategory::Texture, m_AllocationSize);
+		}
+
+		CpuTexture::~CpuTexture()
+		{
+			getInstance()->unregisterAllocation(ResourceCategory::Texture, m_AllocationSize);
+		}
+
+		void CpuTexture::upload(std::span<const TextureRegion> regions, std::span<const std::byte> data)
+		{
+			const auto pixelSize = getPixelSize();
+			auto& pixels = m_Levels.front();
+
+			for (const auto& region : regions)
+			{
+				const auto rowSize = static_cast<uint64_t>(region.m_Width) * pixelSize;
+				if (region.m_X + region.m_Width > getWidth() || region.m_Y + region.m_Height > getHeight())
+					throw BackendError("The texture region is outside the texture!");
+
+				if (region.m_Offset + rowSize * region.m_Height > data.size())
+					throw BackendError("The texture region is outside the data!");
+
+				for (uint32_t row = 0; row < region.m_Height; row++)
+				{
+					const auto destination = (static_cast<uint64_t>(region.m_Y + row) * getWidth() + region.m_X) * pixelSize;
+					std::memcpy(pixels.data() + destination, data.data() + region.m_Offset + rowSize * row, rowSize);
+				}
+			}
+
+			if (!regions.empty() && getMipLevels() > 1)
+				generateMipmaps();
+		}
+
+		void CpuTexture::generateMipmaps()
+		{
+			const auto pixelSize = getPixelSize();
+			for (uint32_t level = 1; level < getMipLevels(); level++)
+			{
+				const auto& source = m_Levels[level - 1];
+				auto& destination = m_Levels[level];
+
+				const auto sourceWidth = static_cast<int32_t>(getMipWidth(level - 1));
+				const auto sourceHeight = static_cast<int32_t>(getMipHeight(level - 1));
+				const auto width = getMipWidth(level);
+				const auto height = getMipHeight(level);
+				const auto scaleX = static_cast<float>(sourceWidth) / width;
+				const auto scaleY = static_cast<float>(sourceHeight) / height;
+
+				// Every pixel bilinearly samples the level above at its center, which averages 2x2 pixels when the size is halved.
+				for (uint32_t y = 0; y < height; y++)
+				{
+					const auto sampleY = (y + 0.5f) * scaleY - 0.5f;
+					const auto top = static_cast<int32_t>(std::floor(sampleY));
+					const auto fractionY = sampleY - top;
+					const auto y0 = std::clamp(top, 0, sourceHeight - 1), y1 = std::clamp(top + 1, 0, sourceHeight - 1);
+
+					for (uint32_t x = 0; x < width; x++)
+					{
+						const auto sampleX = (x + 0.5f) * scaleX - 0.5f;
+						const auto left = static_cast<int32_t>(std::floor(sampleX));
+						const auto fractionX = sampleX - left;
+						const auto x0 = std::clamp(left, 0, sourceWidth - 1), x1 = std::clamp(left + 1, 0, sourceWidth - 1);
+
+						const auto* pTopLeft = source.data() + (static_cast<size_t>(y0) * sourceWidth + x0) * pixelSize;
+						const auto* pTopRight = source.data() + (static_cast<size_t>(y0) * sourceWidth + x1) * pixelSize;
+						const auto* pBottomLeft = source.data() + (static_cast<size_t>(y1) * sourceWidth + x0) * pixelSize;
+						const auto* pBottomRight = source.data() + (static_cast<size_t>(y1) * sourceWidth + x1) * pixelSize;
+						auto* pPixel = destination.data() + (static_cast<size_t>(y) * width + x) * pixelSize;
+
+						for (uint32_t channel = 0; channel < pixelSize; channel++)
+						{
+							const auto upper = pTopLeft[channel] + (pTopRight[channel] - pTopLeft[channel]) * fractionX;
+							const auto lower = pBottomLeft[channel] + (pBottomRight[channel] - pBottomLeft[channel]) * fractionX;
+							pPixel[channel] = static_cast<uint8_t>(std::nearbyint(upper + (lower - upper) * fractionY));
+						}
+					}
+				}
+			}
+		}
+	}
+}
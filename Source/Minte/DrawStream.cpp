@@ -0,0 +1,266 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/DrawStream.hpp"
+#include "Minte/FrontendError.hpp"
+
+#include <limits>
+
+namespace minte
+{
+	DrawStreamWriter::DrawStreamWriter(const std::filesystem::path& path, uint64_t bufferSize /*= 4 * 1024 * 1024*/)
+		: m_Buffer(std::max<uint64_t>(bufferSize, 4096))
+		, m_StartTime(std::chrono::steady_clock::now())
+	{
+		m_pFile = std::fopen(path.string().c_str(), "wb");
+		if (m_pFile == nullptr)
+			throw FrontendError("Failed to open the draw stream file!");
+
+		// We do our own buffering.
+		std::setvbuf(m_pFile, nullptr, _IONBF, 0);
+
+		const auto header = DrawStreamHeader();
+		write(&header, sizeof(header));
+	}
+
+	DrawStreamWriter::~DrawStreamWriter()
+	{
+		flush();
+		std::fclose(m_pFile);
+	}
+
+	uint32_t DrawStreamWriter::registerLayer(uint32_t width, uint32_t height, backend::AntiAliasing antiAliasing, backend::OutputFormat format)
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+
+		DrawStreamLayerCreate chunk;
+		chunk.m_LayerID = m_LayerCount++;
+		chunk.m_Width = width;
+		chunk.m_Height = height;
+		chunk.m_AntiAliasing = antiAliasing;
+		chunk.m_OutputFormat = format;
+
+		writeHeader(DrawStreamChunkType::LayerCreate, sizeof(chunk));
+		write(&chunk, sizeof(chunk));
+
+		return chunk.m_LayerID;
+	}
+
+	void DrawStreamWriter::captureTextures(backend::Instance& instance)
+	{
+		instance.setTextureUpdateCallback([pWeakWriter = weak_from_this()](const backend::Texture& texture, std::span<const backend::TextureRegion> regions, std::span<const std::byte> data)
+			{
+				if (const auto pWriter = pWeakWriter.lock())
+					pWriter->recordTextureUpload(texture, regions, data);
+			}
+		);
+	}
+
+	void DrawStreamWriter::beginFrame()
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+		writeFrameBegin();
+	}
+
+	void DrawStreamWriter::beginLayerUpdate(uint32_t layerID)
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+
+		if (layerID >= m_FrameLayers.size())
+			m_FrameLayers.resize(layerID + 1, false);
+
+		if (!m_IsFrameOpen || m_FrameLayers[layerID])
+			writeFrameBegin();
+
+		m_FrameLayers[layerID] = true;
+	}
+
+	void DrawStreamWriter::recordLayerUpdate(uint32_t layerID)
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+
+		DrawStreamLayerUpdate chunk;
+		chunk.m_LayerID = layerID;
+
+		writeHeader(DrawStreamChunkType::LayerUpdate, sizeof(chunk));
+		write(&chunk, sizeof(chunk));
+	}
+
+	void DrawStreamWriter::recordGeometry(uint32_t layerID, uint64_t vertexOffset, std::span<const Vertex> vertices, uint64_t indexOffset, std::span<const Index> indices)
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+
+		DrawStreamGeometry chunk;
+		chunk.m_VertexOffset = vertexOffset;
+		chunk.m_IndexOffset = indexOffset;
+		chunk.m_LayerID = layerID;
+		chunk.m_VertexCount = static_cast<uint32_t>(vertices.size());
+		chunk.m_IndexCount = static_cast<uint32_t>(indices.size());
+
+		writeHeader(DrawStreamChunkType::Geometry, sizeof(chunk) + vertices.size_bytes() + indices.size_bytes());
+		write(&chunk, sizeof(chunk));
+		write(vertices.data(), vertices.size_bytes());
+		write(indices.data(), indices.size_bytes());
+	}
+
+	void DrawStreamWriter::recordTextureUpload(const backend::Texture& texture, std::span<const backend::TextureRegion> regions, std::span<const std::byte> data)
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+
+		DrawStreamTextureUpload chunk;
+		chunk.m_TextureID = registerTexture(texture);
+
+		for (const auto& region : regions)
+		{
+			// The texture has already validated the regions against the data.
+			const auto pixels = data.subspan(region.m_Offset, static_cast<uint64_t>(region.m_Width) * region.m_Height * texture.getPixelSize());
+
+			chunk.m_X = region.m_X;
+			chunk.m_Y = region.m_Y;
+			chunk.m_Width = region.m_Width;
+			chunk.m_Height = region.m_Height;
+			chunk.m_Size = static_cast<uint32_t>(pixels.size());
+
+			writeHeader(DrawStreamChunkType::TextureUpload, sizeof(chunk) + pixels.size());
+			write(&chunk, sizeof(chunk));
+			write(pixels.data(), pixels.size());
+		}
+	}
+
+	void DrawStreamWriter::recordTextureBind(uint32_t layerID, uint32_t slot, const backend::Texture* pTexture)
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+
+		DrawStreamTextureBind chunk;
+		chunk.m_LayerID = layerID;
+		chunk.m_Slot = slot;
+		chunk.m_TextureID = pTexture ? registerTexture(*pTexture) : DrawStreamTextureBind::NoTexture;
+
+		writeHeader(DrawStreamChunkType::TextureBind, sizeof(chunk));
+		write(&chunk, sizeof(chunk));
+	}
+
+	void DrawStreamWriter::recordDrawCommands(uint32_t layerID, std::span<const backend::DrawCommand> commands)
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+
+		DrawStreamDrawCommands chunk;
+		chunk.m_LayerID = layerID;
+		chunk.m_Count = static_cast<uint32_t>(commands.size());
+
+		writeHeader(DrawStreamChunkType::DrawCommands, sizeof(chunk) + commands.size_bytes());
+		write(&chunk, sizeof(chunk));
+		write(commands.data(), commands.size_bytes());
+	}
+
+	void DrawStreamWriter::flush()
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+		flushBuffer();
+	}
+
+	void DrawStreamWriter::writeHeader(DrawStreamChunkType type, uint64_t size)
+	{
+		if (size > std::numeric_limits<uint32_t>::max())
+			throw FrontendError("The draw stream chunk is too large!");
+
+		DrawStreamChunkHeader header;
+		header.m_Type = type;
+		header.m_Size = static_cast<uint32_t>(size);
+
+		write(&header, sizeof(header));
+	}
+
+	void DrawStreamWriter::writeFrameBegin()
+	{
+		DrawStreamFrameBegin chunk;
+		chunk.m_Timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_StartTime).count();
+
+		writeHeader(DrawStreamChunkType::FrameBegin, sizeof(chunk));
+		write(&chunk, sizeof(chunk));
+
+		std::fill(m_FrameLayers.begin(), m_FrameLayers.end(), false);
+		m_IsFrameOpen = true;
+	}
+
+	uint32_t DrawStreamWriter::registerTexture(const backend::Texture& texture)
+	{
+		const auto [itr, bInserted] = m_TextureIDs.try_emplace(texture.getUniqueID(), m_TextureCount);
+		if (!bInserted)
+			return itr->second;
+
+		DrawStreamTextureCreate chunk;
+		chunk.m_TextureID = m_TextureCount++;
+		chunk.m_Width = texture.getWidth();
+		chunk.m_Height = texture.getHeight();
+		chunk.m_Format = texture.getFormat();
+		chunk.m_Mipmaps = texture.getMipLevels() > 1;
+
+		writeHeader(DrawStreamChunkType::TextureCreate, sizeof(chunk));
+		write(&chunk, sizeof(chunk));
+
+		return chunk.m_TextureID;
+	}
+
+	void DrawStreamWriter::write(const void* pData, uint64_t size)
+	{
+		if (m_BufferUsage + size > m_Buffer.size())
+		{
+			flushBuffer();
+
+			// Large data goes straight to the file.
+			if (size > m_Buffer.size())
+			{
+				std::fwrite(pData, 1, size, m_pFile);
+				return;
+			}
+		}
+
+		std::memcpy(m_Buffer.data() + m_BufferUsage, pData, size);
+		m_BufferUsage += size;
+	}
+
+	void DrawStreamWriter::flushBuffer()
+	{
+		if (m_BufferUsage > 0)
+			std::fwrite(m_Buffer.data(), 1, m_BufferUsage, m_pFile);
+
+		m_BufferUsage = 0;
+	}
+
+	DrawStreamReader::DrawStreamReader(const std::filesystem::path& path)
+		: m_File(path)
+	{
+		DrawStreamHeader header;
+		header.m_Magic = 0;
+
+		if (m_File.getSize() >= sizeof(header))
+			std::memcpy(&header, m_File.getData().data(), sizeof(header));
+
+		if (header.m_Magic != DrawStreamHeader::Magic)
+			throw FrontendError("The file is not a draw stream!");
+
+		if (header.m_Version != DrawStreamHeader::CurrentVersion)
+			throw FrontendError("Unsupported draw stream version!");
+	}
+
+	bool DrawStreamReader::next(DrawStreamChunk& chunk)
+	{
+		const auto data = m_File.getData();
+		if (m_Offset + sizeof(DrawStreamChunkHeader) > data.size())
+			return false;
+
+		DrawStreamChunkHeader header;
+		std::memcpy(&header, data.data() + m_Offset, sizeof(header));
+
+		// The last chunk might be truncated if the application did not shut down cleanly.
+		const uint64_t payloadOffset = m_Offset + sizeof(header);
+		if (payloadOffset + header.m_Size > data.size())
+			return false;
+
+		chunk.m_Type = header.m_Type;
+		chunk.m_Payload = data.subspan(payloadOffset, header.m_Size);
+
+		m_Offset = payloadOffset + header.m_Size;
+		return true;
+	}
+}
@@ -0,0 +1,189 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Drawable.hpp"
+#include "Minte/FrontendError.hpp"
+
+#include <algorithm>
+
+namespace minte
+{
+	void Drawable::addChild(std::shared_ptr<Drawable> pChild)
+	{
+		if (pChild->m_pParentDrawable || pChild->m_IsLayerRoot)
+			throw FrontendError("The drawable already has a parent!");
+
+		pChild->m_pParentDrawable = this;
+		if (m_pStorage)
+			pChild->attach(m_pStorage);
+
+		m_Children.emplace_back(std::move(pChild));
+
+		// The child's position might have changed since it was last drawn.
+		setDirty(DirtyFlags::Structure);
+		m_Children.back()->setTransformDirty();
+
+		if (m_Children.back()->m_pLayoutNode)
+			invalidateLayout();
+	}
+
+	void Drawable::removeChild(const Drawable* pChild)
+	{
+		const auto itr = std::find_if(m_Children.begin(), m_Children.end(), [pChild](const std::shared_ptr<Drawable>& pDrawable) { return pDrawable.get() == pChild; });
+		if (itr == m_Children.end())
+			return;
+
+		const auto bHadLayout = (*itr)->m_pLayoutNode != nullptr;
+
+		(*itr)->detach();
+		(*itr)->m_pParentDrawable = nullptr;
+		m_Children.erase(itr);
+
+		setDirty(DirtyFlags::Structure);
+
+		if (bHadLayout)
+			invalidateLayout();
+	}
+
+	void Drawable::setPosition(Point2D<float> position)
+	{
+		if (position.m_X == m_Position.m_X && position.m_Y == m_Position.m_Y)
+			return;
+
+		m_Position = position;
+		setTransformDirty();
+	}
+
+	void Drawable::setVisible(bool bVisible)
+	{
+		if (bVisible == m_IsVisible)
+			return;
+
+		m_IsVisible = bVisible;
+		if (m_pStorage)
+		{
+			auto& flags = m_pStorage->getFlags()[m_Handle.getIndex()];
+			flags = bVisible ? flags | ElementStorage::ElementFlags::Visible : flags & ~ElementStorage::ElementFlags::Visible;
+		}
+
+		setDirty(DirtyFlags::Structure);
+	}
+
+	void Drawable::setClipRectangle(const Rectangle2D_F32& rectangle)
+	{
+		m_ClipRectangle = rectangle;
+		m_IsClipping = true;
+
+		// The children are uploaded again, since they might have been clipped away.
+		setDirty(DirtyFlags::Structure);
+		for (const auto& pChild : m_Children)
+			pChild->setTransformDirty();
+	}
+
+	void Drawable::clearClipRectangle()
+	{
+		if (!m_IsClipping)
+			return;
+
+		m_IsClipping = false;
+
+		setDirty(DirtyFlags::Structure);
+		for (const auto& pChild : m_Children)
+			pChild->setTransformDirty();
+	}
+
+	void Drawable::setLayoutStyle(const LayoutStyle& style)
+	{
+		if (m_pLayoutNode == nullptr)
+		{
+			m_pLayoutNode = std::make_unique<LayoutNode>();
+
+			// The parent needs to make room for this drawable.
+			if (m_pParentDrawable)
+				m_pParentDrawable->invalidateLayout();
+		}
+
+		m_pLayoutNode->m_Style = style;
+		m_pLayoutNode->m_IsMeasureDirty = false;
+		m_pLayoutNode->m_IsLayoutDirty = false;
+		invalidateLayout();
+	}
+
+	void Drawable::invalidateLayout()
+	{
+		if (m_pLayoutNode == nullptr)
+			return;
+
+		// Walk up till we find an ancestor that is already dirty, or the root of the layout tree.
+		auto pDrawable = this;
+		while (true)
+		{
+			auto& node = *pDrawable->m_pLayoutNode;
+			if (node.m_IsMeasureDirty && node.m_IsLayoutDirty)
+				return;
+
+			node.m_IsMeasureDirty = true;
+			node.m_IsLayoutDirty = true;
+
+			if (pDrawable->isLayoutRoot())
+				break;
+
+			pDrawable = pDrawable->m_pParentDrawable;
+		}
+
+		if (pDrawable->m_pStorage)
+			pDrawable->m_pStorage->addLayoutRoot(pDrawable->m_Handle);
+	}
+
+	void Drawable::setDirty(uint8_t flags)
+	{
+		m_DirtyFlags |= flags;
+
+		// Walk up till we find an ancestor that already knows about it.
+		for (auto pParent = m_pParentDrawable; pParent && !(pParent->m_DirtyFlags & DirtyFlags::Descendant); pParent = pParent->m_pParentDrawable)
+			pParent->m_DirtyFlags |= DirtyFlags::Descendant;
+	}
+
+	void Drawable::setTransformDirty()
+	{
+		setDirty(DirtyFlags::Transform | (m_Children.empty() ? DirtyFlags::None : DirtyFlags::Descendant));
+
+		for (const auto& pChild : m_Children)
+			pChild->setTransformDirty();
+	}
+
+	void Drawable::attach(ElementStorage* pStorage)
+	{
+		m_pStorage = pStorage;
+		m_Handle = pStorage->create(this);
+
+		if (!m_IsVisible)
+			pStorage->getFlags()[m_Handle.getIndex()] &= ~ElementStorage::ElementFlags::Visible;
+
+		// The glyphs are regenerated, since they might be in another atlas.
+		if (usesGlyphAtlas())
+		{
+			pStorage->getFlags()[m_Handle.getIndex()] |= ElementStorage::ElementFlags::UsesGlyphAtlas;
+			markDirty();
+		}
+
+		// Layout trees that changed while detached need to be updated by the layer.
+		if (m_pLayoutNode && m_pLayoutNode->m_IsLayoutDirty && isLayoutRoot())
+			pStorage->addLayoutRoot(m_Handle);
+
+		for (const auto& pChild : m_Children)
+			pChild->attach(pStorage);
+	}
+
+	void Drawable::detach()
+	{
+		if (m_pStorage == nullptr)
+			return;
+
+		for (const auto& pChild : m_Children)
+			pChild->detach();
+
+		m_pStorage->destroy(m_Handle);
+		m_pStorage = nullptr;
+		m_Handle = ElementHandle();
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/ElementStorage.hpp"
+#include "Minte/FrontendError.hpp"
+
+namespace minte
+{
+	ElementHandle ElementStorage::create(Drawable* pDrawable)
+	{
+		uint32_t index = 0;
+		if (!m_FreeSlots.empty())
+		{
+			index = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			if (m_Drawables.size() > ElementHandle::MaxIndex)
+				throw FrontendError("The layer cannot hold any more elements!");
+
+			index = static_cast<uint32_t>(m_Drawables.size());
+			m_Generations.emplace_back(1);
+			m_Drawables.emplace_back();
+			m_Positions.emplace_back();
+			m_ClipRectangles.emplace_back(GetUnclippedRectangle());
+			m_Bounds.emplace_back();
+			m_VertexRanges.emplace_back();
+			m_IndexRanges.emplace_back();
+			m_IndexCounts.emplace_back();
+			m_Flags.emplace_back();
+		}
+
+		m_Drawables[index] = pDrawable;
+		m_Flags[index] = ElementFlags::Visible;
+		return ElementHandle(index, m_Generations[index]);
+	}
+
+	void ElementStorage::destroy(ElementHandle handle)
+	{
+		if (!isAlive(handle))
+			return;
+
+		const auto index = handle.getIndex();
+		m_VertexAllocator.free(m_VertexRanges[index].m_Offset, m_VertexRanges[index].m_Capacity);
+		m_IndexAllocator.free(m_IndexRanges[index].m_Offset, m_IndexRanges[index].m_Capacity);
+		m_SpatialIndex.remove(index);
+
+		m_Drawables[index] = nullptr;
+		m_Positions[index] = Point2D_F32();
+		m_ClipRectangles[index] = GetUnclippedRectangle();
+		m_Bounds[index] = Rectangle2D_F32();
+		m_VertexRanges[index] = GeometryRange();
+		m_IndexRanges[index] = GeometryRange();
+		m_IndexCounts[index] = 0;
+		m_Flags[index] = ElementFlags::None;
+
+		// Skip generation 0 on wrap around so that a handle is never 0.
+		m_Generations[index] = m_Generations[index] == ElementHandle::MaxGeneration ? 1 : m_Generations[index] + 1;
+		m_FreeSlots.emplace_back(index);
+	}
+
+	bool ElementStorage::reserveRange(RangeAllocator& allocator, GeometryRange& range, uint64_t count)
+	{
+		if (count <= range.m_Capacity)
+			return false;
+
+		allocator.free(range.m_Offset, range.m_Capacity);
+
+		range.m_Capacity = count + count / 2;
+		range.m_Offset = allocator.allocate(range.m_Capacity);
+		return true;
+	}
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Font.hpp"
+#include "Minte/FrontendError.hpp"
+
+#include <stb_truetype.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace /* anonymous */
+{
+	std::atomic<uint32_t> FontCounter = 0;
+}
+
+namespace minte
+{
+	Font::Font(const std::filesystem::path& path, uint32_t index /*= 0*/)
+		: m_File(path)
+		, m_pFontInfo(std::make_unique<stbtt_fontinfo>())
+		, m_ID(++FontCounter)
+	{
+		const auto pData = reinterpret_cast<const unsigned char*>(m_File.getData().data());
+		if (pData == nullptr)
+			throw FrontendError("The font file is empty!");
+
+		const auto offset = stbtt_GetFontOffsetForIndex(pData, static_cast<int>(index));
+		if (offset < 0 || static_cast<uint64_t>(offset) >= m_File.getSize() || !stbtt_InitFont(m_pFontInfo.get(), pData, offset))
+			throw FrontendError("Failed to load the font!");
+	}
+
+	Font::~Font() = default;
+
+	uint32_t Font::getGlyphIndex(char32_t codePoint) const
+	{
+		return static_cast<uint32_t>(stbtt_FindGlyphIndex(m_pFontInfo.get(), static_cast<int>(codePoint)));
+	}
+
+	FontMetrics Font::getMetrics(float size) const
+	{
+		int ascent = 0, descent = 0, lineGap = 0;
+		stbtt_GetFontVMetrics(m_pFontInfo.get(), &ascent, &descent, &lineGap);
+
+		const auto scale = getScale(size);
+		return FontMetrics{ ascent * scale, descent * scale, lineGap * scale };
+	}
+
+	float Font::getAdvance(uint32_t glyphIndex, float size) const
+	{
+		int advance = 0, leftSideBearing = 0;
+		stbtt_GetGlyphHMetrics(m_pFontInfo.get(), static_cast<int>(glyphIndex), &advance, &leftSideBearing);
+
+		return advance * getScale(size);
+	}
+
+	float Font::getKerning(uint32_t firstGlyph, uint32_t secondGlyph, float size) const
+	{
+		return stbtt_GetGlyphKernAdvance(m_pFontInfo.get(), static_cast<int>(firstGlyph), static_cast<int>(secondGlyph)) * getScale(size);
+	}
+
+	void Font::rasterize(uint32_t glyphIndex, float size, GlyphBitmap& bitmap) const
+	{
+		const auto scale = getScale(size);
+
+		int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+		stbtt_GetGlyphBitmapBox(m_pFontInfo.get(), static_cast<int>(glyphIndex), scale, scale, &x0, &y0, &x1, &y1);
+
+		bitmap.m_Width = static_cast<uint32_t>(std::max(x1 - x0, 0));
+		bitmap.m_Height = static_cast<uint32_t>(std::max(y1 - y0, 0));
+		bitmap.m_Offset = Point2D_F32(static_cast<float>(x0), static_cast<float>(y0));
+		bitmap.m_Pixels.assign(static_cast<uint64_t>(bitmap.m_Width) * bitmap.m_Height, std::byte(0));
+
+		if (bitmap.m_Pixels.empty())
+			return;
+
+		stbtt_MakeGlyphBitmap(m_pFontInfo.get(), reinterpret_cast<unsigned char*>(bitmap.m_Pixels.data()), static_cast<int>(bitmap.m_Width), static_cast<int>(bitmap.m_Height), static_cast<int>(bitmap.m_Width), scale, scale, static_cast<int>(glyphIndex));
+	}
+
+	void Font::rasterizeDistanceField(uint32_t glyphIndex, float size, uint32_t padding, GlyphBitmap& bitmap) const
+	{
+		// Map the padding to the full range, so that the field reaches 0 at the border of the bitmap.
+		const auto distanceScale = 128.0f / static_cast<float>(std::max(padding, 1u));
+
+		int width = 0, height = 0, xOffset = 0, yOffset = 0;
+		const auto pPixels = stbtt_GetGlyphSDF(m_pFontInfo.get(), getScale(size), static_cast<int>(glyphIndex), static_cast<int>(padding), 128, distanceScale, &width, &height, &xOffset, &yOffset);
+
+		bitmap.m_Width = pPixels ? static_cast<uint32_t>(width) : 0;
+		bitmap.m_Height = pPixels ? static_cast<uint32_t>(height) : 0;
+		bitmap.m_Offset = Point2D_F32(static_cast<float>(xOffset), static_cast<float>(yOffset));
+		bitmap.m_Pixels.resize(static_cast<uint64_t>(bitmap.m_Width) * bitmap.m_Height);
+
+		if (pPixels == nullptr)
+			return;
+
+		std::memcpy(bitmap.m_Pixels.data(), pPixels, bitmap.m_Pixels.size());
+		stbtt_FreeSDF(pPixels, nullptr);
+	}
+
+	float Font::getScale(float size) const
+	{
+		return stbtt_ScaleForMappingEmToPixels(m_pFontInfo.get(), size);
+	}
+}
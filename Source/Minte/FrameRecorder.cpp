@@ -0,0 +1,563 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/FrameRecorder.hpp"
+#include "Minte/FrontendError.hpp"
+
+#include <stb_image_write.h>
+
+#include <array>
+#include <algorithm>
+#include <string>
+
+namespace /* anonymous */
+{
+	/**
+	 * Pixel structure.
+	 * This is used by the QOI encoder.
+	 */
+	struct Pixel final
+	{
+		uint8_t m_R = 0;
+		uint8_t m_G = 0;
+		uint8_t m_B = 0;
+		uint8_t m_A = 0;
+
+		/**
+		 * Equality operator.
+		 *
+		 * @param other The other pixel.
+		 * @return Whether the pixels are equal.
+		 */
+		[[nodiscard]] bool operator==(const Pixel& other) const = default;
+	};
+
+	/**
+	 * Clamp and round a floating point value to a byte.
+	 *
+	 * @param value The value in the [0, 255] range.
+	 * @return The byte value.
+	 */
+	uint8_t ToByte(float value)
+	{
+		return static_cast<uint8_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+	}
+
+	/**
+	 * Convert the color output to tightly packed straight alpha RGBA.
+	 *
+	 * @param pData The color output data.
+	 * @param width The width of the image.
+	 * @param height The height of the image.
+	 * @param format The output format of the data.
+	 * @param scratch The scratch buffer used to store the converted pixels.
+	 * @return The RGBA pixels. This points to the data itself if no conversion was needed.
+	 */
+	const uint8_t* ToRGBA(const uint8_t* pData, uint32_t width, uint32_t height, minte::backend::OutputFormat format, std::vector<uint8_t>& scratch)
+	{
+		using minte::backend::OutputFormat;
+		if (format == OutputFormat::RGBA)
+			return pData;
+
+		const uint64_t pixelCount = static_cast<uint64_t>(width) * height;
+		scratch.resize(pixelCount * 4);
+
+		switch (format)
+		{
+		case OutputFormat::BGRA:
+		case OutputFormat::PremultipliedRGBA:
+		case OutputFormat::PremultipliedBGRA:
+		{
+			const bool bSwizzle = format != OutputFormat::PremultipliedRGBA;
+			const bool bPremultiplied = format != OutputFormat::BGRA;
+
+			for (uint64_t i = 0; i < pixelCount; i++)
+			{
+				const uint8_t* pSource = pData + i * 4;
+				uint8_t* pDestination = scratch.data() + i * 4;
+
+				pDestination[0] = bSwizzle ? pSource[2] : pSource[0];
+				pDestination[1] = pSource[1];
+				pDestination[2] = bSwizzle ? pSource[0] : pSource[2];
+				pDestination[3] = pSource[3];
+
+				// Convert back to straight alpha.
+				if (bPremultiplied && pDestination[3] != 0 && pDestination[3] != 255)
+				{
+					const float scale = 255.0f / pDestination[3];
+					pDestination[0] = ToByte(pDestination[0] * scale);
+					pDestination[1] = ToByte(pDestination[1] * scale);
+					pDestination[2] = ToByte(pDestination[2] * scale);
+				}
+			}
+
+			break;
+		}
+
+		case OutputFormat::NV12:
+		case OutputFormat::YUV420:
+		{
+			const uint8_t* pLuma = pData;
+			const uint8_t* pChroma = pData + pixelCount;
+			const uint32_t chromaWidth = width / 2;
+
+			for (uint32_t y = 0; y < height; y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const uint64_t chromaIndex = static_cast<uint64_t>(y / 2) * chromaWidth + x / 2;
+					const float u = (format == OutputFormat::NV12 ? pChroma[chromaIndex * 2] : pChroma[chromaIndex]) - 128.0f;
+					const float v = (format == OutputFormat::NV12 ? pChroma[chromaIndex * 2 + 1] : pChroma[chromaIndex + pixelCount / 4]) - 128.0f;
+					const float luma = 1.1644f * (pLuma[static_cast<uint64_t>(y) * width + x] - 16.0f);
+
+					// BT.709 limited range.
+					uint8_t* pDestination = scratch.data() + (static_cast<uint64_t>(y) * width + x) * 4;
+					pDestination[0] = ToByte(luma + 1.7927f * v);
+					pDestination[1] = ToByte(luma - 0.2132f * u - 0.5329f * v);
+					pDestination[2] = ToByte(luma + 2.1124f * u);
+					pDestination[3] = 255;
+				}
+			}
+
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return scratch.data();
+	}
+
+	/**
+	 * Convert the color output to planar YUV 4:2:0.
+	 * The color is composited over black and converted using BT.709 limited range, which matches the device conversion.
+	 *
+	 * @param pData The color output data.
+	 * @param width The width of the image.
+	 * @param height The height of the image.
+	 * @param format The output format of the data.
+	 * @param destination The destination to append the planes to.
+	 */
+	void AppendYUV420(const uint8_t* pData, uint32_t width, uint32_t height, minte::backend::OutputFormat format, std::vector<uint8_t>& destination)
+	{
+		using minte::backend::OutputFormat;
+
+		const uint64_t pixelCount = static_cast<uint64_t>(width) * height;
+		const uint32_t chromaWidth = (width + 1) / 2;
+		const uint32_t chromaHeight = (height + 1) / 2;
+		const uint64_t chromaCount = static_cast<uint64_t>(chromaWidth) * chromaHeight;
+
+		// The data is already in the required layout.
+		if (format == OutputFormat::YUV420)
+		{
+			destination.insert(destination.end(), pData, pData + pixelCount + chromaCount * 2);
+			return;
+		}
+
+		const auto offset = destination.size();
+		destination.resize(offset + pixelCount + chromaCount * 2);
+
+		uint8_t* pLuma = destination.data() + offset;
+		uint8_t* pU = pLuma + pixelCount;
+		uint8_t* pV = pU + chromaCount;
+
+		// De-interleave the chroma plane.
+		if (format == OutputFormat::NV12)
+		{
+			std::copy(pData, pData + pixelCount, pLuma);
+			for (uint64_t i = 0; i < chromaCount; i++)
+			{
+				pU[i] = pData[pixelCount + i * 2];
+				pV[i] = pData[pixelCount + i * 2 + 1];
+			}
+
+			return;
+		}
+
+		const bool bSwizzle = format == OutputFormat::BGRA || format == OutputFormat::PremultipliedBGRA;
+		const bool bPremultiplied = format == OutputFormat::PremultipliedRGBA || format == OutputFormat::PremultipliedBGRA;
+
+		// Load a pixel composited over black.
+		const auto load = [&](uint32_t x, uint32_t y, float& r, float& g, float& b)
+		{
+			const uint8_t* pPixel = pData + (static_cast<uint64_t>(std::min(y, height - 1)) * width + std::min(x, width - 1)) * 4;
+			const float alpha = bPremultiplied ? 1.0f : pPixel[3] / 255.0f;
+
+			r = (bSwizzle ? pPixel[2] : pPixel[0]) * alpha;
+			g = pPixel[1] * alpha;
+			b = (bSwizzle ? pPixel[0] : pPixel[2]) * alpha;
+		};
+
+		for (uint32_t y = 0; y < height; y++)
+		{
+			for (uint32_t x = 0; x < width; x++)
+			{
+				float r = 0.0f, g = 0.0f, b = 0.0f;
+				load(x, y, r, g, b);
+				pLuma[static_cast<uint64_t>(y) * width + x] = ToByte(0.1826f * r + 0.6142f * g + 0.0620f * b + 16.0f);
+			}
+		}
+
+		for (uint32_t y = 0; y < chromaHeight; y++)
+		{
+			for (uint32_t x = 0; x < chromaWidth; x++)
+			{
+				float r = 0.0f, g = 0.0f, b = 0.0f;
+				float sumR = 0.0f, sumG = 0.0f, sumB = 0.0f;
+				for (uint32_t i = 0; i < 4; i++)
+				{
+					load(x * 2 + i % 2, y * 2 + i / 2, r, g, b);
+					sumR += r;
+					sumG += g;
+					sumB += b;
+				}
+
+				sumR *= 0.25f;
+				sumG *= 0.25f;
+				sumB *= 0.25f;
+
+				const uint64_t index = static_cast<uint64_t>(y) * chromaWidth + x;
+				pU[index] = ToByte(-0.1006f * sumR - 0.3386f * sumG + 0.4392f * sumB + 128.0f);
+				pV[index] = ToByte(0.4392f * sumR - 0.3989f * sumG - 0.0403f * sumB + 128.0f);
+			}
+		}
+	}
+
+	/**
+	 * Append a 32 bit big endian integer.
+	 *
+	 * @param destination The destination.
+	 * @param value The value to append.
+	 */
+	void AppendBigEndian(std::vector<uint8_t>& destination, uint32_t value)
+	{
+		destination.emplace_back(static_cast<uint8_t>(value >> 24));
+		destination.emplace_back(static_cast<uint8_t>(value >> 16));
+		destination.emplace_back(static_cast<uint8_t>(value >> 8));
+		destination.emplace_back(static_cast<uint8_t>(value));
+	}
+
+	/**
+	 * Encode RGBA pixels using the Quite OK Image format.
+	 *
+	 * @param pPixels The RGBA pixels.
+	 * @param width The width of the image.
+	 * @param height The height of the image.
+	 * @param destination The destination to append the encoded image to.
+	 */
+	void EncodeQOI(const uint8_t* pPixels, uint32_t width, uint32_t height, std::vector<uint8_t>& destination)
+	{
+		constexpr uint8_t OpIndex = 0x00;
+		constexpr uint8_t OpDiff = 0x40;
+		constexpr uint8_t OpLuma = 0x80;
+		constexpr uint8_t OpRun = 0xc0;
+		constexpr uint8_t OpRGB = 0xfe;
+		constexpr uint8_t OpRGBA = 0xff;
+
+		const uint64_t pixelCount = static_cast<uint64_t>(width) * height;
+
+		// The worst case is 5 bytes per pixel, plus the header and the end marker.
+		destination.reserve(destination.size() + 14 + pixelCount * 5 + 8);
+
+		// Write the header.
+		destination.insert(destination.end(), { 'q', 'o', 'i', 'f' });
+		AppendBigEndian(destination, width);
+		AppendBigEndian(destination, height);
+		destination.emplace_back(static_cast<uint8_t>(4));	// RGBA.
+		destination.emplace_back(static_cast<uint8_t>(0));	// sRGB with linear alpha.
+
+		std::array<Pixel, 64> index = {};
+		Pixel previous = { 0, 0, 0, 255 };
+		uint8_t run = 0;
+
+		for (uint64_t i = 0; i < pixelCount; i++)
+		{
+			const uint8_t* pPixel = pPixels + i * 4;
+			const Pixel pixel = { pPixel[0], pPixel[1], pPixel[2], pPixel[3] };
+
+			if (pixel == previous)
+			{
+				run++;
+				if (run == 62 || i == pixelCount - 1)
+				{
+					destination.emplace_back(static_cast<uint8_t>(OpRun | (run - 1)));
+					run = 0;
+				}
+
+				continue;
+			}
+
+			if (run > 0)
+			{
+				destination.emplace_back(static_cast<uint8_t>(OpRun | (run - 1)));
+				run = 0;
+			}
+
+			const uint8_t hash = (pixel.m_R * 3 + pixel.m_G * 5 + pixel.m_B * 7 + pixel.m_A * 11) % 64;
+			if (index[hash] == pixel)
+			{
+				destination.emplace_back(static_cast<uint8_t>(OpIndex | hash));
+			}
+			else
+			{
+				index[hash] = pixel;
+
+				if (pixel.m_A == previous.m_A)
+				{
+					const int8_t dr = static_cast<int8_t>(pixel.m_R - previous.m_R);
+					const int8_t dg = static_cast<int8_t>(pixel.m_G - previous.m_G);
+					const int8_t db = static_cast<int8_t>(pixel.m_B - previous.m_B);
+					const int8_t drdg = dr - dg;
+					const int8_t dbdg = db - dg;
+
+					if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+					{
+						destination.emplace_back(static_cast<uint8_t>(OpDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+					}
+					else if (drdg > -9 && drdg < 8 && dg > -33 && dg < 32 && dbdg > -9 && dbdg < 8)
+					{
+						destination.emplace_back(static_cast<uint8_t>(OpLuma | (dg + 32)));
+						destination.emplace_back(static_cast<uint8_t>((drdg + 8) << 4 | (dbdg + 8)));
+					}
+					else
+					{
+						destination.insert(destination.end(), { OpRGB, pixel.m_R, pixel.m_G, pixel.m_B });
+					}
+				}
+				else
+				{
+					destination.insert(destination.end(), { OpRGBA, pixel.m_R, pixel.m_G, pixel.m_B, pixel.m_A });
+				}
+			}
+
+			previous = pixel;
+		}
+
+		// Write the end marker.
+		destination.insert(destination.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+	}
+
+	/**
+	 * STB write callback.
+	 * This appends the written data to a vector.
+	 *
+	 * @param pContext The destination vector.
+	 * @param pData The data to write.
+	 * @param size The size of the data.
+	 */
+	void AppendToVector(void* pContext, void* pData, int size)
+	{
+		auto pDestination = static_cast<std::vector<uint8_t>*>(pContext);
+		const auto pBegin = static_cast<const uint8_t*>(pData);
+		pDestination->insert(pDestination->end(), pBegin, pBegin + size);
+	}
+
+	/**
+	 * Open a file for large sequential writes.
+	 * The file is unbuffered since we always write whole frames at once.
+	 *
+	 * @param path The file path.
+	 * @return The file pointer. This is nullptr if the file could not be opened.
+	 */
+	std::FILE* OpenFile(const std::filesystem::path& path)
+	{
+		std::FILE* pFile = std::fopen(path.string().c_str(), "wb");
+		if (pFile)
+			std::setvbuf(pFile, nullptr, _IONBF, 0);
+
+		return pFile;
+	}
+}
+
+namespace minte
+{
+	FrameRecorder::FrameRecorder(std::filesystem::path path, FrameFormat format, RecordingPolicy policy /*= RecordingPolicy::Drop*/, uint32_t maxPendingFrames /*= 4*/, uint32_t threadCount /*= 2*/, uint32_t frameRate /*= 60*/)
+		: m_Path(std::move(path))
+		, m_MaxPendingFrames(std::max(maxPendingFrames, 1u))
+		, m_FrameRate(frameRate)
+		, m_Format(format)
+		, m_Policy(policy)
+		, m_ThreadPool(threadCount)
+	{
+		// The Y4M frames go to a single stream, while the rest are written to a directory.
+		if (format == FrameFormat::Y4M)
+		{
+			m_pStream = OpenFile(m_Path);
+			if (m_pStream == nullptr)
+				throw FrontendError("Failed to open the Y4M stream file!");
+		}
+		else
+		{
+			std::filesystem::create_directories(m_Path);
+		}
+	}
+
+	FrameRecorder::~FrameRecorder()
+	{
+		flush();
+
+		if (m_pStream)
+			std::fclose(m_pStream);
+	}
+
+	bool FrameRecorder::record(const LayerOutput& output)
+	{
+		if (output.m_pColorBuffer == nullptr)
+			throw FrontendError("Cannot record a layer output without a color buffer!");
+
+		uint64_t sequence = 0;
+
+		{
+			auto lock = std::unique_lock(m_Mutex);
+			m_Statistics.m_SubmittedFrames++;
+
+			// The Y4M stream cannot change its size midway.
+			if (m_Format == FrameFormat::Y4M)
+			{
+				if (m_StreamWidth == 0)
+				{
+					m_StreamWidth = output.m_Width;
+					m_StreamHeight = output.m_Height;
+				}
+				else if (m_StreamWidth != output.m_Width || m_StreamHeight != output.m_Height)
+				{
+					throw FrontendError("The Y4M stream cannot change its frame size!");
+				}
+			}
+
+			// Apply back-pressure or drop the frame if we're falling behind.
+			if (m_PendingFrames >= m_MaxPendingFrames)
+			{
+				if (m_Policy == RecordingPolicy::Drop)
+				{
+					m_Statistics.m_DroppedFrames++;
+					return false;
+				}
+
+				m_PendingCondition.wait(lock, [this] { return m_PendingFrames < m_MaxPendingFrames; });
+			}
+
+			m_PendingFrames++;
+			sequence = m_NextSequence++;
+		}
+
+		// The job retains the color buffer, so the layer will not overwrite it till we are done. The entity and depth buffers are not needed,
+		// so they are left to the layer to reuse.
+		m_ThreadPool.submit([this, pColorBuffer = output.m_pColorBuffer, width = output.m_Width, height = output.m_Height, format = output.m_ColorFormat, sequence]
+			{
+				writeFrame(pColorBuffer, width, height, format, sequence);
+			});
+		return true;
+	}
+
+	void FrameRecorder::flush()
+	{
+		m_ThreadPool.wait();
+
+		if (m_pStream)
+			std::fflush(m_pStream);
+	}
+
+	FrameRecorderStatistics FrameRecorder::getStatistics() const
+	{
+		auto lock = std::scoped_lock(m_Mutex);
+		return m_Statistics;
+	}
+
+	void FrameRecorder::writeFrame(const std::shared_ptr<backend::ImageBuffer>& pColorBuffer, uint32_t width, uint32_t height, backend::OutputFormat format, uint64_t sequence)
+	{
+		// The scratch buffers are kept per thread so that we don't allocate in the steady state.
+		thread_local std::vector<uint8_t> encoded;
+		thread_local std::vector<uint8_t> scratch;
+		encoded.clear();
+
+		const auto pData = reinterpret_cast<const uint8_t*>(pColorBuffer->mapMemory());
+
+		switch (m_Format)
+		{
+		case FrameFormat::PNG:
+		{
+			const auto pPixels = ToRGBA(pData, width, height, format, scratch);
+			stbi_write_png_to_func(AppendToVector, &encoded, static_cast<int>(width), static_cast<int>(height), 4, pPixels, static_cast<int>(width * 4));
+			break;
+		}
+
+		case FrameFormat::QOI:
+			EncodeQOI(ToRGBA(pData, width, height, format, scratch), width, height, encoded);
+			break;
+
+		case FrameFormat::Y4M:
+		{
+			// Prefix the stream header to the first frame so that every frame is a single write.
+			if (sequence == 0)
+			{
+				const auto header = "YUV4MPEG2 W" + std::to_string(width) + " H" + std::to_string(height) + " F" + std::to_string(m_FrameRate) + ":1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+				encoded.insert(encoded.end(), header.begin(), header.end());
+			}
+
+			constexpr std::string_view frameHeader = "FRAME\n";
+			encoded.insert(encoded.end(), frameHeader.begin(), frameHeader.end());
+			AppendYUV420(pData, width, height, format, encoded);
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		pColorBuffer->unmapMemory();
+
+		// Write the frame. We cannot throw from a worker, so frames which fail to write are counted as dropped.
+		bool bWritten = false;
+		if (m_Format == FrameFormat::Y4M)
+		{
+			bWritten = appendToStream(encoded, sequence);
+		}
+		else
+		{
+			auto name = std::to_string(sequence);
+			name.insert(0, name.size() < 6 ? 6 - name.size() : 0, '0');
+
+			if (std::FILE* pFile = OpenFile(m_Path / ("frame_" + name + (m_Format == FrameFormat::PNG ? ".png" : ".qoi"))))
+			{
+				bWritten = std::fwrite(encoded.data(), 1, encoded.size(), pFile) == encoded.size();
+				std::fclose(pFile);
+			}
+		}
+
+		// Release the frame slot.
+		{
+			auto lock = std::scoped_lock(m_Mutex);
+			m_PendingFrames--;
+
+			if (bWritten)
+			{
+				m_Statistics.m_WrittenFrames++;
+				m_Statistics.m_WrittenBytes += encoded.size();
+			}
+			else
+			{
+				m_Statistics.m_DroppedFrames++;
+			}
+		}
+
+		m_PendingCondition.notify_one();
+	}
+
+	bool FrameRecorder::appendToStream(const std::vector<uint8_t>& data, uint64_t sequence)
+	{
+		// Wait for the previous frames to be written. The pool executes the jobs in order, so the previous frames are already being written.
+		auto lock = std::unique_lock(m_Mutex);
+		m_StreamCondition.wait(lock, [this, sequence] { return m_NextStreamSequence == sequence; });
+		lock.unlock();
+
+		const bool bWritten = std::fwrite(data.data(), 1, data.size(), m_pStream) == data.size();
+
+		lock.lock();
+		m_NextStreamSequence++;
+		lock.unlock();
+
+		m_StreamCondition.notify_all();
+		return bWritten;
+	}
+}
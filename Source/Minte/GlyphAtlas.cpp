@@ -0,0 +1,271 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/GlyphAtlas.hpp"
+#include "Minte/FrontendError.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace /* anonymous */
+{
+	/**
+	 * Create the key of a glyph.
+	 *
+	 * @param fontID The font ID.
+	 * @param glyphIndex The glyph index.
+	 * @param size The quantized font size. This is 0 for distance fields.
+	 * @param mode The glyph mode.
+	 * @return The key.
+	 */
+	uint64_t CreateKey(uint32_t fontID, uint32_t glyphIndex, uint32_t size, minte::GlyphMode mode)
+	{
+		return (static_cast<uint64_t>(fontID & 0xFFFF) << 48) | (static_cast<uint64_t>(glyphIndex & 0xFFFF) << 32) | (static_cast<uint64_t>(size & 0xFFFFFF) << 8) | static_cast<uint64_t>(mode);
+	}
+
+	/**
+	 * Scale a rectangle.
+	 *
+	 * @param rectangle The rectangle to scale.
+	 * @param scale The scale.
+	 * @return The scaled rectangle.
+	 */
+	minte::Rectangle2D_F32 Scale(const minte::Rectangle2D_F32& rectangle, float scale)
+	{
+		return minte::Rectangle2D_F32(
+			minte::Point2D_F32(rectangle.m_MinPoint.m_X * scale, rectangle.m_MinPoint.m_Y * scale),
+			minte::Point2D_F32(rectangle.m_MaxPoint.m_X * scale, rectangle.m_MaxPoint.m_Y * scale)
+		);
+	}
+}
+
+namespace minte
+{
+	GlyphAtlas::GlyphAtlas(TextureFactory&& factory, uint32_t pageSize /*= 1024*/, uint32_t maxPages /*= 4*/, uint32_t firstTextureSlot /*= 1*/, float distanceFieldSize /*= 32.0f*/, uint32_t threadCount /*= 2*/)
+		: m_Factory(std::move(factory))
+		, m_DistanceFieldSize(distanceFieldSize)
+		, m_DistanceFieldPadding(std::max(static_cast<uint32_t>(distanceFieldSize / 8.0f), 2u))
+		, m_PageSize(pageSize)
+		, m_MaxPages(maxPages)
+		, m_FirstTextureSlot(firstTextureSlot)
+		, m_ThreadPool(threadCount)
+	{
+		if (maxPages == 0 || firstTextureSlot + maxPages > backend::RenderTarget::MaxTextures)
+			throw FrontendError("The atlas pages do not fit in the render target's texture slots!");
+
+		m_Pages.reserve(maxPages);
+	}
+
+	GlyphAtlas::~GlyphAtlas()
+	{
+		m_ThreadPool.wait();
+	}
+
+	bool GlyphAtlas::getGlyph(const std::shared_ptr<Font>& pFont, uint32_t glyphIndex, float size, GlyphMode mode, GlyphQuad& quad)
+	{
+		// Coverage glyphs are rasterized at quarter pixel sizes, and are scaled to the exact size.
+		const auto quantizedSize = mode == GlyphMode::Coverage ? std::max(static_cast<uint32_t>(std::lround(size * 4.0f)), 1u) : 0;
+		const auto rasterSize = mode == GlyphMode::Coverage ? static_cast<float>(quantizedSize) / 4.0f : m_DistanceFieldSize;
+		const auto key = CreateKey(pFont->getID(), glyphIndex, quantizedSize, mode);
+
+		const auto [itr, bInserted] = m_Glyphs.try_emplace(key);
+		if (bInserted)
+		{
+			m_ThreadPool.submit([this, pFont, glyphIndex, rasterSize, mode, key]
+				{
+					RasterizedGlyph rasterizedGlyph;
+					rasterizedGlyph.m_Key = key;
+
+					if (mode == GlyphMode::DistanceField)
+						pFont->rasterizeDistanceField(glyphIndex, rasterSize, m_DistanceFieldPadding, rasterizedGlyph.m_Bitmap);
+
+					else
+						pFont->rasterize(glyphIndex, rasterSize, rasterizedGlyph.m_Bitmap);
+
+					auto lock = std::scoped_lock(m_Mutex);
+					m_RasterizedGlyphs.emplace_back(std::move(rasterizedGlyph));
+				}
+			);
+
+			return false;
+		}
+
+		const auto& glyph = itr->second;
+		if (glyph.m_State != GlyphState::Ready)
+			return false;
+
+		quad.m_Bounds = Scale(glyph.m_Bounds, size / rasterSize);
+		quad.m_TextureCoordinates = glyph.m_TextureCoordinates;
+		quad.m_TextureSlot = static_cast<uint8_t>(m_FirstTextureSlot + glyph.m_Page);
+		quad.m_SampleMode = mode == GlyphMode::DistanceField ? backend::SampleMode::DistanceField : backend::SampleMode::Coverage;
+
+		if (glyph.m_Page < m_Pages.size())
+			m_Pages[glyph.m_Page].m_LastUsedFrame = m_Frame;
+
+		return true;
+	}
+
+	bool GlyphAtlas::update()
+	{
+		// Take the glyphs rasterized since the last update. Glyphs which did not fit in the last update are kept.
+		{
+			auto lock = std::scoped_lock(m_Mutex);
+			std::move(m_RasterizedGlyphs.begin(), m_RasterizedGlyphs.end(), std::back_inserter(m_PackingGlyphs));
+			m_RasterizedGlyphs.clear();
+		}
+
+		const auto previousEvictionCount = m_EvictionCount;
+		const auto packedCount = std::erase_if(m_PackingGlyphs, [this](const RasterizedGlyph& rasterizedGlyph) { return pack(rasterizedGlyph); });
+
+		// Upload the new glyphs, one update per page.
+		for (auto& page : m_Pages)
+		{
+			if (page.m_Regions.empty())
+				continue;
+
+			page.m_pTexture->update(page.m_Regions, page.m_UploadData);
+			page.m_Regions.clear();
+			page.m_UploadData.clear();
+		}
+
+		m_Frame++;
+
+		const auto bChanged = packedCount > 0 || m_EvictionCount != previousEvictionCount;
+		if (bChanged)
+			m_Generation++;
+
+		return bChanged;
+	}
+
+	void GlyphAtlas::bind(backend::RenderTarget& renderTarget) const
+	{
+		for (uint32_t i = 0; i < m_Pages.size(); i++)
+			renderTarget.setTexture(m_FirstTextureSlot + i, m_Pages[i].m_pTexture);
+	}
+
+	bool GlyphAtlas::allocate(Page& page, uint32_t width, uint32_t height, Point2D_UI32& position) const
+	{
+		// Use the lowest shelf the glyph fits in, skipping the shelves which are much taller than the glyph.
+		Shelf* pBestShelf = nullptr;
+		for (auto& shelf : page.m_Shelves)
+		{
+			if (shelf.m_Height >= height && shelf.m_Height <= height + height / 2 + 4 && m_PageSize - shelf.m_Width >= width && (pBestShelf == nullptr || shelf.m_Height < pBestShelf->m_Height))
+				pBestShelf = &shelf;
+		}
+
+		// Open a new shelf if there isn't one. The height is rounded up so that similar glyphs can share it.
+		if (pBestShelf == nullptr)
+		{
+			const auto shelfHeight = std::min((height + 3) & ~3u, m_PageSize - page.m_ShelfTop);
+			if (page.m_ShelfTop + height > m_PageSize)
+				return false;
+
+			pBestShelf = &page.m_Shelves.emplace_back(Shelf{ page.m_ShelfTop, shelfHeight, 0 });
+			page.m_ShelfTop += shelfHeight;
+		}
+
+		position = Point2D_UI32(pBestShelf->m_Width, pBestShelf->m_Y);
+		pBestShelf->m_Width += width;
+		return true;
+	}
+
+	bool GlyphAtlas::pack(const RasterizedGlyph& rasterizedGlyph)
+	{
+		const auto itr = m_Glyphs.find(rasterizedGlyph.m_Key);
+		if (itr == m_Glyphs.end())
+			return true;
+
+		auto& glyph = itr->second;
+		const auto& bitmap = rasterizedGlyph.m_Bitmap;
+
+		// Each glyph is surrounded by an empty border, so that filtering does not read its neighbours. The border is uploaded with the glyph, so
+		// it's cleared even if the page was used before.
+		const auto cellWidth = bitmap.m_Width + 2;
+		const auto cellHeight = bitmap.m_Height + 2;
+
+		// Glyphs without an outline, and glyphs which are too large for a page, are not drawn.
+		if (bitmap.m_Width == 0 || bitmap.m_Height == 0 || cellWidth > m_PageSize || cellHeight > m_PageSize)
+		{
+			glyph.m_Bounds = Rectangle2D_F32();
+			glyph.m_Page = m_MaxPages;
+			glyph.m_State = GlyphState::Ready;
+			return true;
+		}
+
+		// Find a page with space, or create a new page, or clear a page that's not in use.
+		Point2D_UI32 position;
+		uint32_t pageIndex = 0;
+		for (; pageIndex < m_Pages.size(); pageIndex++)
+		{
+			if (allocate(m_Pages[pageIndex], cellWidth, cellHeight, position))
+				break;
+		}
+
+		if (pageIndex == m_Pages.size())
+		{
+			if (m_Pages.size() < m_MaxPages)
+			{
+				m_Pages.emplace_back().m_pTexture = m_Factory(m_PageSize, m_PageSize, backend::TextureFormat::R8);
+			}
+			else
+			{
+				pageIndex = evict();
+				if (pageIndex == m_Pages.size())
+					return false;
+			}
+
+			if (!allocate(m_Pages[pageIndex], cellWidth, cellHeight, position))
+				return false;
+		}
+
+		// Copy the glyph to the page's upload data.
+		auto& page = m_Pages[pageIndex];
+		const auto offset = page.m_UploadData.size();
+		page.m_UploadData.resize(offset + static_cast<uint64_t>(cellWidth) * cellHeight, std::byte(0));
+
+		for (uint32_t y = 0; y < bitmap.m_Height; y++)
+			std::memcpy(page.m_UploadData.data() + offset + static_cast<uint64_t>(y + 1) * cellWidth + 1, bitmap.m_Pixels.data() + static_cast<uint64_t>(y) * bitmap.m_Width, bitmap.m_Width);
+
+		page.m_Regions.emplace_back(backend::TextureRegion{ offset, position.m_X, position.m_Y, cellWidth, cellHeight });
+		page.m_Glyphs.emplace_back(rasterizedGlyph.m_Key);
+		page.m_LastUsedFrame = m_Frame;
+
+		const auto pageSize = static_cast<float>(m_PageSize);
+		glyph.m_Bounds = Rectangle2D_F32(bitmap.m_Offset, Point2D_F32(bitmap.m_Offset.m_X + bitmap.m_Width, bitmap.m_Offset.m_Y + bitmap.m_Height));
+		glyph.m_TextureCoordinates = Rectangle2D_F32(
+			Point2D_F32((position.m_X + 1) / pageSize, (position.m_Y + 1) / pageSize),
+			Point2D_F32((position.m_X + 1 + bitmap.m_Width) / pageSize, (position.m_Y + 1 + bitmap.m_Height) / pageSize)
+		);
+
+		glyph.m_Page = pageIndex;
+		glyph.m_State = GlyphState::Ready;
+		return true;
+	}
+
+	uint32_t GlyphAtlas::evict()
+	{
+		auto pageIndex = static_cast<uint32_t>(m_Pages.size());
+		for (uint32_t i = 0; i < m_Pages.size(); i++)
+		{
+			if (m_Pages[i].m_LastUsedFrame < m_Frame && (pageIndex == m_Pages.size() || m_Pages[i].m_LastUsedFrame < m_Pages[pageIndex].m_LastUsedFrame))
+				pageIndex = i;
+		}
+
+		if (pageIndex == m_Pages.size())
+			return pageIndex;
+
+		// The glyphs are removed from the atlas, so they are rasterized again the next time they are requested.
+		auto& page = m_Pages[pageIndex];
+		for (const auto key : page.m_Glyphs)
+			m_Glyphs.erase(key);
+
+		page.m_Glyphs.clear();
+		page.m_Shelves.clear();
+		page.m_Regions.clear();
+		page.m_UploadData.clear();
+		page.m_ShelfTop = 0;
+
+		m_EvictionCount++;
+		return pageIndex;
+	}
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/InputQueue.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace minte
+{
+	InputQueue::InputQueue(uint32_t capacity)
+		: m_pCells(std::make_unique<Cell[]>(std::bit_ceil(std::max(capacity, 2u))))
+		, m_Mask(std::bit_ceil(std::max(capacity, 2u)) - 1)
+	{
+		// Each cell starts with its own position as the sequence, which means that it's free for that position.
+		for (uint64_t i = 0; i <= m_Mask; i++)
+			m_pCells[i].m_Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	bool InputQueue::push(const InputEvent& event)
+	{
+		// Keep the last quarter of the queue for the events that cannot be merged.
+		if (event.m_Type == InputEventType::MouseMove && getSize() >= getCapacity() - getCapacity() / 4)
+		{
+			m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		auto position = m_EnqueuePosition.load(std::memory_order_relaxed);
+		Cell* pCell = nullptr;
+
+		while (true)
+		{
+			pCell = &m_pCells[position & m_Mask];
+			const auto sequence = pCell->m_Sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+			// The cell is free, so try to claim it.
+			if (difference == 0)
+			{
+				if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+
+			// The cell still holds an event from the previous lap, so the queue is full.
+			else if (difference < 0)
+			{
+				m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			// Another producer claimed the cell, so try again with the latest position.
+			else
+			{
+				position = m_EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		pCell->m_Event = event;
+		pCell->m_Sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	uint32_t InputQueue::drain(std::vector<InputEvent>& events)
+	{
+		const auto first = events.size();
+		auto position = m_DequeuePosition.load(std::memory_order_relaxed);
+
+		uint32_t count = 0;
+		for (; count <= m_Mask; count++, position++)
+		{
+			auto& cell = m_pCells[position & m_Mask];
+			if (cell.m_Sequence.load(std::memory_order_acquire) != position + 1)
+				break;
+
+			const auto event = cell.m_Event;
+			cell.m_Sequence.store(position + m_Mask + 1, std::memory_order_release);
+
+			// Merge consecutive mouse moves, keeping the latest position and the total movement.
+			if (event.m_Type == InputEventType::MouseMove && events.size() > first && events.back().m_Type == InputEventType::MouseMove)
+			{
+				auto& previous = events.back();
+				previous.m_Position = event.m_Position;
+				previous.m_Delta.m_X += event.m_Delta.m_X;
+				previous.m_Delta.m_Y += event.m_Delta.m_Y;
+			}
+			else
+			{
+				events.emplace_back(event);
+			}
+		}
+
+		m_DequeuePosition.store(position, std::memory_order_relaxed);
+		return count;
+	}
+}
@@ -3,12 +3,155 @@
 #include "Minte/Layer.hpp"
 #include "Minte/FrontendError.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace /* anonymous */
+{
+	/**
+	 * Intersect two rectangles.
+	 * The minimum point of the result is greater than its maximum point if the rectangles do not overlap.
+	 *
+	 * @param lhs The first rectangle.
+	 * @param rhs The second rectangle.
+	 * @return The intersection.
+	 */
+	minte::Rectangle2D_F32 Intersect(const minte::Rectangle2D_F32& lhs, const minte::Rectangle2D_F32& rhs)
+	{
+		return minte::Rectangle2D_F32(
+			minte::Point2D_F32(std::max(lhs.m_MinPoint.m_X, rhs.m_MinPoint.m_X), std::max(lhs.m_MinPoint.m_Y, rhs.m_MinPoint.m_Y)),
+			minte::Point2D_F32(std::min(lhs.m_MaxPoint.m_X, rhs.m_MaxPoint.m_X), std::min(lhs.m_MaxPoint.m_Y, rhs.m_MaxPoint.m_Y))
+		);
+	}
+
+	/**
+	 * Convert a clip rectangle to a scissor rectangle.
+	 * The rectangle is rounded outwards to whole pixels, and clamped to the render target.
+	 *
+	 * @param clip The clip rectangle in layer space.
+	 * @param width The width of the render target.
+	 * @param height The height of the render target.
+	 * @return The scissor rectangle.
+	 */
+	minte::backend::ScissorRectangle ToScissorRectangle(const minte::Rectangle2D_F32& clip, uint32_t width, uint32_t height)
+	{
+		const auto maxWidth = static_cast<float>(std::min<uint32_t>(width, std::numeric_limits<uint16_t>::max()));
+		const auto maxHeight = static_cast<float>(std::min<uint32_t>(height, std::numeric_limits<uint16_t>::max()));
+
+		const auto minX = std::clamp(std::floor(clip.m_MinPoint.m_X), 0.0f, maxWidth);
+		const auto minY = std::clamp(std::floor(clip.m_MinPoint.m_Y), 0.0f, maxHeight);
+		const auto maxX = std::clamp(std::ceil(clip.m_MaxPoint.m_X), minX, maxWidth);
+		const auto maxY = std::clamp(std::ceil(clip.m_MaxPoint.m_Y), minY, maxHeight);
+
+		minte::backend::ScissorRectangle scissor;
+		scissor.m_X = static_cast<uint16_t>(minX);
+		scissor.m_Y = static_cast<uint16_t>(minY);
+		scissor.m_Width = static_cast<uint16_t>(maxX - minX);
+		scissor.m_Height = static_cast<uint16_t>(maxY - minY);
+		return scissor;
+	}
+
+	/**
+	 * Check if a draw command can be merged into the previous command.
+	 * The commands must have the same state, and the indices between them must be degenerate triangles. The triangles are read in groups of 3
+	 * from the start of the previous command, so the next command must start at a multiple of 3 from it.
+	 *
+	 * @param previous The previous command.
+	 * @param command The command to merge.
+	 * @param fillerEnd The end of the degenerate triangles following the previous command.
+	 * @return Whether the commands can be merged.
+	 */
+	bool CanMergeDrawCommands(const minte::backend::DrawCommand& previous, const minte::backend::DrawCommand& command, uint64_t fillerEnd)
+	{
+		const auto previousEnd = static_cast<uint64_t>(previous.m_IndexOffset) + previous.m_IndexCount;
+		if (command.m_IndexOffset != previousEnd && command.m_IndexOffset != fillerEnd)
+			return false;
+
+		return (command.m_IndexOffset - previous.m_IndexOffset) % 3 == 0
+			&& command.m_VertexOffset == previous.m_VertexOffset
+			&& command.m_Scissor == previous.m_Scissor
+			&& command.m_TextureSlot == previous.m_TextureSlot
+			&& command.m_SampleMode == previous.m_SampleMode
+			&& command.m_IsOpaque == previous.m_IsOpaque;
+	}
+}
+
 namespace minte
 {
 	Layer::Layer(Minte parent, std::unique_ptr<backend::RenderTarget>&& pRenderTarget)
 		: MinteObject(parent)
 		, m_pRenderTarget(std::move(pRenderTarget))
 	{
+		m_pStorage->setTextResources(nullptr, m_pTextLayoutCache.get());
+	}
+
+	Layer::~Layer()
+	{
+		detachDrawables();
+	}
+
+	Layer& Layer::operator=(Layer&& other) noexcept
+	{
+		if (this != &other)
+		{
+			detachDrawables();
+
+			MinteObject::operator=(std::move(other));
+			m_pRenderTarget = std::move(other.m_pRenderTarget);
+			m_pGlyphAtlas = std::move(other.m_pGlyphAtlas);
+			m_pTextLayoutCache = std::move(other.m_pTextLayoutCache);
+			m_GlyphAtlasGeneration = other.m_GlyphAtlasGeneration;
+			m_pDrawStreamWriter = std::move(other.m_pDrawStreamWriter);
+			m_DrawStreamLayerID = other.m_DrawStreamLayerID;
+			m_DrawStreamTextures = other.m_DrawStreamTextures;
+			m_pStorage = std::move(other.m_pStorage);
+			m_Drawables = std::move(other.m_Drawables);
+			m_DrawOrder = std::move(other.m_DrawOrder);
+			m_DrawRanks = std::move(other.m_DrawRanks);
+			m_VisibleElements = std::move(other.m_VisibleElements);
+			m_VertexScratch = std::move(other.m_VertexScratch);
+			m_IndexScratch = std::move(other.m_IndexScratch);
+			m_BatchScratch = std::move(other.m_BatchScratch);
+			m_DrawStack = std::move(other.m_DrawStack);
+			m_CommandScratch = std::move(other.m_CommandScratch);
+			m_LayoutEngine = std::move(other.m_LayoutEngine);
+			m_LayoutRoots = std::move(other.m_LayoutRoots);
+			m_pInputQueue = std::move(other.m_pInputQueue);
+			m_InputEvents = std::move(other.m_InputEvents);
+			m_FocusedElement = other.m_FocusedElement;
+			m_ChangeGeneration = other.m_ChangeGeneration;
+			m_DrawnGeneration = other.m_DrawnGeneration;
+			m_DrawnStateGeneration = other.m_DrawnStateGeneration;
+			m_IsStructureDirty = other.m_IsStructureDirty;
+		}
+
+		return *this;
+	}
+
+	void Layer::addDrawable(std::shared_ptr<Drawable> pDrawable)
+	{
+		if (pDrawable->m_pParentDrawable || pDrawable->m_IsLayerRoot)
+			throw FrontendError("The drawable already has a parent!");
+
+		pDrawable->m_IsLayerRoot = true;
+		pDrawable->attach(m_pStorage.get());
+		pDrawable->setTransformDirty();
+
+		m_Drawables.emplace_back(std::move(pDrawable));
+		m_IsStructureDirty = true;
+	}
+
+	void Layer::removeDrawable(const Drawable* pDrawable)
+	{
+		const auto itr = std::find_if(m_Drawables.begin(), m_Drawables.end(), [pDrawable](const std::shared_ptr<Drawable>& pCandidate) { return pCandidate.get() == pDrawable; });
+		if (itr == m_Drawables.end())
+			return;
+
+		(*itr)->detach();
+		(*itr)->m_IsLayerRoot = false;
+		m_Drawables.erase(itr);
+		m_IsStructureDirty = true;
 	}
 
 	LayerOutput Layer::update()
@@ -18,15 +161,493 @@ namespace minte
 		// We need to update only if the render target is valid.
 		if (m_pRenderTarget->isValid())
 		{
-			m_pRenderTarget->draw();
+			if (m_pDrawStreamWriter)
+				m_pDrawStreamWriter->beginLayerUpdate(m_DrawStreamLayerID);
+
+			// Upload the glyphs rasterized since the last update before the text is generated.
+			if (m_pGlyphAtlas)
+				updateGlyphAtlas();
+
+			updateDrawables();
+
+			if (m_pTextLayoutCache)
+				m_pTextLayoutCache->update();
 
-			// Get the output images.
-			output.m_pColorBuffer = m_pRenderTarget->getColorBuffer();
-			output.m_pEntityBuffer = m_pRenderTarget->getEntityBuffer();
-			output.m_pDepthBuffer = m_pRenderTarget->getDepthBuffer();
+			if (m_pDrawStreamWriter)
+				recordTextureBinds();
+
+			// The buffers still contain the last draw if nothing changed since, so there's nothing to record, submit or copy. The render target's
+			// settings can make the last draw stale as well, like a new output format replacing the color buffer.
+			output.m_IsUnchanged = m_DrawnGeneration == m_ChangeGeneration && m_DrawnStateGeneration == m_pRenderTarget->getStateGeneration();
+			if (!output.m_IsUnchanged)
+			{
+				if (m_pDrawStreamWriter)
+					m_pDrawStreamWriter->recordLayerUpdate(m_DrawStreamLayerID);
+
+				m_pRenderTarget->draw();
+				m_DrawnGeneration = m_ChangeGeneration;
+				m_DrawnStateGeneration = m_pRenderTarget->getStateGeneration();
+			}
+
+			// Get the output images. The handles tell the render target when the user is done with the buffers.
+			output.m_pColorBuffer = backend::ImageBuffer::Retain(m_pRenderTarget->getColorBuffer());
+			output.m_pEntityBuffer = backend::ImageBuffer::Retain(m_pRenderTarget->getEntityBuffer());
+			output.m_pDepthBuffer = backend::ImageBuffer::Retain(m_pRenderTarget->getDepthBuffer());
+
+			output.m_Width = m_pRenderTarget->getWidth();
+			output.m_Height = m_pRenderTarget->getHeight();
+			output.m_ColorFormat = m_pRenderTarget->getOutputFormat();
+
+			// The update is the frame boundary of the instance's allocation counters.
+			m_pRenderTarget->getInstance()->advanceFrame();
 		}
 
+		handleInputs();
+
 		return output;
 	}
 
+	ElementHandle Layer::hitTest(Point2D_F32 point) const
+	{
+		uint32_t topIndex = 0;
+		uint32_t topRank = 0;
+
+		const auto bounds = m_pStorage->getBounds();
+		m_pStorage->getSpatialIndex().query(point, [this, point, bounds, &topIndex, &topRank](uint32_t index)
+			{
+				const auto rank = index < m_DrawRanks.size() ? m_DrawRanks[index] : 0;
+				if (rank > topRank && SpatialIndex::Overlaps(bounds[index], Rectangle2D_F32(point, point)))
+				{
+					topIndex = index;
+					topRank = rank;
+				}
+			}
+		);
+
+		return topRank > 0 ? m_pStorage->getHandle(topIndex) : ElementHandle();
+	}
+
+	void Layer::queryElements(const Rectangle2D_F32& rectangle, std::vector<ElementHandle>& handles) const
+	{
+		const auto first = handles.size();
+		const auto bounds = m_pStorage->getBounds();
+		m_pStorage->getSpatialIndex().query(rectangle, [this, &rectangle, bounds, &handles](uint32_t index)
+			{
+				if (index < m_DrawRanks.size() && m_DrawRanks[index] > 0 && SpatialIndex::Overlaps(bounds[index], rectangle))
+					handles.emplace_back(m_pStorage->getHandle(index));
+			}
+		);
+
+		std::sort(handles.begin() + first, handles.end(), [this](ElementHandle lhs, ElementHandle rhs) { return m_DrawRanks[lhs.getIndex()] < m_DrawRanks[rhs.getIndex()]; });
+	}
+
+	void Layer::setDrawStreamWriter(std::shared_ptr<DrawStreamWriter> pWriter)
+	{
+		m_pDrawStreamWriter = std::move(pWriter);
+
+		if (m_pDrawStreamWriter)
+		{
+			m_DrawStreamLayerID = m_pDrawStreamWriter->registerLayer(m_pRenderTarget->getWidth(), m_pRenderTarget->getHeight(), m_pRenderTarget->getAntiAliasing(), m_pRenderTarget->getOutputFormat());
+			m_pDrawStreamWriter->captureTextures(*m_pRenderTarget->getInstance());
+			m_DrawStreamTextures.fill(0);
+
+			// Upload everything again so that the stream contains the whole layer.
+			for (const auto& pDrawable : m_Drawables)
+				pDrawable->setTransformDirty();
+
+			m_IsStructureDirty = true;
+		}
+	}
+
+	void Layer::setGlyphAtlas(std::shared_ptr<GlyphAtlas> pAtlas)
+	{
+		m_pGlyphAtlas = std::move(pAtlas);
+		m_pStorage->setTextResources(m_pGlyphAtlas.get(), m_pTextLayoutCache.get());
+
+		if (m_pGlyphAtlas)
+			m_GlyphAtlasGeneration = m_pGlyphAtlas->getGeneration();
+
+		invalidateGlyphAtlasUsers();
+	}
+
+	void Layer::setTextLayoutCache(std::shared_ptr<TextLayoutCache> pCache)
+	{
+		m_pTextLayoutCache = std::move(pCache);
+		m_pStorage->setTextResources(m_pGlyphAtlas.get(), m_pTextLayoutCache.get());
+	}
+
+	void Layer::detachDrawables()
+	{
+		for (const auto& pDrawable : m_Drawables)
+		{
+			pDrawable->detach();
+			pDrawable->m_IsLayerRoot = false;
+		}
+
+		m_Drawables.clear();
+	}
+
+	void Layer::updateGlyphAtlas()
+	{
+		m_pGlyphAtlas->update();
+		m_pGlyphAtlas->bind(*m_pRenderTarget);
+
+		// The atlas can be shared, so the generation is compared with the one this layer last saw.
+		if (m_pGlyphAtlas->getGeneration() != m_GlyphAtlasGeneration)
+		{
+			m_GlyphAtlasGeneration = m_pGlyphAtlas->getGeneration();
+			invalidateGlyphAtlasUsers();
+		}
+	}
+
+	void Layer::recordTextureBinds()
+	{
+		for (uint32_t slot = 0; slot < backend::RenderTarget::MaxTextures; slot++)
+		{
+			const auto& pTexture = m_pRenderTarget->getTexture(slot);
+			const auto uniqueID = pTexture ? pTexture->getUniqueID() : 0;
+			if (m_DrawStreamTextures[slot] != uniqueID)
+			{
+				m_pDrawStreamWriter->recordTextureBind(m_DrawStreamLayerID, slot, pTexture.get());
+				m_DrawStreamTextures[slot] = uniqueID;
+			}
+		}
+	}
+
+	void Layer::invalidateGlyphAtlasUsers()
+	{
+		const auto flags = m_pStorage->getFlags();
+		const auto drawables = m_pStorage->getDrawables();
+
+		for (uint32_t i = 0; i < flags.size(); i++)
+		{
+			if ((flags[i] & ElementStorage::ElementFlags::UsesGlyphAtlas) && drawables[i])
+				drawables[i]->setDirty(Drawable::DirtyFlags::Content);
+		}
+	}
+
+	void Layer::updateDrawables()
+	{
+		// Update the layout first, since it moves and resizes the drawables.
+		m_pStorage->takeLayoutRoots(m_LayoutRoots);
+		for (const auto handle : m_LayoutRoots)
+		{
+			if (const auto pDrawable = m_pStorage->getDrawable(handle))
+				m_LayoutEngine.update(*pDrawable, getViewport().m_MaxPoint);
+		}
+
+		bool bCommandsDirty = m_IsStructureDirty;
+		bool bChanged = m_IsStructureDirty || !m_LayoutRoots.empty();
+		m_IsStructureDirty = false;
+
+		// Only the dirty branches are visited.
+		for (const auto& pDrawable : m_Drawables)
+		{
+			if (pDrawable->isDirty())
+			{
+				updateDrawable(*pDrawable, Point2D<float>(), ElementStorage::GetUnclippedRectangle(), bCommandsDirty);
+				bChanged = true;
+			}
+		}
+
+		if (bCommandsDirty)
+			updateDrawCommands();
+
+		if (bChanged)
+			m_ChangeGeneration++;
+	}
+
+	void Layer::updateDrawable(Drawable& drawable, Point2D<float> parentPosition, const Rectangle2D_F32& clip, bool& bCommandsDirty)
+	{
+		const auto flags = drawable.m_DirtyFlags;
+		drawable.m_DirtyFlags = Drawable::DirtyFlags::None;
+
+		const auto position = Point2D<float>(parentPosition.m_X + drawable.m_Position.m_X, parentPosition.m_Y + drawable.m_Position.m_Y);
+
+		if (flags & Drawable::DirtyFlags::Structure)
+			bCommandsDirty = true;
+
+		// Regenerate the geometry if the content changed.
+		if (flags & Drawable::DirtyFlags::Content)
+		{
+			const auto previousIndexCount = drawable.m_Indices.size();
+			m_BatchScratch.swap(drawable.m_Batches);
+
+			drawable.m_Vertices.clear();
+			drawable.m_Indices.clear();
+			drawable.m_Batches.clear();
+			drawable.generateGeometry(drawable.m_Vertices, drawable.m_Indices, drawable.m_Batches);
+
+			if (drawable.m_Indices.size() != previousIndexCount || drawable.m_Batches != m_BatchScratch)
+				bCommandsDirty = true;
+		}
+
+		if (flags & (Drawable::DirtyFlags::Content | Drawable::DirtyFlags::Transform))
+			uploadGeometry(drawable, position, clip, bCommandsDirty);
+
+		if (flags & (Drawable::DirtyFlags::Descendant | Drawable::DirtyFlags::Structure))
+		{
+			// Push the drawable's clip rectangle for its children. Moving it changes the scissor of all of them.
+			auto childClip = clip;
+			if (drawable.m_IsClipping)
+			{
+				const auto& local = drawable.m_ClipRectangle;
+				childClip = Intersect(clip, Rectangle2D_F32(
+					Point2D_F32(local.m_MinPoint.m_X + position.m_X, local.m_MinPoint.m_Y + position.m_Y),
+					Point2D_F32(local.m_MaxPoint.m_X + position.m_X, local.m_MaxPoint.m_Y + position.m_Y)
+				));
+
+				if (flags & Drawable::DirtyFlags::Transform)
+					bCommandsDirty = true;
+			}
+
+			for (const auto& pChild : drawable.m_Children)
+			{
+				if (pChild->isDirty())
+					updateDrawable(*pChild, position, childClip, bCommandsDirty);
+			}
+		}
+	}
+
+	void Layer::uploadGeometry(Drawable& drawable, Point2D<float> position, const Rectangle2D_F32& clip, bool& bCommandsDirty)
+	{
+		const auto index = drawable.m_Handle.getIndex();
+		m_pStorage->getPositions()[index] = position;
+		m_pStorage->getClipRectangles()[index] = clip;
+		m_pStorage->getIndexCounts()[index] = static_cast<uint32_t>(drawable.m_Indices.size());
+
+		// The draw commands need to be rebuilt if the element moved into or out of the viewport.
+		const auto bWasOnScreen = m_pStorage->getSpatialIndex().contains(index) && isOnScreen(m_pStorage->getBounds()[index]);
+
+		if (drawable.m_Vertices.empty() || drawable.m_Indices.empty())
+		{
+			m_pStorage->clearBounds(index, position);
+			return;
+		}
+
+		// Move the vertices to the layer space, and compute the bounds and the opacity while we're at it.
+		auto bounds = Rectangle2D_F32(Point2D_F32(std::numeric_limits<float>::max()), Point2D_F32(std::numeric_limits<float>::lowest()));
+		uint32_t alpha = 0xFF;
+
+		const auto entityID = drawable.m_Handle.getValue();
+		m_VertexScratch.resize(drawable.m_Vertices.size());
+		std::transform(drawable.m_Vertices.begin(), drawable.m_Vertices.end(), m_VertexScratch.begin(), [position, entityID, &bounds, &alpha](Vertex vertex)
+			{
+				vertex.m_Position.m_X += position.m_X;
+				vertex.m_Position.m_Y += position.m_Y;
+				vertex.m_EntityID = entityID;
+
+				bounds.m_MinPoint.m_X = std::min(bounds.m_MinPoint.m_X, vertex.m_Position.m_X);
+				bounds.m_MinPoint.m_Y = std::min(bounds.m_MinPoint.m_Y, vertex.m_Position.m_Y);
+				bounds.m_MaxPoint.m_X = std::max(bounds.m_MaxPoint.m_X, vertex.m_Position.m_X);
+				bounds.m_MaxPoint.m_Y = std::max(bounds.m_MaxPoint.m_Y, vertex.m_Position.m_Y);
+				alpha &= vertex.m_Color >> 24;
+				return vertex;
+			}
+		);
+
+		// The commands of opaque elements can be drawn front to back, so the draw commands are rebuilt when that changes.
+		auto& flags = m_pStorage->getFlags()[index];
+		const auto opacity = alpha == 0xFF ? ElementStorage::ElementFlags::Opaque : ElementStorage::ElementFlags::None;
+		if ((flags & ElementStorage::ElementFlags::Opaque) != opacity)
+		{
+			flags = (flags & ~ElementStorage::ElementFlags::Opaque) | opacity;
+			bCommandsDirty = true;
+		}
+
+		// Elements that are clipped away entirely are dropped before they reach the geometry buffers. The rest are only hit where they're
+		// drawn.
+		if (!SpatialIndex::Overlaps(bounds, clip))
+		{
+			m_pStorage->getIndexCounts()[index] = 0;
+			m_pStorage->clearBounds(index, position);
+
+			if (bWasOnScreen)
+				bCommandsDirty = true;
+
+			return;
+		}
+
+		if (m_pStorage->reserveVertices(index, drawable.m_Vertices.size()))
+			bCommandsDirty = true;
+
+		if (m_pStorage->reserveIndices(index, drawable.m_Indices.size()))
+			bCommandsDirty = true;
+
+		bounds = Intersect(bounds, clip);
+		m_pStorage->setBounds(index, bounds);
+
+		if (isOnScreen(bounds) != bWasOnScreen)
+			bCommandsDirty = true;
+
+		// The indices are made absolute, so that the commands of different elements can be merged. The rest of the range is filled with
+		// degenerate triangles on the element's first vertex, which a merged command can span without drawing anything.
+		const auto vertexOffset = m_pStorage->getVertexRanges()[index].m_Offset;
+		const auto& indexRange = m_pStorage->getIndexRanges()[index];
+		m_IndexScratch.assign(indexRange.m_Capacity, static_cast<Index>(vertexOffset));
+		std::transform(drawable.m_Indices.begin(), drawable.m_Indices.end(), m_IndexScratch.begin(), [vertexOffset](Index vertex) { return static_cast<Index>(vertexOffset + vertex); });
+
+		m_pRenderTarget->updateVertices(vertexOffset, m_VertexScratch);
+		m_pRenderTarget->updateIndices(indexRange.m_Offset, m_IndexScratch);
+
+		if (m_pDrawStreamWriter)
+			m_pDrawStreamWriter->recordGeometry(m_DrawStreamLayerID, vertexOffset, m_VertexScratch, indexRange.m_Offset, m_IndexScratch);
+	}
+
+	void Layer::updateDrawCommands()
+	{
+		m_DrawOrder.clear();
+
+		// Walk the tree in draw order, skipping the hidden branches. Parents are drawn before their children.
+		m_DrawStack.clear();
+		for (auto itr = m_Drawables.rbegin(); itr != m_Drawables.rend(); ++itr)
+			m_DrawStack.emplace_back(itr->get());
+
+		while (!m_DrawStack.empty())
+		{
+			const auto pDrawable = m_DrawStack.back();
+			m_DrawStack.pop_back();
+
+			if (!pDrawable->m_IsVisible)
+				continue;
+
+			m_DrawOrder.emplace_back(pDrawable->m_Handle.getIndex());
+			for (auto itr = pDrawable->m_Children.rbegin(); itr != pDrawable->m_Children.rend(); ++itr)
+				m_DrawStack.emplace_back(itr->get());
+		}
+
+		// Rank the elements by their draw order, so that hit tests can find the top most element.
+		m_DrawRanks.assign(m_pStorage->getSlotCount(), 0);
+		for (uint32_t i = 0; i < m_DrawOrder.size(); i++)
+			m_DrawRanks[m_DrawOrder[i]] = i + 1;
+
+		// Collect the visible elements inside the viewport, and put them back in the draw order.
+		const auto bounds = m_pStorage->getBounds();
+		const auto indexCounts = m_pStorage->getIndexCounts();
+
+		m_VisibleElements.clear();
+		m_pStorage->getSpatialIndex().query(getViewport(), [this, bounds, indexCounts](uint32_t index)
+			{
+				if (m_DrawRanks[index] > 0 && indexCounts[index] > 0 && isOnScreen(bounds[index]))
+					m_VisibleElements.emplace_back(index);
+			}
+		);
+
+		std::sort(m_VisibleElements.begin(), m_VisibleElements.end(), [this](uint32_t lhs, uint32_t rhs) { return m_DrawRanks[lhs] < m_DrawRanks[rhs]; });
+
+		// Build the draw commands using the element storage.
+		const auto indexRanges = m_pStorage->getIndexRanges();
+		const auto clips = m_pStorage->getClipRectangles();
+
+		// The commands are built in a scratch buffer and copied, so the render target keeps its storage.
+		auto& commands = m_CommandScratch;
+		commands.clear();
+
+		// Consecutive commands with the same state are merged, as the entity IDs are in the vertices. The end of the degenerate triangles
+		// after the last command is tracked, so that a command can be merged across them.
+		uint64_t fillerEnd = 0;
+		const auto appendCommand = [&commands, &fillerEnd](const backend::DrawCommand& command)
+		{
+			if (!commands.empty() && CanMergeDrawCommands(commands.back(), command, fillerEnd))
+				commands.back().m_IndexCount = command.m_IndexOffset + command.m_IndexCount - commands.back().m_IndexOffset;
+
+			else
+				commands.emplace_back(command);
+		};
+
+		const auto drawables = m_pStorage->getDrawables();
+		const auto flags = m_pStorage->getFlags();
+		for (const auto index : m_VisibleElements)
+		{
+			backend::DrawCommand command;
+			command.m_IndexOffset = static_cast<uint32_t>(indexRanges[index].m_Offset);
+			command.m_IndexCount = indexCounts[index];
+			command.m_Scissor = ToScissorRectangle(clips[index], m_pRenderTarget->getWidth(), m_pRenderTarget->getHeight());
+
+			// Only the vertex colors are known to be opaque, so the commands that sample a texture are translucent.
+			const bool bOpaque = flags[index] & ElementStorage::ElementFlags::Opaque;
+			command.m_IsOpaque = bOpaque;
+
+			// Each batch gets its own command, and the indices that are not batched are not drawn.
+			const auto& batches = drawables[index]->m_Batches;
+			const auto lastIndex = command.m_IndexOffset + command.m_IndexCount;
+			if (batches.empty())
+			{
+				appendCommand(command);
+			}
+			else
+			{
+				for (const auto& batch : batches)
+				{
+					command.m_IndexCount = std::min(batch.m_IndexCount, lastIndex - command.m_IndexOffset);
+					command.m_TextureSlot = batch.m_TextureSlot;
+					command.m_SampleMode = batch.m_SampleMode;
+					command.m_IsOpaque = bOpaque && batch.m_SampleMode == backend::SampleMode::Color;
+
+					if (command.m_IndexCount > 0)
+						appendCommand(command);
+
+					command.m_IndexOffset += command.m_IndexCount;
+				}
+			}
+
+			// The rest of the range is degenerate only if the last command drew all the element's indices.
+			const auto drawnEnd = commands.empty() ? 0 : static_cast<uint64_t>(commands.back().m_IndexOffset) + commands.back().m_IndexCount;
+			fillerEnd = drawnEnd == lastIndex ? indexRanges[index].m_Offset + indexRanges[index].m_Capacity : drawnEnd;
+		}
+
+		if (m_pDrawStreamWriter)
+			m_pDrawStreamWriter->recordDrawCommands(m_DrawStreamLayerID, commands);
+
+		m_pRenderTarget->setDrawCommands(std::span<const backend::DrawCommand>(commands));
+	}
+
+	void Layer::handleInputs()
+	{
+		m_InputEvents.clear();
+		if (m_pInputQueue->drain(m_InputEvents) == 0)
+			return;
+
+		// The events are hit tested against the spatial index, which was updated with this frame's geometry.
+		for (const auto& event : m_InputEvents)
+		{
+			switch (event.m_Type)
+			{
+			case InputEventType::MouseButtonDown:
+				m_FocusedElement = hitTest(event.m_Position);
+				dispatchInputEvent(m_FocusedElement, event);
+				break;
+
+			case InputEventType::KeyDown:
+			case InputEventType::KeyUp:
+				dispatchInputEvent(m_FocusedElement, event);
+				break;
+
+			default:
+				dispatchInputEvent(hitTest(event.m_Position), event);
+				break;
+			}
+		}
+	}
+
+	void Layer::dispatchInputEvent(ElementHandle handle, const InputEvent& event)
+	{
+		// The handler might remove drawables, so the parent is looked up again using its handle after each call.
+		for (auto pDrawable = m_pStorage->getDrawable(handle); pDrawable; pDrawable = m_pStorage->getDrawable(handle))
+		{
+			handle = pDrawable->m_pParentDrawable ? pDrawable->m_pParentDrawable->m_Handle : ElementHandle();
+			if (pDrawable->onInputEvent(event))
+				break;
+		}
+	}
+
+	Rectangle2D_F32 Layer::getViewport() const
+	{
+		return Rectangle2D_F32(Point2D_F32(0.0f), Point2D_F32(static_cast<float>(m_pRenderTarget->getWidth()), static_cast<float>(m_pRenderTarget->getHeight())));
+	}
+
+	bool Layer::isOnScreen(const Rectangle2D_F32& bounds) const
+	{
+		return SpatialIndex::Overlaps(bounds, getViewport());
+	}
 }
\ No newline at end of file
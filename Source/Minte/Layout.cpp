@@ -0,0 +1,282 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Layout.hpp"
+#include "Minte/Drawable.hpp"
+
+#include <algorithm>
+
+namespace /* anonymous */
+{
+	/**
+	 * Get the main axis component of a point.
+	 *
+	 * @param point The point.
+	 * @param direction The layout direction.
+	 * @return The main axis component.
+	 */
+	float GetMain(minte::Point2D_F32 point, minte::LayoutDirection direction)
+	{
+		return direction == minte::LayoutDirection::Row ? point.m_X : point.m_Y;
+	}
+
+	/**
+	 * Get the cross axis component of a point.
+	 *
+	 * @param point The point.
+	 * @param direction The layout direction.
+	 * @return The cross axis component.
+	 */
+	float GetCross(minte::Point2D_F32 point, minte::LayoutDirection direction)
+	{
+		return direction == minte::LayoutDirection::Row ? point.m_Y : point.m_X;
+	}
+
+	/**
+	 * Create a point using its main and cross axis components.
+	 *
+	 * @param main The main axis component.
+	 * @param cross The cross axis component.
+	 * @param direction The layout direction.
+	 * @return The point.
+	 */
+	minte::Point2D_F32 MakePoint(float main, float cross, minte::LayoutDirection direction)
+	{
+		return direction == minte::LayoutDirection::Row ? minte::Point2D_F32(main, cross) : minte::Point2D_F32(cross, main);
+	}
+
+	/**
+	 * Resolve a length.
+	 *
+	 * @param length The length to resolve.
+	 * @param parentSize The parent's content size, for percentages.
+	 * @param measuredSize The measured size, for automatic lengths.
+	 * @return The resolved size.
+	 */
+	float Resolve(minte::LayoutLength length, float parentSize, float measuredSize)
+	{
+		switch (length.m_Unit)
+		{
+		case minte::LayoutUnit::Pixels:
+			return length.m_Value;
+
+		case minte::LayoutUnit::Percent:
+			return parentSize * length.m_Value / 100.0f;
+
+		default:
+			return measuredSize;
+		}
+	}
+
+	/**
+	 * Clamp a size to the style's minimum and maximum sizes.
+	 *
+	 * @param size The size to clamp.
+	 * @param style The layout style.
+	 * @return The clamped size.
+	 */
+	minte::Point2D_F32 Clamp(minte::Point2D_F32 size, const minte::LayoutStyle& style)
+	{
+		return minte::Point2D_F32(
+			std::clamp(size.m_X, style.m_MinimumSize.m_X, std::max(style.m_MinimumSize.m_X, style.m_MaximumSize.m_X)),
+			std::clamp(size.m_Y, style.m_MinimumSize.m_Y, std::max(style.m_MinimumSize.m_Y, style.m_MaximumSize.m_Y))
+		);
+	}
+
+	/**
+	 * Get the size of the padding.
+	 *
+	 * @param padding The padding.
+	 * @return The total horizontal and vertical padding.
+	 */
+	minte::Point2D_F32 GetPaddingSize(const minte::LayoutEdges& padding)
+	{
+		return minte::Point2D_F32(padding.m_Left + padding.m_Right, padding.m_Top + padding.m_Bottom);
+	}
+}
+
+namespace minte
+{
+	void LayoutEngine::update(Drawable& root, Point2D_F32 viewport)
+	{
+		if (root.m_pLayoutNode == nullptr)
+			return;
+
+		const auto measured = measure(root);
+		const auto& style = root.m_pLayoutNode->m_Style;
+		const auto size = Clamp(Point2D_F32(Resolve(style.m_Width, viewport.m_X, measured.m_X), Resolve(style.m_Height, viewport.m_Y, measured.m_Y)), style);
+
+		arrange(root, size);
+	}
+
+	Point2D_F32 LayoutEngine::measure(Drawable& drawable)
+	{
+		auto& node = *drawable.m_pLayoutNode;
+		if (!node.m_IsMeasureDirty)
+			return node.m_MeasuredSize;
+
+		const auto& style = node.m_Style;
+		const auto direction = style.m_Direction;
+
+		// Stack the children along the main axis. Percentages cannot be resolved yet, so they do not add to the measured size.
+		float main = 0.0f;
+		float cross = 0.0f;
+		uint32_t childCount = 0;
+
+		for (const auto& pChild : drawable.m_Children)
+		{
+			if (pChild->m_pLayoutNode == nullptr)
+				continue;
+
+			const auto childSize = measure(*pChild);
+			const auto& childStyle = pChild->m_pLayoutNode->m_Style;
+			const auto childMain = (direction == LayoutDirection::Row ? childStyle.m_Width : childStyle.m_Height).m_Unit == LayoutUnit::Percent ? 0.0f : GetMain(childSize, direction);
+			const auto childCross = (direction == LayoutDirection::Row ? childStyle.m_Height : childStyle.m_Width).m_Unit == LayoutUnit::Percent ? 0.0f : GetCross(childSize, direction);
+
+			main += childMain;
+			cross = std::max(cross, childCross);
+			childCount++;
+		}
+
+		auto content = childCount > 0 ? MakePoint(main + style.m_Gap * (childCount - 1), cross, direction) : drawable.measureContent();
+		const auto padding = GetPaddingSize(style.m_Padding);
+		content.m_X += padding.m_X;
+		content.m_Y += padding.m_Y;
+
+		// Fixed sizes replace the content size.
+		if (style.m_Width.m_Unit == LayoutUnit::Pixels)
+			content.m_X = style.m_Width.m_Value;
+
+		if (style.m_Height.m_Unit == LayoutUnit::Pixels)
+			content.m_Y = style.m_Height.m_Value;
+
+		node.m_MeasuredSize = Clamp(content, style);
+		node.m_IsMeasureDirty = false;
+		return node.m_MeasuredSize;
+	}
+
+	void LayoutEngine::arrange(Drawable& drawable, Point2D_F32 size)
+	{
+		auto& node = *drawable.m_pLayoutNode;
+		node.m_IsLayoutDirty = false;
+
+		if (node.m_Size.m_X != size.m_X || node.m_Size.m_Y != size.m_Y)
+		{
+			node.m_Size = size;
+			drawable.applyLayoutSize(size);
+		}
+
+		const auto& style = node.m_Style;
+		const auto direction = style.m_Direction;
+		const auto padding = GetPaddingSize(style.m_Padding);
+		const auto innerSize = Point2D_F32(std::max(size.m_X - padding.m_X, 0.0f), std::max(size.m_Y - padding.m_Y, 0.0f));
+		const auto innerMain = GetMain(innerSize, direction);
+		const auto innerCross = GetCross(innerSize, direction);
+
+		// Resolve the sizes of the children, and find the free space along the main axis.
+		// The sizes are kept in a shared stack, since this is called recursively.
+		const auto first = m_ChildSizes.size();
+		float usedMain = 0.0f;
+		float totalGrow = 0.0f;
+
+		for (const auto& pChild : drawable.m_Children)
+		{
+			if (pChild->m_pLayoutNode == nullptr)
+				continue;
+
+			const auto& childStyle = pChild->m_pLayoutNode->m_Style;
+			const auto measured = pChild->m_pLayoutNode->m_MeasuredSize;
+
+			auto childSize = Point2D_F32(Resolve(childStyle.m_Width, innerSize.m_X, measured.m_X), Resolve(childStyle.m_Height, innerSize.m_Y, measured.m_Y));
+			if (style.m_AlignItems == LayoutAlignment::Stretch && (direction == LayoutDirection::Row ? childStyle.m_Height : childStyle.m_Width).m_Unit == LayoutUnit::Auto)
+				childSize = MakePoint(GetMain(childSize, direction), innerCross, direction);
+
+			const auto& resolved = m_ChildSizes.emplace_back(Clamp(childSize, childStyle));
+			usedMain += GetMain(resolved, direction);
+			totalGrow += childStyle.m_Grow;
+		}
+
+		const auto childCount = static_cast<uint32_t>(m_ChildSizes.size() - first);
+		if (childCount == 0)
+			return;
+
+		usedMain += style.m_Gap * (childCount - 1);
+		float freeMain = innerMain - usedMain;
+
+		// Give the free space to the children that can grow.
+		if (freeMain > 0.0f && totalGrow > 0.0f)
+		{
+			float grownMain = 0.0f;
+			auto index = first;
+
+			for (const auto& pChild : drawable.m_Children)
+			{
+				if (pChild->m_pLayoutNode == nullptr)
+					continue;
+
+				auto& childSize = m_ChildSizes[index++];
+				const auto& childStyle = pChild->m_pLayoutNode->m_Style;
+				if (childStyle.m_Grow <= 0.0f)
+					continue;
+
+				const auto previousMain = GetMain(childSize, direction);
+				childSize = Clamp(MakePoint(previousMain + freeMain * childStyle.m_Grow / totalGrow, GetCross(childSize, direction), direction), childStyle);
+				grownMain += GetMain(childSize, direction) - previousMain;
+			}
+
+			freeMain -= grownMain;
+		}
+
+		// Justify the children along the main axis.
+		float offset = 0.0f;
+		float spacing = style.m_Gap;
+		freeMain = std::max(freeMain, 0.0f);
+
+		switch (style.m_JustifyContent)
+		{
+		case LayoutAlignment::Center:
+			offset = freeMain / 2.0f;
+			break;
+
+		case LayoutAlignment::End:
+			offset = freeMain;
+			break;
+
+		case LayoutAlignment::SpaceBetween:
+			spacing += childCount > 1 ? freeMain / (childCount - 1) : 0.0f;
+			break;
+
+		default:
+			break;
+		}
+
+		const auto start = Point2D_F32(style.m_Padding.m_Left, style.m_Padding.m_Top);
+		auto index = first;
+
+		for (const auto& pChild : drawable.m_Children)
+		{
+			if (pChild->m_pLayoutNode == nullptr)
+				continue;
+
+			const auto& childNode = *pChild->m_pLayoutNode;
+			const auto childSize = m_ChildSizes[index++];
+			const auto freeCross = innerCross - GetCross(childSize, direction);
+
+			float crossOffset = 0.0f;
+			if (style.m_AlignItems == LayoutAlignment::Center)
+				crossOffset = freeCross / 2.0f;
+
+			else if (style.m_AlignItems == LayoutAlignment::End)
+				crossOffset = freeCross;
+
+			const auto position = MakePoint(offset, crossOffset, direction);
+			pChild->setPosition(Point2D_F32(start.m_X + position.m_X, start.m_Y + position.m_Y));
+			offset += GetMain(childSize, direction) + spacing;
+
+			// Only the children that changed need to be arranged again.
+			if (childNode.m_IsLayoutDirty || childNode.m_Size.m_X != childSize.m_X || childNode.m_Size.m_Y != childSize.m_Y)
+				arrange(*pChild, childSize);
+		}
+
+		m_ChildSizes.resize(first);
+	}
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/MappedFile.hpp"
+#include "Minte/FrontendError.hpp"
+
+#include <utility>
+
+#if defined(MINTE_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif
+
+namespace minte
+{
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+#if defined(MINTE_PLATFORM_WINDOWS)
+		m_FileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_FileHandle == INVALID_HANDLE_VALUE)
+		{
+			m_FileHandle = nullptr;
+			throw FrontendError("Failed to open the file to map!");
+		}
+
+		LARGE_INTEGER size = {};
+		GetFileSizeEx(m_FileHandle, &size);
+		m_Size = static_cast<uint64_t>(size.QuadPart);
+
+		// Empty files cannot be mapped, so we just leave the data as null.
+		if (m_Size == 0)
+			return;
+
+		m_MappingHandle = CreateFileMappingW(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_MappingHandle == nullptr)
+		{
+			unmap();
+			throw FrontendError("Failed to create the file mapping!");
+		}
+
+		m_pData = static_cast<const std::byte*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+#else
+		const int file = open(path.c_str(), O_RDONLY);
+		if (file == -1)
+			throw FrontendError("Failed to open the file to map!");
+
+		struct stat status = {};
+		fstat(file, &status);
+		m_Size = static_cast<uint64_t>(status.st_size);
+
+		// Empty files cannot be mapped, so we just leave the data as null.
+		if (m_Size > 0)
+		{
+			void* pData = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (pData != MAP_FAILED)
+				m_pData = static_cast<const std::byte*>(pData);
+		}
+
+		// The mapping stays valid after the file is closed.
+		close(file);
+
+#endif
+
+		if (m_Size > 0 && m_pData == nullptr)
+		{
+			unmap();
+			throw FrontendError("Failed to map the file!");
+		}
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		unmap();
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			unmap();
+
+			m_pData = std::exchange(other.m_pData, nullptr);
+			m_Size = std::exchange(other.m_Size, 0);
+
+#if defined(MINTE_PLATFORM_WINDOWS)
+			m_FileHandle = std::exchange(other.m_FileHandle, nullptr);
+			m_MappingHandle = std::exchange(other.m_MappingHandle, nullptr);
+
+#endif
+		}
+
+		return *this;
+	}
+
+	void MappedFile::unmap()
+	{
+#if defined(MINTE_PLATFORM_WINDOWS)
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+
+		m_MappingHandle = nullptr;
+		m_FileHandle = nullptr;
+
+#else
+		if (m_pData)
+			munmap(const_cast<std::byte*>(m_pData), m_Size);
+
+#endif
+
+		m_pData = nullptr;
+		m_Size = 0;
+	}
+}
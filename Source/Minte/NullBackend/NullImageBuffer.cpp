@@ -0,0 +1,37 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/NullBackend/NullImageBuffer.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		NullImageBuffer::NullImageBuffer(const std::shared_ptr<NullInstance>& pInstance, uint64_t size)
+			: ImageBuffer(pInstance, size)
+		{
+		}
+
+		NullImageBuffer::~NullImageBuffer()
+		{
+			if (m_pData)
+				getInstance()->unregisterAllocation(ResourceCategory::Attachment, m_Size);
+		}
+
+		std::byte* NullImageBuffer::mapMemory()
+		{
+			if (!m_pData)
+			{
+				m_pData = std::make_unique<std::byte[]>(m_Size);
+				getInstance()->registerAllocation(ResourceCategory::Attachment, m_Size);
+			}
+
+			m_IsMapped = true;
+			return m_pData.get();
+		}
+
+		void NullImageBuffer::unmapMemory()
+		{
+			m_IsMapped = false;
+		}
+	}
+}
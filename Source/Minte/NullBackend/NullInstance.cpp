@@ -0,0 +1,21 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/NullBackend/NullInstance.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		MemoryStatistics NullInstance::getMemoryStatistics() const
+		{
+			MemoryStatistics statistics;
+			fillTrackedStatistics(statistics);
+
+			auto& heap = statistics.m_Heaps.emplace_back();
+			heap.m_Allocated = statistics.getTotalBytes();
+			heap.m_Usage = heap.m_Allocated;
+
+			return statistics;
+		}
+	}
+}
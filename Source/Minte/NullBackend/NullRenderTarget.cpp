@@ -0,0 +1,126 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/NullBackend/NullRenderTarget.hpp"
+#include "Minte/Backend/NullBackend/NullImageBuffer.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		NullRenderTarget::NullRenderTarget(const std::shared_ptr<NullInstance>& pInstance, uint32_t width, uint32_t height, AntiAliasing antiAliasing /*= AntiAliasing::X1*/)
+			: RenderTarget(pInstance, width, height, antiAliasing)
+		{
+			const auto pixelCount = static_cast<uint64_t>(width) * height;
+			setColorBuffer(createImageBuffer(pixelCount * 4));
+			setEntityBuffer(createImageBuffer(pixelCount * sizeof(uint32_t)));
+			setDepthBuffer(createImageBuffer(pixelCount * sizeof(uint16_t)));
+		}
+
+		void NullRenderTarget::draw()
+		{
+			const bool bReplaced = acquireBuffers();
+			if (!m_IsRecording)
+				return;
+
+			auto& statistics = m_PendingStatistics;
+			statistics.m_BufferReplacements += bReplaced ? 1 : 0;
+
+			// The scissor is counted like the Vulkan backend sets it, only when it changes between commands.
+			ScissorRectangle boundScissor;
+			for (const auto& command : getDrawCommands())
+			{
+				statistics.m_DrawCommands++;
+				statistics.m_OpaqueCommands += command.m_IsOpaque ? 1 : 0;
+				statistics.m_Triangles += command.m_IndexCount / 3;
+
+				if (command.m_Scissor != boundScissor)
+				{
+					boundScissor = command.m_Scissor;
+					statistics.m_ScissorChanges++;
+				}
+			}
+
+			if (getDrawCommandGeneration() != m_DrawCommandGeneration)
+			{
+				statistics.m_CommandListChanges += getDrawCommandGeneration() - m_DrawCommandGeneration;
+				m_DrawCommandGeneration = getDrawCommandGeneration();
+			}
+
+			for (uint32_t slot = 0; slot < MaxTextures; slot++)
+			{
+				const auto pTexture = getTexture(slot).get();
+				if (pTexture != m_BoundTextures[slot])
+				{
+					m_BoundTextures[slot] = pTexture;
+					statistics.m_TextureChanges++;
+				}
+			}
+
+			// Finish the frame.
+			m_FrameStatistics = statistics;
+			m_TotalStatistics.m_DrawCommands += statistics.m_DrawCommands;
+			m_TotalStatistics.m_OpaqueCommands += statistics.m_OpaqueCommands;
+			m_TotalStatistics.m_Triangles += statistics.m_Triangles;
+			m_TotalStatistics.m_VertexUpdates += statistics.m_VertexUpdates;
+			m_TotalStatistics.m_IndexUpdates += statistics.m_IndexUpdates;
+			m_TotalStatistics.m_VertexBytes += statistics.m_VertexBytes;
+			m_TotalStatistics.m_IndexBytes += statistics.m_IndexBytes;
+			m_TotalStatistics.m_CommandListChanges += statistics.m_CommandListChanges;
+			m_TotalStatistics.m_TextureChanges += statistics.m_TextureChanges;
+			m_TotalStatistics.m_ScissorChanges += statistics.m_ScissorChanges;
+			m_TotalStatistics.m_BufferReplacements += statistics.m_BufferReplacements;
+			m_RecordedFrameCount++;
+
+			statistics = NullFrameStatistics();
+		}
+
+		void NullRenderTarget::updateVertices(uint64_t offset, std::span<const Vertex> vertices)
+		{
+			if (m_IsRecording)
+			{
+				m_PendingStatistics.m_VertexUpdates++;
+				m_PendingStatistics.m_VertexBytes += vertices.size_bytes();
+			}
+		}
+
+		void NullRenderTarget::updateIndices(uint64_t offset, std::span<const Index> indices)
+		{
+			if (m_IsRecording)
+			{
+				m_PendingStatistics.m_IndexUpdates++;
+				m_PendingStatistics.m_IndexBytes += indices.size_bytes();
+			}
+		}
+
+		void NullRenderTarget::setOutputFormat(OutputFormat format)
+		{
+			if (format == getOutputFormat())
+				return;
+
+			validateOutputFormat(format);
+			m_OutputFormat = format;
+			invalidateState();
+
+			setColorBuffer(createImageBuffer(getOutputSize()));
+		}
+
+		void NullRenderTarget::setRecording(bool bEnable)
+		{
+			// Start from the current state, so that the first recorded frame only counts what changed after this.
+			if (bEnable && !m_IsRecording)
+			{
+				m_PendingStatistics = NullFrameStatistics();
+				m_DrawCommandGeneration = getDrawCommandGeneration();
+				for (uint32_t slot = 0; slot < MaxTextures; slot++)
+					m_BoundTextures[slot] = getTexture(slot).get();
+			}
+
+			m_IsRecording = bEnable;
+		}
+
+		std::shared_ptr<ImageBuffer> NullRenderTarget::createImageBuffer(uint64_t size)
+		{
+			return std::make_shared<NullImageBuffer>(std::static_pointer_cast<NullInstance>(getInstancePointer()), size);
+		}
+	}
+}
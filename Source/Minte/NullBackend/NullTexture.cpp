@@ -0,0 +1,30 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/NullBackend/NullTexture.hpp"
+#include "Minte/Backend/BackendError.hpp"
+
+namespace minte
+{
+	namespace backend
+	{
+		NullTexture::NullTexture(const std::shared_ptr<NullInstance>& pInstance, uint32_t width, uint32_t height, TextureFormat format, bool bMipmaps /*= false*/)
+			: Texture(pInstance, width, height, format, bMipmaps)
+		{
+		}
+
+		void NullTexture::upload(std::span<const TextureRegion> regions, std::span<const std::byte> data)
+		{
+			for (const auto& region : regions)
+			{
+				const auto regionSize = static_cast<uint64_t>(region.m_Width) * region.m_Height * getPixelSize();
+				if (region.m_X + region.m_Width > getWidth() || region.m_Y + region.m_Height > getHeight())
+					throw BackendError("The texture region is outside the texture!");
+
+				if (region.m_Offset + regionSize > data.size())
+					throw BackendError("The texture region is outside the data!");
+
+				m_UploadedBytes += regionSize;
+			}
+		}
+	}
+}
@@ -0,0 +1,162 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Path.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace minte
+{
+	Path& Path::moveTo(Point2D_F32 point)
+	{
+		// Consecutive moves replace each other, since an empty contour draws nothing.
+		if (!m_Verbs.empty() && m_Verbs.back() == PathVerb::MoveTo)
+		{
+			m_Points.back() = point;
+		}
+		else
+		{
+			m_Verbs.emplace_back(PathVerb::MoveTo);
+			m_Points.emplace_back(point);
+		}
+
+		m_ContourStart = point;
+		m_HasCurrentPoint = true;
+		return *this;
+	}
+
+	Path& Path::lineTo(Point2D_F32 point)
+	{
+		ensureContour();
+
+		m_Verbs.emplace_back(PathVerb::LineTo);
+		m_Points.emplace_back(point);
+		m_SegmentCount++;
+		return *this;
+	}
+
+	Path& Path::quadraticTo(Point2D_F32 control, Point2D_F32 point)
+	{
+		ensureContour();
+
+		m_Verbs.emplace_back(PathVerb::QuadraticTo);
+		m_Points.insert(m_Points.end(), { control, point });
+		m_SegmentCount++;
+		return *this;
+	}
+
+	Path& Path::cubicTo(Point2D_F32 firstControl, Point2D_F32 secondControl, Point2D_F32 point)
+	{
+		ensureContour();
+
+		m_Verbs.emplace_back(PathVerb::CubicTo);
+		m_Points.insert(m_Points.end(), { firstControl, secondControl, point });
+		m_SegmentCount++;
+		return *this;
+	}
+
+	Path& Path::arc(Point2D_F32 center, float radius, float startAngle, float sweepAngle)
+	{
+		const auto start = Point2D_F32(center.m_X + radius * std::cos(startAngle), center.m_Y + radius * std::sin(startAngle));
+		if (m_HasCurrentPoint)
+			lineTo(start);
+
+		else
+			moveTo(start);
+
+		// Each quarter of a circle is approximated by a cubic curve, which is within 0.03% of the radius.
+		const auto sweep = std::clamp(sweepAngle, -2.0f * std::numbers::pi_v<float>, 2.0f * std::numbers::pi_v<float>);
+		const auto segmentCount = std::max(static_cast<uint32_t>(std::ceil(std::abs(sweep) / (std::numbers::pi_v<float> / 2.0f) - 0.001f)), 1u);
+		const auto segmentSweep = sweep / segmentCount;
+		const auto handle = radius * 4.0f / 3.0f * std::tan(segmentSweep / 4.0f);
+
+		auto angle = startAngle;
+		for (uint32_t i = 0; i < segmentCount; i++)
+		{
+			const auto nextAngle = angle + segmentSweep;
+			const auto cosine = std::cos(angle), sine = std::sin(angle);
+			const auto nextCosine = std::cos(nextAngle), nextSine = std::sin(nextAngle);
+
+			cubicTo(
+				Point2D_F32(center.m_X + radius * cosine - handle * sine, center.m_Y + radius * sine + handle * cosine),
+				Point2D_F32(center.m_X + radius * nextCosine + handle * nextSine, center.m_Y + radius * nextSine - handle * nextCosine),
+				Point2D_F32(center.m_X + radius * nextCosine, center.m_Y + radius * nextSine)
+			);
+
+			angle = nextAngle;
+		}
+
+		return *this;
+	}
+
+	Path& Path::close()
+	{
+		if (m_HasCurrentPoint && !m_Verbs.empty() && m_Verbs.back() != PathVerb::MoveTo && m_Verbs.back() != PathVerb::Close)
+		{
+			m_Verbs.emplace_back(PathVerb::Close);
+			m_SegmentCount++;
+		}
+
+		// Drawing after closing continues from the start of the closed contour.
+		if (m_HasCurrentPoint)
+			moveTo(m_ContourStart);
+
+		return *this;
+	}
+
+	Path& Path::addRectangle(const Rectangle2D_F32& rectangle)
+	{
+		const auto& minimum = rectangle.m_MinPoint;
+		const auto& maximum = rectangle.m_MaxPoint;
+
+		return moveTo(minimum)
+			.lineTo(Point2D_F32(maximum.m_X, minimum.m_Y))
+			.lineTo(maximum)
+			.lineTo(Point2D_F32(minimum.m_X, maximum.m_Y))
+			.close();
+	}
+
+	Path& Path::addRoundedRectangle(const Rectangle2D_F32& rectangle, float radius)
+	{
+		const auto& minimum = rectangle.m_MinPoint;
+		const auto& maximum = rectangle.m_MaxPoint;
+
+		const auto clampedRadius = std::clamp(radius, 0.0f, std::min(maximum.m_X - minimum.m_X, maximum.m_Y - minimum.m_Y) / 2.0f);
+		if (clampedRadius <= 0.0f)
+			return addRectangle(rectangle);
+
+		constexpr auto Quarter = std::numbers::pi_v<float> / 2.0f;
+		m_HasCurrentPoint = false;
+
+		arc(Point2D_F32(maximum.m_X - clampedRadius, minimum.m_Y + clampedRadius), clampedRadius, -Quarter, Quarter);
+		arc(Point2D_F32(maximum.m_X - clampedRadius, maximum.m_Y - clampedRadius), clampedRadius, 0.0f, Quarter);
+		arc(Point2D_F32(minimum.m_X + clampedRadius, maximum.m_Y - clampedRadius), clampedRadius, Quarter, Quarter);
+		arc(Point2D_F32(minimum.m_X + clampedRadius, minimum.m_Y + clampedRadius), clampedRadius, 2.0f * Quarter, Quarter);
+		return close();
+	}
+
+	Path& Path::addCircle(Point2D_F32 center, float radius)
+	{
+		m_HasCurrentPoint = false;
+
+		arc(center, radius, 0.0f, 2.0f * std::numbers::pi_v<float>);
+		return close();
+	}
+
+	void Path::clear()
+	{
+		m_Verbs.clear();
+		m_Points.clear();
+
+		m_ContourStart = Point2D_F32();
+		m_SegmentCount = 0;
+		m_HasCurrentPoint = false;
+	}
+
+	void Path::ensureContour()
+	{
+		if (!m_HasCurrentPoint)
+			moveTo(Point2D_F32());
+	}
+}
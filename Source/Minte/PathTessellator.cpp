@@ -0,0 +1,624 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/PathTessellator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINTE_PATH_SSE2
+#include <emmintrin.h>
+
+#endif
+
+namespace /* anonymous */
+{
+	constexpr uint32_t MaximumCurveSegments = 1024;
+	constexpr float PointEpsilon = 1e-4f;
+	constexpr float SweepEpsilon = 1e-4f;
+
+	/**
+	 * Check if two points are close enough to be merged.
+	 *
+	 * @param first The first point.
+	 * @param second The second point.
+	 * @return Whether the points are the same.
+	 */
+	bool IsSamePoint(minte::Point2D_F32 first, minte::Point2D_F32 second)
+	{
+		return std::abs(first.m_X - second.m_X) + std::abs(first.m_Y - second.m_Y) < PointEpsilon;
+	}
+
+	/**
+	 * Get the direction from one point to another.
+	 *
+	 * @param from The start point.
+	 * @param to The end point.
+	 * @return The unit direction vector.
+	 */
+	minte::Point2D_F32 GetDirection(minte::Point2D_F32 from, minte::Point2D_F32 to)
+	{
+		const auto x = to.m_X - from.m_X;
+		const auto y = to.m_Y - from.m_Y;
+		const auto length = std::sqrt(x * x + y * y);
+
+		return minte::Point2D_F32(x / length, y / length);
+	}
+
+	/**
+	 * Check if a flattened contour is convex and winds only once.
+	 *
+	 * @param points The points of the contour.
+	 * @return Whether the contour is convex.
+	 */
+	bool IsConvex(std::span<const minte::Point2D_F32> points)
+	{
+		if (points.size() < 3)
+			return false;
+
+		auto turn = 0.0f;
+		float previousX = 0.0f, previousY = 0.0f;
+		uint32_t xSignChanges = 0, ySignChanges = 0;
+		float lastDirectionX = 0.0f, lastDirectionY = 0.0f;
+
+		for (size_t i = 0; i <= points.size(); i++)
+		{
+			const auto& current = points[i % points.size()];
+			const auto& next = points[(i + 1) % points.size()];
+			const auto x = next.m_X - current.m_X;
+			const auto y = next.m_Y - current.m_Y;
+
+			if (i > 0)
+			{
+				const auto cross = previousX * y - previousY * x;
+				if (cross != 0.0f)
+				{
+					if (turn != 0.0f && (cross > 0.0f) != (turn > 0.0f))
+						return false;
+
+					turn = cross;
+				}
+			}
+
+			// A contour that turns the same way but winds more than once changes its direction more than twice on each axis.
+			if (i < points.size())
+			{
+				if (x != 0.0f)
+				{
+					xSignChanges += lastDirectionX != 0.0f && (x > 0.0f) != (lastDirectionX > 0.0f);
+					lastDirectionX = x;
+				}
+
+				if (y != 0.0f)
+				{
+					ySignChanges += lastDirectionY != 0.0f && (y > 0.0f) != (lastDirectionY > 0.0f);
+					lastDirectionY = y;
+				}
+			}
+
+			previousX = x;
+			previousY = y;
+		}
+
+		return turn != 0.0f && xSignChanges <= 2 && ySignChanges <= 2;
+	}
+
+	/**
+	 * Check if a winding number is inside using a fill rule.
+	 *
+	 * @param winding The winding number.
+	 * @param rule The fill rule.
+	 * @return Whether the winding is inside.
+	 */
+	bool IsInside(int32_t winding, minte::FillRule rule)
+	{
+		return rule == minte::FillRule::NonZero ? winding != 0 : (winding & 1) != 0;
+	}
+
+	/**
+	 * Add a triangle.
+	 *
+	 * @param indices The indices to append to.
+	 * @param first The first vertex index.
+	 * @param second The second vertex index.
+	 * @param third The third vertex index.
+	 */
+	void AddTriangle(std::vector<minte::Index>& indices, minte::Index first, minte::Index second, minte::Index third)
+	{
+		indices.insert(indices.end(), { first, second, third });
+	}
+
+	/**
+	 * Add a vertex.
+	 *
+	 * @param vertices The vertices to append to.
+	 * @param x The X coordinate.
+	 * @param y The Y coordinate.
+	 * @param color The vertex color.
+	 * @return The index of the vertex.
+	 */
+	minte::Index AddVertex(std::vector<minte::Vertex>& vertices, float x, float y, uint32_t color)
+	{
+		vertices.emplace_back(minte::Vertex{ minte::Point2D_F32(x, y), minte::Point2D_F32(), color });
+		return static_cast<minte::Index>(vertices.size() - 1);
+	}
+}
+
+namespace minte
+{
+	PathTessellator::PathTessellator(float tolerance)
+	{
+		setTolerance(tolerance);
+	}
+
+	void PathTessellator::setTolerance(float tolerance)
+	{
+		m_Tolerance = std::max(tolerance, 0.01f);
+	}
+
+	void PathTessellator::fill(const Path& path, FillRule rule, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices)
+	{
+		flatten(path);
+
+		if (m_Contours.size() == 1 && IsConvex(std::span(m_Points).subspan(m_Contours.front().m_FirstPoint, m_Contours.front().m_PointCount)))
+			fillConvex(m_Contours.front(), color, vertices, indices);
+
+		else if (!m_Contours.empty())
+			fillSweep(rule, color, vertices, indices);
+	}
+
+	void PathTessellator::stroke(const Path& path, const StrokeStyle& style, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices)
+	{
+		if (style.m_Width <= 0.0f)
+			return;
+
+		flatten(path);
+
+		for (const auto& contour : m_Contours)
+			strokeContour(contour, style, color, vertices, indices);
+	}
+
+	void PathTessellator::flatten(const Path& path)
+	{
+		m_Points.clear();
+		m_Contours.clear();
+
+		// A contour is only kept if it has segments, so the move after a close doesn't become a dot.
+		bool bHasSegments = false;
+		const auto finishContour = [this, &bHasSegments]
+		{
+			if (m_Contours.empty())
+				return;
+
+			auto& contour = m_Contours.back();
+			if (!bHasSegments)
+			{
+				m_Points.resize(contour.m_FirstPoint);
+				m_Contours.pop_back();
+				return;
+			}
+
+			contour.m_PointCount = static_cast<uint32_t>(m_Points.size()) - contour.m_FirstPoint;
+
+			// The closing line is implied, so a closed contour ending at its first point drops the duplicate.
+			if (contour.m_IsClosed && contour.m_PointCount > 1 && IsSamePoint(m_Points[contour.m_FirstPoint], m_Points.back()))
+			{
+				m_Points.pop_back();
+				contour.m_PointCount--;
+			}
+		};
+
+		const auto addPoint = [this](Point2D_F32 point)
+		{
+			if (!IsSamePoint(m_Points.back(), point))
+				m_Points.emplace_back(point);
+		};
+
+		const auto points = path.getPoints();
+		uint32_t pointIndex = 0;
+
+		for (const auto verb : path.getVerbs())
+		{
+			bHasSegments |= verb != PathVerb::MoveTo;
+
+			switch (verb)
+			{
+			case PathVerb::MoveTo:
+				finishContour();
+				m_Contours.emplace_back(Contour{ static_cast<uint32_t>(m_Points.size()) });
+				m_Points.emplace_back(points[pointIndex++]);
+				bHasSegments = false;
+				break;
+
+			case PathVerb::LineTo:
+				addPoint(points[pointIndex++]);
+				break;
+
+			case PathVerb::QuadraticTo:
+			{
+				// Quadratic curves are elevated to cubic curves, which are exact.
+				const auto start = m_Points.back();
+				const auto& control = points[pointIndex];
+				const auto& end = points[pointIndex + 1];
+
+				flattenCubic(start,
+					Point2D_F32(start.m_X + (control.m_X - start.m_X) * 2.0f / 3.0f, start.m_Y + (control.m_Y - start.m_Y) * 2.0f / 3.0f),
+					Point2D_F32(end.m_X + (control.m_X - end.m_X) * 2.0f / 3.0f, end.m_Y + (control.m_Y - end.m_Y) * 2.0f / 3.0f),
+					end);
+
+				pointIndex += 2;
+				break;
+			}
+
+			case PathVerb::CubicTo:
+				flattenCubic(m_Points.back(), points[pointIndex], points[pointIndex + 1], points[pointIndex + 2]);
+				pointIndex += 3;
+				break;
+
+			case PathVerb::Close:
+				m_Contours.back().m_IsClosed = true;
+				break;
+			}
+		}
+
+		finishContour();
+
+		// Drop the closed contours that collapsed to a point. Open ones are kept, since their caps can draw a dot.
+		std::erase_if(m_Contours, [](const Contour& contour) { return contour.m_PointCount == 1 && contour.m_IsClosed; });
+	}
+
+	void PathTessellator::flattenCubic(Point2D_F32 p0, Point2D_F32 p1, Point2D_F32 p2, Point2D_F32 p3)
+	{
+		// Wang's formula gives the number of lines needed to keep the flattened curve within the tolerance.
+		const auto ddx = std::max(std::abs(p0.m_X - 2.0f * p1.m_X + p2.m_X), std::abs(p1.m_X - 2.0f * p2.m_X + p3.m_X));
+		const auto ddy = std::max(std::abs(p0.m_Y - 2.0f * p1.m_Y + p2.m_Y), std::abs(p1.m_Y - 2.0f * p2.m_Y + p3.m_Y));
+		const auto segments = std::clamp(static_cast<uint32_t>(std::ceil(std::sqrt(0.75f * std::sqrt(ddx * ddx + ddy * ddy) / m_Tolerance))), 1u, MaximumCurveSegments);
+
+		if (segments == 1)
+		{
+			if (!IsSamePoint(m_Points.back(), p3))
+				m_Points.emplace_back(p3);
+
+			return;
+		}
+
+		// The power basis coefficients, so that a point is ((a * t + b) * t + c) * t + p0.
+		const auto ax = p3.m_X - p0.m_X + 3.0f * (p1.m_X - p2.m_X);
+		const auto ay = p3.m_Y - p0.m_Y + 3.0f * (p1.m_Y - p2.m_Y);
+		const auto bx = 3.0f * (p0.m_X - 2.0f * p1.m_X + p2.m_X);
+		const auto by = 3.0f * (p0.m_Y - 2.0f * p1.m_Y + p2.m_Y);
+		const auto cx = 3.0f * (p1.m_X - p0.m_X);
+		const auto cy = 3.0f * (p1.m_Y - p0.m_Y);
+
+		const auto firstPoint = m_Points.size();
+		m_Points.resize(firstPoint + segments);
+		const auto pPoints = m_Points.data() + firstPoint;
+		const auto step = 1.0f / segments;
+		uint32_t i = 1;
+
+#ifdef MINTE_PATH_SSE2
+		const auto ax4 = _mm_set1_ps(ax), ay4 = _mm_set1_ps(ay);
+		const auto bx4 = _mm_set1_ps(bx), by4 = _mm_set1_ps(by);
+		const auto cx4 = _mm_set1_ps(cx), cy4 = _mm_set1_ps(cy);
+		const auto x4 = _mm_set1_ps(p0.m_X), y4 = _mm_set1_ps(p0.m_Y);
+		const auto offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		const auto step4 = _mm_set1_ps(step);
+
+		alignas(16) float interleaved[8];
+		for (; i + 3 <= segments; i += 4)
+		{
+			const auto t = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(i)), offsets), step4);
+			const auto x = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(ax4, t), bx4), t), cx4), t), x4);
+			const auto y = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(ay4, t), by4), t), cy4), t), y4);
+
+			_mm_store_ps(interleaved, _mm_unpacklo_ps(x, y));
+			_mm_store_ps(interleaved + 4, _mm_unpackhi_ps(x, y));
+			std::memcpy(pPoints + i - 1, interleaved, sizeof(interleaved));
+		}
+
+#endif
+
+		for (; i <= segments; i++)
+		{
+			const auto t = i * step;
+			pPoints[i - 1] = Point2D_F32(((ax * t + bx) * t + cx) * t + p0.m_X, ((ay * t + by) * t + cy) * t + p0.m_Y);
+		}
+
+		// Make sure that the curve ends exactly where the next segment starts.
+		pPoints[segments - 1] = p3;
+	}
+
+	void PathTessellator::fillConvex(const Contour& contour, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices) const
+	{
+		const auto firstVertex = static_cast<Index>(vertices.size());
+		for (const auto& point : std::span(m_Points).subspan(contour.m_FirstPoint, contour.m_PointCount))
+			AddVertex(vertices, point.m_X, point.m_Y, color);
+
+		for (Index i = 1; i + 1 < contour.m_PointCount; i++)
+			AddTriangle(indices, firstVertex, firstVertex + i, firstVertex + i + 1);
+	}
+
+	void PathTessellator::fillSweep(FillRule rule, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices)
+	{
+		m_Edges.clear();
+		m_Events.clear();
+		m_ActiveEdges.clear();
+
+		// Every contour is closed when filling.
+		for (const auto& contour : m_Contours)
+		{
+			for (uint32_t i = 0; i < contour.m_PointCount; i++)
+			{
+				const auto& from = m_Points[contour.m_FirstPoint + i];
+				const auto& to = m_Points[contour.m_FirstPoint + (i + 1) % contour.m_PointCount];
+				if (from.m_Y == to.m_Y)
+					continue;
+
+				const auto bDown = from.m_Y < to.m_Y;
+				const auto& top = bDown ? from : to;
+				const auto& bottom = bDown ? to : from;
+
+				Edge edge;
+				edge.m_Top = top.m_Y;
+				edge.m_Bottom = bottom.m_Y;
+				edge.m_X = top.m_X;
+				edge.m_Slope = (bottom.m_X - top.m_X) / (bottom.m_Y - top.m_Y);
+				edge.m_Winding = bDown ? 1 : -1;
+				m_Edges.emplace_back(edge);
+
+				m_Events.insert(m_Events.end(), { top.m_Y, bottom.m_Y });
+			}
+		}
+
+		std::sort(m_Edges.begin(), m_Edges.end(), [](const Edge& lhs, const Edge& rhs) { return lhs.m_Top < rhs.m_Top; });
+		std::sort(m_Events.begin(), m_Events.end());
+		m_Events.erase(std::unique(m_Events.begin(), m_Events.end()), m_Events.end());
+
+		const auto getVertex = [&vertices, color](Edge& edge, float y)
+		{
+			if (edge.m_LastVertexY != y)
+			{
+				edge.m_LastVertex = AddVertex(vertices, edge.getX(y), y, color);
+				edge.m_LastVertexY = y;
+			}
+
+			return edge.m_LastVertex;
+		};
+
+		size_t nextEdge = 0;
+		for (size_t event = 0; event + 1 < m_Events.size(); event++)
+		{
+			auto top = m_Events[event];
+			const auto eventBottom = m_Events[event + 1];
+
+			std::erase_if(m_ActiveEdges, [this, top](uint32_t index) { return m_Edges[index].m_Bottom <= top; });
+			while (nextEdge < m_Edges.size() && m_Edges[nextEdge].m_Top <= top)
+				m_ActiveEdges.emplace_back(static_cast<uint32_t>(nextEdge++));
+
+			// Each slab between two events is split again where its edges cross, so the edges are never reordered inside a slab.
+			while (top < eventBottom)
+			{
+				// The edges are mostly sorted from the last slab, so an insertion sort is close to linear. Edges meeting at the top are ordered
+				// by where they go.
+				for (size_t i = 1; i < m_ActiveEdges.size(); i++)
+				{
+					const auto index = m_ActiveEdges[i];
+					const auto& edge = m_Edges[index];
+					const auto x = edge.getX(top);
+
+					auto j = i;
+					for (; j > 0; j--)
+					{
+						const auto& other = m_Edges[m_ActiveEdges[j - 1]];
+						const auto otherX = other.getX(top);
+						if (std::abs(otherX - x) > SweepEpsilon ? otherX < x : other.m_Slope <= edge.m_Slope)
+							break;
+
+						m_ActiveEdges[j] = m_ActiveEdges[j - 1];
+					}
+
+					m_ActiveEdges[j] = index;
+				}
+
+				// Edges crossing right below the top are swapped instead, since the slab would be too thin to matter. Nearly horizontal edges
+				// can be far apart at the top and still cross there.
+				auto bottom = eventBottom;
+				for (auto bSwapped = true; bSwapped;)
+				{
+					bSwapped = false;
+					bottom = eventBottom;
+
+					for (size_t i = 1; i < m_ActiveEdges.size(); i++)
+					{
+						const auto& left = m_Edges[m_ActiveEdges[i - 1]];
+						const auto& right = m_Edges[m_ActiveEdges[i]];
+						const auto slopeDifference = left.m_Slope - right.m_Slope;
+
+						if (slopeDifference > 0.0f && left.getX(bottom) > right.getX(bottom))
+						{
+							const auto crossing = top + (right.getX(top) - left.getX(top)) / slopeDifference;
+							if (crossing > top + SweepEpsilon)
+							{
+								bottom = std::min(bottom, crossing);
+							}
+							else
+							{
+								std::swap(m_ActiveEdges[i - 1], m_ActiveEdges[i]);
+								bSwapped = true;
+							}
+						}
+					}
+				}
+
+				// Emit a trapezoid for every span that's inside.
+				int32_t winding = 0;
+				Edge* pLeft = nullptr;
+				for (const auto index : m_ActiveEdges)
+				{
+					auto& edge = m_Edges[index];
+					const auto bWasInside = IsInside(winding, rule);
+					winding += edge.m_Winding;
+					const auto bIsInside = IsInside(winding, rule);
+
+					if (!bWasInside && bIsInside)
+					{
+						pLeft = &edge;
+					}
+					else if (bWasInside && !bIsInside)
+					{
+						const auto topLeft = getVertex(*pLeft, top);
+						const auto topRight = getVertex(edge, top);
+						const auto bottomRight = getVertex(edge, bottom);
+						const auto bottomLeft = getVertex(*pLeft, bottom);
+
+						if (vertices[topRight].m_Position.m_X - vertices[topLeft].m_Position.m_X > SweepEpsilon)
+							AddTriangle(indices, topLeft, topRight, bottomRight);
+
+						if (vertices[bottomRight].m_Position.m_X - vertices[bottomLeft].m_Position.m_X > SweepEpsilon)
+							AddTriangle(indices, bottomRight, bottomLeft, topLeft);
+					}
+				}
+
+				top = bottom;
+			}
+		}
+	}
+
+	void PathTessellator::strokeContour(const Contour& contour, const StrokeStyle& style, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices) const
+	{
+		const auto points = std::span(m_Points).subspan(contour.m_FirstPoint, contour.m_PointCount);
+		const auto halfWidth = style.m_Width / 2.0f;
+
+		// A contour with a single point is drawn as a dot if it has a cap that covers it.
+		if (points.size() == 1)
+		{
+			const auto& point = points.front();
+			if (style.m_Cap == LineCap::Round)
+			{
+				addFan(point, halfWidth, 0.0f, 2.0f * std::numbers::pi_v<float>, halfWidth, color, vertices, indices);
+			}
+			else if (style.m_Cap == LineCap::Square)
+			{
+				const auto first = AddVertex(vertices, point.m_X - halfWidth, point.m_Y - halfWidth, color);
+				AddVertex(vertices, point.m_X + halfWidth, point.m_Y - halfWidth, color);
+				AddVertex(vertices, point.m_X + halfWidth, point.m_Y + halfWidth, color);
+				AddVertex(vertices, point.m_X - halfWidth, point.m_Y + halfWidth, color);
+
+				AddTriangle(indices, first, first + 1, first + 2);
+				AddTriangle(indices, first + 2, first + 3, first);
+			}
+
+			return;
+		}
+
+		const auto segmentCount = static_cast<uint32_t>(contour.m_IsClosed ? points.size() : points.size() - 1);
+		const auto bSquareCaps = !contour.m_IsClosed && style.m_Cap == LineCap::Square;
+
+		// Add a quad for every line.
+		for (uint32_t i = 0; i < segmentCount; i++)
+		{
+			auto start = points[i];
+			auto end = points[(i + 1) % points.size()];
+			const auto direction = GetDirection(start, end);
+
+			if (bSquareCaps && i == 0)
+				start = Point2D_F32(start.m_X - direction.m_X * halfWidth, start.m_Y - direction.m_Y * halfWidth);
+
+			if (bSquareCaps && i == segmentCount - 1)
+				end = Point2D_F32(end.m_X + direction.m_X * halfWidth, end.m_Y + direction.m_Y * halfWidth);
+
+			const auto normalX = -direction.m_Y * halfWidth;
+			const auto normalY = direction.m_X * halfWidth;
+
+			const auto first = AddVertex(vertices, start.m_X + normalX, start.m_Y + normalY, color);
+			AddVertex(vertices, start.m_X - normalX, start.m_Y - normalY, color);
+			AddVertex(vertices, end.m_X - normalX, end.m_Y - normalY, color);
+			AddVertex(vertices, end.m_X + normalX, end.m_Y + normalY, color);
+
+			AddTriangle(indices, first, first + 1, first + 2);
+			AddTriangle(indices, first + 2, first + 3, first);
+		}
+
+		// Fill the gaps on the outer side of the joins.
+		const auto firstJoin = contour.m_IsClosed ? 0u : 1u;
+		const auto lastJoin = static_cast<uint32_t>(contour.m_IsClosed ? points.size() : points.size() - 1);
+		for (uint32_t i = firstJoin; i < lastJoin; i++)
+		{
+			const auto& point = points[i];
+			const auto incoming = GetDirection(points[(i + points.size() - 1) % points.size()], point);
+			const auto outgoing = GetDirection(point, points[(i + 1) % points.size()]);
+
+			const auto cross = incoming.m_X * outgoing.m_Y - incoming.m_Y * outgoing.m_X;
+			const auto dot = incoming.m_X * outgoing.m_X + incoming.m_Y * outgoing.m_Y;
+			if (std::abs(cross) < 1e-6f && dot > 0.0f)
+				continue;
+
+			// A positive cross product turns towards the normal, so the gap is on the other side.
+			const auto side = cross > 0.0f ? -halfWidth : halfWidth;
+			const auto fromX = -incoming.m_Y * side, fromY = incoming.m_X * side;
+			const auto toX = -outgoing.m_Y * side, toY = outgoing.m_X * side;
+
+			if (style.m_Join == LineJoin::Round)
+			{
+				const auto angle = std::acos(std::clamp(dot, -1.0f, 1.0f));
+				addFan(point, fromX, fromY, fromX * toY - fromY * toX >= 0.0f ? angle : -angle, halfWidth, color, vertices, indices);
+				continue;
+			}
+
+			const auto center = AddVertex(vertices, point.m_X, point.m_Y, color);
+			const auto from = AddVertex(vertices, point.m_X + fromX, point.m_Y + fromY, color);
+			const auto to = AddVertex(vertices, point.m_X + toX, point.m_Y + toY, color);
+
+			// The miter length relative to the width is 1 / cos(turn / 2).
+			const auto halfTurnCosine = std::sqrt(std::max((1.0f + dot) / 2.0f, 0.0f));
+			if (style.m_Join == LineJoin::Miter && halfTurnCosine * style.m_MiterLimit >= 1.0f)
+			{
+				const auto scale = 1.0f / (2.0f * halfTurnCosine * halfTurnCosine);
+				const auto tip = AddVertex(vertices, point.m_X + (fromX + toX) * scale, point.m_Y + (fromY + toY) * scale, color);
+
+				AddTriangle(indices, center, from, tip);
+				AddTriangle(indices, center, tip, to);
+			}
+			else
+			{
+				AddTriangle(indices, center, from, to);
+			}
+		}
+
+		// Round caps are half fans around the end points.
+		if (!contour.m_IsClosed && style.m_Cap == LineCap::Round)
+		{
+			const auto startDirection = GetDirection(points[0], points[1]);
+			const auto endDirection = GetDirection(points[points.size() - 2], points.back());
+
+			addFan(points.front(), -startDirection.m_Y * halfWidth, startDirection.m_X * halfWidth, std::numbers::pi_v<float>, halfWidth, color, vertices, indices);
+			addFan(points.back(), endDirection.m_Y * halfWidth, -endDirection.m_X * halfWidth, std::numbers::pi_v<float>, halfWidth, color, vertices, indices);
+		}
+	}
+
+	void PathTessellator::addFan(Point2D_F32 center, float fromX, float fromY, float angle, float halfWidth, uint32_t color, std::vector<Vertex>& vertices, std::vector<Index>& indices) const
+	{
+		// Each step is the largest angle whose chord stays within the tolerance of the arc.
+		const auto stepAngle = m_Tolerance < halfWidth ? 2.0f * std::acos(1.0f - m_Tolerance / halfWidth) : std::numbers::pi_v<float> / 2.0f;
+		const auto steps = std::clamp(static_cast<uint32_t>(std::ceil(std::abs(angle) / stepAngle)), 1u, MaximumCurveSegments);
+		const auto cosine = std::cos(angle / steps);
+		const auto sine = std::sin(angle / steps);
+
+		const auto centerVertex = AddVertex(vertices, center.m_X, center.m_Y, color);
+		auto previous = AddVertex(vertices, center.m_X + fromX, center.m_Y + fromY, color);
+
+		auto x = fromX, y = fromY;
+		for (uint32_t i = 0; i < steps; i++)
+		{
+			const auto rotatedX = x * cosine - y * sine;
+			y = x * sine + y * cosine;
+			x = rotatedX;
+
+			const auto current = AddVertex(vertices, center.m_X + x, center.m_Y + y, color);
+			AddTriangle(indices, centerVertex, previous, current);
+			previous = current;
+		}
+	}
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Shape.hpp"
+
+#include <algorithm>
+
+namespace /* anonymous */
+{
+	/**
+	 * Get the tessellator of the current thread.
+	 * The tessellator's scratch buffers are reused by all the shapes generated on the thread.
+	 *
+	 * @return The tessellator.
+	 */
+	minte::PathTessellator& GetTessellator()
+	{
+		thread_local minte::PathTessellator tessellator;
+		return tessellator;
+	}
+}
+
+namespace minte
+{
+	Shape::Shape(Path path, uint32_t fillColor, FillRule rule)
+		: m_Path(std::move(path)), m_FillColor(fillColor), m_FillRule(rule), m_HasFill(true)
+	{
+	}
+
+	void Shape::setPath(Path path)
+	{
+		m_Path = std::move(path);
+		markDirty();
+	}
+
+	void Shape::setFill(uint32_t color, FillRule rule)
+	{
+		m_FillColor = color;
+		m_FillRule = rule;
+		m_HasFill = true;
+		markDirty();
+	}
+
+	void Shape::clearFill()
+	{
+		m_HasFill = false;
+		markDirty();
+	}
+
+	void Shape::setStroke(const StrokeStyle& style, uint32_t color)
+	{
+		m_StrokeStyle = style;
+		m_StrokeColor = color;
+		m_HasStroke = true;
+		markDirty();
+	}
+
+	void Shape::clearStroke()
+	{
+		m_HasStroke = false;
+		markDirty();
+	}
+
+	void Shape::generateGeometry(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<DrawBatch>& batches) const
+	{
+		auto& tessellator = GetTessellator();
+
+		if (m_HasFill)
+			tessellator.fill(m_Path, m_FillRule, m_FillColor, vertices, indices);
+
+		if (m_HasStroke)
+			tessellator.stroke(m_Path, m_StrokeStyle, m_StrokeColor, vertices, indices);
+	}
+
+	Point2D_F32 Shape::measureContent() const
+	{
+		auto size = Point2D_F32();
+		for (const auto& point : m_Path.getPoints())
+		{
+			size.m_X = std::max(size.m_X, point.m_X);
+			size.m_Y = std::max(size.m_Y, point.m_Y);
+		}
+
+		if (m_HasStroke)
+		{
+			size.m_X += m_StrokeStyle.m_Width / 2.0f;
+			size.m_Y += m_StrokeStyle.m_Width / 2.0f;
+		}
+
+		return size;
+	}
+}
@@ -0,0 +1,316 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/SpatialIndex.hpp"
+
+#include <algorithm>
+
+namespace /* anonymous */
+{
+	/**
+	 * Get the union of two rectangles.
+	 *
+	 * @param lhs The first rectangle.
+	 * @param rhs The second rectangle.
+	 * @return The rectangle containing both.
+	 */
+	minte::Rectangle2D_F32 Union(const minte::Rectangle2D_F32& lhs, const minte::Rectangle2D_F32& rhs)
+	{
+		return minte::Rectangle2D_F32(
+			minte::Point2D_F32(std::min(lhs.m_MinPoint.m_X, rhs.m_MinPoint.m_X), std::min(lhs.m_MinPoint.m_Y, rhs.m_MinPoint.m_Y)),
+			minte::Point2D_F32(std::max(lhs.m_MaxPoint.m_X, rhs.m_MaxPoint.m_X), std::max(lhs.m_MaxPoint.m_Y, rhs.m_MaxPoint.m_Y))
+		);
+	}
+
+	/**
+	 * Enlarge a rectangle by a margin on every side.
+	 *
+	 * @param rectangle The rectangle.
+	 * @param margin The margin.
+	 * @return The enlarged rectangle.
+	 */
+	minte::Rectangle2D_F32 Enlarge(const minte::Rectangle2D_F32& rectangle, float margin)
+	{
+		return minte::Rectangle2D_F32(
+			minte::Point2D_F32(rectangle.m_MinPoint.m_X - margin, rectangle.m_MinPoint.m_Y - margin),
+			minte::Point2D_F32(rectangle.m_MaxPoint.m_X + margin, rectangle.m_MaxPoint.m_Y + margin)
+		);
+	}
+
+	/**
+	 * Get the perimeter of a rectangle.
+	 * This is used as the cost of a node, since it's cheaper than the area and works better for thin rectangles.
+	 *
+	 * @param rectangle The rectangle.
+	 * @return The perimeter.
+	 */
+	float Perimeter(const minte::Rectangle2D_F32& rectangle)
+	{
+		return 2.0f * ((rectangle.m_MaxPoint.m_X - rectangle.m_MinPoint.m_X) + (rectangle.m_MaxPoint.m_Y - rectangle.m_MinPoint.m_Y));
+	}
+
+	/**
+	 * Check if a rectangle contains another.
+	 *
+	 * @param outer The outer rectangle.
+	 * @param inner The inner rectangle.
+	 * @return Whether the outer rectangle contains the inner rectangle.
+	 */
+	bool Contains(const minte::Rectangle2D_F32& outer, const minte::Rectangle2D_F32& inner)
+	{
+		return outer.m_MinPoint.m_X <= inner.m_MinPoint.m_X && outer.m_MinPoint.m_Y <= inner.m_MinPoint.m_Y &&
+			outer.m_MaxPoint.m_X >= inner.m_MaxPoint.m_X && outer.m_MaxPoint.m_Y >= inner.m_MaxPoint.m_Y;
+	}
+}
+
+namespace minte
+{
+	void SpatialIndex::update(uint32_t element, const Rectangle2D_F32& bounds)
+	{
+		if (element >= m_Leaves.size())
+			m_Leaves.resize(element + 1, NullNode);
+
+		auto leaf = m_Leaves[element];
+		if (leaf != NullNode)
+		{
+			// Keep the node if it still contains the bounds, and is not too large for them.
+			const auto& enlargedBounds = m_Nodes[leaf].m_Bounds;
+			if (Contains(enlargedBounds, bounds) && Contains(Enlarge(bounds, Margin * 4), enlargedBounds))
+				return;
+
+			removeLeaf(leaf);
+		}
+		else
+		{
+			leaf = allocateNode();
+			m_Nodes[leaf].m_Element = element;
+			m_Leaves[element] = leaf;
+		}
+
+		m_Nodes[leaf].m_Bounds = Enlarge(bounds, Margin);
+		insertLeaf(leaf);
+	}
+
+	void SpatialIndex::remove(uint32_t element)
+	{
+		if (!contains(element))
+			return;
+
+		const auto leaf = m_Leaves[element];
+		removeLeaf(leaf);
+		freeNode(leaf);
+
+		m_Leaves[element] = NullNode;
+	}
+
+	uint32_t SpatialIndex::allocateNode()
+	{
+		uint32_t node = 0;
+		if (m_FreeList != NullNode)
+		{
+			node = m_FreeList;
+			m_FreeList = m_Nodes[node].m_Parent;
+		}
+		else
+		{
+			node = static_cast<uint32_t>(m_Nodes.size());
+			m_Nodes.emplace_back();
+		}
+
+		m_Nodes[node] = Node();
+		m_Nodes[node].m_Height = 0;
+		return node;
+	}
+
+	void SpatialIndex::freeNode(uint32_t node)
+	{
+		m_Nodes[node] = Node();
+		m_Nodes[node].m_Parent = m_FreeList;
+		m_FreeList = node;
+	}
+
+	void SpatialIndex::insertLeaf(uint32_t leaf)
+	{
+		if (m_Root == NullNode)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].m_Parent = NullNode;
+			return;
+		}
+
+		// Find the best sibling by walking down the tree, choosing the child that grows the least.
+		const auto leafBounds = m_Nodes[leaf].m_Bounds;
+		auto index = m_Root;
+		while (!m_Nodes[index].isLeaf())
+		{
+			const auto& node = m_Nodes[index];
+			const auto perimeter = Perimeter(node.m_Bounds);
+			const auto combinedPerimeter = Perimeter(Union(node.m_Bounds, leafBounds));
+
+			// The cost of creating a new parent for this node and the leaf, and the minimum cost of pushing the leaf further down.
+			const auto cost = 2.0f * combinedPerimeter;
+			const auto inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+			const auto childCost = [this, &leafBounds, inheritanceCost](uint32_t child)
+			{
+				const auto& childNode = m_Nodes[child];
+				const auto combined = Perimeter(Union(leafBounds, childNode.m_Bounds));
+				return childNode.isLeaf() ? combined + inheritanceCost : (combined - Perimeter(childNode.m_Bounds)) + inheritanceCost;
+			};
+
+			const auto leftCost = childCost(node.m_Left);
+			const auto rightCost = childCost(node.m_Right);
+
+			if (cost < leftCost && cost < rightCost)
+				break;
+
+			index = leftCost < rightCost ? node.m_Left : node.m_Right;
+		}
+
+		// Create a new parent for the sibling and the leaf.
+		const auto sibling = index;
+		const auto oldParent = m_Nodes[sibling].m_Parent;
+		const auto newParent = allocateNode();
+
+		auto& parentNode = m_Nodes[newParent];
+		parentNode.m_Parent = oldParent;
+		parentNode.m_Bounds = Union(leafBounds, m_Nodes[sibling].m_Bounds);
+		parentNode.m_Height = m_Nodes[sibling].m_Height + 1;
+		parentNode.m_Left = sibling;
+		parentNode.m_Right = leaf;
+
+		if (oldParent != NullNode)
+		{
+			if (m_Nodes[oldParent].m_Left == sibling)
+				m_Nodes[oldParent].m_Left = newParent;
+			else
+				m_Nodes[oldParent].m_Right = newParent;
+		}
+		else
+		{
+			m_Root = newParent;
+		}
+
+		m_Nodes[sibling].m_Parent = newParent;
+		m_Nodes[leaf].m_Parent = newParent;
+
+		refit(newParent);
+	}
+
+	void SpatialIndex::removeLeaf(uint32_t leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		const auto parent = m_Nodes[leaf].m_Parent;
+		const auto grandParent = m_Nodes[parent].m_Parent;
+		const auto sibling = m_Nodes[parent].m_Left == leaf ? m_Nodes[parent].m_Right : m_Nodes[parent].m_Left;
+
+		// Replace the parent with the sibling.
+		if (grandParent != NullNode)
+		{
+			if (m_Nodes[grandParent].m_Left == parent)
+				m_Nodes[grandParent].m_Left = sibling;
+			else
+				m_Nodes[grandParent].m_Right = sibling;
+
+			m_Nodes[sibling].m_Parent = grandParent;
+			freeNode(parent);
+			refit(grandParent);
+		}
+		else
+		{
+			m_Root = sibling;
+			m_Nodes[sibling].m_Parent = NullNode;
+			freeNode(parent);
+		}
+
+		m_Nodes[leaf].m_Parent = NullNode;
+	}
+
+	void SpatialIndex::refit(uint32_t node)
+	{
+		while (node != NullNode)
+		{
+			node = balance(node);
+
+			auto& current = m_Nodes[node];
+			const auto& left = m_Nodes[current.m_Left];
+			const auto& right = m_Nodes[current.m_Right];
+
+			current.m_Height = 1 + std::max(left.m_Height, right.m_Height);
+			current.m_Bounds = Union(left.m_Bounds, right.m_Bounds);
+
+			node = current.m_Parent;
+		}
+	}
+
+	uint32_t SpatialIndex::balance(uint32_t node)
+	{
+		auto& nodeA = m_Nodes[node];
+		if (nodeA.isLeaf() || nodeA.m_Height < 2)
+			return node;
+
+		const auto indexB = nodeA.m_Left;
+		const auto indexC = nodeA.m_Right;
+		auto& nodeB = m_Nodes[indexB];
+		auto& nodeC = m_Nodes[indexC];
+
+		// Promote the taller child, and give its shorter child to the node.
+		const auto rotate = [this, node, &nodeA](uint32_t indexUp, Node& up, uint32_t& downSlot, const Node& other)
+		{
+			const auto indexF = up.m_Left;
+			const auto indexG = up.m_Right;
+			auto& nodeF = m_Nodes[indexF];
+			auto& nodeG = m_Nodes[indexG];
+
+			up.m_Left = node;
+			up.m_Parent = nodeA.m_Parent;
+			nodeA.m_Parent = indexUp;
+
+			if (up.m_Parent != NullNode)
+			{
+				if (m_Nodes[up.m_Parent].m_Left == node)
+					m_Nodes[up.m_Parent].m_Left = indexUp;
+				else
+					m_Nodes[up.m_Parent].m_Right = indexUp;
+			}
+			else
+			{
+				m_Root = indexUp;
+			}
+
+			const auto keepF = nodeF.m_Height > nodeG.m_Height;
+			const auto indexKept = keepF ? indexF : indexG;
+			const auto indexGiven = keepF ? indexG : indexF;
+			auto& kept = m_Nodes[indexKept];
+			auto& given = m_Nodes[indexGiven];
+
+			up.m_Right = indexKept;
+			downSlot = indexGiven;
+			given.m_Parent = node;
+
+			nodeA.m_Bounds = Union(other.m_Bounds, given.m_Bounds);
+			nodeA.m_Height = 1 + std::max(other.m_Height, given.m_Height);
+			up.m_Bounds = Union(nodeA.m_Bounds, kept.m_Bounds);
+			up.m_Height = 1 + std::max(nodeA.m_Height, kept.m_Height);
+		};
+
+		const auto difference = nodeC.m_Height - nodeB.m_Height;
+		if (difference > 1)
+		{
+			rotate(indexC, nodeC, nodeA.m_Right, nodeB);
+			return indexC;
+		}
+
+		if (difference < -1)
+		{
+			rotate(indexB, nodeB, nodeA.m_Left, nodeC);
+			return indexB;
+		}
+
+		return node;
+	}
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Text.hpp"
+
+#include <cmath>
+
+namespace minte
+{
+	Text::Text(std::shared_ptr<Font> pFont, std::string text, float size, uint32_t color, GlyphMode mode /*= GlyphMode::Coverage*/)
+		: m_pFont(std::move(pFont))
+		, m_Text(std::move(text))
+		, m_Size(size)
+		, m_Color(color)
+		, m_Mode(mode)
+	{
+	}
+
+	void Text::setText(std::string text)
+	{
+		if (m_pParagraph)
+			m_pParagraph->setText(text);
+
+		else
+			m_Text = std::move(text);
+
+		invalidate();
+	}
+
+	void Text::replaceText(uint32_t offset, uint32_t count, std::string_view text)
+	{
+		// The text owns its layout from the first edit onwards.
+		if (m_pParagraph == nullptr)
+		{
+			m_pParagraph = std::make_unique<ParagraphLayout>(m_pFont, m_Size, m_WrapWidth);
+			m_pParagraph->setText(m_Text);
+			m_Text.clear();
+		}
+
+		m_pParagraph->replace(offset, count, text);
+		invalidate();
+	}
+
+	void Text::setFontSize(float size)
+	{
+		m_Size = size;
+
+		if (m_pParagraph)
+		{
+			const auto text = m_pParagraph->getText();
+			m_pParagraph = std::make_unique<ParagraphLayout>(m_pFont, m_Size, m_WrapWidth);
+			m_pParagraph->setText(text);
+		}
+
+		invalidate();
+	}
+
+	void Text::setWrapWidth(float wrapWidth)
+	{
+		m_WrapWidth = wrapWidth;
+
+		if (m_pParagraph)
+			m_pParagraph->setWrapWidth(wrapWidth);
+
+		invalidate();
+	}
+
+	void Text::setColor(uint32_t color)
+	{
+		m_Color = color;
+		markDirty();
+	}
+
+	void Text::generateGeometry(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<DrawBatch>& batches) const
+	{
+		const auto pAtlas = getGlyphAtlas();
+		TextLayout layout;
+		if (pAtlas == nullptr || !getLayout(layout))
+			return;
+
+		m_QuadSlots.clear();
+		auto sampleMode = backend::SampleMode::Coverage;
+		uint32_t slotMask = 0;
+
+		// The baselines are snapped to pixels, so that small coverage glyphs stay sharp.
+		GlyphQuad quad;
+		for (uint32_t i = 0; i < layout.m_Lines.size(); i++)
+		{
+			const auto& line = layout.m_Lines[i];
+			const auto baseline = std::round(layout.m_Metrics.m_Ascent + layout.m_LineHeight * i);
+			auto pen = 0.0f;
+
+			for (const auto& glyph : layout.m_Glyphs.subspan(line.m_FirstGlyph, line.m_GlyphCount))
+			{
+				if (!(glyph.m_Flags & ShapedGlyph::Whitespace) && pAtlas->getGlyph(m_pFont, glyph.m_GlyphIndex, m_Size, m_Mode, quad) && quad.m_Bounds.m_MaxPoint.m_X > quad.m_Bounds.m_MinPoint.m_X)
+				{
+					const auto x0 = pen + quad.m_Bounds.m_MinPoint.m_X;
+					const auto y0 = baseline + quad.m_Bounds.m_MinPoint.m_Y;
+					const auto x1 = pen + quad.m_Bounds.m_MaxPoint.m_X;
+					const auto y1 = baseline + quad.m_Bounds.m_MaxPoint.m_Y;
+					const auto& uv = quad.m_TextureCoordinates;
+
+					vertices.emplace_back(Vertex{ Point2D<float>(x0, y0), uv.m_MinPoint, m_Color });
+					vertices.emplace_back(Vertex{ Point2D<float>(x1, y0), Point2D<float>(uv.m_MaxPoint.m_X, uv.m_MinPoint.m_Y), m_Color });
+					vertices.emplace_back(Vertex{ Point2D<float>(x1, y1), uv.m_MaxPoint, m_Color });
+					vertices.emplace_back(Vertex{ Point2D<float>(x0, y1), Point2D<float>(uv.m_MinPoint.m_X, uv.m_MaxPoint.m_Y), m_Color });
+
+					m_QuadSlots.emplace_back(quad.m_TextureSlot);
+					slotMask |= 1u << quad.m_TextureSlot;
+					sampleMode = quad.m_SampleMode;
+				}
+
+				pen += glyph.m_Advance;
+			}
+		}
+
+		// Group the quads by their page, so that each page is a single batch.
+		for (uint8_t slot = 0; slotMask != 0; slot++, slotMask >>= 1)
+		{
+			if (!(slotMask & 1))
+				continue;
+
+			const auto firstIndex = indices.size();
+			for (uint32_t quadIndex = 0; quadIndex < m_QuadSlots.size(); quadIndex++)
+			{
+				if (m_QuadSlots[quadIndex] != slot)
+					continue;
+
+				const auto vertex = quadIndex * 4;
+				indices.insert(indices.end(), { vertex, vertex + 1, vertex + 2, vertex + 2, vertex + 3, vertex });
+			}
+
+			batches.emplace_back(DrawBatch{ static_cast<uint32_t>(indices.size() - firstIndex), slot, sampleMode });
+		}
+	}
+
+	Point2D_F32 Text::measureContent() const
+	{
+		TextLayout layout;
+		return getLayout(layout) ? layout.m_Size : Point2D_F32();
+	}
+
+	bool Text::getLayout(TextLayout& layout) const
+	{
+		if (m_pParagraph)
+		{
+			layout = m_pParagraph->getLayout();
+			return true;
+		}
+
+		const auto pCache = getTextLayoutCache();
+		if (pCache == nullptr || m_pFont == nullptr)
+			return false;
+
+		layout = pCache->getLayout(m_pFont, m_Text, m_Size, m_WrapWidth);
+		return true;
+	}
+
+	void Text::invalidate()
+	{
+		markDirty();
+		invalidateLayout();
+	}
+}
@@ -0,0 +1,487 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/TextLayout.hpp"
+#include "Minte/FrontendError.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace /* anonymous */
+{
+	/**
+	 * Combine a hash with a value.
+	 *
+	 * @param seed The hash to combine with.
+	 * @param value The value.
+	 * @return The combined hash.
+	 */
+	uint64_t HashCombine(uint64_t seed, uint64_t value)
+	{
+		return seed ^ (value + 0x9E3779B97F4A7C15 + (seed << 6) + (seed >> 2));
+	}
+
+	/**
+	 * Check if a byte is a UTF-8 continuation byte.
+	 *
+	 * @param byte The byte.
+	 * @return Whether the byte continues a code point.
+	 */
+	bool IsContinuation(char byte)
+	{
+		return (static_cast<uint8_t>(byte) & 0xC0) == 0x80;
+	}
+
+	/**
+	 * Decode a UTF-8 code point.
+	 * Invalid bytes are decoded as the replacement character, one byte at a time.
+	 *
+	 * @param text The text.
+	 * @param offset The byte offset of the code point.
+	 * @param codePoint The decoded code point.
+	 * @return The offset of the next code point.
+	 */
+	uint32_t Decode(std::string_view text, uint32_t offset, char32_t& codePoint)
+	{
+		const auto lead = static_cast<uint8_t>(text[offset]);
+		const auto length = lead < 0x80 ? 1u : (lead & 0xE0) == 0xC0 ? 2u : (lead & 0xF0) == 0xE0 ? 3u : (lead & 0xF8) == 0xF0 ? 4u : 0u;
+
+		if (length == 1)
+		{
+			codePoint = lead;
+			return offset + 1;
+		}
+
+		if (length == 0 || offset + length > text.size())
+		{
+			codePoint = 0xFFFD;
+			return offset + 1;
+		}
+
+		codePoint = lead & (0x7F >> length);
+		for (uint32_t i = 1; i < length; i++)
+		{
+			if (!IsContinuation(text[offset + i]))
+			{
+				codePoint = 0xFFFD;
+				return offset + 1;
+			}
+
+			codePoint = (codePoint << 6) | (static_cast<uint8_t>(text[offset + i]) & 0x3F);
+		}
+
+		return offset + length;
+	}
+
+	/**
+	 * Shape a single code point.
+	 *
+	 * @param font The font.
+	 * @param codePoint The code point.
+	 * @param size The font size in pixels.
+	 * @param glyph The glyph to write to. The offset is not changed.
+	 */
+	void ShapeCodePoint(const minte::Font& font, char32_t codePoint, float size, minte::ShapedGlyph& glyph)
+	{
+		using minte::ShapedGlyph;
+
+		switch (codePoint)
+		{
+		case U'\n':
+			glyph.m_Flags = ShapedGlyph::Whitespace | ShapedGlyph::LineFeed;
+			break;
+
+		case U'\r':
+			glyph.m_Flags = ShapedGlyph::Whitespace;
+			break;
+
+		case U'\t':
+			glyph.m_Flags = ShapedGlyph::Whitespace | ShapedGlyph::BreakAfter;
+			glyph.m_GlyphIndex = font.getGlyphIndex(U' ');
+			glyph.m_Advance = font.getAdvance(glyph.m_GlyphIndex, size) * 4.0f;
+			break;
+
+		case U' ':
+		case U'\u3000':
+			glyph.m_Flags = ShapedGlyph::Whitespace | ShapedGlyph::BreakAfter;
+			glyph.m_GlyphIndex = font.getGlyphIndex(codePoint);
+			glyph.m_Advance = font.getAdvance(glyph.m_GlyphIndex, size);
+			break;
+
+		default:
+			glyph.m_Flags = codePoint == U'-' || codePoint == U'\u2014' ? ShapedGlyph::BreakAfter : ShapedGlyph::None;
+			glyph.m_GlyphIndex = font.getGlyphIndex(codePoint);
+			glyph.m_Advance = font.getAdvance(glyph.m_GlyphIndex, size);
+			break;
+		}
+	}
+
+	/**
+	 * Kern a glyph with the glyph that follows it.
+	 * Whitespace is not kerned.
+	 *
+	 * @param font The font.
+	 * @param size The font size in pixels.
+	 * @param glyph The glyph to kern.
+	 * @param nextGlyph The next glyph.
+	 */
+	void Kern(const minte::Font& font, float size, minte::ShapedGlyph& glyph, const minte::ShapedGlyph& nextGlyph)
+	{
+		if (!((glyph.m_Flags | nextGlyph.m_Flags) & minte::ShapedGlyph::Whitespace))
+			glyph.m_Advance += font.getKerning(glyph.m_GlyphIndex, nextGlyph.m_GlyphIndex, size);
+	}
+
+	/**
+	 * Shape a range of text.
+	 * The last glyph is kerned with the code point that follows the range, so the range can be spliced into a longer run.
+	 *
+	 * @param font The font.
+	 * @param text The text.
+	 * @param begin The byte offset of the first code point.
+	 * @param end The byte offset after the last code point.
+	 * @param size The font size in pixels.
+	 * @param glyphs The vector to append the glyphs to.
+	 */
+	void ShapeText(const minte::Font& font, std::string_view text, uint32_t begin, uint32_t end, float size, std::vector<minte::ShapedGlyph>& glyphs)
+	{
+		const auto firstGlyph = glyphs.size();
+
+		char32_t codePoint = 0;
+		for (auto offset = begin; offset < end;)
+		{
+			auto& glyph = glyphs.emplace_back();
+			glyph.m_Offset = offset;
+			offset = Decode(text, offset, codePoint);
+
+			ShapeCodePoint(font, codePoint, size, glyph);
+		}
+
+		for (auto i = firstGlyph + 1; i < glyphs.size(); i++)
+			Kern(font, size, glyphs[i - 1], glyphs[i]);
+
+		if (glyphs.size() > firstGlyph && end < text.size())
+		{
+			minte::ShapedGlyph nextGlyph;
+			Decode(text, end, codePoint);
+			ShapeCodePoint(font, codePoint, size, nextGlyph);
+			Kern(font, size, glyphs.back(), nextGlyph);
+		}
+	}
+
+	/**
+	 * Break a single line.
+	 * Lines are broken at the last break opportunity that fits in the wrap width. Words that are wider than the wrap width are broken
+	 * between their glyphs.
+	 *
+	 * @param glyphs The glyphs.
+	 * @param firstGlyph The first glyph of the line.
+	 * @param wrapWidth The wrap width. Set this to 0 to only break at line feeds.
+	 * @param line The line to write to.
+	 * @return The first glyph of the next line.
+	 */
+	uint32_t BreakLine(std::span<const minte::ShapedGlyph> glyphs, uint32_t firstGlyph, float wrapWidth, minte::TextLine& line)
+	{
+		using minte::ShapedGlyph;
+
+		auto width = 0.0f;
+		auto visibleWidth = 0.0f;
+
+		uint32_t breakGlyph = firstGlyph;
+		auto breakWidth = 0.0f;
+
+		const auto glyphCount = static_cast<uint32_t>(glyphs.size());
+		for (auto i = firstGlyph; i < glyphCount; i++)
+		{
+			const auto& glyph = glyphs[i];
+			if (glyph.m_Flags & ShapedGlyph::LineFeed)
+			{
+				line = minte::TextLine{ firstGlyph, i + 1 - firstGlyph, visibleWidth };
+				return i + 1;
+			}
+
+			// Whitespace can hang past the wrap width.
+			if (!(glyph.m_Flags & ShapedGlyph::Whitespace))
+			{
+				if (wrapWidth > 0.0f && i > firstGlyph && width + glyph.m_Advance > wrapWidth)
+				{
+					if (breakGlyph > firstGlyph)
+					{
+						line = minte::TextLine{ firstGlyph, breakGlyph - firstGlyph, breakWidth };
+						return breakGlyph;
+					}
+
+					line = minte::TextLine{ firstGlyph, i - firstGlyph, visibleWidth };
+					return i;
+				}
+
+				visibleWidth = width + glyph.m_Advance;
+			}
+
+			width += glyph.m_Advance;
+
+			if (glyph.m_Flags & ShapedGlyph::BreakAfter)
+			{
+				breakGlyph = i + 1;
+				breakWidth = visibleWidth;
+			}
+		}
+
+		line = minte::TextLine{ firstGlyph, glyphCount - firstGlyph, visibleWidth };
+		return glyphCount;
+	}
+
+	/**
+	 * Check if the glyphs need an empty line at the end.
+	 * This is the case when the last glyph is a line feed, so that the caret can be placed after it.
+	 *
+	 * @param glyphs The glyphs.
+	 * @return Whether an empty line is needed.
+	 */
+	bool NeedsTrailingLine(std::span<const minte::ShapedGlyph> glyphs)
+	{
+		return !glyphs.empty() && (glyphs.back().m_Flags & minte::ShapedGlyph::LineFeed);
+	}
+
+	/**
+	 * Break glyphs to lines.
+	 *
+	 * @param glyphs The glyphs.
+	 * @param wrapWidth The wrap width. Set this to 0 to only break at line feeds.
+	 * @param lines The vector to append the lines to.
+	 * @return The width of the widest line.
+	 */
+	float BreakLines(std::span<const minte::ShapedGlyph> glyphs, float wrapWidth, std::vector<minte::TextLine>& lines)
+	{
+		auto width = 0.0f;
+		for (uint32_t glyph = 0; glyph < glyphs.size();)
+		{
+			glyph = BreakLine(glyphs, glyph, wrapWidth, lines.emplace_back());
+			width = std::max(width, lines.back().m_Width);
+		}
+
+		if (NeedsTrailingLine(glyphs))
+			lines.emplace_back(minte::TextLine{ static_cast<uint32_t>(glyphs.size()), 0, 0.0f });
+
+		return width;
+	}
+
+	/**
+	 * Create a text layout.
+	 *
+	 * @param font The font.
+	 * @param size The font size in pixels.
+	 * @param glyphs The glyphs.
+	 * @param lines The lines.
+	 * @param width The width of the widest line.
+	 * @return The layout.
+	 */
+	minte::TextLayout CreateLayout(const minte::Font& font, float size, std::span<const minte::ShapedGlyph> glyphs, std::span<const minte::TextLine> lines, float width)
+	{
+		minte::TextLayout layout;
+		layout.m_Glyphs = glyphs;
+		layout.m_Lines = lines;
+		layout.m_Metrics = font.getMetrics(size);
+		layout.m_LineHeight = layout.m_Metrics.m_Ascent - layout.m_Metrics.m_Descent + layout.m_Metrics.m_LineGap;
+		layout.m_Size = minte::Point2D_F32(width, layout.m_LineHeight * static_cast<float>(lines.size()));
+		return layout;
+	}
+}
+
+namespace minte
+{
+	TextLayout TextLayoutCache::getLayout(const std::shared_ptr<Font>& pFont, std::string_view text, float size, float wrapWidth)
+	{
+		const auto fontID = pFont->getID();
+		const auto runKey = HashCombine(HashCombine(std::hash<std::string_view>()(text), fontID), std::bit_cast<uint32_t>(size));
+		const auto linesKey = HashCombine(runKey, std::bit_cast<uint32_t>(wrapWidth));
+
+		// Runs with the same key but a different text are shaped again, which changes their version.
+		auto& run = m_Runs[runKey];
+		auto bHit = true;
+
+		if (run.m_Version == 0 || run.m_FontID != fontID || run.m_Size != size || run.m_Text != text)
+		{
+			run.m_Text.assign(text);
+			run.m_Glyphs.clear();
+			ShapeText(*pFont, run.m_Text, 0, static_cast<uint32_t>(run.m_Text.size()), size, run.m_Glyphs);
+
+			run.m_Version = ++m_Version;
+			run.m_FontID = fontID;
+			run.m_Size = size;
+			bHit = false;
+		}
+
+		auto& lines = m_Lines[linesKey];
+		if (lines.m_RunKey != runKey || lines.m_RunVersion != run.m_Version || lines.m_WrapWidth != wrapWidth)
+		{
+			lines.m_Lines.clear();
+			lines.m_Width = BreakLines(run.m_Glyphs, wrapWidth, lines.m_Lines);
+
+			lines.m_RunKey = runKey;
+			lines.m_RunVersion = run.m_Version;
+			lines.m_WrapWidth = wrapWidth;
+			bHit = false;
+		}
+
+		run.m_LastUsedFrame = m_Frame;
+		lines.m_LastUsedFrame = m_Frame;
+
+		if (bHit)
+			m_HitCount++;
+
+		else
+			m_MissCount++;
+
+		return CreateLayout(*pFont, size, run.m_Glyphs, lines.m_Lines, lines.m_Width);
+	}
+
+	void TextLayoutCache::update()
+	{
+		// Each run usually has a single set of lines, so the lines get the same capacity.
+		trim(m_Runs, m_Capacity);
+		trim(m_Lines, m_Capacity);
+
+		m_Frame++;
+	}
+
+	template<class Entry>
+	void TextLayoutCache::trim(std::unordered_map<uint64_t, Entry>& entries, uint64_t capacity)
+	{
+		if (entries.size() <= capacity)
+			return;
+
+		// Remove a quarter more than needed, so that the cache is not trimmed every frame while it's full.
+		m_Frames.clear();
+		for (const auto& [key, entry] : entries)
+			m_Frames.emplace_back(entry.m_LastUsedFrame);
+
+		const auto removeCount = std::min(entries.size() - capacity + capacity / 4, m_Frames.size() - 1);
+		std::nth_element(m_Frames.begin(), m_Frames.begin() + removeCount, m_Frames.end());
+
+		const auto threshold = std::min(m_Frames[removeCount], m_Frame);
+		std::erase_if(entries, [threshold](const auto& entry) { return entry.second.m_LastUsedFrame < threshold; });
+	}
+
+	ParagraphLayout::ParagraphLayout(std::shared_ptr<Font> pFont, float size, float wrapWidth)
+		: m_pFont(std::move(pFont))
+		, m_Size(size)
+		, m_WrapWidth(wrapWidth)
+	{
+	}
+
+	void ParagraphLayout::setText(std::string_view text)
+	{
+		m_Text.assign(text);
+
+		m_Glyphs.clear();
+		ShapeText(*m_pFont, m_Text, 0, static_cast<uint32_t>(m_Text.size()), m_Size, m_Glyphs);
+
+		m_Lines.clear();
+		m_Width = BreakLines(m_Glyphs, m_WrapWidth, m_Lines);
+		m_ReflowedLineCount = static_cast<uint32_t>(m_Lines.size());
+	}
+
+	void ParagraphLayout::replace(uint32_t offset, uint32_t count, std::string_view text)
+	{
+		const auto end = static_cast<uint64_t>(offset) + count;
+		if (end > m_Text.size() || (offset < m_Text.size() && IsContinuation(m_Text[offset])) || (end < m_Text.size() && IsContinuation(m_Text[end])))
+			throw FrontendError("The replaced range is not a valid range of the text!");
+
+		// The glyph before the range is shaped again as well, since its kerning depends on the first replaced glyph.
+		const auto byOffset = [](const ShapedGlyph& glyph, uint32_t value) { return glyph.m_Offset < value; };
+		const auto firstGlyph = static_cast<uint32_t>(std::lower_bound(m_Glyphs.begin(), m_Glyphs.end(), offset, byOffset) - m_Glyphs.begin());
+		const auto endGlyph = static_cast<uint32_t>(std::lower_bound(m_Glyphs.begin(), m_Glyphs.end(), static_cast<uint32_t>(end), byOffset) - m_Glyphs.begin());
+		const auto shapeGlyph = firstGlyph > 0 ? firstGlyph - 1 : 0;
+
+		const auto byteDelta = static_cast<int64_t>(text.size()) - count;
+		const auto shapeBegin = shapeGlyph < m_Glyphs.size() ? m_Glyphs[shapeGlyph].m_Offset : 0;
+
+		m_Text.replace(offset, count, text);
+
+		const auto shapeEnd = endGlyph < m_Glyphs.size() ? static_cast<uint32_t>(m_Glyphs[endGlyph].m_Offset + byteDelta) : static_cast<uint32_t>(m_Text.size());
+
+		m_GlyphScratch.clear();
+		ShapeText(*m_pFont, m_Text, shapeBegin, shapeEnd, m_Size, m_GlyphScratch);
+
+		// Splice the new glyphs in, and move the glyphs after them.
+		const auto glyphDelta = static_cast<int64_t>(m_GlyphScratch.size()) - (endGlyph - shapeGlyph);
+		const auto changeEnd = shapeGlyph + static_cast<uint32_t>(m_GlyphScratch.size());
+
+		m_Glyphs.erase(m_Glyphs.begin() + shapeGlyph, m_Glyphs.begin() + endGlyph);
+		m_Glyphs.insert(m_Glyphs.begin() + shapeGlyph, m_GlyphScratch.begin(), m_GlyphScratch.end());
+
+		for (auto i = changeEnd; i < m_Glyphs.size(); i++)
+			m_Glyphs[i].m_Offset = static_cast<uint32_t>(m_Glyphs[i].m_Offset + byteDelta);
+
+		// The line before the changed line is broken again too, since the first word of the changed line might fit in it now.
+		const auto byFirstGlyph = [](uint32_t value, const TextLine& line) { return value < line.m_FirstGlyph; };
+		auto firstLine = static_cast<uint32_t>(std::upper_bound(m_Lines.begin(), m_Lines.end(), shapeGlyph, byFirstGlyph) - m_Lines.begin());
+		firstLine = firstLine > 1 ? firstLine - 2 : 0;
+
+		reflow(firstLine, changeEnd, glyphDelta);
+	}
+
+	void ParagraphLayout::setWrapWidth(float wrapWidth)
+	{
+		if (m_WrapWidth == wrapWidth)
+			return;
+
+		m_WrapWidth = wrapWidth;
+
+		m_Lines.clear();
+		m_Width = BreakLines(m_Glyphs, m_WrapWidth, m_Lines);
+		m_ReflowedLineCount = static_cast<uint32_t>(m_Lines.size());
+	}
+
+	TextLayout ParagraphLayout::getLayout() const
+	{
+		return CreateLayout(*m_pFont, m_Size, m_Glyphs, m_Lines, m_Width);
+	}
+
+	void ParagraphLayout::reflow(uint32_t firstLine, uint32_t changeEnd, int64_t glyphDelta)
+	{
+		const auto glyphCount = static_cast<uint32_t>(m_Glyphs.size());
+		auto glyph = firstLine < m_Lines.size() ? m_Lines[firstLine].m_FirstGlyph : 0;
+
+		// Break the lines till a line starts at the same glyph as an old line, after the change.
+		m_LineScratch.clear();
+		auto oldLine = firstLine + 1;
+		auto bConverged = false;
+
+		while (glyph < glyphCount)
+		{
+			glyph = BreakLine(m_Glyphs, glyph, m_WrapWidth, m_LineScratch.emplace_back());
+			if (glyph < changeEnd || glyph == glyphCount)
+				continue;
+
+			const auto oldGlyph = static_cast<int64_t>(glyph) - glyphDelta;
+			while (oldLine < m_Lines.size() && m_Lines[oldLine].m_FirstGlyph < oldGlyph)
+				oldLine++;
+
+			if (oldLine < m_Lines.size() && m_Lines[oldLine].m_FirstGlyph == oldGlyph)
+			{
+				bConverged = true;
+				break;
+			}
+		}
+
+		if (!bConverged)
+		{
+			oldLine = static_cast<uint32_t>(m_Lines.size());
+			if (NeedsTrailingLine(m_Glyphs))
+				m_LineScratch.emplace_back(TextLine{ glyphCount, 0, 0.0f });
+		}
+
+		// Replace the old lines and move the reused ones.
+		m_Lines.erase(m_Lines.begin() + std::min(firstLine, static_cast<uint32_t>(m_Lines.size())), m_Lines.begin() + oldLine);
+		m_Lines.insert(m_Lines.begin() + std::min(firstLine, static_cast<uint32_t>(m_Lines.size())), m_LineScratch.begin(), m_LineScratch.end());
+
+		for (auto i = firstLine + m_LineScratch.size(); i < m_Lines.size(); i++)
+			m_Lines[i].m_FirstGlyph = static_cast<uint32_t>(m_Lines[i].m_FirstGlyph + glyphDelta);
+
+		m_Width = 0.0f;
+		for (const auto& line : m_Lines)
+			m_Width = std::max(m_Width, line.m_Width);
+
+		m_ReflowedLineCount = static_cast<uint32_t>(m_LineScratch.size());
+	}
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace minte
+{
+	ThreadPool::ThreadPool(uint32_t threadCount /*= std::thread::hardware_concurrency()*/)
+	{
+		// Make sure that we have at least one worker, the hardware concurrency can be 0 if it's not computable.
+		threadCount = std::max(threadCount, 1u);
+
+		m_Workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+			m_Workers.emplace_back([this](std::stop_token stopToken) { worker(stopToken); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		wait();
+
+		// Join the workers before the synchronization primitives are destroyed.
+		for (auto& worker : m_Workers)
+			worker.request_stop();
+
+		m_Workers.clear();
+	}
+
+	void ThreadPool::submit(Job&& job)
+	{
+		{
+			auto lock = std::scoped_lock(m_Mutex);
+			m_Jobs.emplace_back(std::move(job));
+		}
+
+		m_JobCondition.notify_one();
+	}
+
+	void ThreadPool::wait()
+	{
+		auto lock = std::unique_lock(m_Mutex);
+		m_IdleCondition.wait(lock, [this] { return m_Jobs.empty() && m_ActiveJobs == 0; });
+	}
+
+	void ThreadPool::worker(std::stop_token stopToken)
+	{
+		while (true)
+		{
+			Job job;
+
+			// Wait till we get a job or till we are asked to stop.
+			{
+				auto lock = std::unique_lock(m_Mutex);
+				if (!m_JobCondition.wait(lock, stopToken, [this] { return !m_Jobs.empty(); }))
+					return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+				m_ActiveJobs++;
+			}
+
+			job();
+
+			// Notify the waiting threads if we're done with all the jobs.
+			{
+				auto lock = std::scoped_lock(m_Mutex);
+				m_ActiveJobs--;
+
+				if (m_Jobs.empty() && m_ActiveJobs == 0)
+					m_IdleCondition.notify_all();
+			}
+		}
+	}
+}
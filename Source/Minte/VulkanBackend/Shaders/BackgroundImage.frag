@@ -0,0 +1,21 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#version 450
+
+layout (location = 0) out vec4 outColor;
+
+layout (set = 0, binding = 0) uniform sampler2D backgroundImage;
+
+layout (push_constant) uniform Constants
+{
+	uvec2 renderExtent;
+	uvec2 targetExtent;
+	uint rowLength;
+	uint firstTexel;
+} constants;
+
+void main()
+{
+	// The image is stretched over the area being drawn, which is smaller than the render target when the render scale is used.
+	outColor = texture(backgroundImage, gl_FragCoord.xy / vec2(constants.renderExtent));
+}
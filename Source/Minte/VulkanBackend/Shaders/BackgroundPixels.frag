@@ -0,0 +1,22 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#version 450
+
+layout (location = 0) out vec4 outColor;
+
+layout (set = 0, binding = 0) uniform samplerBuffer backgroundPixels;
+
+layout (push_constant) uniform Constants
+{
+	uvec2 renderExtent;
+	uvec2 targetExtent;
+	uint rowLength;
+	uint firstTexel;
+} constants;
+
+void main()
+{
+	// The pixels are the size of the render target, so the nearest one is fetched when the render scale is used.
+	const uvec2 pixel = min(uvec2(gl_FragCoord.xy * vec2(constants.targetExtent) / vec2(constants.renderExtent)), constants.targetExtent - 1);
+	outColor = texelFetch(backgroundPixels, int(constants.firstTexel + pixel.y * constants.rowLength + pixel.x));
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#version 450
+
+layout (location = 0) in vec2 inTextureCoordinate;
+layout (location = 1) in vec4 inColor;
+layout (location = 2) flat in uint inEntityID;
+
+layout (location = 0) out vec4 outColor;
+layout (location = 1) out uint outEntity;
+
+layout (set = 0, binding = 0) uniform sampler2D textureSampler;
+
+layout (push_constant) uniform Constants
+{
+	vec2 extent;
+	uint sampleMode;
+	float depth;
+} constants;
+
+// These must match the backend::SampleMode enum.
+const uint SampleModeColor = 0;
+const uint SampleModeImage = 1;
+const uint SampleModeCoverage = 2;
+const uint SampleModeDistanceField = 3;
+
+void main()
+{
+	outColor = inColor;
+	outEntity = inEntityID;
+
+	// The sample mode is the same for the whole draw, so the derivatives are well defined.
+	if (constants.sampleMode == SampleModeImage)
+	{
+		outColor *= texture(textureSampler, inTextureCoordinate);
+	}
+	else if (constants.sampleMode == SampleModeCoverage)
+	{
+		outColor.a *= texture(textureSampler, inTextureCoordinate).r;
+	}
+	else if (constants.sampleMode == SampleModeDistanceField)
+	{
+		// Keep the edge about a pixel wide at any scale.
+		const float distance = texture(textureSampler, inTextureCoordinate).r;
+		const float width = max(fwidth(distance) * 0.5, 1.0 / 255.0);
+		outColor.a *= smoothstep(0.5 - width, 0.5 + width, distance);
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#version 450
+
+layout (location = 0) in vec2 inPosition;
+layout (location = 1) in vec2 inTextureCoordinate;
+layout (location = 2) in vec4 inColor;
+layout (location = 3) in uint inEntityID;
+
+layout (location = 0) out vec2 outTextureCoordinate;
+layout (location = 1) out vec4 outColor;
+layout (location = 2) flat out uint outEntityID;
+
+layout (push_constant) uniform Constants
+{
+	vec2 extent;
+	uint sampleMode;
+	float depth;
+} constants;
+
+void main()
+{
+	outTextureCoordinate = inTextureCoordinate;
+	outColor = inColor;
+	outEntityID = inEntityID;
+
+	// The positions are in pixels, with the origin at the top left corner.
+	gl_Position = vec4(inPosition / constants.extent * 2.0 - 1.0, constants.depth, 1.0);
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#version 450
+
+layout (location = 0) out vec4 outColor;
+layout (location = 1) out uint outEntity;
+
+layout (set = 0, binding = 0) uniform sampler2D colorImage;
+layout (set = 0, binding = 1) uniform usampler2D entityImage;
+layout (set = 0, binding = 2) uniform sampler2D depthImage;
+
+layout (push_constant) uniform Constants
+{
+	uvec2 sourceExtent;
+	uvec2 destinationExtent;
+} constants;
+
+// Catmull-Rom filter weights of the 4 pixels around a sample, matching the CPU backend.
+vec4 getWeights(float t)
+{
+	return vec4(
+		((-0.5 * t + 1.0) * t - 0.5) * t,
+		(1.5 * t - 2.5) * t * t + 1.0,
+		((-1.5 * t + 2.0) * t + 0.5) * t,
+		(0.5 * t - 0.5) * t * t
+	);
+}
+
+void main()
+{
+	// The fragment coordinate is the pixel center.
+	const vec2 center = gl_FragCoord.xy * vec2(constants.sourceExtent) / vec2(constants.destinationExtent);
+	const vec2 samplePosition = center - 0.5;
+	const ivec2 first = ivec2(floor(samplePosition)) - 1;
+	const ivec2 last = ivec2(constants.sourceExtent) - 1;
+	const vec4 weightsX = getWeights(fract(samplePosition.x));
+	const vec4 weightsY = getWeights(fract(samplePosition.y));
+
+	// The scaled image is in the top left of the source, so the pixels are fetched and clamped to its edge by hand.
+	vec4 color = vec4(0.0);
+	for (int j = 0; j < 4; j++)
+	{
+		const int y = clamp(first.y + j, 0, last.y);
+
+		vec4 row = vec4(0.0);
+		for (int i = 0; i < 4; i++)
+			row += texelFetch(colorImage, ivec2(clamp(first.x + i, 0, last.x), y), 0) * weightsX[i];
+
+		color += row * weightsY[j];
+	}
+
+	outColor = clamp(color, 0.0, 1.0);
+
+	// The entity IDs and the depth can't be blended, so they're copied from the nearest pixel.
+	const ivec2 nearest = min(ivec2(center), last);
+	outEntity = texelFetch(entityImage, nearest, 0).r;
+	gl_FragDepth = texelFetch(depthImage, nearest, 0).r;
+}
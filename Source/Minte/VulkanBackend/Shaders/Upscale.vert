@@ -0,0 +1,10 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#version 450
+
+void main()
+{
+	// A single triangle covering the whole render target.
+	const vec2 position = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+	gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -7,29 +7,36 @@ namespace minte
 {
 	namespace backend
 	{
-		VulkanImageBuffer::VulkanImageBuffer(const std::shared_ptr<VulkanInstance>& pInstance, uint64_t size)
-			: ImageBuffer(pInstance, size)
+		VulkanImageBuffer::VulkanImageBuffer(const std::shared_ptr<VulkanInstance>& pInstance, uint64_t size, ResourceCategory category /*= ResourceCategory::Readback*/)
+			: ImageBuffer(pInstance, size), m_Category(category)
 		{
 			VkBufferCreateInfo createInfo = {};
 			createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 			createInfo.pNext = VK_NULL_HANDLE;
 			createInfo.flags = 0;
 			createInfo.size = size;
-			createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
 			createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 			createInfo.queueFamilyIndexCount = 0;
 			createInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
 
+			// Readback buffers are read by the host, so they need to be cached. Staging buffers are only written to.
 			VmaAllocationCreateInfo allocationCreateInfo = {};
-			allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+			allocationCreateInfo.flags = category == ResourceCategory::Readback ? VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT : VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
 			allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
 
-			MINTE_VK_ASSERT(vmaCreateBuffer(getInstance()->as<VulkanInstance>()->getAllocator(), &createInfo, &allocationCreateInfo, &m_Buffer, &m_Allocation, VK_NULL_HANDLE), "Failed to create the buffer!");
+			VmaAllocationInfo allocationInfo = {};
+			MINTE_VK_ASSERT(vmaCreateBuffer(pInstance->getAllocator(), &createInfo, &allocationCreateInfo, &m_Buffer, &m_Allocation, &allocationInfo), "Failed to create the buffer!");
+
+			m_AllocationSize = allocationInfo.size;
+			pInstance->registerAllocation(m_Category, m_AllocationSize);
 		}
 
 		VulkanImageBuffer::~VulkanImageBuffer()
 		{
-			vmaDestroyBuffer(getInstance()->as<VulkanInstance>()->getAllocator(), m_Buffer, m_Allocation);
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			vmaDestroyBuffer(pInstance->getAllocator(), m_Buffer, m_Allocation);
+			pInstance->unregisterAllocation(m_Category, m_AllocationSize);
 		}
 
 		std::byte* VulkanImageBuffer::mapMemory()
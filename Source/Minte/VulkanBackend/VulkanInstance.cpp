@@ -273,7 +273,34 @@ namespace minte
 			vkDestroyInstance(m_Instance, VK_NULL_HANDLE);
 		}
 
-		void VulkanInstance::changeImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout currentLayout, VkImageLayout newLayout, VkImageAspectFlags aspectFlags, uint32_t mipLevels /*= 1*/, uint32_t layers /*= 1*/) const
+		MemoryStatistics VulkanInstance::getMemoryStatistics() const
+		{
+			MemoryStatistics statistics;
+			statistics.m_HasDeviceBudget = m_HasMemoryBudget;
+			fillTrackedStatistics(statistics);
+
+			// Get the heap budgets from VMA. This uses VK_EXT_memory_budget if it's enabled.
+			const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+			vmaGetMemoryProperties(m_Allocator, &pMemoryProperties);
+
+			std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+			vmaGetHeapBudgets(m_Allocator, budgets.data());
+
+			statistics.m_Heaps.resize(pMemoryProperties->memoryHeapCount);
+			for (uint32_t i = 0; i < pMemoryProperties->memoryHeapCount; i++)
+			{
+				auto& heap = statistics.m_Heaps[i];
+				heap.m_Size = pMemoryProperties->memoryHeaps[i].size;
+				heap.m_Usage = budgets[i].usage;
+				heap.m_Budget = budgets[i].budget;
+				heap.m_Allocated = budgets[i].statistics.allocationBytes;
+				heap.m_IsDeviceLocal = pMemoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+			}
+
+			return statistics;
+		}
+
+		void VulkanInstance::changeImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout currentLayout, VkImageLayout newLayout, VkImageAspectFlags aspectFlags, uint32_t mipLevels /*= 1*/, uint32_t layers /*= 1*/, uint32_t baseMipLevel /*= 0*/) const
 		{
 			// Create the memory barrier.
 			VkImageMemoryBarrier memorybarrier = {};
@@ -286,7 +313,7 @@ namespace minte
 			memorybarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 			memorybarrier.image = image;
 			memorybarrier.subresourceRange.aspectMask = aspectFlags;
-			memorybarrier.subresourceRange.baseMipLevel = 0;
+			memorybarrier.subresourceRange.baseMipLevel = baseMipLevel;
 			memorybarrier.subresourceRange.levelCount = mipLevels;
 			memorybarrier.subresourceRange.baseArrayLayer = 0;
 			memorybarrier.subresourceRange.layerCount = layers;
@@ -376,6 +403,21 @@ namespace minte
 			getDeviceTable().vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &memorybarrier);
 		}
 
+		VkShaderModule VulkanInstance::createShaderModule(std::span<const uint32_t> code) const
+		{
+			VkShaderModuleCreateInfo createInfo = {};
+			createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+			createInfo.pNext = VK_NULL_HANDLE;
+			createInfo.flags = 0;
+			createInfo.codeSize = code.size_bytes();
+			createInfo.pCode = code.data();
+
+			VkShaderModule shaderModule = VK_NULL_HANDLE;
+			MINTE_VK_ASSERT(m_DeviceTable.vkCreateShaderModule(m_LogicalDevice, &createInfo, VK_NULL_HANDLE, &shaderModule), "Failed to create the shader module!");
+
+			return shaderModule;
+		}
+
 		void VulkanInstance::setupInstance()
 		{
 			// Setup the application info.
@@ -559,6 +601,69 @@ namespace minte
 			if (m_PhysicalDevice == VK_NULL_HANDLE)
 				throw backend::BackendError("Failed to find a suitable physical device!");
 
+			// Enable the optional extensions if they are supported.
+			auto enabledExtensions = deviceExtensions;
+			if (CheckDeviceExtensionSupport(m_PhysicalDevice, { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME }))
+			{
+				enabledExtensions.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+				m_HasMemoryBudget = true;
+			}
+
+			// Exporting the attachments needs file descriptors for both the memory and the semaphores. Dma-bufs are optional on top of that.
+			if (CheckDeviceExtensionSupport(m_PhysicalDevice, { VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME, VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME }))
+			{
+				enabledExtensions.emplace_back(VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME);
+				enabledExtensions.emplace_back(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME);
+				m_HasExternalMemory = true;
+
+				if (CheckDeviceExtensionSupport(m_PhysicalDevice, { VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME }))
+				{
+					enabledExtensions.emplace_back(VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME);
+					m_HasDmaBufMemory = true;
+				}
+			}
+
+			// Host pointers can be imported as memory, as long as they're aligned to the device's import alignment.
+			if (CheckDeviceExtensionSupport(m_PhysicalDevice, { VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME }))
+			{
+				VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostMemoryProperties = {};
+				hostMemoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+				hostMemoryProperties.pNext = VK_NULL_HANDLE;
+
+				VkPhysicalDeviceProperties2 properties = {};
+				properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+				properties.pNext = &hostMemoryProperties;
+				vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties);
+
+				enabledExtensions.emplace_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+				m_HostPointerAlignment = hostMemoryProperties.minImportedHostPointerAlignment;
+				m_HasHostMemoryImport = true;
+			}
+
+			// Present wait needs both extensions, and the features have to be queried.
+			VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+			presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+			presentWaitFeatures.pNext = VK_NULL_HANDLE;
+
+			VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+			presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+			presentIdFeatures.pNext = &presentWaitFeatures;
+
+			if (CheckDeviceExtensionSupport(m_PhysicalDevice, { VK_KHR_PRESENT_ID_EXTENSION_NAME, VK_KHR_PRESENT_WAIT_EXTENSION_NAME }))
+			{
+				VkPhysicalDeviceFeatures2 supportedFeatures = {};
+				supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+				supportedFeatures.pNext = &presentIdFeatures;
+				vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supportedFeatures);
+
+				if (presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE)
+				{
+					enabledExtensions.emplace_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+					enabledExtensions.emplace_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+					m_HasPresentWait = true;
+				}
+			}
+
 			// Setup device queues.
 			constexpr float priority = 1.0f;
 			std::set<uint32_t> uniqueQueueFamilies = {
@@ -592,14 +697,14 @@ namespace minte
 			// Setup the device create info.
 			VkDeviceCreateInfo deviceCreateInfo = {};
 			deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-			deviceCreateInfo.pNext = VK_NULL_HANDLE;
+			deviceCreateInfo.pNext = m_HasPresentWait ? &presentIdFeatures : VK_NULL_HANDLE;
 			deviceCreateInfo.flags = 0;
 			deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 			deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 			deviceCreateInfo.enabledLayerCount = 0;
 			deviceCreateInfo.ppEnabledLayerNames = VK_NULL_HANDLE;
-			deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-			deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
+			deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+			deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data();
 			deviceCreateInfo.pEnabledFeatures = &features;
 
 #ifdef MINTE_DEBUG
@@ -655,7 +760,7 @@ namespace minte
 			// Setup create info.
 			VmaAllocatorCreateInfo createInfo = {};
 			// createInfo.flags = VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT;
-			createInfo.flags = 0;
+			createInfo.flags = m_HasMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
 			createInfo.physicalDevice = m_PhysicalDevice;
 			createInfo.device = m_LogicalDevice;
 			createInfo.pVulkanFunctions = &functions;
@@ -5,9 +5,117 @@
 #include "Minte/Backend/VulkanBackend/VulkanImageBuffer.hpp"
 
 #include <array>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+
+#endif
 
 namespace /* anonymous */
 {
+	/**
+	 * Color conversion compute shader code.
+	 */
+	constexpr uint32_t ColorConversionShaderCode[] = {
+#include "Shaders/ColorConversion.comp.spv.hpp"
+	};
+
+	/**
+	 * Geometry vertex shader code.
+	 */
+	constexpr uint32_t GeometryVertexShaderCode[] = {
+#include "Shaders/Geometry.vert.spv.hpp"
+	};
+
+	/**
+	 * Geometry fragment shader code.
+	 */
+	constexpr uint32_t GeometryFragmentShaderCode[] = {
+#include "Shaders/Geometry.frag.spv.hpp"
+	};
+
+	/**
+	 * Upscale vertex shader code.
+	 */
+	constexpr uint32_t UpscaleVertexShaderCode[] = {
+#include "Shaders/Upscale.vert.spv.hpp"
+	};
+
+	/**
+	 * Upscale fragment shader code.
+	 */
+	constexpr uint32_t UpscaleFragmentShaderCode[] = {
+#include "Shaders/Upscale.frag.spv.hpp"
+	};
+
+	/**
+	 * Background image fragment shader code.
+	 */
+	constexpr uint32_t BackgroundImageFragmentShaderCode[] = {
+#include "Shaders/BackgroundImage.frag.spv.hpp"
+	};
+
+	/**
+	 * Background pixels fragment shader code.
+	 */
+	constexpr uint32_t BackgroundPixelsFragmentShaderCode[] = {
+#include "Shaders/BackgroundPixels.frag.spv.hpp"
+	};
+
+	/**
+	 * Geometry push constants structure.
+	 * This must match the push constant block in the shaders.
+	 */
+	struct GeometryConstants final
+	{
+		float m_Width = 0.0f;
+		float m_Height = 0.0f;
+		uint32_t m_SampleMode = 0;
+		float m_Depth = 0.0f;
+	};
+
+	/**
+	 * Color conversion push constants structure.
+	 * This must match the push constant block in the shader.
+	 */
+	struct ConversionConstants final
+	{
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_Format = 0;
+	};
+
+	/**
+	 * Upscale push constants structure.
+	 * This must match the push constant block in the shader.
+	 */
+	struct UpscaleConstants final
+	{
+		uint32_t m_SourceWidth = 0;
+		uint32_t m_SourceHeight = 0;
+		uint32_t m_DestinationWidth = 0;
+		uint32_t m_DestinationHeight = 0;
+	};
+
+	/**
+	 * Background push constants structure.
+	 * This must match the push constant block in the shaders.
+	 */
+	struct BackgroundConstants final
+	{
+		uint32_t m_RenderWidth = 0;
+		uint32_t m_RenderHeight = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_RowLength = 0;
+		uint32_t m_FirstTexel = 0;
+	};
+
 	/**
 	 * Get the Vulkan sample count from the anti-aliasing value.
 	 *
@@ -28,6 +136,37 @@ namespace /* anonymous */
 		default:									throw minte::backend::BackendError("Invalid Anti-Aliasing value!");
 		}
 	}
+
+	/**
+	 * Get the Vulkan handle type of an external memory type.
+	 *
+	 * @param type The external memory type.
+	 * @return The handle type.
+	 */
+	VkExternalMemoryHandleTypeFlagBits GetExternalMemoryHandleType(minte::backend::VulkanExternalMemory type)
+	{
+		switch (type)
+		{
+		case minte::backend::VulkanExternalMemory::OpaqueFD:	return VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+		case minte::backend::VulkanExternalMemory::DmaBuf:		return VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+		default:												throw minte::backend::BackendError("Invalid external memory type!");
+		}
+	}
+
+	/**
+	 * Close a file descriptor.
+	 * File descriptors are only exported on POSIX platforms, so this does nothing elsewhere.
+	 *
+	 * @param fileDescriptor The file descriptor to close. Nothing is done if it's -1.
+	 */
+	void CloseFileDescriptor(int32_t fileDescriptor)
+	{
+#ifndef _WIN32
+		if (fileDescriptor != -1)
+			close(fileDescriptor);
+
+#endif
+	}
 }
 
 namespace minte
@@ -38,15 +177,12 @@ namespace minte
 			: backend::RenderTarget(pInstance, width, height, antiAliasing)
 		{
 			// Create the attachments.
-			m_ColorAttachment = createAttachment(VK_FORMAT_R8G8B8A8_UNORM, GetSampleCount(antiAliasing), VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
-			m_EntityAttachment = createAttachment(VK_FORMAT_R32_SFLOAT, GetSampleCount(antiAliasing), VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+			setupColorOutput();
+			m_EntityAttachment = createAttachment(VK_FORMAT_R32_UINT, GetSampleCount(antiAliasing), VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
 			m_DepthAttachment = createAttachment(VK_FORMAT_D16_UNORM, GetSampleCount(antiAliasing), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT);
 
 			// Setup the buffers.
 			VkMemoryRequirements imageMemoryRequirements = {};
-			vkGetImageMemoryRequirements(pInstance->getLogicalDevice(), m_ColorAttachment.m_Image, &imageMemoryRequirements);
-			setColorBuffer(std::make_unique<VulkanImageBuffer>(pInstance, imageMemoryRequirements.size));
-
 			vkGetImageMemoryRequirements(pInstance->getLogicalDevice(), m_EntityAttachment.m_Image, &imageMemoryRequirements);
 			setEntityBuffer(std::make_unique<VulkanImageBuffer>(pInstance, imageMemoryRequirements.size));
 
@@ -57,6 +193,8 @@ namespace minte
 			setupRenderPass();
 			setupFramebuffer();
 			setupCommandBuffer();
+			setupTextureDescriptors();
+			setupGeometryPipeline();
 		}
 
 		VulkanRenderTarget::~VulkanRenderTarget()
@@ -64,18 +202,43 @@ namespace minte
 			destroyAttachment(m_ColorAttachment);
 			destroyAttachment(m_EntityAttachment);
 			destroyAttachment(m_DepthAttachment);
+			destroyConversionPipeline();
+			destroyUpscale();
+			destroyBackground();
+			releaseBackgroundPixels();
+			destroyGeometryBuffer(m_VertexBuffer);
+			destroyGeometryBuffer(m_IndexBuffer);
 
 			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkDestroyPipeline(pInstance->getLogicalDevice(), m_GeometryPipeline, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipeline(pInstance->getLogicalDevice(), m_OpaqueGeometryPipeline, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipelineLayout(pInstance->getLogicalDevice(), m_GeometryPipelineLayout, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyDescriptorPool(pInstance->getLogicalDevice(), m_TextureDescriptorPool, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyDescriptorSetLayout(pInstance->getLogicalDevice(), m_TextureDescriptorSetLayout, VK_NULL_HANDLE);
 			pInstance->getDeviceTable().vkDestroyRenderPass(pInstance->getLogicalDevice(), m_RenderPass, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyRenderPass(pInstance->getLogicalDevice(), m_UpscaleRenderPass, VK_NULL_HANDLE);
 			pInstance->getDeviceTable().vkDestroyFramebuffer(pInstance->getLogicalDevice(), m_Framebuffer, VK_NULL_HANDLE);
 			pInstance->getDeviceTable().vkDestroyCommandPool(pInstance->getLogicalDevice(), m_CommandPool, VK_NULL_HANDLE);
 			pInstance->getDeviceTable().vkDestroyFence(pInstance->getLogicalDevice(), m_Fence, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroySemaphore(pInstance->getLogicalDevice(), m_CompletionSemaphore, VK_NULL_HANDLE);
+
+			CloseFileDescriptor(m_CompletionFileDescriptor);
 		}
 
 		void VulkanRenderTarget::draw()
 		{
+			const auto startTime = std::chrono::steady_clock::now();
 			const auto pInstance = getInstance()->as<VulkanInstance>();
 
+			// Make sure we don't write to a buffer that's retained by the user. The buffers are not written if the output stays on the GPU.
+			if (isHostOutput() && acquireBuffers() && getOutputFormat() != OutputFormat::RGBA)
+				updateConversionDescriptor();
+
+			updateTextureDescriptors();
+
+			if (isScaled() && m_UpscalePipeline == VK_NULL_HANDLE)
+				setupUpscale();
+
 			// Begin command buffer.
 			VkCommandBufferBeginInfo beginInfo = {};
 			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -92,10 +255,10 @@ namespace minte
 			clearColors[0].color.float32[2] = 0.0f;
 			clearColors[0].color.float32[3] = 0.0f;
 
-			clearColors[1].color.float32[0] = 0.0f;
-			clearColors[1].color.float32[1] = 0.0f;
-			clearColors[1].color.float32[2] = 0.0f;
-			clearColors[1].color.float32[3] = 0.0f;
+			clearColors[1].color.uint32[0] = 0;
+			clearColors[1].color.uint32[1] = 0;
+			clearColors[1].color.uint32[2] = 0;
+			clearColors[1].color.uint32[3] = 0;
 
 			clearColors[2].depthStencil.depth = 1.0f;
 			clearColors[2].depthStencil.stencil = 0.0f;
@@ -106,37 +269,32 @@ namespace minte
 			renderPassBeginInfo.pNext = VK_NULL_HANDLE;
 			renderPassBeginInfo.renderPass = m_RenderPass;
 			renderPassBeginInfo.framebuffer = m_Framebuffer;
-			renderPassBeginInfo.renderArea.extent = VkExtent2D{ getWidth(), getHeight() };
+			renderPassBeginInfo.renderArea.extent = VkExtent2D{ getRenderWidth(), getRenderHeight() };
 			renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearColors.size());
 			renderPassBeginInfo.pClearValues = clearColors.data();
 
 			pInstance->getDeviceTable().vkCmdBeginRenderPass(m_CommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-			// Bind the pipeline.
+			// Draw the background over the cleared color, so the entities are drawn on top of it.
+			if (hasBackground())
+				recordBackground();
+
 			// Draw the entities.
+			recordGeometry(false);
 
 			// Unbind the render target.
 			pInstance->getDeviceTable().vkCmdEndRenderPass(m_CommandBuffer);
 
-			// Copy the color, depth and picking images to the buffers.
-			VkBufferImageCopy imageCopy = {};
-			imageCopy.imageExtent = { getWidth(), getHeight(), 1 };
-			imageCopy.imageOffset = { 0, 0, 0 };
-			imageCopy.imageSubresource.baseArrayLayer = 0;
-			imageCopy.imageSubresource.layerCount = 1;
-			imageCopy.imageSubresource.mipLevel = 0;
-			imageCopy.bufferOffset = 0;
-			imageCopy.bufferImageHeight = getHeight();
-			imageCopy.bufferRowLength = getWidth();
-
-			imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			pInstance->getDeviceTable().vkCmdCopyImageToBuffer(m_CommandBuffer, m_ColorAttachment.m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, getColorBuffer()->as<VulkanImageBuffer>()->getBuffer(), 1, &imageCopy);
+			// Upscale the entities if they were drawn at a lower resolution.
+			if (isScaled())
+				recordUpscale();
 
-			imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			pInstance->getDeviceTable().vkCmdCopyImageToBuffer(m_CommandBuffer, m_EntityAttachment.m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, getEntityBuffer()->as<VulkanImageBuffer>()->getBuffer(), 1, &imageCopy);
+			// Copy the color, depth and picking images to the buffers.
+			if (isHostOutput())
+				recordReadback();
 
-			imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-			pInstance->getDeviceTable().vkCmdCopyImageToBuffer(m_CommandBuffer, m_DepthAttachment.m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, getDepthBuffer()->as<VulkanImageBuffer>()->getBuffer(), 1, &imageCopy);
+			if (m_ExternalMemory != VulkanExternalMemory::None)
+				recordExternalRelease();
 
 			// End the command buffer.
 			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkEndCommandBuffer(m_CommandBuffer), "Failed to end command buffer!");
@@ -151,13 +309,98 @@ namespace minte
 			submitInfo.commandBufferCount = 1;
 			submitInfo.pCommandBuffers = &m_CommandBuffer;
 			submitInfo.pWaitDstStageMask = &waitStageMask;
-			submitInfo.signalSemaphoreCount = 0;
-			submitInfo.pSignalSemaphores = VK_NULL_HANDLE;
+			submitInfo.signalSemaphoreCount = m_CompletionSemaphore != VK_NULL_HANDLE ? 1 : 0;
+			submitInfo.pSignalSemaphores = &m_CompletionSemaphore;
 
 			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkQueueSubmit(pInstance->getGraphicsQueue().m_Queue, 1, &submitInfo, m_Fence), "Failed to submit the queue!");
 
+			// Export the completion semaphore while the signal is pending. Exporting a sync file descriptor unsignals the semaphore, so it can be
+			// signaled again by the next draw call.
+			if (m_CompletionSemaphore != VK_NULL_HANDLE)
+			{
+				CloseFileDescriptor(m_CompletionFileDescriptor);
+
+				VkSemaphoreGetFdInfoKHR getFdInfo = {};
+				getFdInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR;
+				getFdInfo.pNext = VK_NULL_HANDLE;
+				getFdInfo.semaphore = m_CompletionSemaphore;
+				getFdInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT;
+
+				m_CompletionFileDescriptor = -1;
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkGetSemaphoreFdKHR(pInstance->getLogicalDevice(), &getFdInfo, &m_CompletionFileDescriptor), "Failed to export the completion semaphore!");
+			}
+
 			// Wait for the fence to finish execution.
 			waitForFence();
+
+			updateRenderScale(std::chrono::steady_clock::now() - startTime);
+		}
+
+		void VulkanRenderTarget::updateVertices(uint64_t offset, std::span<const Vertex> vertices)
+		{
+			writeGeometryBuffer(m_VertexBuffer, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, offset * sizeof(Vertex), std::as_bytes(vertices));
+		}
+
+		void VulkanRenderTarget::updateIndices(uint64_t offset, std::span<const Index> indices)
+		{
+			writeGeometryBuffer(m_IndexBuffer, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, offset * sizeof(Index), std::as_bytes(indices));
+		}
+
+		void VulkanRenderTarget::setOutputFormat(OutputFormat format)
+		{
+			if (format == getOutputFormat())
+				return;
+
+			validateOutputFormat(format);
+			if (format != OutputFormat::RGBA && getAntiAliasing() != AntiAliasing::X1)
+				throw BackendError("Converting the color output requires the anti-aliasing to be x1!");
+
+			m_OutputFormat = format;
+			invalidateState();
+
+			// The draw call waits till the device is done, so we can recreate the color output right away.
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkDestroyFramebuffer(pInstance->getLogicalDevice(), m_Framebuffer, VK_NULL_HANDLE);
+			destroyAttachment(m_ColorAttachment);
+
+			setupColorOutput();
+			setupFramebuffer();
+
+			// Setup the conversion pipeline if we need to.
+			if (format != OutputFormat::RGBA)
+			{
+				if (m_ConversionPipeline == VK_NULL_HANDLE)
+					setupConversionPipeline();
+
+				updateConversionDescriptor();
+			}
+		}
+
+		void VulkanRenderTarget::setupColorOutput()
+		{
+			const auto pInstance = std::static_pointer_cast<VulkanInstance>(getInstancePointer());
+
+			// The conversion shader reads the color attachment as a storage image.
+			const bool bConvert = getOutputFormat() != OutputFormat::RGBA;
+			const VkImageUsageFlags usageFlags = bConvert ? VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+			m_ColorAttachment = createAttachment(VK_FORMAT_R8G8B8A8_UNORM, GetSampleCount(getAntiAliasing()), usageFlags, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, m_ExternalMemory != VulkanExternalMemory::None);
+
+			// Setup the color buffer. The converted output is tightly packed, so we don't need the whole image.
+			if (bConvert)
+			{
+				setColorBuffer(std::make_unique<VulkanImageBuffer>(pInstance, getOutputSize()));
+			}
+			else
+			{
+				VkMemoryRequirements imageMemoryRequirements = {};
+				vkGetImageMemoryRequirements(pInstance->getLogicalDevice(), m_ColorAttachment.m_Image, &imageMemoryRequirements);
+				setColorBuffer(std::make_unique<VulkanImageBuffer>(pInstance, imageMemoryRequirements.size));
+			}
+		}
+
+		std::shared_ptr<ImageBuffer> VulkanRenderTarget::createImageBuffer(uint64_t size)
+		{
+			return std::make_shared<VulkanImageBuffer>(std::static_pointer_cast<VulkanInstance>(getInstancePointer()), size);
 		}
 
 		void VulkanRenderTarget::setupRenderPass()
@@ -182,7 +425,7 @@ namespace minte
 
 			// Entity attachment.
 			attachmentDescriptions[1].flags = 0;
-			attachmentDescriptions[1].format = VK_FORMAT_R32_SFLOAT;
+			attachmentDescriptions[1].format = VK_FORMAT_R32_UINT;
 			attachmentDescriptions[1].samples = GetSampleCount(getAntiAliasing());
 			attachmentDescriptions[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 			attachmentDescriptions[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
@@ -208,23 +451,24 @@ namespace minte
 			attachmentReferences[2].attachment = 2;
 			attachmentReferences[2].layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
-			// Create the subpass dependencies.
+			// Create the subpass dependencies. The depth attachment is tested and written by the opaque commands, and every attachment is copied
+			// by the transfers recorded after the render pass.
 			std::array<VkSubpassDependency, 2> subpassDependencies = {};
 			subpassDependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
 			subpassDependencies[0].dstSubpass = 0;
 			subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-			subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
 			subpassDependencies[0].srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-			subpassDependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			subpassDependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 			subpassDependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
 			subpassDependencies[1].srcSubpass = 0;
 			subpassDependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
-			subpassDependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-			subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-			subpassDependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-			subpassDependencies[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-			subpassDependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+			subpassDependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			subpassDependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			subpassDependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			subpassDependencies[1].dependencyFlags = 0;
 
 			// Create the subpass description.
 			VkSubpassDescription subpassDescription = {};
@@ -253,17 +497,39 @@ namespace minte
 
 			const auto pInstance = getInstance()->as<VulkanInstance>();
 			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateRenderPass(pInstance->getLogicalDevice(), &renderPassCreateInfo, VK_NULL_HANDLE, &m_RenderPass), "Failed to create render pass!");
+
+			// The upscale render pass overwrites every pixel, so it does not need to clear the attachments.
+			for (auto& attachmentDescription : attachmentDescriptions)
+				attachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+
+			// The attachments are copied to the scaled images right before the upscale render pass, so their layout transitions have to wait
+			// for the copies. The depth is written by the upscale shader as well.
+			subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			subpassDependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			subpassDependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateRenderPass(pInstance->getLogicalDevice(), &renderPassCreateInfo, VK_NULL_HANDLE, &m_UpscaleRenderPass), "Failed to create the upscale render pass!");
 		}
 
-		minte::backend::VulkanRenderTarget::VulkanAttachment VulkanRenderTarget::createAttachment(VkFormat format, VkSampleCountFlagBits sampleCount, VkImageUsageFlags usageFlags, VkImageTiling tiling, VkImageAspectFlags aspectFlags) const
+		minte::backend::VulkanRenderTarget::VulkanAttachment VulkanRenderTarget::createAttachment(VkFormat format, VkSampleCountFlagBits sampleCount, VkImageUsageFlags usageFlags, VkImageTiling tiling, VkImageAspectFlags aspectFlags, bool bExportable /*= false*/) const
 		{
 			VulkanAttachment attachment;
 			const auto pInstance = getInstance()->as<VulkanInstance>();
 
+			// Dma-bufs are imported without knowing the driver's tiling, so they have to be linear.
+			if (bExportable && m_ExternalMemory == VulkanExternalMemory::DmaBuf)
+				tiling = VK_IMAGE_TILING_LINEAR;
+
+			VkExternalMemoryImageCreateInfo externalCreateInfo = {};
+			externalCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO;
+			externalCreateInfo.pNext = VK_NULL_HANDLE;
+			externalCreateInfo.handleTypes = m_ExportMemoryAllocateInfo.handleTypes;
+
 			// Setup image create info structure.
 			VkImageCreateInfo imageCreateInfo = {};
 			imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-			imageCreateInfo.pNext = VK_NULL_HANDLE;
+			imageCreateInfo.pNext = bExportable ? &externalCreateInfo : VK_NULL_HANDLE;
 			imageCreateInfo.flags = 0;
 			imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
 			imageCreateInfo.format = format;
@@ -287,8 +553,55 @@ namespace minte
 			VmaAllocationCreateInfo imageAllocationCreateInfo = {};
 			imageAllocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
+			// Exportable memory is allocated from a pool of its own, which adds the export info to the allocations. Each image gets a dedicated
+			// allocation, so the exported memory contains nothing else.
+			if (bExportable)
+			{
+				VkPhysicalDeviceExternalImageFormatInfo externalFormatInfo = {};
+				externalFormatInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_IMAGE_FORMAT_INFO;
+				externalFormatInfo.pNext = VK_NULL_HANDLE;
+				externalFormatInfo.handleType = static_cast<VkExternalMemoryHandleTypeFlagBits>(m_ExportMemoryAllocateInfo.handleTypes);
+
+				VkPhysicalDeviceImageFormatInfo2 formatInfo = {};
+				formatInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_FORMAT_INFO_2;
+				formatInfo.pNext = &externalFormatInfo;
+				formatInfo.format = format;
+				formatInfo.type = VK_IMAGE_TYPE_2D;
+				formatInfo.tiling = tiling;
+				formatInfo.usage = imageCreateInfo.usage;
+				formatInfo.flags = 0;
+
+				VkExternalImageFormatProperties externalFormatProperties = {};
+				externalFormatProperties.sType = VK_STRUCTURE_TYPE_EXTERNAL_IMAGE_FORMAT_PROPERTIES;
+				externalFormatProperties.pNext = VK_NULL_HANDLE;
+
+				VkImageFormatProperties2 formatProperties = {};
+				formatProperties.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_PROPERTIES_2;
+				formatProperties.pNext = &externalFormatProperties;
+
+				if (vkGetPhysicalDeviceImageFormatProperties2(pInstance->getPhysicalDevice(), &formatInfo, &formatProperties) != VK_SUCCESS ||
+					!(externalFormatProperties.externalMemoryProperties.externalMemoryFeatures & VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT))
+					throw BackendError("The attachment cannot be exported using the external memory type!");
+
+				VmaPoolCreateInfo poolCreateInfo = {};
+				MINTE_VK_ASSERT(vmaFindMemoryTypeIndexForImageInfo(pInstance->getAllocator(), &imageCreateInfo, &imageAllocationCreateInfo, &poolCreateInfo.memoryTypeIndex), "Failed to find the exportable memory type!");
+				poolCreateInfo.pMemoryAllocateNext = const_cast<VkExportMemoryAllocateInfo*>(&m_ExportMemoryAllocateInfo);
+
+				MINTE_VK_ASSERT(vmaCreatePool(pInstance->getAllocator(), &poolCreateInfo, &attachment.m_ExportPool), "Failed to create the exportable memory pool!");
+
+				imageAllocationCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+				imageAllocationCreateInfo.pool = attachment.m_ExportPool;
+			}
+
 			// Create the image.
-			MINTE_VK_ASSERT(vmaCreateImage(pInstance->getAllocator(), &imageCreateInfo, &imageAllocationCreateInfo, &attachment.m_Image, &attachment.m_ImageAllocation, VK_NULL_HANDLE), "Failed to create the image!");
+			VmaAllocationInfo allocationInfo = {};
+			MINTE_VK_ASSERT(vmaCreateImage(pInstance->getAllocator(), &imageCreateInfo, &imageAllocationCreateInfo, &attachment.m_Image, &attachment.m_ImageAllocation, &allocationInfo), "Failed to create the image!");
+
+			attachment.m_Format = format;
+			attachment.m_Tiling = tiling;
+			attachment.m_Usage = imageCreateInfo.usage;
+			attachment.m_AllocationSize = allocationInfo.size;
+			pInstance->registerAllocation(ResourceCategory::Attachment, attachment.m_AllocationSize);
 
 			// Create the image view.
 			VkImageViewCreateInfo imageViewCreateInfo = {};
@@ -322,8 +635,344 @@ namespace minte
 		{
 			const auto pInstance = getInstance()->as<VulkanInstance>();
 
-			vmaDestroyImage(pInstance->getAllocator(), attachment.m_Image, attachment.m_ImageAllocation);
 			pInstance->getDeviceTable().vkDestroyImageView(pInstance->getLogicalDevice(), attachment.m_ImageView, VK_NULL_HANDLE);
+			vmaDestroyImage(pInstance->getAllocator(), attachment.m_Image, attachment.m_ImageAllocation);
+			pInstance->unregisterAllocation(ResourceCategory::Attachment, attachment.m_AllocationSize);
+
+			if (attachment.m_ExportPool != nullptr)
+				vmaDestroyPool(pInstance->getAllocator(), attachment.m_ExportPool);
+		}
+
+		void VulkanRenderTarget::setExternalMemory(VulkanExternalMemory type, bool bExportEntities /*= false*/)
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			if (type != VulkanExternalMemory::None)
+			{
+				if (!pInstance->hasExternalMemory())
+					throw BackendError("The device cannot export memory!");
+
+				if (type == VulkanExternalMemory::DmaBuf && !pInstance->hasDmaBufMemory())
+					throw BackendError("The device cannot export dma-bufs!");
+
+				// Multisampled images are resolved by the importer, which can't be done without knowing the driver's sample locations.
+				if (getAntiAliasing() != AntiAliasing::X1)
+					throw BackendError("Exporting the attachments requires the anti-aliasing to be x1!");
+			}
+
+			m_ExternalMemory = type;
+			m_IsExportingEntities = type != VulkanExternalMemory::None && bExportEntities;
+			invalidateState();
+
+			m_ExportMemoryAllocateInfo.sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO;
+			m_ExportMemoryAllocateInfo.pNext = VK_NULL_HANDLE;
+			m_ExportMemoryAllocateInfo.handleTypes = type != VulkanExternalMemory::None ? GetExternalMemoryHandleType(type) : 0;
+
+			// The draw call waits till the device is done, so we can recreate the attachments right away.
+			pInstance->getDeviceTable().vkDestroyFramebuffer(pInstance->getLogicalDevice(), m_Framebuffer, VK_NULL_HANDLE);
+			destroyAttachment(m_ColorAttachment);
+			destroyAttachment(m_EntityAttachment);
+
+			setupColorOutput();
+			m_EntityAttachment = createAttachment(VK_FORMAT_R32_UINT, GetSampleCount(getAntiAliasing()), VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, m_IsExportingEntities);
+			setupFramebuffer();
+
+			if (getOutputFormat() != OutputFormat::RGBA)
+				updateConversionDescriptor();
+
+			// Recreate the completion semaphore. Not every driver can export sync file descriptors, in which case the importer has to rely on
+			// the draw call waiting till the device is done.
+			pInstance->getDeviceTable().vkDestroySemaphore(pInstance->getLogicalDevice(), m_CompletionSemaphore, VK_NULL_HANDLE);
+			CloseFileDescriptor(m_CompletionFileDescriptor);
+
+			m_CompletionSemaphore = VK_NULL_HANDLE;
+			m_CompletionFileDescriptor = -1;
+
+			if (type == VulkanExternalMemory::None)
+				return;
+
+			VkPhysicalDeviceExternalSemaphoreInfo externalSemaphoreInfo = {};
+			externalSemaphoreInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_SEMAPHORE_INFO;
+			externalSemaphoreInfo.pNext = VK_NULL_HANDLE;
+			externalSemaphoreInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT;
+
+			VkExternalSemaphoreProperties externalSemaphoreProperties = {};
+			externalSemaphoreProperties.sType = VK_STRUCTURE_TYPE_EXTERNAL_SEMAPHORE_PROPERTIES;
+			externalSemaphoreProperties.pNext = VK_NULL_HANDLE;
+
+			vkGetPhysicalDeviceExternalSemaphoreProperties(pInstance->getPhysicalDevice(), &externalSemaphoreInfo, &externalSemaphoreProperties);
+			if (!(externalSemaphoreProperties.externalSemaphoreFeatures & VK_EXTERNAL_SEMAPHORE_FEATURE_EXPORTABLE_BIT))
+				return;
+
+			VkExportSemaphoreCreateInfo exportSemaphoreCreateInfo = {};
+			exportSemaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO;
+			exportSemaphoreCreateInfo.pNext = VK_NULL_HANDLE;
+			exportSemaphoreCreateInfo.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT;
+
+			VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+			semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreCreateInfo.pNext = &exportSemaphoreCreateInfo;
+			semaphoreCreateInfo.flags = 0;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSemaphore(pInstance->getLogicalDevice(), &semaphoreCreateInfo, VK_NULL_HANDLE, &m_CompletionSemaphore), "Failed to create the completion semaphore!");
+		}
+
+		void VulkanRenderTarget::setBackgroundImage(VkImageView imageView, VkImageLayout layout /*= VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL*/)
+		{
+			if (imageView == VK_NULL_HANDLE)
+			{
+				clearBackground();
+				return;
+			}
+
+			releaseBackgroundPixels();
+			invalidateState();
+
+			// The draw call waits till the device is done, so the pipeline and the descriptor can be replaced right away.
+			if (m_BackgroundPipeline != VK_NULL_HANDLE && m_IsBackgroundPixels)
+				destroyBackground();
+
+			if (m_BackgroundPipeline == VK_NULL_HANDLE)
+				setupBackground(false);
+
+			m_BackgroundImageView = imageView;
+
+			VkDescriptorImageInfo imageInfo = {};
+			imageInfo.sampler = m_BackgroundSampler;
+			imageInfo.imageView = imageView;
+			imageInfo.imageLayout = layout;
+
+			VkWriteDescriptorSet write = {};
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.pNext = VK_NULL_HANDLE;
+			write.dstSet = m_BackgroundDescriptorSet;
+			write.dstBinding = 0;
+			write.dstArrayElement = 0;
+			write.descriptorCount = 1;
+			write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			write.pImageInfo = &imageInfo;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkUpdateDescriptorSets(pInstance->getLogicalDevice(), 1, &write, 0, VK_NULL_HANDLE);
+		}
+
+		void VulkanRenderTarget::setBackgroundPixels(const std::byte* pPixels, uint64_t rowPitch)
+		{
+			if (pPixels == nullptr)
+			{
+				clearBackground();
+				return;
+			}
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			if (!pInstance->hasHostMemoryImport())
+				throw BackendError("The device cannot import host memory!");
+
+			// The pixels are fetched as texels, so they have to be aligned to a whole pixel.
+			const auto address = reinterpret_cast<uintptr_t>(pPixels);
+			if (address % 4 != 0 || rowPitch % 4 != 0 || rowPitch < static_cast<uint64_t>(getWidth()) * 4)
+				throw BackendError("The background pixels must be 4 byte aligned, with at least the render target's width in each row!");
+
+			// Only whole aligned ranges can be imported, so the range around the pixels is imported and the pixels are offset into it.
+			const auto alignment = pInstance->getHostPointerAlignment();
+			const auto firstAddress = address - address % alignment;
+			const auto lastAddress = address + rowPitch * (getHeight() - 1) + static_cast<uint64_t>(getWidth()) * 4;
+			const auto size = (lastAddress - firstAddress + alignment - 1) / alignment * alignment;
+
+			if (size / 4 > pInstance->getPhysicalDeviceProperties().limits.maxTexelBufferElements)
+				throw BackendError("The background pixels are too large to be read as a texel buffer!");
+
+			releaseBackgroundPixels();
+			m_BackgroundImageView = VK_NULL_HANDLE;
+			invalidateState();
+
+			// Create the buffer.
+			VkExternalMemoryBufferCreateInfo externalCreateInfo = {};
+			externalCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+			externalCreateInfo.pNext = VK_NULL_HANDLE;
+			externalCreateInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+			VkBufferCreateInfo bufferCreateInfo = {};
+			bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferCreateInfo.pNext = &externalCreateInfo;
+			bufferCreateInfo.flags = 0;
+			bufferCreateInfo.size = size;
+			bufferCreateInfo.usage = VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
+			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			bufferCreateInfo.queueFamilyIndexCount = 0;
+			bufferCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateBuffer(pInstance->getLogicalDevice(), &bufferCreateInfo, VK_NULL_HANDLE, &m_BackgroundBuffer), "Failed to create the background buffer!");
+
+			// Import the memory. VMA can't import host pointers, so the memory is allocated directly.
+			VkMemoryHostPointerPropertiesEXT hostPointerProperties = {};
+			hostPointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+			hostPointerProperties.pNext = VK_NULL_HANDLE;
+
+			auto pHostPointer = reinterpret_cast<void*>(firstAddress);
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkGetMemoryHostPointerPropertiesEXT(pInstance->getLogicalDevice(), VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, pHostPointer, &hostPointerProperties), "Failed to get the host pointer properties!");
+
+			VkMemoryRequirements memoryRequirements = {};
+			pInstance->getDeviceTable().vkGetBufferMemoryRequirements(pInstance->getLogicalDevice(), m_BackgroundBuffer, &memoryRequirements);
+
+			// The buffer can need more memory than the range being imported, in which case it can't be bound to it.
+			if (memoryRequirements.size > size)
+				throw BackendError("The background pixels are too small to be imported as a texel buffer!");
+
+			// The pixels are written by the host between the draw calls without being flushed, so the memory has to be coherent.
+			const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+			vmaGetMemoryProperties(pInstance->getAllocator(), &pMemoryProperties);
+
+			auto memoryTypeBits = memoryRequirements.memoryTypeBits & hostPointerProperties.memoryTypeBits;
+			for (uint32_t i = 0; i < pMemoryProperties->memoryTypeCount; i++)
+			{
+				if (!(pMemoryProperties->memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+					memoryTypeBits &= ~(1u << i);
+			}
+
+			if (memoryTypeBits == 0)
+				throw BackendError("The background pixels cannot be imported as a texel buffer!");
+
+			VkImportMemoryHostPointerInfoEXT importInfo = {};
+			importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+			importInfo.pNext = VK_NULL_HANDLE;
+			importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+			importInfo.pHostPointer = pHostPointer;
+
+			VkMemoryAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocateInfo.pNext = &importInfo;
+			allocateInfo.allocationSize = size;
+			allocateInfo.memoryTypeIndex = static_cast<uint32_t>(std::countr_zero(memoryTypeBits));
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkAllocateMemory(pInstance->getLogicalDevice(), &allocateInfo, VK_NULL_HANDLE, &m_BackgroundMemory), "Failed to import the background pixels!");
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkBindBufferMemory(pInstance->getLogicalDevice(), m_BackgroundBuffer, m_BackgroundMemory, 0), "Failed to bind the background memory!");
+
+			// Create the buffer view.
+			VkBufferViewCreateInfo viewCreateInfo = {};
+			viewCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
+			viewCreateInfo.pNext = VK_NULL_HANDLE;
+			viewCreateInfo.flags = 0;
+			viewCreateInfo.buffer = m_BackgroundBuffer;
+			viewCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+			viewCreateInfo.offset = 0;
+			viewCreateInfo.range = VK_WHOLE_SIZE;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateBufferView(pInstance->getLogicalDevice(), &viewCreateInfo, VK_NULL_HANDLE, &m_BackgroundBufferView), "Failed to create the background buffer view!");
+
+			m_BackgroundRowLength = static_cast<uint32_t>(rowPitch / 4);
+			m_BackgroundFirstTexel = static_cast<uint32_t>((address - firstAddress) / 4);
+
+			// Setup the pipeline and write the buffer view to the descriptor.
+			if (m_BackgroundPipeline != VK_NULL_HANDLE && !m_IsBackgroundPixels)
+				destroyBackground();
+
+			if (m_BackgroundPipeline == VK_NULL_HANDLE)
+				setupBackground(true);
+
+			VkWriteDescriptorSet write = {};
+			write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			write.pNext = VK_NULL_HANDLE;
+			write.dstSet = m_BackgroundDescriptorSet;
+			write.dstBinding = 0;
+			write.dstArrayElement = 0;
+			write.descriptorCount = 1;
+			write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+			write.pTexelBufferView = &m_BackgroundBufferView;
+
+			pInstance->getDeviceTable().vkUpdateDescriptorSets(pInstance->getLogicalDevice(), 1, &write, 0, VK_NULL_HANDLE);
+		}
+
+		void VulkanRenderTarget::clearBackground()
+		{
+			// The pipeline is kept, as the background is likely to be set again.
+			releaseBackgroundPixels();
+			m_BackgroundImageView = VK_NULL_HANDLE;
+			invalidateState();
+		}
+
+		int32_t VulkanRenderTarget::takeCompletionFileDescriptor()
+		{
+			const auto fileDescriptor = m_CompletionFileDescriptor;
+			m_CompletionFileDescriptor = -1;
+
+			return fileDescriptor;
+		}
+
+		minte::backend::VulkanExportedImage VulkanRenderTarget::exportAttachment(const VulkanAttachment& attachment) const
+		{
+			if (attachment.m_ExportPool == nullptr)
+				throw BackendError("The attachment is not exported!");
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			VmaAllocationInfo allocationInfo = {};
+			vmaGetAllocationInfo(pInstance->getAllocator(), attachment.m_ImageAllocation, &allocationInfo);
+
+			VkMemoryGetFdInfoKHR getFdInfo = {};
+			getFdInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
+			getFdInfo.pNext = VK_NULL_HANDLE;
+			getFdInfo.memory = allocationInfo.deviceMemory;
+			getFdInfo.handleType = GetExternalMemoryHandleType(m_ExternalMemory);
+
+			VulkanExportedImage exportedImage;
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkGetMemoryFdKHR(pInstance->getLogicalDevice(), &getFdInfo, &exportedImage.m_FileDescriptor), "Failed to export the attachment memory!");
+
+			exportedImage.m_Size = allocationInfo.size;
+			exportedImage.m_HandleType = getFdInfo.handleType;
+			exportedImage.m_MemoryTypeIndex = allocationInfo.memoryType;
+			exportedImage.m_Format = attachment.m_Format;
+			exportedImage.m_Tiling = attachment.m_Tiling;
+			exportedImage.m_Usage = attachment.m_Usage;
+			exportedImage.m_Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			exportedImage.m_Width = getWidth();
+			exportedImage.m_Height = getHeight();
+
+			// The row pitch is only defined for linear images.
+			if (attachment.m_Tiling == VK_IMAGE_TILING_LINEAR)
+			{
+				VkImageSubresource subresource = {};
+				subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				subresource.mipLevel = 0;
+				subresource.arrayLayer = 0;
+
+				VkSubresourceLayout layout = {};
+				pInstance->getDeviceTable().vkGetImageSubresourceLayout(pInstance->getLogicalDevice(), attachment.m_Image, &subresource, &layout);
+				exportedImage.m_RowPitch = layout.rowPitch;
+			}
+
+			return exportedImage;
+		}
+
+		void VulkanRenderTarget::recordExternalRelease() const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// The render passes discard the attachments' contents, so they don't have to be acquired back before the next draw call.
+			VkImageMemoryBarrier imageBarrier = {};
+			imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageBarrier.pNext = VK_NULL_HANDLE;
+			imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			imageBarrier.dstAccessMask = 0;
+			imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			imageBarrier.srcQueueFamilyIndex = pInstance->getGraphicsQueue().m_Family;
+			imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_EXTERNAL;
+			imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			imageBarrier.subresourceRange.baseMipLevel = 0;
+			imageBarrier.subresourceRange.levelCount = 1;
+			imageBarrier.subresourceRange.baseArrayLayer = 0;
+			imageBarrier.subresourceRange.layerCount = 1;
+
+			std::array<VkImageMemoryBarrier, 2> imageBarriers = { imageBarrier, imageBarrier };
+			imageBarriers[0].image = m_ColorAttachment.m_Image;
+			imageBarriers[1].image = m_EntityAttachment.m_Image;
+
+			// The conversion leaves the color attachment in the general layout. It's moved back so the importer always gets the same layout.
+			if (isHostOutput() && getOutputFormat() != OutputFormat::RGBA)
+				imageBarriers[0].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+			const VkPipelineStageFlags sourceStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			pInstance->getDeviceTable().vkCmdPipelineBarrier(m_CommandBuffer, sourceStageMask, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, m_IsExportingEntities ? 2 : 1, imageBarriers.data());
 		}
 
 		void VulkanRenderTarget::setupFramebuffer()
@@ -377,6 +1026,1382 @@ namespace minte
 			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateFence(pInstance->getLogicalDevice(), &fenceCreateInfo, nullptr, &m_Fence), "Failed to create fence!");
 		}
 
+		void VulkanRenderTarget::setupGeometryPipeline()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// Create the pipeline layout.
+			VkPushConstantRange pushConstantRange = {};
+			pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+			pushConstantRange.offset = 0;
+			pushConstantRange.size = sizeof(GeometryConstants);
+
+			VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+			pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineLayoutCreateInfo.flags = 0;
+			pipelineLayoutCreateInfo.setLayoutCount = 1;
+			pipelineLayoutCreateInfo.pSetLayouts = &m_TextureDescriptorSetLayout;
+			pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+			pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreatePipelineLayout(pInstance->getLogicalDevice(), &pipelineLayoutCreateInfo, VK_NULL_HANDLE, &m_GeometryPipelineLayout), "Failed to create the geometry pipeline layout!");
+
+			// Setup the shader stages.
+			const auto vertexShaderModule = pInstance->createShaderModule(GeometryVertexShaderCode);
+			const auto fragmentShaderModule = pInstance->createShaderModule(GeometryFragmentShaderCode);
+
+			std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages = {};
+			shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			shaderStages[0].pNext = VK_NULL_HANDLE;
+			shaderStages[0].flags = 0;
+			shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+			shaderStages[0].module = vertexShaderModule;
+			shaderStages[0].pName = "main";
+			shaderStages[0].pSpecializationInfo = VK_NULL_HANDLE;
+
+			shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			shaderStages[1].pNext = VK_NULL_HANDLE;
+			shaderStages[1].flags = 0;
+			shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+			shaderStages[1].module = fragmentShaderModule;
+			shaderStages[1].pName = "main";
+			shaderStages[1].pSpecializationInfo = VK_NULL_HANDLE;
+
+			// Setup the vertex input.
+			VkVertexInputBindingDescription bindingDescription = {};
+			bindingDescription.binding = 0;
+			bindingDescription.stride = sizeof(Vertex);
+			bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+			std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions = {};
+			attributeDescriptions[0].location = 0;
+			attributeDescriptions[0].binding = 0;
+			attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
+			attributeDescriptions[0].offset = offsetof(Vertex, m_Position);
+
+			attributeDescriptions[1].location = 1;
+			attributeDescriptions[1].binding = 0;
+			attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
+			attributeDescriptions[1].offset = offsetof(Vertex, m_TextureCoordinate);
+
+			attributeDescriptions[2].location = 2;
+			attributeDescriptions[2].binding = 0;
+			attributeDescriptions[2].format = VK_FORMAT_R8G8B8A8_UNORM;
+			attributeDescriptions[2].offset = offsetof(Vertex, m_Color);
+
+			attributeDescriptions[3].location = 3;
+			attributeDescriptions[3].binding = 0;
+			attributeDescriptions[3].format = VK_FORMAT_R32_UINT;
+			attributeDescriptions[3].offset = offsetof(Vertex, m_EntityID);
+
+			VkPipelineVertexInputStateCreateInfo vertexInputState = {};
+			vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+			vertexInputState.pNext = VK_NULL_HANDLE;
+			vertexInputState.flags = 0;
+			vertexInputState.vertexBindingDescriptionCount = 1;
+			vertexInputState.pVertexBindingDescriptions = &bindingDescription;
+			vertexInputState.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+			vertexInputState.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+			VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {};
+			inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+			inputAssemblyState.pNext = VK_NULL_HANDLE;
+			inputAssemblyState.flags = 0;
+			inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			inputAssemblyState.primitiveRestartEnable = VK_FALSE;
+
+			// The viewport and scissor are set when drawing.
+			VkPipelineViewportStateCreateInfo viewportState = {};
+			viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+			viewportState.pNext = VK_NULL_HANDLE;
+			viewportState.flags = 0;
+			viewportState.viewportCount = 1;
+			viewportState.pViewports = VK_NULL_HANDLE;
+			viewportState.scissorCount = 1;
+			viewportState.pScissors = VK_NULL_HANDLE;
+
+			VkPipelineRasterizationStateCreateInfo rasterizationState = {};
+			rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+			rasterizationState.pNext = VK_NULL_HANDLE;
+			rasterizationState.flags = 0;
+			rasterizationState.depthClampEnable = VK_FALSE;
+			rasterizationState.rasterizerDiscardEnable = VK_FALSE;
+			rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+			rasterizationState.cullMode = VK_CULL_MODE_NONE;
+			rasterizationState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+			rasterizationState.depthBiasEnable = VK_FALSE;
+			rasterizationState.lineWidth = 1.0f;
+
+			VkPipelineMultisampleStateCreateInfo multisampleState = {};
+			multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+			multisampleState.pNext = VK_NULL_HANDLE;
+			multisampleState.flags = 0;
+			multisampleState.rasterizationSamples = GetSampleCount(getAntiAliasing());
+			multisampleState.sampleShadingEnable = VK_FALSE;
+			multisampleState.minSampleShading = 1.0f;
+			multisampleState.pSampleMask = VK_NULL_HANDLE;
+			multisampleState.alphaToCoverageEnable = VK_FALSE;
+			multisampleState.alphaToOneEnable = VK_FALSE;
+
+			// Translucent commands are drawn back to front, and only test the depth written by the opaque commands in front of them.
+			VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
+			depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+			depthStencilState.pNext = VK_NULL_HANDLE;
+			depthStencilState.flags = 0;
+			depthStencilState.depthTestEnable = VK_TRUE;
+			depthStencilState.depthWriteEnable = VK_FALSE;
+			depthStencilState.depthCompareOp = VK_COMPARE_OP_LESS;
+			depthStencilState.depthBoundsTestEnable = VK_FALSE;
+			depthStencilState.stencilTestEnable = VK_FALSE;
+
+			// Opaque commands are drawn front to back and write their depth, so the hidden fragments are rejected before they're shaded. A
+			// command can contain multiple elements which share its depth, and are drawn in order, so equal depths pass.
+			auto opaqueDepthStencilState = depthStencilState;
+			opaqueDepthStencilState.depthWriteEnable = VK_TRUE;
+			opaqueDepthStencilState.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+			// The color is alpha blended, and the entity ID (the element handle) is overwritten.
+			std::array<VkPipelineColorBlendAttachmentState, 2> blendAttachments = {};
+			blendAttachments[0].blendEnable = VK_TRUE;
+			blendAttachments[0].srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+			blendAttachments[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+			blendAttachments[0].colorBlendOp = VK_BLEND_OP_ADD;
+			blendAttachments[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+			blendAttachments[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+			blendAttachments[0].alphaBlendOp = VK_BLEND_OP_ADD;
+			blendAttachments[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+			blendAttachments[1].blendEnable = VK_FALSE;
+			blendAttachments[1].colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+
+			VkPipelineColorBlendStateCreateInfo colorBlendState = {};
+			colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+			colorBlendState.pNext = VK_NULL_HANDLE;
+			colorBlendState.flags = 0;
+			colorBlendState.logicOpEnable = VK_FALSE;
+			colorBlendState.logicOp = VK_LOGIC_OP_COPY;
+			colorBlendState.attachmentCount = static_cast<uint32_t>(blendAttachments.size());
+			colorBlendState.pAttachments = blendAttachments.data();
+
+			// Opaque commands overwrite the color, which is what blending with full alpha does.
+			auto opaqueBlendAttachments = blendAttachments;
+			opaqueBlendAttachments[0].blendEnable = VK_FALSE;
+
+			auto opaqueColorBlendState = colorBlendState;
+			opaqueColorBlendState.pAttachments = opaqueBlendAttachments.data();
+
+			const std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+			VkPipelineDynamicStateCreateInfo dynamicState = {};
+			dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+			dynamicState.pNext = VK_NULL_HANDLE;
+			dynamicState.flags = 0;
+			dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+			dynamicState.pDynamicStates = dynamicStates.data();
+
+			// Create the pipeline.
+			VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+			pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+			pipelineCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineCreateInfo.flags = 0;
+			pipelineCreateInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+			pipelineCreateInfo.pStages = shaderStages.data();
+			pipelineCreateInfo.pVertexInputState = &vertexInputState;
+			pipelineCreateInfo.pInputAssemblyState = &inputAssemblyState;
+			pipelineCreateInfo.pTessellationState = VK_NULL_HANDLE;
+			pipelineCreateInfo.pViewportState = &viewportState;
+			pipelineCreateInfo.pRasterizationState = &rasterizationState;
+			pipelineCreateInfo.pMultisampleState = &multisampleState;
+			pipelineCreateInfo.pDepthStencilState = &depthStencilState;
+			pipelineCreateInfo.pColorBlendState = &colorBlendState;
+			pipelineCreateInfo.pDynamicState = &dynamicState;
+			pipelineCreateInfo.layout = m_GeometryPipelineLayout;
+			pipelineCreateInfo.renderPass = m_RenderPass;
+			pipelineCreateInfo.subpass = 0;
+			pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+			pipelineCreateInfo.basePipelineIndex = 0;
+
+			auto opaquePipelineCreateInfo = pipelineCreateInfo;
+			opaquePipelineCreateInfo.pDepthStencilState = &opaqueDepthStencilState;
+			opaquePipelineCreateInfo.pColorBlendState = &opaqueColorBlendState;
+
+			const std::array<VkGraphicsPipelineCreateInfo, 2> pipelineCreateInfos = { pipelineCreateInfo, opaquePipelineCreateInfo };
+			std::array<VkPipeline, 2> pipelines = {};
+
+			const auto result = pInstance->getDeviceTable().vkCreateGraphicsPipelines(pInstance->getLogicalDevice(), VK_NULL_HANDLE, static_cast<uint32_t>(pipelineCreateInfos.size()), pipelineCreateInfos.data(), VK_NULL_HANDLE, pipelines.data());
+			m_GeometryPipeline = pipelines[0];
+			m_OpaqueGeometryPipeline = pipelines[1];
+			pInstance->getDeviceTable().vkDestroyShaderModule(pInstance->getLogicalDevice(), vertexShaderModule, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyShaderModule(pInstance->getLogicalDevice(), fragmentShaderModule, VK_NULL_HANDLE);
+			MINTE_VK_ASSERT(result, "Failed to create the geometry pipeline!");
+		}
+
+		void VulkanRenderTarget::setupTextureDescriptors()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// Create the descriptor set layout.
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = 0;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			binding.descriptorCount = 1;
+			binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			binding.pImmutableSamplers = VK_NULL_HANDLE;
+
+			VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+			layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutCreateInfo.pNext = VK_NULL_HANDLE;
+			layoutCreateInfo.flags = 0;
+			layoutCreateInfo.bindingCount = 1;
+			layoutCreateInfo.pBindings = &binding;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorSetLayout(pInstance->getLogicalDevice(), &layoutCreateInfo, VK_NULL_HANDLE, &m_TextureDescriptorSetLayout), "Failed to create the texture descriptor set layout!");
+
+			// Create the descriptor pool and allocate a descriptor set per slot.
+			VkDescriptorPoolSize poolSize = {};
+			poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			poolSize.descriptorCount = MaxTextures;
+
+			VkDescriptorPoolCreateInfo poolCreateInfo = {};
+			poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			poolCreateInfo.pNext = VK_NULL_HANDLE;
+			poolCreateInfo.flags = 0;
+			poolCreateInfo.maxSets = MaxTextures;
+			poolCreateInfo.poolSizeCount = 1;
+			poolCreateInfo.pPoolSizes = &poolSize;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorPool(pInstance->getLogicalDevice(), &poolCreateInfo, VK_NULL_HANDLE, &m_TextureDescriptorPool), "Failed to create the texture descriptor pool!");
+
+			std::array<VkDescriptorSetLayout, MaxTextures> layouts = {};
+			layouts.fill(m_TextureDescriptorSetLayout);
+
+			VkDescriptorSetAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocateInfo.pNext = VK_NULL_HANDLE;
+			allocateInfo.descriptorPool = m_TextureDescriptorPool;
+			allocateInfo.descriptorSetCount = MaxTextures;
+			allocateInfo.pSetLayouts = layouts.data();
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkAllocateDescriptorSets(pInstance->getLogicalDevice(), &allocateInfo, m_TextureDescriptorSets.data()), "Failed to allocate the texture descriptor sets!");
+
+			// Create the default texture, and write it to all the slots.
+			m_pDefaultTexture = std::make_shared<VulkanTexture>(std::static_pointer_cast<VulkanInstance>(getInstancePointer()), 1, 1, TextureFormat::RGBA8);
+
+			const std::array<std::byte, 4> white = { std::byte(255), std::byte(255), std::byte(255), std::byte(255) };
+			const TextureRegion region = { 0, 0, 0, 1, 1 };
+			m_pDefaultTexture->update({ &region, 1 }, white);
+
+			updateTextureDescriptors();
+		}
+
+		void VulkanRenderTarget::updateTextureDescriptors()
+		{
+			std::array<VkDescriptorImageInfo, MaxTextures> imageInfos = {};
+			std::array<VkWriteDescriptorSet, MaxTextures> writes = {};
+			uint32_t writeCount = 0;
+
+			for (uint32_t i = 0; i < MaxTextures; i++)
+			{
+				auto pTexture = getTexture(i) ? getTexture(i) : m_pDefaultTexture;
+				if (pTexture == m_BoundTextures[i])
+					continue;
+
+				// The bound texture is kept alive till the slot is written again, since the descriptor set refers to it.
+				const auto pVulkanTexture = static_cast<const VulkanTexture*>(pTexture.get());
+				m_BoundTextures[i] = std::move(pTexture);
+
+				auto& imageInfo = imageInfos[writeCount];
+				imageInfo.sampler = pVulkanTexture->getSampler();
+				imageInfo.imageView = pVulkanTexture->getImageView();
+				imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+				auto& write = writes[writeCount++];
+				write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				write.pNext = VK_NULL_HANDLE;
+				write.dstSet = m_TextureDescriptorSets[i];
+				write.dstBinding = 0;
+				write.dstArrayElement = 0;
+				write.descriptorCount = 1;
+				write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				write.pImageInfo = &imageInfo;
+			}
+
+			if (writeCount == 0)
+				return;
+
+			// The draw call waits till the device is done, so none of the descriptor sets are in use.
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkUpdateDescriptorSets(pInstance->getLogicalDevice(), writeCount, writes.data(), 0, VK_NULL_HANDLE);
+		}
+
+		void VulkanRenderTarget::recordGeometry(bool bNativeResolution) const
+		{
+			// Return if there's nothing to draw.
+			if (getDrawCommands().empty() || m_VertexBuffer.m_Buffer == VK_NULL_HANDLE || m_IndexBuffer.m_Buffer == VK_NULL_HANDLE)
+				return;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// Set the viewport and scissor to cover the area we draw to. The viewport scales the geometry.
+			const auto scale = bNativeResolution ? 1.0f : getRenderScale();
+			const auto areaWidth = bNativeResolution ? getWidth() : getRenderWidth();
+			const auto areaHeight = bNativeResolution ? getHeight() : getRenderHeight();
+
+			VkViewport viewport = {};
+			viewport.x = 0.0f;
+			viewport.y = 0.0f;
+			viewport.width = static_cast<float>(getWidth()) * scale;
+			viewport.height = static_cast<float>(getHeight()) * scale;
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+
+			VkRect2D scissor = {};
+			scissor.offset = { 0, 0 };
+			scissor.extent = { areaWidth, areaHeight };
+
+			pInstance->getDeviceTable().vkCmdSetViewport(m_CommandBuffer, 0, 1, &viewport);
+			pInstance->getDeviceTable().vkCmdSetScissor(m_CommandBuffer, 0, 1, &scissor);
+
+			// Bind the geometry.
+			const VkDeviceSize vertexOffset = 0;
+			pInstance->getDeviceTable().vkCmdBindVertexBuffers(m_CommandBuffer, 0, 1, &m_VertexBuffer.m_Buffer, &vertexOffset);
+			pInstance->getDeviceTable().vkCmdBindIndexBuffer(m_CommandBuffer, m_IndexBuffer.m_Buffer, 0, VK_INDEX_TYPE_UINT32);
+
+			// Draw the commands.
+			GeometryConstants constants = {};
+			constants.m_Width = static_cast<float>(getWidth());
+			constants.m_Height = static_cast<float>(getHeight());
+
+			// Only bind the texture descriptor sets when the slot changes. Commands that do not sample a texture keep the bound slot. The scissor
+			// is dynamic state as well, so it's only set when the clip changes.
+			uint32_t boundSlot = MaxTextures;
+			ScissorRectangle boundScissor;
+			const auto recordCommand = [this, pInstance, scale, areaWidth, areaHeight, &constants, &scissor, &boundSlot, &boundScissor](const DrawCommand& command, float depth)
+			{
+				if (command.m_Scissor != boundScissor)
+				{
+					boundScissor = command.m_Scissor;
+
+					// The scissor is scaled outwards, so that scaled commands don't lose the pixels at their edges.
+					const auto right = std::min(static_cast<uint32_t>(std::ceil((command.m_Scissor.m_X + command.m_Scissor.m_Width) * scale)), areaWidth);
+					const auto bottom = std::min(static_cast<uint32_t>(std::ceil((command.m_Scissor.m_Y + command.m_Scissor.m_Height) * scale)), areaHeight);
+					scissor.offset.x = static_cast<int32_t>(std::min(static_cast<uint32_t>(std::floor(command.m_Scissor.m_X * scale)), right));
+					scissor.offset.y = static_cast<int32_t>(std::min(static_cast<uint32_t>(std::floor(command.m_Scissor.m_Y * scale)), bottom));
+					scissor.extent.width = right - scissor.offset.x;
+					scissor.extent.height = bottom - scissor.offset.y;
+					pInstance->getDeviceTable().vkCmdSetScissor(m_CommandBuffer, 0, 1, &scissor);
+				}
+
+				const uint32_t slot = command.m_SampleMode == SampleMode::Color && boundSlot != MaxTextures ? boundSlot : std::min<uint32_t>(command.m_TextureSlot, MaxTextures - 1);
+				if (slot != boundSlot)
+				{
+					boundSlot = slot;
+					pInstance->getDeviceTable().vkCmdBindDescriptorSets(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GeometryPipelineLayout, 0, 1, &m_TextureDescriptorSets[slot], 0, VK_NULL_HANDLE);
+				}
+
+				constants.m_SampleMode = static_cast<uint32_t>(command.m_SampleMode);
+				constants.m_Depth = depth;
+				pInstance->getDeviceTable().vkCmdPushConstants(m_CommandBuffer, m_GeometryPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(GeometryConstants), &constants);
+				pInstance->getDeviceTable().vkCmdDrawIndexed(m_CommandBuffer, command.m_IndexCount, 1, command.m_IndexOffset, static_cast<int32_t>(command.m_VertexOffset), 0);
+			};
+
+			const auto& commands = getDrawCommands();
+			if (commands.size() > MaxDepthOrderedCommands)
+			{
+				// There are too many commands to give each a depth of its own, so all of them are drawn in order at the front.
+				pInstance->getDeviceTable().vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GeometryPipeline);
+				for (const auto& command : commands)
+				{
+					if (isDrawnAtNativeResolution(command) == bNativeResolution)
+						recordCommand(command, 0.0f);
+				}
+
+				return;
+			}
+
+			// Draw the opaque commands front to back, and then the translucent commands back to front on top of them.
+			pInstance->getDeviceTable().vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_OpaqueGeometryPipeline);
+			for (auto i = commands.size(); i > 0; i--)
+			{
+				if (commands[i - 1].m_IsOpaque && isDrawnAtNativeResolution(commands[i - 1]) == bNativeResolution)
+					recordCommand(commands[i - 1], GetDrawCommandDepth(i - 1, commands.size()));
+			}
+
+			pInstance->getDeviceTable().vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GeometryPipeline);
+			for (uint64_t i = 0; i < commands.size(); i++)
+			{
+				if (!commands[i].m_IsOpaque && isDrawnAtNativeResolution(commands[i]) == bNativeResolution)
+					recordCommand(commands[i], GetDrawCommandDepth(i, commands.size()));
+			}
+		}
+
+		void VulkanRenderTarget::writeGeometryBuffer(VulkanGeometryBuffer& buffer, VkBufferUsageFlags usage, uint64_t offset, std::span<const std::byte> data) const
+		{
+			if (data.empty())
+				return;
+
+			// Grow the buffer if the data does not fit. The draw call waits till the device is done, so we can replace it right away.
+			const uint64_t requiredSize = offset + data.size();
+			if (requiredSize > buffer.m_Size)
+			{
+				auto newBuffer = createGeometryBuffer(std::max({ requiredSize, buffer.m_Size * 2, uint64_t(64 * 1024) }), usage);
+				if (buffer.m_pMappedData)
+					std::memcpy(newBuffer.m_pMappedData, buffer.m_pMappedData, buffer.m_Size);
+
+				destroyGeometryBuffer(buffer);
+				buffer = newBuffer;
+			}
+
+			std::memcpy(buffer.m_pMappedData + offset, data.data(), data.size());
+
+			// This is a no-op if the memory is host coherent.
+			MINTE_VK_ASSERT(vmaFlushAllocation(getInstance()->as<VulkanInstance>()->getAllocator(), buffer.m_Allocation, offset, data.size()), "Failed to flush the geometry buffer!");
+		}
+
+		minte::backend::VulkanRenderTarget::VulkanGeometryBuffer VulkanRenderTarget::createGeometryBuffer(uint64_t size, VkBufferUsageFlags usage) const
+		{
+			VulkanGeometryBuffer buffer;
+			buffer.m_Size = size;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			VkBufferCreateInfo createInfo = {};
+			createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			createInfo.pNext = VK_NULL_HANDLE;
+			createInfo.flags = 0;
+			createInfo.size = size;
+			createInfo.usage = usage;
+			createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			createInfo.queueFamilyIndexCount = 0;
+			createInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+
+			// Prefer device memory that the host can write to, VMA falls back to host memory if there isn't any.
+			VmaAllocationCreateInfo allocationCreateInfo = {};
+			allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+			allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+			VmaAllocationInfo allocationInfo = {};
+			MINTE_VK_ASSERT(vmaCreateBuffer(pInstance->getAllocator(), &createInfo, &allocationCreateInfo, &buffer.m_Buffer, &buffer.m_Allocation, &allocationInfo), "Failed to create the geometry buffer!");
+
+			buffer.m_pMappedData = static_cast<std::byte*>(allocationInfo.pMappedData);
+			buffer.m_AllocationSize = allocationInfo.size;
+			pInstance->registerAllocation(ResourceCategory::Geometry, buffer.m_AllocationSize);
+
+			return buffer;
+		}
+
+		void VulkanRenderTarget::destroyGeometryBuffer(const VulkanGeometryBuffer& buffer) const
+		{
+			// Return if we haven't created the buffer.
+			if (buffer.m_Buffer == VK_NULL_HANDLE)
+				return;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			vmaDestroyBuffer(pInstance->getAllocator(), buffer.m_Buffer, buffer.m_Allocation);
+			pInstance->unregisterAllocation(ResourceCategory::Geometry, buffer.m_AllocationSize);
+		}
+
+		void VulkanRenderTarget::setupConversionPipeline()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// Create the descriptor set layout.
+			std::array<VkDescriptorSetLayoutBinding, 2> bindings = {};
+			bindings[0].binding = 0;
+			bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			bindings[0].descriptorCount = 1;
+			bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[0].pImmutableSamplers = VK_NULL_HANDLE;
+
+			bindings[1].binding = 1;
+			bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[1].descriptorCount = 1;
+			bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings[1].pImmutableSamplers = VK_NULL_HANDLE;
+
+			VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+			layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutCreateInfo.pNext = VK_NULL_HANDLE;
+			layoutCreateInfo.flags = 0;
+			layoutCreateInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+			layoutCreateInfo.pBindings = bindings.data();
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorSetLayout(pInstance->getLogicalDevice(), &layoutCreateInfo, VK_NULL_HANDLE, &m_ConversionDescriptorSetLayout), "Failed to create the conversion descriptor set layout!");
+
+			// Create the pipeline layout.
+			VkPushConstantRange pushConstantRange = {};
+			pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			pushConstantRange.offset = 0;
+			pushConstantRange.size = sizeof(ConversionConstants);
+
+			VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+			pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineLayoutCreateInfo.flags = 0;
+			pipelineLayoutCreateInfo.setLayoutCount = 1;
+			pipelineLayoutCreateInfo.pSetLayouts = &m_ConversionDescriptorSetLayout;
+			pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+			pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreatePipelineLayout(pInstance->getLogicalDevice(), &pipelineLayoutCreateInfo, VK_NULL_HANDLE, &m_ConversionPipelineLayout), "Failed to create the conversion pipeline layout!");
+
+			// Create the pipeline.
+			const auto shaderModule = pInstance->createShaderModule(ColorConversionShaderCode);
+
+			VkComputePipelineCreateInfo pipelineCreateInfo = {};
+			pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+			pipelineCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineCreateInfo.flags = 0;
+			pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			pipelineCreateInfo.stage.pNext = VK_NULL_HANDLE;
+			pipelineCreateInfo.stage.flags = 0;
+			pipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+			pipelineCreateInfo.stage.module = shaderModule;
+			pipelineCreateInfo.stage.pName = "main";
+			pipelineCreateInfo.stage.pSpecializationInfo = VK_NULL_HANDLE;
+			pipelineCreateInfo.layout = m_ConversionPipelineLayout;
+			pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+			pipelineCreateInfo.basePipelineIndex = 0;
+
+			const auto result = pInstance->getDeviceTable().vkCreateComputePipelines(pInstance->getLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, VK_NULL_HANDLE, &m_ConversionPipeline);
+			pInstance->getDeviceTable().vkDestroyShaderModule(pInstance->getLogicalDevice(), shaderModule, VK_NULL_HANDLE);
+			MINTE_VK_ASSERT(result, "Failed to create the conversion pipeline!");
+
+			// Create the descriptor pool and allocate the descriptor set.
+			std::array<VkDescriptorPoolSize, 2> poolSizes = {};
+			poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			poolSizes[0].descriptorCount = 1;
+			poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			poolSizes[1].descriptorCount = 1;
+
+			VkDescriptorPoolCreateInfo poolCreateInfo = {};
+			poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			poolCreateInfo.pNext = VK_NULL_HANDLE;
+			poolCreateInfo.flags = 0;
+			poolCreateInfo.maxSets = 1;
+			poolCreateInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+			poolCreateInfo.pPoolSizes = poolSizes.data();
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorPool(pInstance->getLogicalDevice(), &poolCreateInfo, VK_NULL_HANDLE, &m_ConversionDescriptorPool), "Failed to create the conversion descriptor pool!");
+
+			VkDescriptorSetAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocateInfo.pNext = VK_NULL_HANDLE;
+			allocateInfo.descriptorPool = m_ConversionDescriptorPool;
+			allocateInfo.descriptorSetCount = 1;
+			allocateInfo.pSetLayouts = &m_ConversionDescriptorSetLayout;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkAllocateDescriptorSets(pInstance->getLogicalDevice(), &allocateInfo, &m_ConversionDescriptorSet), "Failed to allocate the conversion descriptor set!");
+		}
+
+		void VulkanRenderTarget::updateConversionDescriptor() const
+		{
+			VkDescriptorImageInfo imageInfo = {};
+			imageInfo.sampler = VK_NULL_HANDLE;
+			imageInfo.imageView = m_ColorAttachment.m_ImageView;
+			imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+			VkDescriptorBufferInfo bufferInfo = {};
+			bufferInfo.buffer = getColorBuffer()->as<VulkanImageBuffer>()->getBuffer();
+			bufferInfo.offset = 0;
+			bufferInfo.range = VK_WHOLE_SIZE;
+
+			std::array<VkWriteDescriptorSet, 2> writes = {};
+			writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[0].pNext = VK_NULL_HANDLE;
+			writes[0].dstSet = m_ConversionDescriptorSet;
+			writes[0].dstBinding = 0;
+			writes[0].dstArrayElement = 0;
+			writes[0].descriptorCount = 1;
+			writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[0].pImageInfo = &imageInfo;
+
+			writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[1].pNext = VK_NULL_HANDLE;
+			writes[1].dstSet = m_ConversionDescriptorSet;
+			writes[1].dstBinding = 1;
+			writes[1].dstArrayElement = 0;
+			writes[1].descriptorCount = 1;
+			writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[1].pBufferInfo = &bufferInfo;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkUpdateDescriptorSets(pInstance->getLogicalDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, VK_NULL_HANDLE);
+		}
+
+		void VulkanRenderTarget::recordConversion() const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// Wait for the render pass to finish writing and move the image to the general layout.
+			VkImageMemoryBarrier imageBarrier = {};
+			imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageBarrier.pNext = VK_NULL_HANDLE;
+			imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			imageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+			imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.image = m_ColorAttachment.m_Image;
+			imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			imageBarrier.subresourceRange.baseMipLevel = 0;
+			imageBarrier.subresourceRange.levelCount = 1;
+			imageBarrier.subresourceRange.baseArrayLayer = 0;
+			imageBarrier.subresourceRange.layerCount = 1;
+
+			pInstance->getDeviceTable().vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &imageBarrier);
+
+			// Bind and dispatch.
+			ConversionConstants constants = {};
+			constants.m_Width = getWidth();
+			constants.m_Height = getHeight();
+			constants.m_Format = static_cast<uint32_t>(getOutputFormat());
+
+			pInstance->getDeviceTable().vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_ConversionPipeline);
+			pInstance->getDeviceTable().vkCmdBindDescriptorSets(m_CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_ConversionPipelineLayout, 0, 1, &m_ConversionDescriptorSet, 0, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkCmdPushConstants(m_CommandBuffer, m_ConversionPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ConversionConstants), &constants);
+
+			// The YUV formats process a block of 8x2 pixels per invocation, and the work group size is 8x8.
+			if (getOutputFormat() == OutputFormat::NV12 || getOutputFormat() == OutputFormat::YUV420)
+				pInstance->getDeviceTable().vkCmdDispatch(m_CommandBuffer, (getWidth() / 8 + 7) / 8, (getHeight() / 2 + 7) / 8, 1);
+
+			else
+				pInstance->getDeviceTable().vkCmdDispatch(m_CommandBuffer, (getWidth() + 7) / 8, (getHeight() + 7) / 8, 1);
+		}
+
+		void VulkanRenderTarget::destroyConversionPipeline() const
+		{
+			// Return if we haven't created the pipeline.
+			if (m_ConversionPipeline == VK_NULL_HANDLE)
+				return;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkDestroyDescriptorPool(pInstance->getLogicalDevice(), m_ConversionDescriptorPool, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipeline(pInstance->getLogicalDevice(), m_ConversionPipeline, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipelineLayout(pInstance->getLogicalDevice(), m_ConversionPipelineLayout, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyDescriptorSetLayout(pInstance->getLogicalDevice(), m_ConversionDescriptorSetLayout, VK_NULL_HANDLE);
+		}
+
+		void VulkanRenderTarget::setupUpscale()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// Create the images the scaled geometry is copied to. The scaled area is never larger than the render target.
+			m_ScaledColorImage = createAttachment(VK_FORMAT_R8G8B8A8_UNORM, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+			m_ScaledEntityImage = createAttachment(VK_FORMAT_R32_UINT, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+			m_ScaledDepthImage = createAttachment(VK_FORMAT_D16_UNORM, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+			// The shader fetches the pixels and filters them itself, so the sampler is not used to filter.
+			VkSamplerCreateInfo samplerCreateInfo = {};
+			samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			samplerCreateInfo.pNext = VK_NULL_HANDLE;
+			samplerCreateInfo.flags = 0;
+			samplerCreateInfo.magFilter = VK_FILTER_NEAREST;
+			samplerCreateInfo.minFilter = VK_FILTER_NEAREST;
+			samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+			samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCreateInfo.mipLodBias = 0.0f;
+			samplerCreateInfo.anisotropyEnable = VK_FALSE;
+			samplerCreateInfo.maxAnisotropy = 1.0f;
+			samplerCreateInfo.compareEnable = VK_FALSE;
+			samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+			samplerCreateInfo.minLod = 0.0f;
+			samplerCreateInfo.maxLod = 0.0f;
+			samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+			samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSampler(pInstance->getLogicalDevice(), &samplerCreateInfo, VK_NULL_HANDLE, &m_UpscaleSampler), "Failed to create the upscale sampler!");
+
+			// Create the descriptor set layout.
+			std::array<VkDescriptorSetLayoutBinding, 3> bindings = {};
+			for (uint32_t i = 0; i < bindings.size(); i++)
+			{
+				bindings[i].binding = i;
+				bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				bindings[i].descriptorCount = 1;
+				bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+				bindings[i].pImmutableSamplers = VK_NULL_HANDLE;
+			}
+
+			VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+			layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutCreateInfo.pNext = VK_NULL_HANDLE;
+			layoutCreateInfo.flags = 0;
+			layoutCreateInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+			layoutCreateInfo.pBindings = bindings.data();
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorSetLayout(pInstance->getLogicalDevice(), &layoutCreateInfo, VK_NULL_HANDLE, &m_UpscaleDescriptorSetLayout), "Failed to create the upscale descriptor set layout!");
+
+			// Create the descriptor pool, allocate the descriptor set and write the images to it.
+			VkDescriptorPoolSize poolSize = {};
+			poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			poolSize.descriptorCount = static_cast<uint32_t>(bindings.size());
+
+			VkDescriptorPoolCreateInfo poolCreateInfo = {};
+			poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			poolCreateInfo.pNext = VK_NULL_HANDLE;
+			poolCreateInfo.flags = 0;
+			poolCreateInfo.maxSets = 1;
+			poolCreateInfo.poolSizeCount = 1;
+			poolCreateInfo.pPoolSizes = &poolSize;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorPool(pInstance->getLogicalDevice(), &poolCreateInfo, VK_NULL_HANDLE, &m_UpscaleDescriptorPool), "Failed to create the upscale descriptor pool!");
+
+			VkDescriptorSetAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocateInfo.pNext = VK_NULL_HANDLE;
+			allocateInfo.descriptorPool = m_UpscaleDescriptorPool;
+			allocateInfo.descriptorSetCount = 1;
+			allocateInfo.pSetLayouts = &m_UpscaleDescriptorSetLayout;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkAllocateDescriptorSets(pInstance->getLogicalDevice(), &allocateInfo, &m_UpscaleDescriptorSet), "Failed to allocate the upscale descriptor set!");
+
+			const std::array<VkImageView, 3> imageViews = { m_ScaledColorImage.m_ImageView, m_ScaledEntityImage.m_ImageView, m_ScaledDepthImage.m_ImageView };
+			std::array<VkDescriptorImageInfo, 3> imageInfos = {};
+			std::array<VkWriteDescriptorSet, 3> writes = {};
+			for (uint32_t i = 0; i < writes.size(); i++)
+			{
+				imageInfos[i].sampler = m_UpscaleSampler;
+				imageInfos[i].imageView = imageViews[i];
+				imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+				writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[i].pNext = VK_NULL_HANDLE;
+				writes[i].dstSet = m_UpscaleDescriptorSet;
+				writes[i].dstBinding = i;
+				writes[i].dstArrayElement = 0;
+				writes[i].descriptorCount = 1;
+				writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				writes[i].pImageInfo = &imageInfos[i];
+			}
+
+			pInstance->getDeviceTable().vkUpdateDescriptorSets(pInstance->getLogicalDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, VK_NULL_HANDLE);
+
+			// Create the pipeline layout.
+			VkPushConstantRange pushConstantRange = {};
+			pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			pushConstantRange.offset = 0;
+			pushConstantRange.size = sizeof(UpscaleConstants);
+
+			VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+			pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineLayoutCreateInfo.flags = 0;
+			pipelineLayoutCreateInfo.setLayoutCount = 1;
+			pipelineLayoutCreateInfo.pSetLayouts = &m_UpscaleDescriptorSetLayout;
+			pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+			pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreatePipelineLayout(pInstance->getLogicalDevice(), &pipelineLayoutCreateInfo, VK_NULL_HANDLE, &m_UpscalePipelineLayout), "Failed to create the upscale pipeline layout!");
+
+			// Setup the shader stages.
+			const auto vertexShaderModule = pInstance->createShaderModule(UpscaleVertexShaderCode);
+			const auto fragmentShaderModule = pInstance->createShaderModule(UpscaleFragmentShaderCode);
+
+			std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages = {};
+			shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			shaderStages[0].pNext = VK_NULL_HANDLE;
+			shaderStages[0].flags = 0;
+			shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+			shaderStages[0].module = vertexShaderModule;
+			shaderStages[0].pName = "main";
+			shaderStages[0].pSpecializationInfo = VK_NULL_HANDLE;
+
+			shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			shaderStages[1].pNext = VK_NULL_HANDLE;
+			shaderStages[1].flags = 0;
+			shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+			shaderStages[1].module = fragmentShaderModule;
+			shaderStages[1].pName = "main";
+			shaderStages[1].pSpecializationInfo = VK_NULL_HANDLE;
+
+			// The triangle is generated in the vertex shader, so there's no vertex input.
+			VkPipelineVertexInputStateCreateInfo vertexInputState = {};
+			vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+			vertexInputState.pNext = VK_NULL_HANDLE;
+			vertexInputState.flags = 0;
+			vertexInputState.vertexBindingDescriptionCount = 0;
+			vertexInputState.pVertexBindingDescriptions = VK_NULL_HANDLE;
+			vertexInputState.vertexAttributeDescriptionCount = 0;
+			vertexInputState.pVertexAttributeDescriptions = VK_NULL_HANDLE;
+
+			VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {};
+			inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+			inputAssemblyState.pNext = VK_NULL_HANDLE;
+			inputAssemblyState.flags = 0;
+			inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			inputAssemblyState.primitiveRestartEnable = VK_FALSE;
+
+			// The viewport and scissor are set when drawing.
+			VkPipelineViewportStateCreateInfo viewportState = {};
+			viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+			viewportState.pNext = VK_NULL_HANDLE;
+			viewportState.flags = 0;
+			viewportState.viewportCount = 1;
+			viewportState.pViewports = VK_NULL_HANDLE;
+			viewportState.scissorCount = 1;
+			viewportState.pScissors = VK_NULL_HANDLE;
+
+			VkPipelineRasterizationStateCreateInfo rasterizationState = {};
+			rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+			rasterizationState.pNext = VK_NULL_HANDLE;
+			rasterizationState.flags = 0;
+			rasterizationState.depthClampEnable = VK_FALSE;
+			rasterizationState.rasterizerDiscardEnable = VK_FALSE;
+			rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+			rasterizationState.cullMode = VK_CULL_MODE_NONE;
+			rasterizationState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+			rasterizationState.depthBiasEnable = VK_FALSE;
+			rasterizationState.lineWidth = 1.0f;
+
+			VkPipelineMultisampleStateCreateInfo multisampleState = {};
+			multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+			multisampleState.pNext = VK_NULL_HANDLE;
+			multisampleState.flags = 0;
+			multisampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+			multisampleState.sampleShadingEnable = VK_FALSE;
+			multisampleState.minSampleShading = 1.0f;
+			multisampleState.pSampleMask = VK_NULL_HANDLE;
+			multisampleState.alphaToCoverageEnable = VK_FALSE;
+			multisampleState.alphaToOneEnable = VK_FALSE;
+
+			// The depth is written as is, so the native resolution commands are tested against it.
+			VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
+			depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+			depthStencilState.pNext = VK_NULL_HANDLE;
+			depthStencilState.flags = 0;
+			depthStencilState.depthTestEnable = VK_TRUE;
+			depthStencilState.depthWriteEnable = VK_TRUE;
+			depthStencilState.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+			depthStencilState.depthBoundsTestEnable = VK_FALSE;
+			depthStencilState.stencilTestEnable = VK_FALSE;
+
+			// Every attachment is overwritten.
+			std::array<VkPipelineColorBlendAttachmentState, 2> blendAttachments = {};
+			blendAttachments[0].blendEnable = VK_FALSE;
+			blendAttachments[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+			blendAttachments[1].blendEnable = VK_FALSE;
+			blendAttachments[1].colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+
+			VkPipelineColorBlendStateCreateInfo colorBlendState = {};
+			colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+			colorBlendState.pNext = VK_NULL_HANDLE;
+			colorBlendState.flags = 0;
+			colorBlendState.logicOpEnable = VK_FALSE;
+			colorBlendState.logicOp = VK_LOGIC_OP_COPY;
+			colorBlendState.attachmentCount = static_cast<uint32_t>(blendAttachments.size());
+			colorBlendState.pAttachments = blendAttachments.data();
+
+			const std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+			VkPipelineDynamicStateCreateInfo dynamicState = {};
+			dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+			dynamicState.pNext = VK_NULL_HANDLE;
+			dynamicState.flags = 0;
+			dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+			dynamicState.pDynamicStates = dynamicStates.data();
+
+			// Create the pipeline.
+			VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+			pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+			pipelineCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineCreateInfo.flags = 0;
+			pipelineCreateInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+			pipelineCreateInfo.pStages = shaderStages.data();
+			pipelineCreateInfo.pVertexInputState = &vertexInputState;
+			pipelineCreateInfo.pInputAssemblyState = &inputAssemblyState;
+			pipelineCreateInfo.pTessellationState = VK_NULL_HANDLE;
+			pipelineCreateInfo.pViewportState = &viewportState;
+			pipelineCreateInfo.pRasterizationState = &rasterizationState;
+			pipelineCreateInfo.pMultisampleState = &multisampleState;
+			pipelineCreateInfo.pDepthStencilState = &depthStencilState;
+			pipelineCreateInfo.pColorBlendState = &colorBlendState;
+			pipelineCreateInfo.pDynamicState = &dynamicState;
+			pipelineCreateInfo.layout = m_UpscalePipelineLayout;
+			pipelineCreateInfo.renderPass = m_UpscaleRenderPass;
+			pipelineCreateInfo.subpass = 0;
+			pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+			pipelineCreateInfo.basePipelineIndex = 0;
+
+			const auto result = pInstance->getDeviceTable().vkCreateGraphicsPipelines(pInstance->getLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, VK_NULL_HANDLE, &m_UpscalePipeline);
+
+			pInstance->getDeviceTable().vkDestroyShaderModule(pInstance->getLogicalDevice(), vertexShaderModule, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyShaderModule(pInstance->getLogicalDevice(), fragmentShaderModule, VK_NULL_HANDLE);
+
+			MINTE_VK_ASSERT(result, "Failed to create the upscale pipeline!");
+		}
+
+		void VulkanRenderTarget::recordUpscale() const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			const std::array<const VulkanAttachment*, 3> pAttachments = { &m_ColorAttachment, &m_EntityAttachment, &m_DepthAttachment };
+			const std::array<const VulkanAttachment*, 3> pScaledImages = { &m_ScaledColorImage, &m_ScaledEntityImage, &m_ScaledDepthImage };
+			const std::array<VkImageAspectFlags, 3> aspects = { VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_ASPECT_DEPTH_BIT };
+
+			// Wait for the render pass to finish writing, and get the scaled images ready to be copied to.
+			VkMemoryBarrier memoryBarrier = {};
+			memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			memoryBarrier.pNext = VK_NULL_HANDLE;
+			memoryBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+			std::array<VkImageMemoryBarrier, 3> imageBarriers = {};
+			for (uint32_t i = 0; i < imageBarriers.size(); i++)
+			{
+				imageBarriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				imageBarriers[i].pNext = VK_NULL_HANDLE;
+				imageBarriers[i].srcAccessMask = 0;
+				imageBarriers[i].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				imageBarriers[i].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+				imageBarriers[i].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				imageBarriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageBarriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageBarriers[i].image = pScaledImages[i]->m_Image;
+				imageBarriers[i].subresourceRange.aspectMask = aspects[i];
+				imageBarriers[i].subresourceRange.baseMipLevel = 0;
+				imageBarriers[i].subresourceRange.levelCount = 1;
+				imageBarriers[i].subresourceRange.baseArrayLayer = 0;
+				imageBarriers[i].subresourceRange.layerCount = 1;
+			}
+
+			pInstance->getDeviceTable().vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+			// Copy the scaled area.
+			VkImageCopy imageCopy = {};
+			imageCopy.srcSubresource.mipLevel = 0;
+			imageCopy.srcSubresource.baseArrayLayer = 0;
+			imageCopy.srcSubresource.layerCount = 1;
+			imageCopy.srcOffset = { 0, 0, 0 };
+			imageCopy.dstSubresource = imageCopy.srcSubresource;
+			imageCopy.dstOffset = { 0, 0, 0 };
+			imageCopy.extent = { getRenderWidth(), getRenderHeight(), 1 };
+
+			for (uint32_t i = 0; i < pAttachments.size(); i++)
+			{
+				imageCopy.srcSubresource.aspectMask = aspects[i];
+				imageCopy.dstSubresource.aspectMask = aspects[i];
+				pInstance->getDeviceTable().vkCmdCopyImage(m_CommandBuffer, pAttachments[i]->m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, pScaledImages[i]->m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+			}
+
+			// Make the copies visible to the shader, and don't let the render pass overwrite the attachments before they're copied.
+			for (auto& imageBarrier : imageBarriers)
+			{
+				imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+				imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				imageBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			}
+
+			pInstance->getDeviceTable().vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+			// Upscale the images over the whole render target.
+			VkRenderPassBeginInfo renderPassBeginInfo = {};
+			renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassBeginInfo.pNext = VK_NULL_HANDLE;
+			renderPassBeginInfo.renderPass = m_UpscaleRenderPass;
+			renderPassBeginInfo.framebuffer = m_Framebuffer;
+			renderPassBeginInfo.renderArea.extent = VkExtent2D{ getWidth(), getHeight() };
+			renderPassBeginInfo.clearValueCount = 0;
+			renderPassBeginInfo.pClearValues = VK_NULL_HANDLE;
+
+			pInstance->getDeviceTable().vkCmdBeginRenderPass(m_CommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+			VkViewport viewport = {};
+			viewport.x = 0.0f;
+			viewport.y = 0.0f;
+			viewport.width = static_cast<float>(getWidth());
+			viewport.height = static_cast<float>(getHeight());
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+
+			VkRect2D scissor = {};
+			scissor.offset = { 0, 0 };
+			scissor.extent = { getWidth(), getHeight() };
+
+			pInstance->getDeviceTable().vkCmdSetViewport(m_CommandBuffer, 0, 1, &viewport);
+			pInstance->getDeviceTable().vkCmdSetScissor(m_CommandBuffer, 0, 1, &scissor);
+
+			UpscaleConstants constants = {};
+			constants.m_SourceWidth = getRenderWidth();
+			constants.m_SourceHeight = getRenderHeight();
+			constants.m_DestinationWidth = getWidth();
+			constants.m_DestinationHeight = getHeight();
+
+			pInstance->getDeviceTable().vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_UpscalePipeline);
+			pInstance->getDeviceTable().vkCmdBindDescriptorSets(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_UpscalePipelineLayout, 0, 1, &m_UpscaleDescriptorSet, 0, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkCmdPushConstants(m_CommandBuffer, m_UpscalePipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(UpscaleConstants), &constants);
+			pInstance->getDeviceTable().vkCmdDraw(m_CommandBuffer, 3, 1, 0, 0);
+
+			// Draw the native resolution commands on top.
+			recordGeometry(true);
+
+			pInstance->getDeviceTable().vkCmdEndRenderPass(m_CommandBuffer);
+		}
+
+		void VulkanRenderTarget::destroyUpscale() const
+		{
+			// Return if we haven't set it up.
+			if (m_UpscalePipeline == VK_NULL_HANDLE)
+				return;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			destroyAttachment(m_ScaledColorImage);
+			destroyAttachment(m_ScaledEntityImage);
+			destroyAttachment(m_ScaledDepthImage);
+
+			pInstance->getDeviceTable().vkDestroyDescriptorPool(pInstance->getLogicalDevice(), m_UpscaleDescriptorPool, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipeline(pInstance->getLogicalDevice(), m_UpscalePipeline, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipelineLayout(pInstance->getLogicalDevice(), m_UpscalePipelineLayout, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyDescriptorSetLayout(pInstance->getLogicalDevice(), m_UpscaleDescriptorSetLayout, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroySampler(pInstance->getLogicalDevice(), m_UpscaleSampler, VK_NULL_HANDLE);
+		}
+
+		void VulkanRenderTarget::setupBackground(bool bPixels)
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			m_IsBackgroundPixels = bPixels;
+
+			// Images are filtered when the render scale is used, host pixels are fetched as they are.
+			if (!bPixels)
+			{
+				VkSamplerCreateInfo samplerCreateInfo = {};
+				samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+				samplerCreateInfo.pNext = VK_NULL_HANDLE;
+				samplerCreateInfo.flags = 0;
+				samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+				samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+				samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+				samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+				samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+				samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+				samplerCreateInfo.mipLodBias = 0.0f;
+				samplerCreateInfo.anisotropyEnable = VK_FALSE;
+				samplerCreateInfo.maxAnisotropy = 1.0f;
+				samplerCreateInfo.compareEnable = VK_FALSE;
+				samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+				samplerCreateInfo.minLod = 0.0f;
+				samplerCreateInfo.maxLod = 0.0f;
+				samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+				samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSampler(pInstance->getLogicalDevice(), &samplerCreateInfo, VK_NULL_HANDLE, &m_BackgroundSampler), "Failed to create the background sampler!");
+			}
+
+			const auto descriptorType = bPixels ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+			// Create the descriptor set layout.
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = 0;
+			binding.descriptorType = descriptorType;
+			binding.descriptorCount = 1;
+			binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			binding.pImmutableSamplers = VK_NULL_HANDLE;
+
+			VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+			layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutCreateInfo.pNext = VK_NULL_HANDLE;
+			layoutCreateInfo.flags = 0;
+			layoutCreateInfo.bindingCount = 1;
+			layoutCreateInfo.pBindings = &binding;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorSetLayout(pInstance->getLogicalDevice(), &layoutCreateInfo, VK_NULL_HANDLE, &m_BackgroundDescriptorSetLayout), "Failed to create the background descriptor set layout!");
+
+			// Create the descriptor pool and allocate the descriptor set. The background is written to it when it's set.
+			VkDescriptorPoolSize poolSize = {};
+			poolSize.type = descriptorType;
+			poolSize.descriptorCount = 1;
+
+			VkDescriptorPoolCreateInfo poolCreateInfo = {};
+			poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			poolCreateInfo.pNext = VK_NULL_HANDLE;
+			poolCreateInfo.flags = 0;
+			poolCreateInfo.maxSets = 1;
+			poolCreateInfo.poolSizeCount = 1;
+			poolCreateInfo.pPoolSizes = &poolSize;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateDescriptorPool(pInstance->getLogicalDevice(), &poolCreateInfo, VK_NULL_HANDLE, &m_BackgroundDescriptorPool), "Failed to create the background descriptor pool!");
+
+			VkDescriptorSetAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			allocateInfo.pNext = VK_NULL_HANDLE;
+			allocateInfo.descriptorPool = m_BackgroundDescriptorPool;
+			allocateInfo.descriptorSetCount = 1;
+			allocateInfo.pSetLayouts = &m_BackgroundDescriptorSetLayout;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkAllocateDescriptorSets(pInstance->getLogicalDevice(), &allocateInfo, &m_BackgroundDescriptorSet), "Failed to allocate the background descriptor set!");
+
+			// Create the pipeline layout.
+			VkPushConstantRange pushConstantRange = {};
+			pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			pushConstantRange.offset = 0;
+			pushConstantRange.size = sizeof(BackgroundConstants);
+
+			VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+			pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineLayoutCreateInfo.flags = 0;
+			pipelineLayoutCreateInfo.setLayoutCount = 1;
+			pipelineLayoutCreateInfo.pSetLayouts = &m_BackgroundDescriptorSetLayout;
+			pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+			pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreatePipelineLayout(pInstance->getLogicalDevice(), &pipelineLayoutCreateInfo, VK_NULL_HANDLE, &m_BackgroundPipelineLayout), "Failed to create the background pipeline layout!");
+
+			// Setup the shader stages.
+			const auto vertexShaderModule = pInstance->createShaderModule(UpscaleVertexShaderCode);
+			const auto fragmentShaderModule = bPixels ? pInstance->createShaderModule(BackgroundPixelsFragmentShaderCode) : pInstance->createShaderModule(BackgroundImageFragmentShaderCode);
+
+			std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages = {};
+			shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			shaderStages[0].pNext = VK_NULL_HANDLE;
+			shaderStages[0].flags = 0;
+			shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+			shaderStages[0].module = vertexShaderModule;
+			shaderStages[0].pName = "main";
+			shaderStages[0].pSpecializationInfo = VK_NULL_HANDLE;
+
+			shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			shaderStages[1].pNext = VK_NULL_HANDLE;
+			shaderStages[1].flags = 0;
+			shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+			shaderStages[1].module = fragmentShaderModule;
+			shaderStages[1].pName = "main";
+			shaderStages[1].pSpecializationInfo = VK_NULL_HANDLE;
+
+			// The triangle is generated in the vertex shader, so there's no vertex input.
+			VkPipelineVertexInputStateCreateInfo vertexInputState = {};
+			vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+			vertexInputState.pNext = VK_NULL_HANDLE;
+			vertexInputState.flags = 0;
+			vertexInputState.vertexBindingDescriptionCount = 0;
+			vertexInputState.pVertexBindingDescriptions = VK_NULL_HANDLE;
+			vertexInputState.vertexAttributeDescriptionCount = 0;
+			vertexInputState.pVertexAttributeDescriptions = VK_NULL_HANDLE;
+
+			VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {};
+			inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+			inputAssemblyState.pNext = VK_NULL_HANDLE;
+			inputAssemblyState.flags = 0;
+			inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			inputAssemblyState.primitiveRestartEnable = VK_FALSE;
+
+			// The viewport and scissor are set when drawing.
+			VkPipelineViewportStateCreateInfo viewportState = {};
+			viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+			viewportState.pNext = VK_NULL_HANDLE;
+			viewportState.flags = 0;
+			viewportState.viewportCount = 1;
+			viewportState.pViewports = VK_NULL_HANDLE;
+			viewportState.scissorCount = 1;
+			viewportState.pScissors = VK_NULL_HANDLE;
+
+			VkPipelineRasterizationStateCreateInfo rasterizationState = {};
+			rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+			rasterizationState.pNext = VK_NULL_HANDLE;
+			rasterizationState.flags = 0;
+			rasterizationState.depthClampEnable = VK_FALSE;
+			rasterizationState.rasterizerDiscardEnable = VK_FALSE;
+			rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+			rasterizationState.cullMode = VK_CULL_MODE_NONE;
+			rasterizationState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+			rasterizationState.depthBiasEnable = VK_FALSE;
+			rasterizationState.lineWidth = 1.0f;
+
+			VkPipelineMultisampleStateCreateInfo multisampleState = {};
+			multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+			multisampleState.pNext = VK_NULL_HANDLE;
+			multisampleState.flags = 0;
+			multisampleState.rasterizationSamples = GetSampleCount(getAntiAliasing());
+			multisampleState.sampleShadingEnable = VK_FALSE;
+			multisampleState.minSampleShading = 1.0f;
+			multisampleState.pSampleMask = VK_NULL_HANDLE;
+			multisampleState.alphaToCoverageEnable = VK_FALSE;
+			multisampleState.alphaToOneEnable = VK_FALSE;
+
+			// The background is behind everything, so the depth is left cleared.
+			VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
+			depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+			depthStencilState.pNext = VK_NULL_HANDLE;
+			depthStencilState.flags = 0;
+			depthStencilState.depthTestEnable = VK_FALSE;
+			depthStencilState.depthWriteEnable = VK_FALSE;
+			depthStencilState.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+			depthStencilState.depthBoundsTestEnable = VK_FALSE;
+			depthStencilState.stencilTestEnable = VK_FALSE;
+
+			// The color is overwritten, and the entity ID is left cleared.
+			std::array<VkPipelineColorBlendAttachmentState, 2> blendAttachments = {};
+			blendAttachments[0].blendEnable = VK_FALSE;
+			blendAttachments[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+			blendAttachments[1].blendEnable = VK_FALSE;
+			blendAttachments[1].colorWriteMask = 0;
+
+			VkPipelineColorBlendStateCreateInfo colorBlendState = {};
+			colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+			colorBlendState.pNext = VK_NULL_HANDLE;
+			colorBlendState.flags = 0;
+			colorBlendState.logicOpEnable = VK_FALSE;
+			colorBlendState.logicOp = VK_LOGIC_OP_COPY;
+			colorBlendState.attachmentCount = static_cast<uint32_t>(blendAttachments.size());
+			colorBlendState.pAttachments = blendAttachments.data();
+
+			const std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+			VkPipelineDynamicStateCreateInfo dynamicState = {};
+			dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+			dynamicState.pNext = VK_NULL_HANDLE;
+			dynamicState.flags = 0;
+			dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+			dynamicState.pDynamicStates = dynamicStates.data();
+
+			// Create the pipeline.
+			VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+			pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+			pipelineCreateInfo.pNext = VK_NULL_HANDLE;
+			pipelineCreateInfo.flags = 0;
+			pipelineCreateInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+			pipelineCreateInfo.pStages = shaderStages.data();
+			pipelineCreateInfo.pVertexInputState = &vertexInputState;
+			pipelineCreateInfo.pInputAssemblyState = &inputAssemblyState;
+			pipelineCreateInfo.pTessellationState = VK_NULL_HANDLE;
+			pipelineCreateInfo.pViewportState = &viewportState;
+			pipelineCreateInfo.pRasterizationState = &rasterizationState;
+			pipelineCreateInfo.pMultisampleState = &multisampleState;
+			pipelineCreateInfo.pDepthStencilState = &depthStencilState;
+			pipelineCreateInfo.pColorBlendState = &colorBlendState;
+			pipelineCreateInfo.pDynamicState = &dynamicState;
+			pipelineCreateInfo.layout = m_BackgroundPipelineLayout;
+			pipelineCreateInfo.renderPass = m_RenderPass;
+			pipelineCreateInfo.subpass = 0;
+			pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+			pipelineCreateInfo.basePipelineIndex = 0;
+
+			const auto result = pInstance->getDeviceTable().vkCreateGraphicsPipelines(pInstance->getLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, VK_NULL_HANDLE, &m_BackgroundPipeline);
+
+			pInstance->getDeviceTable().vkDestroyShaderModule(pInstance->getLogicalDevice(), vertexShaderModule, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyShaderModule(pInstance->getLogicalDevice(), fragmentShaderModule, VK_NULL_HANDLE);
+
+			MINTE_VK_ASSERT(result, "Failed to create the background pipeline!");
+		}
+
+		void VulkanRenderTarget::recordBackground() const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// The background covers the scaled area, like the geometry drawn on top of it.
+			VkViewport viewport = {};
+			viewport.x = 0.0f;
+			viewport.y = 0.0f;
+			viewport.width = static_cast<float>(getRenderWidth());
+			viewport.height = static_cast<float>(getRenderHeight());
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+
+			VkRect2D scissor = {};
+			scissor.offset = { 0, 0 };
+			scissor.extent = { getRenderWidth(), getRenderHeight() };
+
+			pInstance->getDeviceTable().vkCmdSetViewport(m_CommandBuffer, 0, 1, &viewport);
+			pInstance->getDeviceTable().vkCmdSetScissor(m_CommandBuffer, 0, 1, &scissor);
+
+			BackgroundConstants constants = {};
+			constants.m_RenderWidth = getRenderWidth();
+			constants.m_RenderHeight = getRenderHeight();
+			constants.m_Width = getWidth();
+			constants.m_Height = getHeight();
+			constants.m_RowLength = m_BackgroundRowLength;
+			constants.m_FirstTexel = m_BackgroundFirstTexel;
+
+			pInstance->getDeviceTable().vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_BackgroundPipeline);
+			pInstance->getDeviceTable().vkCmdBindDescriptorSets(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_BackgroundPipelineLayout, 0, 1, &m_BackgroundDescriptorSet, 0, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkCmdPushConstants(m_CommandBuffer, m_BackgroundPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(BackgroundConstants), &constants);
+			pInstance->getDeviceTable().vkCmdDraw(m_CommandBuffer, 3, 1, 0, 0);
+		}
+
+		void VulkanRenderTarget::releaseBackgroundPixels()
+		{
+			// Return if there are no imported pixels.
+			if (m_BackgroundBuffer == VK_NULL_HANDLE)
+				return;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkDestroyBufferView(pInstance->getLogicalDevice(), m_BackgroundBufferView, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyBuffer(pInstance->getLogicalDevice(), m_BackgroundBuffer, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkFreeMemory(pInstance->getLogicalDevice(), m_BackgroundMemory, VK_NULL_HANDLE);
+
+			m_BackgroundBufferView = VK_NULL_HANDLE;
+			m_BackgroundBuffer = VK_NULL_HANDLE;
+			m_BackgroundMemory = VK_NULL_HANDLE;
+		}
+
+		void VulkanRenderTarget::destroyBackground()
+		{
+			// Return if we haven't set it up.
+			if (m_BackgroundPipeline == VK_NULL_HANDLE)
+				return;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkDestroyDescriptorPool(pInstance->getLogicalDevice(), m_BackgroundDescriptorPool, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipeline(pInstance->getLogicalDevice(), m_BackgroundPipeline, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyPipelineLayout(pInstance->getLogicalDevice(), m_BackgroundPipelineLayout, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyDescriptorSetLayout(pInstance->getLogicalDevice(), m_BackgroundDescriptorSetLayout, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroySampler(pInstance->getLogicalDevice(), m_BackgroundSampler, VK_NULL_HANDLE);
+
+			m_BackgroundDescriptorPool = VK_NULL_HANDLE;
+			m_BackgroundDescriptorSet = VK_NULL_HANDLE;
+			m_BackgroundPipeline = VK_NULL_HANDLE;
+			m_BackgroundPipelineLayout = VK_NULL_HANDLE;
+			m_BackgroundDescriptorSetLayout = VK_NULL_HANDLE;
+			m_BackgroundSampler = VK_NULL_HANDLE;
+		}
+
+		void VulkanRenderTarget::recordReadback() const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			VkBufferImageCopy imageCopy = {};
+			imageCopy.imageExtent = { getWidth(), getHeight(), 1 };
+			imageCopy.imageOffset = { 0, 0, 0 };
+			imageCopy.imageSubresource.baseArrayLayer = 0;
+			imageCopy.imageSubresource.layerCount = 1;
+			imageCopy.imageSubresource.mipLevel = 0;
+			imageCopy.bufferOffset = 0;
+			imageCopy.bufferImageHeight = getHeight();
+			imageCopy.bufferRowLength = getWidth();
+
+			// Convert the color output if required, or else copy it as is.
+			if (getOutputFormat() != OutputFormat::RGBA)
+			{
+				recordConversion();
+			}
+			else
+			{
+				imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				pInstance->getDeviceTable().vkCmdCopyImageToBuffer(m_CommandBuffer, m_ColorAttachment.m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, getColorBuffer()->as<VulkanImageBuffer>()->getBuffer(), 1, &imageCopy);
+			}
+
+			imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			pInstance->getDeviceTable().vkCmdCopyImageToBuffer(m_CommandBuffer, m_EntityAttachment.m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, getEntityBuffer()->as<VulkanImageBuffer>()->getBuffer(), 1, &imageCopy);
+
+			imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+			pInstance->getDeviceTable().vkCmdCopyImageToBuffer(m_CommandBuffer, m_DepthAttachment.m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, getDepthBuffer()->as<VulkanImageBuffer>()->getBuffer(), 1, &imageCopy);
+
+			// Make the buffer writes visible to the host.
+			VkMemoryBarrier memoryBarrier = {};
+			memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			memoryBarrier.pNext = VK_NULL_HANDLE;
+			memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			memoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+			pInstance->getDeviceTable().vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+		}
+
 		void VulkanRenderTarget::waitForFence() const
 		{
 			const auto pInstance = getInstance()->as<VulkanInstance>();
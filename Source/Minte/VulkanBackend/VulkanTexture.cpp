@@ -0,0 +1,302 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Backend/VulkanBackend/VulkanTexture.hpp"
+#include "Minte/Backend/VulkanBackend/VulkanMacros.hpp"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace /* anonymous */
+{
+	/**
+	 * Get the Vulkan format from the texture format.
+	 *
+	 * @param format The texture format.
+	 * @return The Vulkan format.
+	 */
+	VkFormat GetFormat(minte::backend::TextureFormat format)
+	{
+		switch (format)
+		{
+		case minte::backend::TextureFormat::R8:		return VK_FORMAT_R8_UNORM;
+		case minte::backend::TextureFormat::RGBA8:	return VK_FORMAT_R8G8B8A8_UNORM;
+		default:									throw minte::backend::BackendError("Invalid texture format!");
+		}
+	}
+}
+
+namespace minte
+{
+	namespace backend
+	{
+		VulkanTexture::VulkanTexture(const std::shared_ptr<VulkanInstance>& pInstance, uint32_t width, uint32_t height, TextureFormat format, bool bMipmaps /*= false*/)
+			: Texture(pInstance, width, height, format, bMipmaps)
+		{
+			setupImage();
+			setupSampler();
+			setupCommandBuffer();
+
+			// Clear the image so that the regions which were never updated are transparent.
+			beginCommandBuffer();
+			pInstance->changeImageLayout(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, getMipLevels());
+
+			VkClearColorValue clearColor = {};
+			VkImageSubresourceRange subresourceRange = {};
+			subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			subresourceRange.baseMipLevel = 0;
+			subresourceRange.levelCount = getMipLevels();
+			subresourceRange.baseArrayLayer = 0;
+			subresourceRange.layerCount = 1;
+
+			pInstance->getDeviceTable().vkCmdClearColorImage(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &subresourceRange);
+			pInstance->changeImageLayout(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, getMipLevels());
+			submitCommandBuffer();
+		}
+
+		VulkanTexture::~VulkanTexture()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			pInstance->getDeviceTable().vkDestroySampler(pInstance->getLogicalDevice(), m_Sampler, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyImageView(pInstance->getLogicalDevice(), m_ImageView, VK_NULL_HANDLE);
+			vmaDestroyImage(pInstance->getAllocator(), m_Image, m_Allocation);
+			pInstance->unregisterAllocation(ResourceCategory::Texture, m_AllocationSize);
+
+			pInstance->getDeviceTable().vkDestroyCommandPool(pInstance->getLogicalDevice(), m_CommandPool, VK_NULL_HANDLE);
+			pInstance->getDeviceTable().vkDestroyFence(pInstance->getLogicalDevice(), m_Fence, VK_NULL_HANDLE);
+		}
+
+		void VulkanTexture::upload(std::span<const TextureRegion> regions, std::span<const std::byte> data)
+		{
+			if (regions.empty() || data.empty())
+				return;
+
+			const auto pInstance = std::static_pointer_cast<VulkanInstance>(getInstancePointer());
+
+			// Grow the staging buffer if the data does not fit. The previous update was waited on, so we can replace it right away.
+			if (m_pStagingBuffer == nullptr || m_pStagingBuffer->getSize() < data.size())
+				m_pStagingBuffer = std::make_unique<VulkanImageBuffer>(pInstance, std::max<uint64_t>(data.size(), m_pStagingBuffer ? m_pStagingBuffer->getSize() * 2 : 64 * 1024), ResourceCategory::Staging);
+
+			std::memcpy(m_pStagingBuffer->mapMemory(), data.data(), data.size());
+			m_pStagingBuffer->unmapMemory();
+
+			// Copy all the regions at once.
+			std::vector<VkBufferImageCopy> copies;
+			copies.reserve(regions.size());
+
+			for (const auto& region : regions)
+			{
+				auto& copy = copies.emplace_back();
+				copy.bufferOffset = region.m_Offset;
+				copy.bufferRowLength = 0;
+				copy.bufferImageHeight = 0;
+				copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				copy.imageSubresource.mipLevel = 0;
+				copy.imageSubresource.baseArrayLayer = 0;
+				copy.imageSubresource.layerCount = 1;
+				copy.imageOffset = { static_cast<int32_t>(region.m_X), static_cast<int32_t>(region.m_Y), 0 };
+				copy.imageExtent = { region.m_Width, region.m_Height, 1 };
+			}
+
+			beginCommandBuffer();
+			pInstance->changeImageLayout(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, getMipLevels());
+			pInstance->getDeviceTable().vkCmdCopyBufferToImage(m_CommandBuffer, m_pStagingBuffer->getBuffer(), m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copies.size()), copies.data());
+
+			if (getMipLevels() > 1)
+				recordMipmaps();
+			else
+				pInstance->changeImageLayout(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+
+			submitCommandBuffer();
+		}
+
+		void VulkanTexture::setupImage()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			const auto format = GetFormat(getFormat());
+
+			VkImageCreateInfo imageCreateInfo = {};
+			imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageCreateInfo.pNext = VK_NULL_HANDLE;
+			imageCreateInfo.flags = 0;
+			imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageCreateInfo.format = format;
+			imageCreateInfo.extent.width = getWidth();
+			imageCreateInfo.extent.height = getHeight();
+			imageCreateInfo.extent.depth = 1;
+			imageCreateInfo.mipLevels = getMipLevels();
+			imageCreateInfo.arrayLayers = 1;
+			imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageCreateInfo.queueFamilyIndexCount = 0;
+			imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+			imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+			// The mip chain is blitted from the level above it, and the levels are blended by the sampler.
+			if (getMipLevels() > 1)
+			{
+				constexpr VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+				VkFormatProperties formatProperties = {};
+				vkGetPhysicalDeviceFormatProperties(pInstance->getPhysicalDevice(), format, &formatProperties);
+
+				if ((formatProperties.optimalTilingFeatures & requiredFeatures) != requiredFeatures)
+					throw BackendError("The device cannot generate the mipmaps of the texture format!");
+
+				imageCreateInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			}
+
+			VmaAllocationCreateInfo allocationCreateInfo = {};
+			allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+			VmaAllocationInfo allocationInfo = {};
+			MINTE_VK_ASSERT(vmaCreateImage(pInstance->getAllocator(), &imageCreateInfo, &allocationCreateInfo, &m_Image, &m_Allocation, &allocationInfo), "Failed to create the texture image!");
+
+			m_AllocationSize = allocationInfo.size;
+			pInstance->registerAllocation(ResourceCategory::Texture, m_AllocationSize);
+
+			// Single channel textures are read as red, and the rest of the channels are left to the shader.
+			VkImageViewCreateInfo imageViewCreateInfo = {};
+			imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+			imageViewCreateInfo.flags = 0;
+			imageViewCreateInfo.image = m_Image;
+			imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			imageViewCreateInfo.format = format;
+			imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+			imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+			imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+			imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+			imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+			imageViewCreateInfo.subresourceRange.levelCount = getMipLevels();
+			imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+			imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateImageView(pInstance->getLogicalDevice(), &imageViewCreateInfo, VK_NULL_HANDLE, &m_ImageView), "Failed to create the texture image view!");
+		}
+
+		void VulkanTexture::setupSampler()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// Distance fields need linear filtering to be scaled, and clamping keeps the atlas neighbours out of the edges. The levels of mipmapped
+			// textures are blended as well, so minified images are filtered trilinearly.
+			VkSamplerCreateInfo samplerCreateInfo = {};
+			samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			samplerCreateInfo.pNext = VK_NULL_HANDLE;
+			samplerCreateInfo.flags = 0;
+			samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+			samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+			samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+			samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCreateInfo.mipLodBias = 0.0f;
+			samplerCreateInfo.anisotropyEnable = VK_FALSE;
+			samplerCreateInfo.maxAnisotropy = 1.0f;
+			samplerCreateInfo.compareEnable = VK_FALSE;
+			samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+			samplerCreateInfo.minLod = 0.0f;
+			samplerCreateInfo.maxLod = static_cast<float>(getMipLevels() - 1);
+			samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+			samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSampler(pInstance->getLogicalDevice(), &samplerCreateInfo, VK_NULL_HANDLE, &m_Sampler), "Failed to create the texture sampler!");
+		}
+
+		void VulkanTexture::recordMipmaps() const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// The format was checked for linear blits when the image was created.
+			VkImageBlit imageBlit = {};
+			imageBlit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			imageBlit.srcSubresource.baseArrayLayer = 0;
+			imageBlit.srcSubresource.layerCount = 1;
+			imageBlit.dstSubresource = imageBlit.srcSubresource;
+
+			for (uint32_t level = 1; level < getMipLevels(); level++)
+			{
+				// Wait for the previous level to be written before reading it.
+				pInstance->changeImageLayout(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, 1, 1, level - 1);
+
+				imageBlit.srcSubresource.mipLevel = level - 1;
+				imageBlit.srcOffsets[0] = { 0, 0, 0 };
+				imageBlit.srcOffsets[1] = { static_cast<int32_t>(getMipWidth(level - 1)), static_cast<int32_t>(getMipHeight(level - 1)), 1 };
+
+				imageBlit.dstSubresource.mipLevel = level;
+				imageBlit.dstOffsets[0] = { 0, 0, 0 };
+				imageBlit.dstOffsets[1] = { static_cast<int32_t>(getMipWidth(level)), static_cast<int32_t>(getMipHeight(level)), 1 };
+
+				pInstance->getDeviceTable().vkCmdBlitImage(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_LINEAR);
+			}
+
+			// All but the last level were read from, and the last one was only written to.
+			pInstance->changeImageLayout(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, getMipLevels() - 1);
+			pInstance->changeImageLayout(m_CommandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, 1, 1, getMipLevels() - 1);
+		}
+
+		void VulkanTexture::setupCommandBuffer()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+			commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			commandPoolCreateInfo.pNext = VK_NULL_HANDLE;
+			commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			commandPoolCreateInfo.queueFamilyIndex = pInstance->getGraphicsQueue().m_Family;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateCommandPool(pInstance->getLogicalDevice(), &commandPoolCreateInfo, VK_NULL_HANDLE, &m_CommandPool), "Failed to create the texture command pool!");
+
+			VkCommandBufferAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocateInfo.pNext = VK_NULL_HANDLE;
+			allocateInfo.commandPool = m_CommandPool;
+			allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocateInfo.commandBufferCount = 1;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkAllocateCommandBuffers(pInstance->getLogicalDevice(), &allocateInfo, &m_CommandBuffer), "Failed to allocate the texture command buffer!");
+
+			VkFenceCreateInfo fenceCreateInfo = {};
+			fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			fenceCreateInfo.flags = 0;
+			fenceCreateInfo.pNext = VK_NULL_HANDLE;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateFence(pInstance->getLogicalDevice(), &fenceCreateInfo, VK_NULL_HANDLE, &m_Fence), "Failed to create the texture fence!");
+		}
+
+		void VulkanTexture::beginCommandBuffer() const
+		{
+			VkCommandBufferBeginInfo beginInfo = {};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			beginInfo.pNext = VK_NULL_HANDLE;
+			beginInfo.pInheritanceInfo = VK_NULL_HANDLE;
+
+			MINTE_VK_ASSERT(getInstance()->as<VulkanInstance>()->getDeviceTable().vkBeginCommandBuffer(m_CommandBuffer, &beginInfo), "Failed to begin the texture command buffer!");
+		}
+
+		void VulkanTexture::submitCommandBuffer() const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkEndCommandBuffer(m_CommandBuffer), "Failed to end the texture command buffer!");
+
+			VkSubmitInfo submitInfo = {};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.waitSemaphoreCount = 0;
+			submitInfo.pWaitSemaphores = VK_NULL_HANDLE;
+			submitInfo.pWaitDstStageMask = VK_NULL_HANDLE;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &m_CommandBuffer;
+			submitInfo.signalSemaphoreCount = 0;
+			submitInfo.pSignalSemaphores = VK_NULL_HANDLE;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkQueueSubmit(pInstance->getGraphicsQueue().m_Queue, 1, &submitInfo, m_Fence), "Failed to submit the texture update!");
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkWaitForFences(pInstance->getLogicalDevice(), 1, &m_Fence, VK_TRUE, std::numeric_limits<uint64_t>::max()), "Failed to wait for the texture fence!");
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkResetFences(pInstance->getLogicalDevice(), 1, &m_Fence), "Failed to reset the texture fence!");
+		}
+	}
+}
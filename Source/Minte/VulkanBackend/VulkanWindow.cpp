@@ -2,13 +2,18 @@
 
 #include "Minte/Backend/VulkanBackend/VulkanWindow.hpp"
 #include "Minte/Backend/VulkanBackend/VulkanMacros.hpp"
+#include "Minte/Layer.hpp"
 
 #include <SDL_vulkan.h>
 
 #include <array>
+#include <algorithm>
+#include <limits>
 
 namespace /* anonymous */
 {
+	constexpr int32_t MinimizedWaitTimeout = 100;	// How long to wait for a window event while minimized, in milliseconds.
+
 	/**
 	 * Static initializer struct.
 	 * These structs are used to initialize data that are to be initialized just once in the application.
@@ -33,14 +38,78 @@ namespace /* anonymous */
 			SDL_Quit();
 		}
 	};
+
+	/**
+	 * Get the mouse button from the SDL button.
+	 *
+	 * @param button The SDL button.
+	 * @return The mouse button.
+	 */
+	minte::MouseButton GetMouseButton(uint8_t button)
+	{
+		switch (button)
+		{
+		case SDL_BUTTON_LEFT:
+			return minte::MouseButton::Left;
+
+		case SDL_BUTTON_MIDDLE:
+			return minte::MouseButton::Middle;
+
+		case SDL_BUTTON_RIGHT:
+			return minte::MouseButton::Right;
+
+		case SDL_BUTTON_X1:
+			return minte::MouseButton::X1;
+
+		case SDL_BUTTON_X2:
+			return minte::MouseButton::X2;
+
+		default:
+			return minte::MouseButton::None;
+		}
+	}
+
+	/**
+	 * Get the best present mode for a present policy.
+	 * FIFO is the fallback, as it's the only mode every surface supports.
+	 *
+	 * @param policy The present policy.
+	 * @param presentModes The present modes supported by the surface.
+	 * @return The present mode.
+	 */
+	VkPresentModeKHR GetPresentMode(minte::backend::PresentPolicy policy, const std::vector<VkPresentModeKHR>& presentModes)
+	{
+		// Mailbox replaces the queued image instead of waiting for the vertical blank, and immediate does not wait at all.
+		if (policy == minte::backend::PresentPolicy::LowLatency)
+		{
+			for (const auto presentMode : { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR })
+			{
+				if (std::find(presentModes.begin(), presentModes.end(), presentMode) != presentModes.end())
+					return presentMode;
+			}
+		}
+
+		return VK_PRESENT_MODE_FIFO_KHR;
+	}
+
+	/**
+	 * Get the default number of frames in flight for a present policy.
+	 *
+	 * @param policy The present policy.
+	 * @return The frame count.
+	 */
+	uint32_t GetDefaultFramesInFlight(minte::backend::PresentPolicy policy)
+	{
+		return policy == minte::backend::PresentPolicy::VSync ? 2 : 1;
+	}
 }
 
 namespace minte
 {
 	namespace backend
 	{
-		VulkanWindow::VulkanWindow(const std::shared_ptr<VulkanInstance>& pInstance, std::string&& title, uint32_t width, uint32_t height)
-			: Window(pInstance, std::move(title), width, height)
+		VulkanWindow::VulkanWindow(const std::shared_ptr<VulkanInstance>& pInstance, std::string&& title, uint32_t width, uint32_t height, PresentPolicy policy /*= PresentPolicy::LowLatency*/, uint32_t framesInFlight /*= 0*/)
+			: Window(pInstance, std::move(title), width, height), m_PresentPolicy(policy), m_IsPresentWaitEnabled(pInstance->hasPresentWait())
 		{
 			// Resolve the flags.
 			uint32_t windowFlags = SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE;
@@ -73,24 +142,353 @@ namespace minte
 			// Setup the rest.
 			setupSwapchain();
 			setupRenderPass();
-			setupFramebuffer();
-			setupSyncObjects();
+			setupFramebuffers();
+			setupFrames(std::clamp(framesInFlight == 0 ? GetDefaultFramesInFlight(policy) : framesInFlight, 1u, MaxFramesInFlight));
 		}
 
 		VulkanWindow::~VulkanWindow()
 		{
-			clearSwapchain();
-
 			const auto pInstance = getInstance()->as<VulkanInstance>();
+
+			// The frame fences don't cover the presentation, so wait for the queue to finish before destroying anything.
+			pInstance->getDeviceTable().vkQueueWaitIdle(pInstance->getGraphicsQueue().m_Queue);
+
+			for (const auto& frame : m_Frames)
+			{
+				pInstance->getDeviceTable().vkDestroySemaphore(pInstance->getLogicalDevice(), frame.m_ImageAvailableSemaphore, VK_NULL_HANDLE);
+				pInstance->getDeviceTable().vkDestroyFence(pInstance->getLogicalDevice(), frame.m_InFlightFence, VK_NULL_HANDLE);
+			}
+
+			pInstance->getDeviceTable().vkDestroyCommandPool(pInstance->getLogicalDevice(), m_CommandPool, VK_NULL_HANDLE);
+
+			clearSwapchain();
 			pInstance->getDeviceTable().vkDestroyRenderPass(pInstance->getLogicalDevice(), m_RenderPass, VK_NULL_HANDLE);
-			pInstance->getDeviceTable().vkDestroyFramebuffer(pInstance->getLogicalDevice(), m_Framebuffer, VK_NULL_HANDLE);
-			pInstance->getDeviceTable().vkDestroySemaphore(pInstance->getLogicalDevice(), m_RenderFinishedSemaphore, VK_NULL_HANDLE);
-			pInstance->getDeviceTable().vkDestroySemaphore(pInstance->getLogicalDevice(), m_InFlightSemaphore, VK_NULL_HANDLE);
 
 			vkDestroySurfaceKHR(pInstance->getInstance(), m_Surface, VK_NULL_HANDLE);
 			SDL_DestroyWindow(m_pWindow);
 		}
 
+		bool VulkanWindow::pollEvents(InputQueue& queue)
+		{
+			const auto windowID = SDL_GetWindowID(m_pWindow);
+			bool bIsOpen = true;
+
+			// The SDL time stamps are in milliseconds since SDL was initialized, so they are converted using the current time.
+			const auto pollTime = std::chrono::steady_clock::now();
+			const auto pollTicks = SDL_GetTicks();
+
+			SDL_Event sdlEvent = {};
+			while (SDL_PollEvent(&sdlEvent))
+			{
+				InputEvent event;
+
+				switch (sdlEvent.type)
+				{
+				case SDL_QUIT:
+					bIsOpen = false;
+					continue;
+
+				case SDL_WINDOWEVENT:
+					if (sdlEvent.window.windowID == windowID)
+					{
+						if (sdlEvent.window.event == SDL_WINDOWEVENT_CLOSE)
+							bIsOpen = false;
+
+						// The swapchain is recreated by the next frame, so a burst of resize events only recreates it once.
+						else if (sdlEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+							m_IsSwapchainOutdated = true;
+					}
+
+					continue;
+
+				case SDL_MOUSEMOTION:
+					if (sdlEvent.motion.windowID != windowID)
+						continue;
+
+					event.m_Type = InputEventType::MouseMove;
+					event.m_Position = Point2D_F32(static_cast<float>(sdlEvent.motion.x), static_cast<float>(sdlEvent.motion.y));
+					event.m_Delta = Point2D_F32(static_cast<float>(sdlEvent.motion.xrel), static_cast<float>(sdlEvent.motion.yrel));
+					break;
+
+				case SDL_MOUSEBUTTONDOWN:
+				case SDL_MOUSEBUTTONUP:
+					if (sdlEvent.button.windowID != windowID)
+						continue;
+
+					event.m_Type = sdlEvent.type == SDL_MOUSEBUTTONDOWN ? InputEventType::MouseButtonDown : InputEventType::MouseButtonUp;
+					event.m_Position = Point2D_F32(static_cast<float>(sdlEvent.button.x), static_cast<float>(sdlEvent.button.y));
+					event.m_Button = GetMouseButton(sdlEvent.button.button);
+					break;
+
+				case SDL_MOUSEWHEEL:
+				{
+					if (sdlEvent.wheel.windowID != windowID)
+						continue;
+
+					// Wheel events do not carry the pointer position.
+					int32_t x = 0, y = 0;
+					SDL_GetMouseState(&x, &y);
+
+					event.m_Type = InputEventType::MouseWheel;
+					event.m_Position = Point2D_F32(static_cast<float>(x), static_cast<float>(y));
+					event.m_Delta = Point2D_F32(static_cast<float>(sdlEvent.wheel.x), static_cast<float>(sdlEvent.wheel.y));
+					break;
+				}
+
+				case SDL_KEYDOWN:
+				case SDL_KEYUP:
+					if (sdlEvent.key.windowID != windowID)
+						continue;
+
+					event.m_Type = sdlEvent.type == SDL_KEYDOWN ? InputEventType::KeyDown : InputEventType::KeyUp;
+					event.m_KeyCode = static_cast<uint32_t>(sdlEvent.key.keysym.sym);
+					event.m_Modifiers = sdlEvent.key.keysym.mod;
+					break;
+
+				default:
+					continue;
+				}
+
+				event.m_Timestamp = pollTime - std::chrono::milliseconds(pollTicks - sdlEvent.common.timestamp);
+				if (m_PendingInputTime == std::chrono::steady_clock::time_point() || event.m_Timestamp < m_PendingInputTime)
+					m_PendingInputTime = event.m_Timestamp;
+
+				queue.push(event);
+			}
+
+			return bIsOpen;
+		}
+
+		VkCommandBuffer VulkanWindow::beginFrame()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			const auto& frame = m_Frames[m_FrameIndex];
+
+			// Wait till the GPU is done with the last frame which used these objects. This is the only place the CPU waits for the GPU.
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkWaitForFences(pInstance->getLogicalDevice(), 1, &frame.m_InFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max()), "Failed to wait for the frame fence!");
+
+			// Keep no more frames queued for the display than there are frames in flight, or just one with the low latency policy, so the new
+			// frame uses recent input. An error here shows up again when acquiring.
+			if (m_IsPresentWaitEnabled)
+			{
+				const auto presentID = m_PresentPolicy == PresentPolicy::LowLatency ? m_PresentID : frame.m_PresentID;
+				if (presentID > m_RetiredPresentID)
+					pInstance->getDeviceTable().vkWaitForPresentKHR(pInstance->getLogicalDevice(), m_Swapchain, presentID, std::numeric_limits<uint64_t>::max());
+			}
+
+			for (auto& other : m_Frames)
+				measureLatency(other);
+
+			releaseRetiredSwapchains();
+
+			if (m_IsSwapchainOutdated && !recreateSwapchain())
+				return VK_NULL_HANDLE;
+
+			// Acquire the next image. An out of date swapchain does not signal the semaphore, so it can be used again after recreating it.
+			auto result = pInstance->getDeviceTable().vkAcquireNextImageKHR(pInstance->getLogicalDevice(), m_Swapchain, std::numeric_limits<uint64_t>::max(), frame.m_ImageAvailableSemaphore, VK_NULL_HANDLE, &m_ImageIndex);
+			if (result == VK_ERROR_OUT_OF_DATE_KHR)
+			{
+				if (!recreateSwapchain())
+					return VK_NULL_HANDLE;
+
+				result = pInstance->getDeviceTable().vkAcquireNextImageKHR(pInstance->getLogicalDevice(), m_Swapchain, std::numeric_limits<uint64_t>::max(), frame.m_ImageAvailableSemaphore, VK_NULL_HANDLE, &m_ImageIndex);
+			}
+
+			// A suboptimal swapchain can still be presented to, so it's recreated by the next frame. If the window is still changing, this frame is
+			// skipped.
+			if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
+				m_IsSwapchainOutdated = true;
+
+			if (result == VK_ERROR_OUT_OF_DATE_KHR)
+				return VK_NULL_HANDLE;
+
+			if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+				throw BackendError("Failed to acquire the next swapchain image!");
+
+			// The images can be acquired out of order, so the image might still be used by another frame in flight.
+			auto& image = m_SwapchainImages[m_ImageIndex];
+			if (image.m_InFlightFence != VK_NULL_HANDLE && image.m_InFlightFence != frame.m_InFlightFence)
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkWaitForFences(pInstance->getLogicalDevice(), 1, &image.m_InFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max()), "Failed to wait for the image fence!");
+
+			image.m_InFlightFence = frame.m_InFlightFence;
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkResetFences(pInstance->getLogicalDevice(), 1, &frame.m_InFlightFence), "Failed to reset the frame fence!");
+
+			// Begin the command buffer.
+			VkCommandBufferBeginInfo beginInfo = {};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.pNext = VK_NULL_HANDLE;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			beginInfo.pInheritanceInfo = VK_NULL_HANDLE;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkBeginCommandBuffer(frame.m_CommandBuffer, &beginInfo), "Failed to begin the frame command buffer!");
+			return frame.m_CommandBuffer;
+		}
+
+		void VulkanWindow::endFrame()
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			auto& frame = m_Frames[m_FrameIndex];
+			const auto& image = m_SwapchainImages[m_ImageIndex];
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkEndCommandBuffer(frame.m_CommandBuffer), "Failed to end the frame command buffer!");
+
+			// Submit the frame. The image is written by either a render pass or a transfer, which need to wait till it's acquired.
+			const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+			VkSubmitInfo submitInfo = {};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.pNext = VK_NULL_HANDLE;
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &frame.m_ImageAvailableSemaphore;
+			submitInfo.pWaitDstStageMask = &waitStageMask;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &frame.m_CommandBuffer;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &image.m_RenderFinishedSemaphore;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkQueueSubmit(pInstance->getGraphicsQueue().m_Queue, 1, &submitInfo, frame.m_InFlightFence), "Failed to submit the frame!");
+			m_FrameCount++;
+
+			// The frame shows all the input polled since the last present.
+			frame.m_InputTime = m_PendingInputTime;
+			m_PendingInputTime = {};
+			frame.m_PresentID = ++m_PresentID;
+
+			// Queue the image for presentation.
+			VkPresentIdKHR presentId = {};
+			presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+			presentId.pNext = VK_NULL_HANDLE;
+			presentId.swapchainCount = 1;
+			presentId.pPresentIds = &frame.m_PresentID;
+
+			VkPresentInfoKHR presentInfo = {};
+			presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+			presentInfo.pNext = m_IsPresentWaitEnabled ? &presentId : VK_NULL_HANDLE;
+			presentInfo.waitSemaphoreCount = 1;
+			presentInfo.pWaitSemaphores = &image.m_RenderFinishedSemaphore;
+			presentInfo.swapchainCount = 1;
+			presentInfo.pSwapchains = &m_Swapchain;
+			presentInfo.pImageIndices = &m_ImageIndex;
+			presentInfo.pResults = VK_NULL_HANDLE;
+
+			// The image is released even if the swapchain is out of date, so it's recreated by the next frame.
+			const auto result = pInstance->getDeviceTable().vkQueuePresentKHR(pInstance->getGraphicsQueue().m_Queue, &presentInfo);
+			if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+				m_IsSwapchainOutdated = true;
+
+			else if (result != VK_SUCCESS)
+				throw BackendError("Failed to present the swapchain image!");
+
+			m_FrameIndex = (m_FrameIndex + 1) % static_cast<uint32_t>(m_Frames.size());
+		}
+
+		void VulkanWindow::measureLatency(Frame& frame)
+		{
+			if (frame.m_InputTime == std::chrono::steady_clock::time_point())
+				return;
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			// Presents to a retired swapchain cannot be waited on, so they fall back to the fence.
+			const auto result = m_IsPresentWaitEnabled && frame.m_PresentID > m_RetiredPresentID
+				? pInstance->getDeviceTable().vkWaitForPresentKHR(pInstance->getLogicalDevice(), m_Swapchain, frame.m_PresentID, 0)
+				: pInstance->getDeviceTable().vkGetFenceStatus(pInstance->getLogicalDevice(), frame.m_InFlightFence);
+
+			// The frame is not shown yet.
+			if (result == VK_TIMEOUT || result == VK_NOT_READY)
+				return;
+
+			// Frames lost to an out of date swapchain are not measured.
+			if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+			{
+				const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frame.m_InputTime);
+				const auto nanoseconds = static_cast<double>(latency.count());
+
+				m_LastLatency = latency;
+				m_AverageLatency = m_LatencySampleCount == 0 ? nanoseconds : m_AverageLatency * 0.9 + nanoseconds * 0.1;
+				m_LatencySampleCount++;
+			}
+
+			frame.m_InputTime = {};
+		}
+
+		void VulkanWindow::present(const Layer& layer)
+		{
+			present(layer.getRenderTarget());
+		}
+
+		void VulkanWindow::present(const RenderTarget& renderTarget)
+		{
+			if (renderTarget.getInstance() != getInstance())
+				throw BackendError("The render target must be created using the window's instance!");
+
+			// Multisampled images cannot be blitted.
+			if (renderTarget.getAntiAliasing() != AntiAliasing::X1)
+				throw BackendError("Presenting a render target requires the anti-aliasing to be x1!");
+
+			if (!m_CanBlitToSwapchain)
+				throw BackendError("The swapchain format cannot be blitted to!");
+
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			const auto pRenderTarget = renderTarget.as<VulkanRenderTarget>();
+			const auto sourceImage = pRenderTarget->getColorImage();
+			const auto sourceLayout = pRenderTarget->getColorImageLayout();
+			const auto commandBuffer = beginFrame();
+			if (commandBuffer == VK_NULL_HANDLE)
+				return;
+
+			const auto destinationImage = getCurrentImage();
+
+			// The render target's last pass wrote the image, which is already in a layout the image can be blitted from.
+			VkMemoryBarrier memoryBarrier = {};
+			memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			memoryBarrier.pNext = VK_NULL_HANDLE;
+			memoryBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+			pInstance->getDeviceTable().vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+			pInstance->changeImageLayout(commandBuffer, destinationImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+
+			const auto width = std::min(renderTarget.getWidth(), m_Width);
+			const auto height = std::min(renderTarget.getHeight(), m_Height);
+
+			// Clear the window if the image doesn't cover it.
+			if (width < m_Width || height < m_Height)
+			{
+				VkClearColorValue clearColor = {};
+				clearColor.float32[3] = 1.0f;
+
+				VkImageSubresourceRange subresourceRange = {};
+				subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				subresourceRange.baseMipLevel = 0;
+				subresourceRange.levelCount = 1;
+				subresourceRange.baseArrayLayer = 0;
+				subresourceRange.layerCount = 1;
+
+				pInstance->getDeviceTable().vkCmdClearColorImage(commandBuffer, destinationImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &subresourceRange);
+				pInstance->changeImageLayout(commandBuffer, destinationImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT);
+			}
+
+			// Blit the image rather than copying it, since the swapchain's channel order can be different.
+			if (width > 0 && height > 0)
+			{
+				VkImageBlit imageBlit = {};
+				imageBlit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				imageBlit.srcSubresource.mipLevel = 0;
+				imageBlit.srcSubresource.baseArrayLayer = 0;
+				imageBlit.srcSubresource.layerCount = 1;
+				imageBlit.srcOffsets[0] = { 0, 0, 0 };
+				imageBlit.srcOffsets[1] = { static_cast<int32_t>(width), static_cast<int32_t>(height), 1 };
+				imageBlit.dstSubresource = imageBlit.srcSubresource;
+				imageBlit.dstOffsets[0] = imageBlit.srcOffsets[0];
+				imageBlit.dstOffsets[1] = imageBlit.srcOffsets[1];
+
+				pInstance->getDeviceTable().vkCmdBlitImage(commandBuffer, sourceImage, sourceLayout, destinationImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_NEAREST);
+			}
+
+			pInstance->changeImageLayout(commandBuffer, destinationImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_ASPECT_COLOR_BIT);
+			endFrame();
+		}
+
 		void VulkanWindow::refreshExtent()
 		{
 			int32_t width = 0, height = 0;
@@ -100,14 +498,33 @@ namespace minte
 			m_Height = height;
 		}
 
-		void VulkanWindow::setupSwapchain()
+		void VulkanWindow::setupSwapchain(VkSwapchainKHR oldSwapchain /*= VK_NULL_HANDLE*/)
 		{
 			const auto pInstance = getInstance()->as<VulkanInstance>();
 
+			// The images are presented using the graphics queue.
+			VkBool32 bPresentSupported = VK_FALSE;
+			MINTE_VK_ASSERT(vkGetPhysicalDeviceSurfaceSupportKHR(pInstance->getPhysicalDevice(), pInstance->getGraphicsQueue().m_Family, m_Surface, &bPresentSupported), "Failed to check the surface support!");
+
+			if (bPresentSupported == VK_FALSE)
+				throw BackendError("The graphics queue cannot present to the window surface!");
+
 			// Get the surface capabilities.
 			VkSurfaceCapabilitiesKHR surfaceCapabilities = {};
 			MINTE_VK_ASSERT(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(pInstance->getPhysicalDevice(), m_Surface, &surfaceCapabilities), "Failed to get the surface capabilities!");
 
+			// The swapchain has to match the surface's extent, unless the surface lets the swapchain decide it.
+			if (surfaceCapabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
+			{
+				m_Width = surfaceCapabilities.currentExtent.width;
+				m_Height = surfaceCapabilities.currentExtent.height;
+			}
+			else
+			{
+				m_Width = std::clamp(m_Width, surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width);
+				m_Height = std::clamp(m_Height, surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height);
+			}
+
 			// Get the surface formats.
 			uint32_t formatCount = 0;
 			MINTE_VK_ASSERT(vkGetPhysicalDeviceSurfaceFormatsKHR(pInstance->getPhysicalDevice(), m_Surface, &formatCount, VK_NULL_HANDLE), "Failed to get the surface format count!");
@@ -128,21 +545,7 @@ namespace minte
 			std::vector<VkPresentModeKHR> presentModes(presentModeCount);
 			MINTE_VK_ASSERT(vkGetPhysicalDeviceSurfacePresentModesKHR(pInstance->getPhysicalDevice(), m_Surface, &presentModeCount, presentModes.data()), "Failed to get the surface present modes!");
 
-			// Check if we have the present mode we need.
-			bool bPresentModeAvailable = false;
-			VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
-			for (const auto availablePresentMode : presentModes)
-			{
-				if (availablePresentMode == presentMode)
-				{
-					bPresentModeAvailable = true;
-					break;
-				}
-			}
-
-			// If not available, let's just use the first one we got.
-			if (!bPresentModeAvailable)
-				presentMode = presentModes.front();
+			m_PresentMode = GetPresentMode(m_PresentPolicy, presentModes);
 
 			// Resolve the surface composite.
 			VkCompositeAlphaFlagBitsKHR surfaceComposite = static_cast<VkCompositeAlphaFlagBitsKHR>(surfaceCapabilities.supportedCompositeAlpha);
@@ -164,13 +567,24 @@ namespace minte
 
 			m_SwapchainFormat = surfaceFormat.format;
 
+			// Render targets are blitted to the swapchain images, which the surface format might not support.
+			VkFormatProperties formatProperties = {};
+			vkGetPhysicalDeviceFormatProperties(pInstance->getPhysicalDevice(), m_SwapchainFormat, &formatProperties);
+			m_CanBlitToSwapchain = formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT;
+
+			// Use one more image than the minimum, so that we don't have to wait for the presentation engine to release one. Power saving uses
+			// the minimum, as it waits for the display anyway. A maximum of 0 means there isn't one.
+			auto imageCount = m_PresentPolicy == PresentPolicy::PowerSaving ? surfaceCapabilities.minImageCount : surfaceCapabilities.minImageCount + 1;
+			if (surfaceCapabilities.maxImageCount > 0)
+				imageCount = std::min(imageCount, surfaceCapabilities.maxImageCount);
+
 			// Create the swap chain.
 			VkSwapchainCreateInfoKHR swapchainCreateInfo = {};
 			swapchainCreateInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
 			swapchainCreateInfo.pNext = VK_NULL_HANDLE;
 			swapchainCreateInfo.flags = 0;
 			swapchainCreateInfo.surface = m_Surface;
-			swapchainCreateInfo.minImageCount = 1;
+			swapchainCreateInfo.minImageCount = imageCount;
 			swapchainCreateInfo.imageFormat = m_SwapchainFormat;
 			swapchainCreateInfo.imageColorSpace = surfaceFormat.colorSpace;
 			swapchainCreateInfo.imageExtent.width = m_Width;
@@ -182,9 +596,9 @@ namespace minte
 			swapchainCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
 			swapchainCreateInfo.preTransform = surfaceCapabilities.currentTransform;
 			swapchainCreateInfo.compositeAlpha = surfaceComposite;
-			swapchainCreateInfo.presentMode = presentMode;
+			swapchainCreateInfo.presentMode = m_PresentMode;
 			swapchainCreateInfo.clipped = VK_TRUE;
-			swapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
+			swapchainCreateInfo.oldSwapchain = oldSwapchain;
 
 			// Resolve the queue families if the two queues are different.
 			std::array<uint32_t, 2> queueFamilyindices = {
@@ -201,10 +615,13 @@ namespace minte
 
 			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSwapchainKHR(pInstance->getLogicalDevice(), &swapchainCreateInfo, VK_NULL_HANDLE, &m_Swapchain), "Failed to create the swapchain!");
 
-			// Get the image.
-			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkGetSwapchainImagesKHR(pInstance->getLogicalDevice(), m_Swapchain, &swapchainCreateInfo.minImageCount, &m_SwapchainImage), "Failed to get the swapchain images!");
+			// Get the images. The implementation can create more than we asked for.
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkGetSwapchainImagesKHR(pInstance->getLogicalDevice(), m_Swapchain, &imageCount, VK_NULL_HANDLE), "Failed to get the swapchain image count!");
+
+			std::vector<VkImage> images(imageCount);
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkGetSwapchainImagesKHR(pInstance->getLogicalDevice(), m_Swapchain, &imageCount, images.data()), "Failed to get the swapchain images!");
 
-			// Create image views.
+			// Create the image views and the semaphores.
 			VkImageViewCreateInfo viewCreateInfo = {};
 			viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 			viewCreateInfo.pNext = VK_NULL_HANDLE;
@@ -218,14 +635,98 @@ namespace minte
 			viewCreateInfo.subresourceRange.baseArrayLayer = 0;
 			viewCreateInfo.subresourceRange.layerCount = 1;
 
-			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateImageView(pInstance->getLogicalDevice(), &viewCreateInfo, VK_NULL_HANDLE, &m_SwapchainImageView), "Failed to create the swapchain image view!");
+			VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+			semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreCreateInfo.pNext = VK_NULL_HANDLE;
+			semaphoreCreateInfo.flags = 0;
+
+			m_SwapchainImages.resize(imageCount);
+			for (uint32_t i = 0; i < imageCount; i++)
+			{
+				auto& image = m_SwapchainImages[i];
+				image.m_Image = images[i];
+				viewCreateInfo.image = images[i];
+
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateImageView(pInstance->getLogicalDevice(), &viewCreateInfo, VK_NULL_HANDLE, &image.m_ImageView), "Failed to create the swapchain image view!");
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSemaphore(pInstance->getLogicalDevice(), &semaphoreCreateInfo, VK_NULL_HANDLE, &image.m_RenderFinishedSemaphore), "Failed to create the render finished semaphore!");
+			}
 		}
 
-		void VulkanWindow::clearSwapchain()
+		bool VulkanWindow::recreateSwapchain()
 		{
 			const auto pInstance = getInstance()->as<VulkanInstance>();
-			pInstance->getDeviceTable().vkDestroyImageView(pInstance->getLogicalDevice(), m_SwapchainImageView, VK_NULL_HANDLE);
-			pInstance->getDeviceTable().vkDestroySwapchainKHR(pInstance->getLogicalDevice(), m_Swapchain, VK_NULL_HANDLE);
+
+			// A minimized window has no extent, so the swapchain stays out of date till it's restored. Nothing is drawn till then, so wait for the
+			// window to be restored instead of returning right away. The event is left in the queue for pollEvents().
+			VkSurfaceCapabilitiesKHR surfaceCapabilities = {};
+			MINTE_VK_ASSERT(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(pInstance->getPhysicalDevice(), m_Surface, &surfaceCapabilities), "Failed to get the surface capabilities!");
+
+			refreshExtent();
+			if (m_Width == 0 || m_Height == 0 || surfaceCapabilities.currentExtent.width == 0 || surfaceCapabilities.currentExtent.height == 0)
+			{
+				SDL_WaitEventTimeout(nullptr, MinimizedWaitTimeout);
+				m_IsSwapchainOutdated = true;
+				return false;
+			}
+
+			// The frames in flight and the presentation engine can still use the old images, so they are retired instead of destroyed.
+			auto& retiredSwapchain = m_RetiredSwapchains.emplace_back();
+			retiredSwapchain.m_Images = std::move(m_SwapchainImages);
+			retiredSwapchain.m_Swapchain = m_Swapchain;
+			retiredSwapchain.m_FrameCount = m_FrameCount;
+
+			m_SwapchainImages.clear();
+			m_Swapchain = VK_NULL_HANDLE;
+
+			setupSwapchain(retiredSwapchain.m_Swapchain);
+			setupFramebuffers();
+
+			m_RetiredPresentID = m_PresentID;
+			m_IsSwapchainOutdated = false;
+			return true;
+		}
+
+		void VulkanWindow::releaseRetiredSwapchains()
+		{
+			// The frames submitted before a swapchain was retired are done once every frame in flight was waited on after them. One more frame
+			// is waited for, so the presentation engine is done with the last image as well.
+			const auto framesInFlight = static_cast<uint64_t>(m_Frames.size());
+			const auto itr = std::remove_if(m_RetiredSwapchains.begin(), m_RetiredSwapchains.end(), [this, framesInFlight](const RetiredSwapchain& retiredSwapchain)
+				{
+					if (retiredSwapchain.m_FrameCount + framesInFlight > m_FrameCount)
+						return false;
+
+					destroySwapchain(retiredSwapchain.m_Swapchain, retiredSwapchain.m_Images);
+					return true;
+				}
+			);
+
+			m_RetiredSwapchains.erase(itr, m_RetiredSwapchains.end());
+		}
+
+		void VulkanWindow::destroySwapchain(VkSwapchainKHR swapchain, const std::vector<SwapchainImage>& images) const
+		{
+			const auto pInstance = getInstance()->as<VulkanInstance>();
+			for (const auto& image : images)
+			{
+				pInstance->getDeviceTable().vkDestroyFramebuffer(pInstance->getLogicalDevice(), image.m_Framebuffer, VK_NULL_HANDLE);
+				pInstance->getDeviceTable().vkDestroyImageView(pInstance->getLogicalDevice(), image.m_ImageView, VK_NULL_HANDLE);
+				pInstance->getDeviceTable().vkDestroySemaphore(pInstance->getLogicalDevice(), image.m_RenderFinishedSemaphore, VK_NULL_HANDLE);
+			}
+
+			pInstance->getDeviceTable().vkDestroySwapchainKHR(pInstance->getLogicalDevice(), swapchain, VK_NULL_HANDLE);
+		}
+
+		void VulkanWindow::clearSwapchain()
+		{
+			for (const auto& retiredSwapchain : m_RetiredSwapchains)
+				destroySwapchain(retiredSwapchain.m_Swapchain, retiredSwapchain.m_Images);
+
+			destroySwapchain(m_Swapchain, m_SwapchainImages);
+
+			m_RetiredSwapchains.clear();
+			m_SwapchainImages.clear();
+			m_Swapchain = VK_NULL_HANDLE;
 		}
 
 		void VulkanWindow::setupRenderPass()
@@ -242,13 +743,14 @@ namespace minte
 			attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 			attachmentDescription.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
-			// Create the subpass dependencies.
+			// Create the subpass dependencies. The first one makes the layout transition wait for the acquire semaphore, which is waited on at
+			// the color attachment output stage.
 			std::array<VkSubpassDependency, 2> subpassDependencies = {};
 			subpassDependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
 			subpassDependencies[0].dstSubpass = 0;
-			subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 			subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-			subpassDependencies[0].srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+			subpassDependencies[0].srcAccessMask = 0;
 			subpassDependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 			subpassDependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
@@ -293,7 +795,7 @@ namespace minte
 			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateRenderPass(pInstance->getLogicalDevice(), &renderPassCreateInfo, VK_NULL_HANDLE, &m_RenderPass), "Failed to create render pass!");
 		}
 
-		void VulkanWindow::setupFramebuffer()
+		void VulkanWindow::setupFramebuffers()
 		{
 			VkFramebufferCreateInfo frameBufferCreateInfo = {};
 			frameBufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -304,22 +806,60 @@ namespace minte
 			frameBufferCreateInfo.width = m_Width;
 			frameBufferCreateInfo.height = m_Height;
 			frameBufferCreateInfo.layers = 1;
-			frameBufferCreateInfo.pAttachments = &m_SwapchainImageView;
 
 			const auto pInstance = getInstance()->as<VulkanInstance>();
-			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateFramebuffer(pInstance->getLogicalDevice(), &frameBufferCreateInfo, VK_NULL_HANDLE, &m_Framebuffer), "Failed to create the frame buffer!");
+			for (auto& image : m_SwapchainImages)
+			{
+				frameBufferCreateInfo.pAttachments = &image.m_ImageView;
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateFramebuffer(pInstance->getLogicalDevice(), &frameBufferCreateInfo, VK_NULL_HANDLE, &image.m_Framebuffer), "Failed to create the frame buffer!");
+			}
 		}
 
-		void VulkanWindow::setupSyncObjects()
+		void VulkanWindow::setupFrames(uint32_t framesInFlight)
 		{
-			VkSemaphoreCreateInfo createInfo = {};
-			createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-			createInfo.pNext = VK_NULL_HANDLE;
-			createInfo.flags = 0;
-
 			const auto pInstance = getInstance()->as<VulkanInstance>();
-			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSemaphore(pInstance->getLogicalDevice(), &createInfo, VK_NULL_HANDLE, &m_InFlightSemaphore), "Failed to create the in flight semaphore!");
-			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSemaphore(pInstance->getLogicalDevice(), &createInfo, VK_NULL_HANDLE, &m_RenderFinishedSemaphore), "Failed to create the render finished semaphore!");
+
+			// Create the command pool. The command buffers are reset every time they're begun.
+			VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+			commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			commandPoolCreateInfo.pNext = VK_NULL_HANDLE;
+			commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+			commandPoolCreateInfo.queueFamilyIndex = pInstance->getGraphicsQueue().m_Family;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateCommandPool(pInstance->getLogicalDevice(), &commandPoolCreateInfo, VK_NULL_HANDLE, &m_CommandPool), "Failed to create the window command pool!");
+
+			// Allocate the command buffers.
+			std::vector<VkCommandBuffer> commandBuffers(framesInFlight);
+
+			VkCommandBufferAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocateInfo.pNext = VK_NULL_HANDLE;
+			allocateInfo.commandPool = m_CommandPool;
+			allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocateInfo.commandBufferCount = framesInFlight;
+
+			MINTE_VK_ASSERT(pInstance->getDeviceTable().vkAllocateCommandBuffers(pInstance->getLogicalDevice(), &allocateInfo, commandBuffers.data()), "Failed to allocate the window command buffers!");
+
+			// Create the sync objects. The fences are created signaled, since the first wait on each of them has nothing to wait for.
+			VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+			semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreCreateInfo.pNext = VK_NULL_HANDLE;
+			semaphoreCreateInfo.flags = 0;
+
+			VkFenceCreateInfo fenceCreateInfo = {};
+			fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			fenceCreateInfo.pNext = VK_NULL_HANDLE;
+			fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+			m_Frames.resize(framesInFlight);
+			for (uint32_t i = 0; i < framesInFlight; i++)
+			{
+				auto& frame = m_Frames[i];
+				frame.m_CommandBuffer = commandBuffers[i];
+
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateSemaphore(pInstance->getLogicalDevice(), &semaphoreCreateInfo, VK_NULL_HANDLE, &frame.m_ImageAvailableSemaphore), "Failed to create the image available semaphore!");
+				MINTE_VK_ASSERT(pInstance->getDeviceTable().vkCreateFence(pInstance->getLogicalDevice(), &fenceCreateInfo, VK_NULL_HANDLE, &frame.m_InFlightFence), "Failed to create the frame fence!");
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,4 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
@@ -0,0 +1,4 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Checks/RasterCheck.hpp"
+#include "Checks/ParagraphLayoutCheck.hpp"
+#include "Checks/PathTessellatorCheck.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace /* anonymous */
+{
+	/**
+	 * The exit code which tells CTest that a check was skipped.
+	 */
+	constexpr int SkipReturnCode = 77;
+
+	/**
+	 * Print the result of a check.
+	 *
+	 * @param name The check name.
+	 * @param bPassed Whether the check passed.
+	 * @return The exit code.
+	 */
+	int Report(std::string_view name, bool bPassed)
+	{
+		std::cout << name << ": " << (bPassed ? "passed" : "failed") << std::endl;
+		return bPassed ? 0 : 1;
+	}
+}
+
+auto main(int argc, char** argv) -> int
+try
+{
+	const auto check = argc > 1 ? std::string_view(argv[1]) : std::string_view();
+
+	if (check == "cpu-raster")
+		return Report("CPU raster", CheckCpuRaster());
+
+	if (check == "path-tessellator")
+		return Report("Path tessellator", CheckPathTessellator());
+
+	// Fonts are not shipped with the repository, so the paragraph check is skipped when none is given.
+	if (check == "paragraph-layout")
+	{
+		if (argc < 3 || std::string_view(argv[2]).empty())
+		{
+			std::cout << "Paragraph layout: skipped, set MINTE_TEST_FONT to a font file to run it" << std::endl;
+			return SkipReturnCode;
+		}
+
+		return Report("Paragraph layout", CheckParagraphLayout(argv[2]));
+	}
+
+	std::cout << "Usage: MinteChecks cpu-raster | path-tessellator | paragraph-layout <font file>" << std::endl;
+	return 1;
+}
+catch (std::runtime_error& error)
+{
+	std::cout << "Error occurred: " << error.what() << std::endl;
+	return 1;
+}
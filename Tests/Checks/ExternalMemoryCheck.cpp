@@ -0,0 +1,255 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "ExternalMemoryCheck.hpp"
+
+#include "Minte/Backend/VulkanBackend/VulkanImageBuffer.hpp"
+#include "Minte/Backend/VulkanBackend/VulkanMacros.hpp"
+#include "Minte/Box.hpp"
+#include "Minte/Layer.hpp"
+#include "Minte/Minte.hpp"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace /* anonymous */
+{
+	/**
+	 * Import an exported image and copy it to a buffer.
+	 *
+	 * @param pInstance The instance to import the image to.
+	 * @param exportedImage The exported image. The file descriptor is consumed.
+	 * @param completionFileDescriptor The sync file descriptor to wait on before copying. It's consumed, and ignored if it's -1.
+	 * @return The buffer with the imported pixels.
+	 */
+	std::shared_ptr<minte::backend::VulkanImageBuffer> ImportImage(const std::shared_ptr<minte::backend::VulkanInstance>& pInstance, const minte::backend::VulkanExportedImage& exportedImage, int32_t completionFileDescriptor)
+	{
+		const auto& deviceTable = pInstance->getDeviceTable();
+		const auto logicalDevice = pInstance->getLogicalDevice();
+
+		// Create an image with the same parameters as the exported one.
+		VkExternalMemoryImageCreateInfo externalCreateInfo = {};
+		externalCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO;
+		externalCreateInfo.pNext = VK_NULL_HANDLE;
+		externalCreateInfo.handleTypes = exportedImage.m_HandleType;
+
+		VkImageCreateInfo imageCreateInfo = {};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.pNext = &externalCreateInfo;
+		imageCreateInfo.flags = 0;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = exportedImage.m_Format;
+		imageCreateInfo.extent = { exportedImage.m_Width, exportedImage.m_Height, 1 };
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = exportedImage.m_Tiling;
+		imageCreateInfo.usage = exportedImage.m_Usage;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.queueFamilyIndexCount = 0;
+		imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VkImage image = VK_NULL_HANDLE;
+		MINTE_VK_ASSERT(deviceTable.vkCreateImage(logicalDevice, &imageCreateInfo, VK_NULL_HANDLE, &image), "Failed to create the imported image!");
+
+		// Opaque file descriptors have to be imported to the exporter's memory type. Dma-bufs report the types they can be imported to.
+		uint32_t memoryTypeIndex = exportedImage.m_MemoryTypeIndex;
+		if (exportedImage.m_HandleType != VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT)
+		{
+			VkMemoryFdPropertiesKHR fdProperties = {};
+			fdProperties.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
+			fdProperties.pNext = VK_NULL_HANDLE;
+			MINTE_VK_ASSERT(deviceTable.vkGetMemoryFdPropertiesKHR(logicalDevice, exportedImage.m_HandleType, exportedImage.m_FileDescriptor, &fdProperties), "Failed to get the memory file descriptor properties!");
+
+			VkMemoryRequirements memoryRequirements = {};
+			deviceTable.vkGetImageMemoryRequirements(logicalDevice, image, &memoryRequirements);
+
+			const auto memoryTypeBits = memoryRequirements.memoryTypeBits & fdProperties.memoryTypeBits;
+			if (memoryTypeBits == 0)
+				throw minte::backend::BackendError("The exported image cannot be imported!");
+
+			memoryTypeIndex = static_cast<uint32_t>(std::countr_zero(memoryTypeBits));
+		}
+
+		// Import the memory. The exporter used a dedicated allocation, so the import has to be one as well.
+		VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo = {};
+		dedicatedAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		dedicatedAllocateInfo.pNext = VK_NULL_HANDLE;
+		dedicatedAllocateInfo.image = image;
+		dedicatedAllocateInfo.buffer = VK_NULL_HANDLE;
+
+		VkImportMemoryFdInfoKHR importInfo = {};
+		importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+		importInfo.pNext = &dedicatedAllocateInfo;
+		importInfo.handleType = exportedImage.m_HandleType;
+		importInfo.fd = exportedImage.m_FileDescriptor;
+
+		VkMemoryAllocateInfo allocateInfo = {};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocateInfo.pNext = &importInfo;
+		allocateInfo.allocationSize = exportedImage.m_Size;
+		allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		MINTE_VK_ASSERT(deviceTable.vkAllocateMemory(logicalDevice, &allocateInfo, VK_NULL_HANDLE, &memory), "Failed to import the exported image!");
+		MINTE_VK_ASSERT(deviceTable.vkBindImageMemory(logicalDevice, image, memory, 0), "Failed to bind the imported memory!");
+
+		// Import the completion file descriptor. Sync file descriptors can only be imported temporarily.
+		VkSemaphore semaphore = VK_NULL_HANDLE;
+		if (completionFileDescriptor != -1)
+		{
+			VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+			semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			semaphoreCreateInfo.pNext = VK_NULL_HANDLE;
+			semaphoreCreateInfo.flags = 0;
+			MINTE_VK_ASSERT(deviceTable.vkCreateSemaphore(logicalDevice, &semaphoreCreateInfo, VK_NULL_HANDLE, &semaphore), "Failed to create the completion semaphore!");
+
+			VkImportSemaphoreFdInfoKHR importSemaphoreInfo = {};
+			importSemaphoreInfo.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR;
+			importSemaphoreInfo.pNext = VK_NULL_HANDLE;
+			importSemaphoreInfo.semaphore = semaphore;
+			importSemaphoreInfo.flags = VK_SEMAPHORE_IMPORT_TEMPORARY_BIT;
+			importSemaphoreInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT;
+			importSemaphoreInfo.fd = completionFileDescriptor;
+			MINTE_VK_ASSERT(deviceTable.vkImportSemaphoreFdKHR(logicalDevice, &importSemaphoreInfo), "Failed to import the completion file descriptor!");
+		}
+
+		// Setup the command buffer.
+		VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolCreateInfo.pNext = VK_NULL_HANDLE;
+		commandPoolCreateInfo.flags = 0;
+		commandPoolCreateInfo.queueFamilyIndex = pInstance->getGraphicsQueue().m_Family;
+
+		VkCommandPool commandPool = VK_NULL_HANDLE;
+		MINTE_VK_ASSERT(deviceTable.vkCreateCommandPool(logicalDevice, &commandPoolCreateInfo, VK_NULL_HANDLE, &commandPool), "Failed to create the command pool!");
+
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.pNext = VK_NULL_HANDLE;
+		commandBufferAllocateInfo.commandPool = commandPool;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		MINTE_VK_ASSERT(deviceTable.vkAllocateCommandBuffers(logicalDevice, &commandBufferAllocateInfo, &commandBuffer), "Failed to allocate the command buffer!");
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.pNext = VK_NULL_HANDLE;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = VK_NULL_HANDLE;
+		MINTE_VK_ASSERT(deviceTable.vkBeginCommandBuffer(commandBuffer, &beginInfo), "Failed to begin the command buffer!");
+
+		// Acquire the image from the external queue family, which the render target released it to.
+		VkImageMemoryBarrier acquireBarrier = {};
+		acquireBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		acquireBarrier.pNext = VK_NULL_HANDLE;
+		acquireBarrier.srcAccessMask = 0;
+		acquireBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		acquireBarrier.oldLayout = exportedImage.m_Layout;
+		acquireBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		acquireBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_EXTERNAL;
+		acquireBarrier.dstQueueFamilyIndex = pInstance->getGraphicsQueue().m_Family;
+		acquireBarrier.image = image;
+		acquireBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		acquireBarrier.subresourceRange.baseMipLevel = 0;
+		acquireBarrier.subresourceRange.levelCount = 1;
+		acquireBarrier.subresourceRange.baseArrayLayer = 0;
+		acquireBarrier.subresourceRange.layerCount = 1;
+
+		deviceTable.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &acquireBarrier);
+
+		// Copy the image to a tightly packed buffer, the same way the render target reads it back.
+		auto pBuffer = std::make_shared<minte::backend::VulkanImageBuffer>(pInstance, static_cast<uint64_t>(exportedImage.m_Width) * exportedImage.m_Height * 4);
+
+		VkBufferImageCopy imageCopy = {};
+		imageCopy.bufferOffset = 0;
+		imageCopy.bufferRowLength = exportedImage.m_Width;
+		imageCopy.bufferImageHeight = exportedImage.m_Height;
+		imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageCopy.imageSubresource.mipLevel = 0;
+		imageCopy.imageSubresource.baseArrayLayer = 0;
+		imageCopy.imageSubresource.layerCount = 1;
+		imageCopy.imageOffset = { 0, 0, 0 };
+		imageCopy.imageExtent = { exportedImage.m_Width, exportedImage.m_Height, 1 };
+
+		deviceTable.vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, pBuffer->getBuffer(), 1, &imageCopy);
+
+		VkMemoryBarrier hostBarrier = {};
+		hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		hostBarrier.pNext = VK_NULL_HANDLE;
+		hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+		deviceTable.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+		MINTE_VK_ASSERT(deviceTable.vkEndCommandBuffer(commandBuffer), "Failed to end the command buffer!");
+
+		// Submit and wait till the copy is done.
+		VkFenceCreateInfo fenceCreateInfo = {};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCreateInfo.pNext = VK_NULL_HANDLE;
+		fenceCreateInfo.flags = 0;
+
+		VkFence fence = VK_NULL_HANDLE;
+		MINTE_VK_ASSERT(deviceTable.vkCreateFence(logicalDevice, &fenceCreateInfo, VK_NULL_HANDLE, &fence), "Failed to create the fence!");
+
+		const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = VK_NULL_HANDLE;
+		submitInfo.waitSemaphoreCount = semaphore != VK_NULL_HANDLE ? 1 : 0;
+		submitInfo.pWaitSemaphores = &semaphore;
+		submitInfo.pWaitDstStageMask = &waitStageMask;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		submitInfo.signalSemaphoreCount = 0;
+		submitInfo.pSignalSemaphores = VK_NULL_HANDLE;
+
+		MINTE_VK_ASSERT(deviceTable.vkQueueSubmit(pInstance->getGraphicsQueue().m_Queue, 1, &submitInfo, fence), "Failed to submit the queue!");
+		MINTE_VK_ASSERT(deviceTable.vkWaitForFences(logicalDevice, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max()), "Failed to wait for the fence!");
+
+		// Destroy everything but the buffer.
+		deviceTable.vkDestroyFence(logicalDevice, fence, VK_NULL_HANDLE);
+		deviceTable.vkDestroyCommandPool(logicalDevice, commandPool, VK_NULL_HANDLE);
+		deviceTable.vkDestroySemaphore(logicalDevice, semaphore, VK_NULL_HANDLE);
+		deviceTable.vkDestroyImage(logicalDevice, image, VK_NULL_HANDLE);
+		deviceTable.vkFreeMemory(logicalDevice, memory, VK_NULL_HANDLE);
+
+		return pBuffer;
+	}
+}
+
+bool CheckExternalMemory(minte::backend::VulkanExternalMemory type)
+{
+	constexpr uint32_t width = 64;
+	constexpr uint32_t height = 64;
+
+	// The importer is a second logical device, so nothing is shared with the exporter but the file descriptors.
+	const auto pExporter = std::make_shared<minte::backend::VulkanInstance>();
+	const auto pImporter = std::make_shared<minte::backend::VulkanInstance>();
+
+	auto pRenderTarget = std::make_unique<minte::backend::VulkanRenderTarget>(pExporter, width, height);
+	pRenderTarget->setExternalMemory(type);
+
+	const auto pVulkanRenderTarget = pRenderTarget.get();
+	auto layer = minte::Layer(minte::Minte(pExporter), std::move(pRenderTarget));
+
+	// Draw a box over part of the render target, so both the box and the cleared pixels are compared.
+	const auto pBox = layer.createDrawable<minte::Box>(minte::Point2D<float>(32.0f, 16.0f), 0xFF4080C0u);
+	pBox->setPosition(minte::Point2D<float>(8.0f, 24.0f));
+
+	const auto output = layer.update();
+	const auto pImportedBuffer = ImportImage(pImporter, pVulkanRenderTarget->exportColorImage(), pVulkanRenderTarget->takeCompletionFileDescriptor());
+
+	const auto pDrawnPixels = output.m_pColorBuffer->mapMemory();
+	const auto pImportedPixels = pImportedBuffer->mapMemory();
+	const bool bMatches = std::memcmp(pDrawnPixels, pImportedPixels, static_cast<size_t>(width) * height * 4) == 0;
+
+	output.m_pColorBuffer->unmapMemory();
+	pImportedBuffer->unmapMemory();
+
+	return bMatches;
+}
@@ -0,0 +1,15 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include "Minte/Backend/VulkanBackend/VulkanRenderTarget.hpp"
+
+/**
+ * Check if an exported color attachment can be imported.
+ * A box is drawn to an exported render target, whose color image is imported into a second logical device, copied to a buffer and compared
+ * against the render target's own readback. The copy waits on the render target's completion file descriptor if there is one.
+ *
+ * @param type The external memory type to check.
+ * @return Whether the imported pixels match the drawn ones.
+ */
+[[nodiscard]] bool CheckExternalMemory(minte::backend::VulkanExternalMemory type);
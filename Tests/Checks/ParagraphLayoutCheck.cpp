@@ -0,0 +1,109 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "ParagraphLayoutCheck.hpp"
+
+#include "Minte/TextLayout.hpp"
+
+#include <array>
+#include <iostream>
+#include <random>
+#include <string_view>
+
+namespace /* anonymous */
+{
+	constexpr float FontSize = 16.0f;
+
+	/**
+	 * Check if two layouts have the same glyphs and lines.
+	 *
+	 * @param edited The layout of the edited paragraph.
+	 * @param fresh The layout of the fresh paragraph.
+	 * @return Whether the layouts are the same.
+	 */
+	bool IsSameLayout(const minte::TextLayout& edited, const minte::TextLayout& fresh)
+	{
+		if (edited.m_Glyphs.size() != fresh.m_Glyphs.size() || edited.m_Lines.size() != fresh.m_Lines.size())
+		{
+			std::cout << "The edited layout has " << edited.m_Glyphs.size() << " glyphs in " << edited.m_Lines.size() << " lines, expected " << fresh.m_Glyphs.size() << " glyphs in " << fresh.m_Lines.size() << " lines." << std::endl;
+			return false;
+		}
+
+		for (size_t i = 0; i < edited.m_Glyphs.size(); i++)
+		{
+			const auto& lhs = edited.m_Glyphs[i];
+			const auto& rhs = fresh.m_Glyphs[i];
+			if (lhs.m_GlyphIndex != rhs.m_GlyphIndex || lhs.m_Offset != rhs.m_Offset || lhs.m_Advance != rhs.m_Advance || lhs.m_Flags != rhs.m_Flags)
+			{
+				std::cout << "Glyph " << i << " of the edited layout differs." << std::endl;
+				return false;
+			}
+		}
+
+		for (size_t i = 0; i < edited.m_Lines.size(); i++)
+		{
+			const auto& lhs = edited.m_Lines[i];
+			const auto& rhs = fresh.m_Lines[i];
+			if (lhs.m_FirstGlyph != rhs.m_FirstGlyph || lhs.m_GlyphCount != rhs.m_GlyphCount || lhs.m_Width != rhs.m_Width)
+			{
+				std::cout << "Line " << i << " of the edited layout differs." << std::endl;
+				return false;
+			}
+		}
+
+		if (edited.m_Size.m_X != fresh.m_Size.m_X || edited.m_Size.m_Y != fresh.m_Size.m_Y)
+		{
+			std::cout << "The size of the edited layout differs." << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+}
+
+bool CheckParagraphLayout(const std::filesystem::path& fontPath)
+{
+	const auto pFont = std::make_shared<minte::Font>(fontPath);
+
+	// The pieces contain spaces, line feeds, kerning pairs and multi-byte code points.
+	constexpr std::array<std::string_view, 10> Pieces = { "word ", "AV", "To", " ", "\n", "longer words ", "\xC3\xA9t\xC3\xA9 ", "\xE6\x97\xA5\xE6\x9C\xAC", "x", "  " };
+
+	std::mt19937 generator(3);
+	for (const auto wrapWidth : { 0.0f, 60.0f, 200.0f })
+	{
+		auto paragraph = minte::ParagraphLayout(pFont, FontSize, wrapWidth);
+		std::vector<uint32_t> boundaries = { 0 };	// The byte offsets of the code point boundaries.
+
+		for (uint32_t edit = 0; edit < 500; edit++)
+		{
+			// Replace a random range of code points with a few random pieces.
+			const auto first = generator() % boundaries.size();
+			const auto last = std::min<size_t>(first + generator() % 4, boundaries.size() - 1);
+
+			std::string text;
+			for (auto count = generator() % 3; count > 0; count--)
+				text += Pieces[generator() % Pieces.size()];
+
+			paragraph.replace(boundaries[first], boundaries[last] - boundaries[first], text);
+
+			boundaries.clear();
+			for (uint32_t offset = 0; offset < paragraph.getText().size(); offset++)
+			{
+				if ((static_cast<uint8_t>(paragraph.getText()[offset]) & 0xC0) != 0x80)
+					boundaries.emplace_back(offset);
+			}
+
+			boundaries.emplace_back(static_cast<uint32_t>(paragraph.getText().size()));
+
+			auto freshParagraph = minte::ParagraphLayout(pFont, FontSize, wrapWidth);
+			freshParagraph.setText(paragraph.getText());
+
+			if (!IsSameLayout(paragraph.getLayout(), freshParagraph.getLayout()))
+			{
+				std::cout << "Edit " << edit << " with the wrap width " << wrapWidth << " did not match a fresh layout." << std::endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
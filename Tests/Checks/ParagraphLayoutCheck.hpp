@@ -0,0 +1,14 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+#include <filesystem>
+
+/**
+ * Check the incremental paragraph layout against a fresh layout.
+ * Random edits are applied to a paragraph, and after each edit its glyphs and lines are compared to a paragraph laid out from the edited text.
+ *
+ * @param fontPath The font file to lay the text out with.
+ * @return Whether every edited layout matches the fresh one.
+ */
+[[nodiscard]] bool CheckParagraphLayout(const std::filesystem::path& fontPath);
@@ -0,0 +1,136 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "PathTessellatorCheck.hpp"
+
+#include "Minte/PathTessellator.hpp"
+
+#include <iostream>
+#include <random>
+
+namespace /* anonymous */
+{
+	using Contour = std::vector<minte::Point2D_F32>;
+
+	/**
+	 * Compute the winding number of the contours around a point.
+	 *
+	 * @param contours The closed contours.
+	 * @param x The X coordinate of the point.
+	 * @param y The Y coordinate of the point.
+	 * @return The winding number.
+	 */
+	int32_t GetWindingNumber(const std::vector<Contour>& contours, double x, double y)
+	{
+		int32_t winding = 0;
+		for (const auto& contour : contours)
+		{
+			for (size_t i = 0; i < contour.size(); i++)
+			{
+				const auto& first = contour[i];
+				const auto& second = contour[(i + 1) % contour.size()];
+				const auto side = (static_cast<double>(second.m_X) - first.m_X) * (y - first.m_Y) - (static_cast<double>(second.m_Y) - first.m_Y) * (x - first.m_X);
+
+				if (first.m_Y <= y && second.m_Y > y && side > 0.0)
+					winding++;
+
+				else if (first.m_Y > y && second.m_Y <= y && side < 0.0)
+					winding--;
+			}
+		}
+
+		return winding;
+	}
+
+	/**
+	 * Count the triangles covering a point.
+	 *
+	 * @param vertices The tessellated vertices.
+	 * @param indices The tessellated indices.
+	 * @param x The X coordinate of the point.
+	 * @param y The Y coordinate of the point.
+	 * @return The number of triangles which are not degenerate and contain the point.
+	 */
+	uint32_t GetCoverCount(const std::vector<minte::Vertex>& vertices, const std::vector<minte::Index>& indices, double x, double y)
+	{
+		uint32_t count = 0;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const auto& first = vertices[indices[i]].m_Position;
+			const auto& second = vertices[indices[i + 1]].m_Position;
+			const auto& third = vertices[indices[i + 2]].m_Position;
+
+			const auto getSide = [x, y](const minte::Point2D_F32& start, const minte::Point2D_F32& end)
+			{
+				return (static_cast<double>(end.m_X) - start.m_X) * (y - start.m_Y) - (static_cast<double>(end.m_Y) - start.m_Y) * (x - start.m_X);
+			};
+
+			const auto area = (static_cast<double>(second.m_X) - first.m_X) * (static_cast<double>(third.m_Y) - first.m_Y) - (static_cast<double>(second.m_Y) - first.m_Y) * (static_cast<double>(third.m_X) - first.m_X);
+			if (std::abs(area) < 1e-9)
+				continue;
+
+			const auto firstSide = getSide(first, second);
+			const auto secondSide = getSide(second, third);
+			const auto thirdSide = getSide(third, first);
+
+			const bool bNegative = firstSide < 0.0 || secondSide < 0.0 || thirdSide < 0.0;
+			const bool bPositive = firstSide > 0.0 || secondSide > 0.0 || thirdSide > 0.0;
+			if (!(bNegative && bPositive))
+				count++;
+		}
+
+		return count;
+	}
+}
+
+bool CheckPathTessellator()
+{
+	auto tessellator = minte::PathTessellator();
+	std::vector<minte::Vertex> vertices;
+	std::vector<minte::Index> indices;
+
+	std::mt19937 generator(4);
+	for (uint32_t iteration = 0; iteration < 1000; iteration++)
+	{
+		// The points are on an integer grid, so the contours have plenty of collinear edges and shared points.
+		minte::Path path;
+		std::vector<Contour> contours(1 + generator() % 3);
+		for (auto& contour : contours)
+		{
+			contour.resize(3 + generator() % 8);
+			for (auto& point : contour)
+				point = minte::Point2D_F32(static_cast<float>(generator() % 100), static_cast<float>(generator() % 100));
+
+			path.moveTo(contour.front());
+			for (size_t i = 1; i < contour.size(); i++)
+				path.lineTo(contour[i]);
+
+			path.close();
+		}
+
+		for (const auto fillRule : { minte::FillRule::NonZero, minte::FillRule::EvenOdd })
+		{
+			vertices.clear();
+			indices.clear();
+			tessellator.fill(path, fillRule, 0xFFFFFFFF, vertices, indices);
+
+			// The samples are nudged off the grid so that they never land on an edge.
+			for (uint32_t sample = 0; sample < 200; sample++)
+			{
+				const auto x = (generator() % 100000) / 1000.0 + 0.0003;
+				const auto y = (generator() % 100000) / 1000.0 + 0.0007;
+
+				const auto winding = GetWindingNumber(contours, x, y);
+				const bool bInside = fillRule == minte::FillRule::NonZero ? winding != 0 : (winding & 1) != 0;
+				const auto count = GetCoverCount(vertices, indices, x, y);
+
+				if (count != (bInside ? 1 : 0))
+				{
+					std::cout << "Iteration " << iteration << " covered (" << x << ", " << y << ") " << count << " times with the winding number " << winding << "." << std::endl;
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
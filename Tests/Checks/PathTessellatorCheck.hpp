@@ -0,0 +1,12 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+/**
+ * Check the path fills against the winding number.
+ * Random polygons with multiple contours are filled with both fill rules, and random points are checked to be covered by exactly one triangle
+ * if the winding number of the contours puts them inside, and by none otherwise.
+ *
+ * @return Whether every sampled point matches the fill rule.
+ */
+[[nodiscard]] bool CheckPathTessellator();
@@ -0,0 +1,299 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "RasterCheck.hpp"
+
+#include "Minte/Backend/CpuBackend/CpuRenderTarget.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+namespace /* anonymous */
+{
+	constexpr uint32_t Width = 160;
+	constexpr uint32_t Height = 120;
+
+	/**
+	 * Reference triangle structure.
+	 */
+	struct ReferenceTriangle final
+	{
+		std::array<minte::Point2D_F32, 3> m_Points;
+		uint32_t m_Color = 0;
+		uint32_t m_EntityID = 0;
+	};
+
+	/**
+	 * Pixel coverage enum.
+	 */
+	enum class Coverage : uint8_t
+	{
+		Outside,
+		Edge,	// The pixel center is exactly on an edge.
+		Inside
+	};
+
+	/**
+	 * Find how a triangle covers a pixel's center.
+	 *
+	 * @param triangle The triangle.
+	 * @param x The X coordinate of the pixel.
+	 * @param y The Y coordinate of the pixel.
+	 * @return The coverage.
+	 */
+	Coverage GetCoverage(const ReferenceTriangle& triangle, uint32_t x, uint32_t y)
+	{
+		const auto& points = triangle.m_Points;
+		const auto area = (static_cast<double>(points[1].m_X) - points[0].m_X) * (static_cast<double>(points[2].m_Y) - points[0].m_Y) - (static_cast<double>(points[1].m_Y) - points[0].m_Y) * (static_cast<double>(points[2].m_X) - points[0].m_X);
+		if (area == 0.0)
+			return Coverage::Outside;
+
+		bool bOnEdge = false;
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			const auto& first = points[i];
+			const auto& second = points[(i + 1) % 3];
+			const auto edge = (static_cast<double>(second.m_X) - first.m_X) * (y + 0.5 - first.m_Y) - (static_cast<double>(second.m_Y) - first.m_Y) * (x + 0.5 - first.m_X);
+			if (edge == 0.0)
+				bOnEdge = true;
+
+			else if ((edge > 0.0) != (area > 0.0))
+				return Coverage::Outside;
+		}
+
+		return bOnEdge ? Coverage::Edge : Coverage::Inside;
+	}
+
+	/**
+	 * Copy the pixels out of an image buffer.
+	 *
+	 * @param pBuffer The image buffer.
+	 * @return The pixels.
+	 */
+	std::vector<uint32_t> ReadPixels(const std::shared_ptr<minte::backend::ImageBuffer>& pBuffer)
+	{
+		std::vector<uint32_t> pixels(pBuffer->getSize() / sizeof(uint32_t));
+		std::memcpy(pixels.data(), pBuffer->mapMemory(), pixels.size() * sizeof(uint32_t));
+		pBuffer->unmapMemory();
+
+		return pixels;
+	}
+
+	/**
+	 * Draw the triangles.
+	 * The first half is drawn by a command which is opaque if all of its triangles are, and the second half by a translucent command.
+	 *
+	 * @param renderTarget The render target.
+	 * @param triangles The triangles.
+	 */
+	void DrawTriangles(minte::backend::RenderTarget& renderTarget, const std::vector<ReferenceTriangle>& triangles)
+	{
+		std::vector<minte::Vertex> vertices;
+		std::vector<minte::Index> indices;
+		for (const auto& triangle : triangles)
+		{
+			for (const auto& point : triangle.m_Points)
+			{
+				auto& vertex = vertices.emplace_back();
+				vertex.m_Position = point;
+				vertex.m_Color = triangle.m_Color;
+				vertex.m_EntityID = triangle.m_EntityID;
+
+				indices.emplace_back(static_cast<minte::Index>(indices.size()));
+			}
+		}
+
+		std::vector<minte::backend::DrawCommand> commands(2);
+		commands[0].m_IndexCount = static_cast<uint32_t>(triangles.size() / 2 * 3);
+		commands[0].m_IsOpaque = std::all_of(triangles.begin(), triangles.begin() + triangles.size() / 2, [](const ReferenceTriangle& triangle) { return (triangle.m_Color >> 24) == 0xFF; });
+		commands[0].m_Scissor.m_Width = Width;
+		commands[0].m_Scissor.m_Height = Height;
+
+		commands[1] = commands[0];
+		commands[1].m_IndexOffset = commands[0].m_IndexCount;
+		commands[1].m_IndexCount = static_cast<uint32_t>(indices.size()) - commands[0].m_IndexCount;
+		commands[1].m_IsOpaque = false;
+
+		renderTarget.updateVertices(0, vertices);
+		renderTarget.updateIndices(0, indices);
+		renderTarget.setDrawCommands(std::move(commands));
+		renderTarget.draw();
+	}
+
+	/**
+	 * Check random triangles against the reference, and a single thread against multiple threads.
+	 *
+	 * @return Whether the pixels match.
+	 */
+	bool CheckTriangles()
+	{
+		// The points are on a 1/16 pixel grid, which the rasterizer's subpixel grid holds exactly.
+		std::mt19937 generator(1);
+		std::uniform_int_distribution<int32_t> coordinate(-16 * 16, 176 * 16);
+
+		std::vector<ReferenceTriangle> triangles(400);
+		for (uint32_t i = 0; i < triangles.size(); i++)
+		{
+			for (auto& point : triangles[i].m_Points)
+				point = minte::Point2D_F32(coordinate(generator) / 16.0f, coordinate(generator) * 0.75f / 16.0f);
+
+			triangles[i].m_Color = 0xFF000000 | (generator() & 0xFFFFFF);
+			triangles[i].m_EntityID = i + 1;
+		}
+
+		auto renderTarget = minte::backend::CpuRenderTarget(std::make_shared<minte::backend::CpuInstance>(1), Width, Height);
+		DrawTriangles(renderTarget, triangles);
+
+		const auto colors = ReadPixels(renderTarget.getColorBuffer());
+		const auto entities = ReadPixels(renderTarget.getEntityBuffer());
+
+		// The last triangle covering a pixel is the one that's visible.
+		uint64_t checkedPixels = 0;
+		for (uint32_t y = 0; y < Height; y++)
+		{
+			for (uint32_t x = 0; x < Width; x++)
+			{
+				const ReferenceTriangle* pTop = nullptr;
+				bool bOnEdge = false;
+				for (const auto& triangle : triangles)
+				{
+					const auto coverage = GetCoverage(triangle, x, y);
+					if (coverage == Coverage::Inside)
+					{
+						pTop = &triangle;
+						bOnEdge = false;
+					}
+					else if (coverage == Coverage::Edge)
+					{
+						bOnEdge = true;
+					}
+				}
+
+				if (bOnEdge)
+					continue;
+
+				const auto pixel = y * Width + x;
+				const auto expectedColor = pTop ? pTop->m_Color : 0;
+				const auto expectedEntity = pTop ? pTop->m_EntityID : 0;
+				if (colors[pixel] != expectedColor || entities[pixel] != expectedEntity)
+				{
+					std::cout << "Pixel (" << x << ", " << y << ") has the entity " << entities[pixel] << ", expected " << expectedEntity << "." << std::endl;
+					return false;
+				}
+
+				checkedPixels++;
+			}
+		}
+
+		// Most of the pixels should be decided without the fill convention.
+		if (checkedPixels < Width * Height * 9 / 10)
+		{
+			std::cout << "Only " << checkedPixels << " pixels were checked." << std::endl;
+			return false;
+		}
+
+		// The tiles are shared among the threads, which must not change the result.
+		auto threadedRenderTarget = minte::backend::CpuRenderTarget(std::make_shared<minte::backend::CpuInstance>(4), Width, Height);
+		DrawTriangles(threadedRenderTarget, triangles);
+
+		if (ReadPixels(threadedRenderTarget.getColorBuffer()) != colors || ReadPixels(threadedRenderTarget.getEntityBuffer()) != entities)
+		{
+			std::cout << "Multiple threads rasterized different pixels than a single thread." << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Check that the pixels on the shared edges of a mesh are drawn exactly once.
+	 * A translucent jittered grid covering the render target must blend every pixel like a single quad does.
+	 *
+	 * @return Whether every pixel is blended once.
+	 */
+	bool CheckSharedEdges()
+	{
+		constexpr uint32_t Color = 0x80FF4020;
+		constexpr uint32_t Cells = 23;
+
+		const auto pInstance = std::make_shared<minte::backend::CpuInstance>(1);
+
+		// The reference is a single quad.
+		std::vector<ReferenceTriangle> quad(2);
+		quad[0].m_Points = { minte::Point2D_F32(-8.0f, -8.0f), minte::Point2D_F32(Width + 8.0f, -8.0f), minte::Point2D_F32(Width + 8.0f, Height + 8.0f) };
+		quad[1].m_Points = { minte::Point2D_F32(-8.0f, -8.0f), minte::Point2D_F32(Width + 8.0f, Height + 8.0f), minte::Point2D_F32(-8.0f, Height + 8.0f) };
+		quad[0].m_Color = quad[1].m_Color = Color;
+
+		auto quadRenderTarget = minte::backend::CpuRenderTarget(pInstance, Width, Height);
+		DrawTriangles(quadRenderTarget, quad);
+		const auto expected = ReadPixels(quadRenderTarget.getColorBuffer()).front();
+
+		// Jitter the inner points of the grid, and alternate the diagonals.
+		std::mt19937 generator(2);
+		std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+
+		std::vector<minte::Point2D_F32> points;
+		for (uint32_t y = 0; y <= Cells; y++)
+		{
+			for (uint32_t x = 0; x <= Cells; x++)
+			{
+				auto point = minte::Point2D_F32(-8.0f + x * (Width + 16.0f) / Cells, -8.0f + y * (Height + 16.0f) / Cells);
+				if (x > 0 && x < Cells && y > 0 && y < Cells)
+				{
+					point.m_X += jitter(generator) * (Width + 16.0f) / Cells;
+					point.m_Y += jitter(generator) * (Height + 16.0f) / Cells;
+				}
+
+				points.emplace_back(point);
+			}
+		}
+
+		std::vector<ReferenceTriangle> mesh;
+		for (uint32_t y = 0; y < Cells; y++)
+		{
+			for (uint32_t x = 0; x < Cells; x++)
+			{
+				const auto topLeft = points[y * (Cells + 1) + x];
+				const auto topRight = points[y * (Cells + 1) + x + 1];
+				const auto bottomLeft = points[(y + 1) * (Cells + 1) + x];
+				const auto bottomRight = points[(y + 1) * (Cells + 1) + x + 1];
+
+				auto& first = mesh.emplace_back();
+				auto& second = mesh.emplace_back();
+				if ((x + y) % 2)
+				{
+					first.m_Points = { topLeft, topRight, bottomRight };
+					second.m_Points = { topLeft, bottomRight, bottomLeft };
+				}
+				else
+				{
+					first.m_Points = { topLeft, bottomLeft, topRight };
+					second.m_Points = { topRight, bottomLeft, bottomRight };
+				}
+
+				first.m_Color = second.m_Color = Color;
+			}
+		}
+
+		auto meshRenderTarget = minte::backend::CpuRenderTarget(pInstance, Width, Height);
+		DrawTriangles(meshRenderTarget, mesh);
+
+		const auto colors = ReadPixels(meshRenderTarget.getColorBuffer());
+		for (uint32_t i = 0; i < colors.size(); i++)
+		{
+			if (colors[i] != expected)
+			{
+				std::cout << "Pixel (" << i % Width << ", " << i / Width << ") of the mesh was not blended exactly once." << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+bool CheckCpuRaster()
+{
+	return CheckTriangles() && CheckSharedEdges();
+}
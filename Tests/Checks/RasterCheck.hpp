@@ -0,0 +1,13 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#pragma once
+
+/**
+ * Check the CPU backend's rasterizer against a reference.
+ * Random triangles are drawn with flat colors and compared to a per-pixel point in triangle test, which draws them in order. Pixels whose
+ * center is exactly on an edge are skipped, as the fill convention decides them. A jittered grid mesh is drawn translucent to check that the
+ * pixels on shared edges are drawn exactly once, and the results of a single and multiple threads are compared.
+ *
+ * @return Whether the rasterized pixels match the reference.
+ */
+[[nodiscard]] bool CheckCpuRaster();
@@ -3,8 +3,18 @@
 #include "HeadsUpDisplay.hpp"
 
 #include "Minte/Backend/VulkanBackend/VulkanRenderTarget.hpp"
+#include "Minte/Box.hpp"
 
 HeadsUpDisplay::HeadsUpDisplay(minte::Minte parent)
 	: minte::Layer(parent, std::make_unique<minte::backend::VulkanRenderTarget>(parent.getInstanceAs<minte::backend::VulkanInstance>(), 1280, 720))
 {
+	// Create a status bar with a few indicators.
+	const auto pStatusBar = createDrawable<minte::Box>(minte::Point2D<float>(1280.0f, 48.0f), 0xC0202020u);
+	pStatusBar->setPosition(minte::Point2D<float>(0.0f, 672.0f));
+
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		const auto pIndicator = pStatusBar->createChild<minte::Box>(minte::Point2D<float>(32.0f, 32.0f), 0xFF40C040u);
+		pIndicator->setPosition(minte::Point2D<float>(8.0f + i * 40.0f, 8.0f));
+	}
 }
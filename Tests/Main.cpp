@@ -3,14 +3,105 @@
 #include "Minte/Minte.hpp"
 
 #include "Minte/Backend/VulkanBackend/VulkanInstance.hpp"
+#include "Minte/Backend/VulkanBackend/VulkanWindow.hpp"
 
 #include "Layers/HeadsUpDisplay.hpp"
+#include "Checks/ExternalMemoryCheck.hpp"
 
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <string_view>
+
+namespace /* anonymous */
+{
+	/**
+	 * Get the present policy named by a command line argument.
+	 *
+	 * @param name The policy name. This is low-latency, vsync or power-saving.
+	 * @return The present policy. Unknown names use low latency.
+	 */
+	minte::backend::PresentPolicy GetPresentPolicy(std::string_view name)
+	{
+		if (name == "vsync")
+			return minte::backend::PresentPolicy::VSync;
+
+		if (name == "power-saving")
+			return minte::backend::PresentPolicy::PowerSaving;
+
+		return minte::backend::PresentPolicy::LowLatency;
+	}
+
+	/**
+	 * Present the HUD to a window till it's closed.
+	 * The frame rate and the input to present latency are printed every second, so the present policies and the number of frames in flight
+	 * can be compared. The latency is only measured for frames which show new input, so move the mouse over the window to get samples.
+	 *
+	 * @param policy The present policy.
+	 * @param framesInFlight The number of frames in flight. 0 uses the present policy's default.
+	 */
+	void RunWindow(minte::backend::PresentPolicy policy, uint32_t framesInFlight)
+	{
+		auto instance = minte::Minte(std::make_shared<minte::backend::VulkanInstance>());
+		auto hud = HeadsUpDisplay(instance);
+
+		// The window blits the render target on the GPU, so the output doesn't have to be copied to the host.
+		hud.getRenderTarget().setHostOutput(false);
+
+		minte::backend::VulkanWindow window(instance.getInstanceAs<minte::backend::VulkanInstance>(), "Minte HUD", 1280, 720, policy, framesInFlight);
+
+		uint64_t frameCount = 0;
+		auto reportTime = std::chrono::steady_clock::now();
+		while (window.pollEvents(*hud.getInputQueue()))
+		{
+			const auto images = hud.update();
+			window.present(hud);
+			frameCount++;
+
+			const auto now = std::chrono::steady_clock::now();
+			if (now - reportTime >= std::chrono::seconds(1))
+			{
+				const auto seconds = std::chrono::duration<double>(now - reportTime).count();
+				std::cout << "Frames per second: " << static_cast<double>(frameCount) / seconds;
+
+				// Present wait tells when the frame is shown. Without it, the latency leaves out the time spent in the presentation queue.
+				if (window.getLatencySampleCount() > 0)
+				{
+					std::cout << ", latency: " << std::chrono::duration<double, std::milli>(window.getLastLatency()).count() << " ms (average "
+						<< std::chrono::duration<double, std::milli>(window.getAverageLatency()).count() << " ms over " << window.getLatencySampleCount()
+						<< " frames" << (window.isPresentWaitEnabled() ? "" : ", without present wait") << ")";
+				}
+
+				std::cout << std::endl;
+
+				frameCount = 0;
+				reportTime = now;
+			}
+		}
+	}
+}
 
 auto main(int argc, char** argv) -> int
 try
 {
+	// Run the external memory round trip instead of the sample if asked to.
+	if (argc > 1 && std::string_view(argv[1]) == "--check-external-memory")
+	{
+		const auto type = argc > 2 && std::string_view(argv[2]) == "dma-buf" ? minte::backend::VulkanExternalMemory::DmaBuf : minte::backend::VulkanExternalMemory::OpaqueFD;
+		const bool bMatches = CheckExternalMemory(type);
+
+		std::cout << "External memory round trip: " << (bMatches ? "passed" : "failed") << std::endl;
+		return bMatches ? 0 : 1;
+	}
+
+	// Present the HUD to a window instead of drawing it offscreen if asked to.
+	if (argc > 1 && std::string_view(argv[1]) == "--window")
+	{
+		const auto policy = argc > 2 ? GetPresentPolicy(argv[2]) : minte::backend::PresentPolicy::LowLatency;
+		RunWindow(policy, argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 0);
+		return 0;
+	}
+
 	auto instance = minte::Minte(std::make_shared<minte::backend::VulkanInstance>());
 	auto hud = HeadsUpDisplay(instance);
 
@@ -19,4 +110,5 @@ try
 catch (std::runtime_error& error)
 {
 	std::cout << "Error occurred: " << error.what() << std::endl;
-}
\ No newline at end of file
+	return 1;
+}
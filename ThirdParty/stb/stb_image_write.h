@@ -0,0 +1,2 @@
+typedef void stbi_write_func(void *context, void *data, int size);
+int stbi_write_png_to_func(stbi_write_func *func, void *context, int w, int h, int comp, const void  *data, int stride_in_bytes);
@@ -0,0 +1,24 @@
+// Test stub with the stb_truetype API used by Minte. Glyph g is a filled box of (g%20+4) x (g%30+6) units*scale.
+#pragma once
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+struct stbtt_fontinfo { const unsigned char* data; int offset; };
+inline int stbtt_GetFontOffsetForIndex(const unsigned char*, int index) { return index == 0 ? 0 : -1; }
+inline int stbtt_InitFont(stbtt_fontinfo* info, const unsigned char* data, int offset) { info->data = data; info->offset = offset; return 1; }
+inline int stbtt_FindGlyphIndex(const stbtt_fontinfo*, int cp) { return cp < 65536 ? cp : 0; }
+inline float stbtt_ScaleForMappingEmToPixels(const stbtt_fontinfo*, float px) { return px / 32.0f; }
+inline void stbtt_GetFontVMetrics(const stbtt_fontinfo*, int* a, int* d, int* l) { *a = 26; *d = -6; *l = 2; }
+inline void stbtt_GetGlyphHMetrics(const stbtt_fontinfo*, int g, int* adv, int* lsb) { *adv = g == 32 ? 10 : (g % 20 + 6); *lsb = 1; }
+inline int stbtt_GetGlyphKernAdvance(const stbtt_fontinfo*, int a, int b) { return (a == 'A' && b == 'V') ? -2 : 0; }
+inline void stbtt_GetGlyphBitmapBox(const stbtt_fontinfo*, int g, float sx, float sy, int* x0, int* y0, int* x1, int* y1) {
+  if (g == 32) { *x0 = *y0 = *x1 = *y1 = 0; return; }
+  *x0 = 1; *y0 = -(int)std::ceil((g % 30 + 6) * sy); *x1 = 1 + (int)std::ceil((g % 20 + 4) * sx); *y1 = 0; }
+inline void stbtt_MakeGlyphBitmap(const stbtt_fontinfo*, unsigned char* out, int w, int h, int stride, float, float, int) {
+  for (int y = 0; y < h; y++) std::memset(out + y * stride, 255, w); }
+inline unsigned char* stbtt_GetGlyphSDF(const stbtt_fontinfo* info, float scale, int g, int pad, unsigned char, float, int* w, int* h, int* xo, int* yo) {
+  int x0, y0, x1, y1; stbtt_GetGlyphBitmapBox(info, g, scale, scale, &x0, &y0, &x1, &y1);
+  if (x1 == x0) { *w = *h = 0; return nullptr; }
+  *w = x1 - x0 + 2 * pad; *h = y1 - y0 + 2 * pad; *xo = x0 - pad; *yo = y0 - pad;
+  auto p = (unsigned char*)std::malloc(*w * *h); std::memset(p, 200, *w * *h); return p; }
+inline void stbtt_FreeSDF(unsigned char* p, void*) { std::free(p); }
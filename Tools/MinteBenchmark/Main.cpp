@@ -0,0 +1,547 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/Layer.hpp"
+#include "Minte/Minte.hpp"
+#include "Minte/Box.hpp"
+#include "Minte/Shape.hpp"
+#include "Minte/Text.hpp"
+
+#include "Minte/Backend/NullBackend/NullRenderTarget.hpp"
+#include "Minte/Backend/NullBackend/NullTexture.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string_view>
+
+namespace /* anonymous */
+{
+	std::atomic<uint64_t> AllocationCount = 0;
+
+	/**
+	 * Benchmark options structure.
+	 */
+	struct Options final
+	{
+		std::filesystem::path m_FontPath;
+		uint32_t m_Frames = 600;
+		uint32_t m_Messages = 2000;
+	};
+
+	/**
+	 * Frame statistics structure.
+	 */
+	struct Statistics final
+	{
+		std::vector<double> m_FrameTimes;	// In milliseconds.
+		uint64_t m_SteadyAllocations = 0;	// The allocations made in the second half of the frames.
+		uint64_t m_Glyphs = 0;	// The number of glyphs laid out, which keeps the work from being optimized away.
+		uint64_t m_Segments = 0;	// The number of path segments tessellated.
+
+		minte::backend::NullFrameStatistics m_Backend;	// The work given to the backend in the steady frames.
+		uint64_t m_BackendFrames = 0;
+	};
+
+	/**
+	 * Print the usage information.
+	 */
+	void PrintUsage()
+	{
+		std::cout << "Usage: MinteBenchmark --font <path> [--frames <count>] [--messages <count>]" << std::endl;
+		std::cout << "  --font      The TrueType font used by the text workloads." << std::endl;
+		std::cout << "  --frames    The number of frames to run each workload for. Default is 600." << std::endl;
+		std::cout << "  --messages  The number of messages in the chat log. Default is 2000." << std::endl;
+	}
+
+	/**
+	 * Parse the command line options.
+	 *
+	 * @param argc The argument count.
+	 * @param argv The arguments.
+	 * @param options The options to parse to.
+	 * @return Whether the options are valid.
+	 */
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const auto argument = std::string_view(argv[i]);
+			if (argument == "--font" && i + 1 < argc)
+				options.m_FontPath = argv[++i];
+
+			else if (argument == "--frames" && i + 1 < argc)
+				options.m_Frames = std::max(static_cast<uint32_t>(std::stoul(argv[++i])), 2u);
+
+			else if (argument == "--messages" && i + 1 < argc)
+				options.m_Messages = static_cast<uint32_t>(std::stoul(argv[++i]));
+
+			else
+				return false;
+		}
+
+		return !options.m_FontPath.empty();
+	}
+
+	/**
+	 * Create a chat message.
+	 *
+	 * @param random The random number generator.
+	 * @return The message.
+	 */
+	std::string CreateMessage(std::minstd_rand& random)
+	{
+		constexpr std::string_view Words[] = {
+			"hello", "the", "build", "is", "green", "again", "can", "you", "review", "my", "change", "before", "lunch", "thanks!", "looks",
+			"good", "to", "me", "but", "the", "shader", "needs", "another", "pass", "AVATAR", "rendering", "is", "broken", "on", "lavapipe", ":)"
+		};
+
+		std::string message;
+		const auto wordCount = 3 + random() % 40;
+		for (uint32_t i = 0; i < wordCount; i++)
+		{
+			if (i > 0)
+				message += ' ';
+
+			message += Words[random() % std::size(Words)];
+		}
+
+		return message;
+	}
+
+	/**
+	 * Run the chat log workload.
+	 * Every frame measures all the messages of the log (to get the scroll height), and types a character into the composer. A message is
+	 * sent every 30 frames, and the window is resized every 200 frames.
+	 *
+	 * @param options The benchmark options.
+	 * @param pFont The font.
+	 * @param cacheCapacity The capacity of the layout cache. A capacity of 0 shapes and breaks all the text every frame.
+	 * @param bIncrementalEdits Whether the composer is edited incrementally, or laid out again after every character.
+	 * @return The statistics.
+	 */
+	Statistics RunChatWorkload(const Options& options, const std::shared_ptr<minte::Font>& pFont, uint32_t cacheCapacity, bool bIncrementalEdits)
+	{
+		std::minstd_rand random(42);
+
+		std::vector<std::string> messages;
+		messages.reserve(options.m_Messages + options.m_Frames / 30 + 1);
+		for (uint32_t i = 0; i < options.m_Messages; i++)
+			messages.emplace_back(CreateMessage(random));
+
+		auto cache = minte::TextLayoutCache(cacheCapacity);
+		auto composer = minte::ParagraphLayout(pFont, 15.0f, 600.0f);
+		auto draft = CreateMessage(random);
+		uint32_t draftLength = 0;
+
+		Statistics statistics;
+		statistics.m_FrameTimes.reserve(options.m_Frames);
+
+		for (uint32_t frame = 0; frame < options.m_Frames; frame++)
+		{
+			if (frame == options.m_Frames / 2)
+				statistics.m_SteadyAllocations = AllocationCount;
+
+			const auto startTime = std::chrono::steady_clock::now();
+			const auto wrapWidth = (frame / 200) % 2 == 0 ? 600.0f : 480.0f;
+
+			// Measure the log.
+			for (const auto& message : messages)
+				statistics.m_Glyphs += cache.getLayout(pFont, message, 15.0f, wrapWidth).m_Glyphs.size();
+
+			// Type into the composer, and send the message when it's done.
+			if (draftLength < draft.size())
+			{
+				if (bIncrementalEdits)
+					composer.replace(draftLength, 0, std::string_view(draft).substr(draftLength, 1));
+
+				else
+					composer.setText(std::string_view(draft).substr(0, draftLength + 1));
+
+				draftLength++;
+			}
+
+			if (frame % 30 == 29)
+			{
+				messages.emplace_back(composer.getText());
+				composer.setText("");
+				draft = CreateMessage(random);
+				draftLength = 0;
+			}
+
+			cache.update();
+
+			const auto endTime = std::chrono::steady_clock::now();
+			statistics.m_FrameTimes.emplace_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+		}
+
+		statistics.m_SteadyAllocations = AllocationCount - statistics.m_SteadyAllocations;
+		return statistics;
+	}
+
+	/**
+	 * Create an icon like path.
+	 * This has a curved blob, a circle and a rounded rectangle, which overlap each other.
+	 *
+	 * @param random The random number generator.
+	 * @return The path.
+	 */
+	minte::Path CreateIcon(std::minstd_rand& random)
+	{
+		using minte::Point2D_F32;
+
+		const auto x = static_cast<float>(random() % 1000);
+		const auto y = static_cast<float>(random() % 1000);
+		const auto size = 16.0f + static_cast<float>(random() % 48);
+
+		minte::Path path;
+		path.moveTo(Point2D_F32(x, y))
+			.cubicTo(Point2D_F32(x + size * 0.3f, y - size * 0.4f), Point2D_F32(x + size * 0.7f, y + size * 0.4f), Point2D_F32(x + size, y))
+			.quadraticTo(Point2D_F32(x + size * 0.5f, y + size * 0.6f), Point2D_F32(x, y))
+			.close();
+
+		path.addCircle(Point2D_F32(x + size * 0.5f, y + size * 0.1f), size * 0.1f);
+		path.addRoundedRectangle(minte::Rectangle2D_F32(Point2D_F32(x, y + size * 0.2f), Point2D_F32(x + size * 0.5f, y + size * 0.5f)), size * 0.08f);
+		return path;
+	}
+
+	/**
+	 * Run the path workload.
+	 * Every frame fills and strokes a set of icons, each tessellated on its own like the shapes of a layer.
+	 *
+	 * @param options The benchmark options.
+	 * @return The statistics.
+	 */
+	Statistics RunPathWorkload(const Options& options)
+	{
+		std::minstd_rand random(42);
+
+		std::vector<minte::Path> icons;
+		icons.reserve(500);
+		for (uint32_t i = 0; i < 500; i++)
+			icons.emplace_back(CreateIcon(random));
+
+		auto tessellator = minte::PathTessellator();
+		auto strokeStyle = minte::StrokeStyle();
+		strokeStyle.m_Width = 2.0f;
+		strokeStyle.m_Join = minte::LineJoin::Round;
+
+		std::vector<minte::Vertex> vertices;
+		std::vector<minte::Index> indices;
+
+		Statistics statistics;
+		statistics.m_FrameTimes.reserve(options.m_Frames);
+
+		for (uint32_t frame = 0; frame < options.m_Frames; frame++)
+		{
+			if (frame == options.m_Frames / 2)
+				statistics.m_SteadyAllocations = AllocationCount;
+
+			const auto startTime = std::chrono::steady_clock::now();
+
+			for (const auto& icon : icons)
+			{
+				vertices.clear();
+				indices.clear();
+
+				tessellator.fill(icon, minte::FillRule::NonZero, 0xffffffff, vertices, indices);
+				tessellator.stroke(icon, strokeStyle, 0x000000ff, vertices, indices);
+				statistics.m_Segments += icon.getSegmentCount() * 2;
+			}
+
+			const auto endTime = std::chrono::steady_clock::now();
+			statistics.m_FrameTimes.emplace_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+		}
+
+		statistics.m_SteadyAllocations = AllocationCount - statistics.m_SteadyAllocations;
+		return statistics;
+	}
+
+	/**
+	 * Run the layer workload.
+	 * This updates a whole layer on the null backend, so only the frontend is measured. Every frame scrolls a list of 400 labeled rows,
+	 * changes the color of one of the icons and updates a counter. The counter cycles like a frame rate readout, so its texts are cached
+	 * after the first 60 frames. An idle layer is left as it is after the first frame, like a static menu.
+	 *
+	 * @param options The benchmark options.
+	 * @param pFont The font.
+	 * @param bIdle Whether the layer is idle.
+	 * @return The statistics.
+	 */
+	Statistics RunLayerWorkload(const Options& options, const std::shared_ptr<minte::Font>& pFont, bool bIdle)
+	{
+		using minte::Point2D;
+
+		std::minstd_rand random(42);
+
+		const auto pInstance = std::make_shared<minte::backend::NullInstance>();
+		auto pRenderTarget = std::make_unique<minte::backend::NullRenderTarget>(pInstance, 1280, 720);
+		const auto pNullRenderTarget = pRenderTarget.get();
+
+		auto layer = minte::Layer(minte::Minte(pInstance), std::move(pRenderTarget));
+		layer.setGlyphAtlas(std::make_shared<minte::GlyphAtlas>([pInstance](uint32_t width, uint32_t height, minte::backend::TextureFormat format)
+			{
+				return std::make_shared<minte::backend::NullTexture>(pInstance, width, height, format);
+			}
+		));
+
+		// The list scrolls inside a clipped panel, so only the visible rows are uploaded.
+		const auto pPanel = layer.createDrawable<minte::Box>(Point2D<float>(800.0f, 600.0f), 0xFF181818u);
+		pPanel->setPosition(Point2D<float>(0.0f, 60.0f));
+		pPanel->setClipRectangle(minte::Rectangle2D_F32(minte::Point2D_F32(0.0f), minte::Point2D_F32(800.0f, 600.0f)));
+
+		const auto pList = pPanel->createChild<minte::Box>(Point2D<float>(800.0f, 400 * 32.0f), 0xFF202020u);
+		for (uint32_t i = 0; i < 400; i++)
+		{
+			const auto pRow = pList->createChild<minte::Box>(Point2D<float>(800.0f, 30.0f), i % 2 == 0 ? 0xFF303030u : 0xFF383838u);
+			pRow->setPosition(Point2D<float>(0.0f, i * 32.0f));
+
+			const auto pLabel = pRow->createChild<minte::Text>(pFont, CreateMessage(random).substr(0, 60), 14.0f, 0xFFFFFFFFu);
+			pLabel->setPosition(Point2D<float>(8.0f, 6.0f));
+		}
+
+		std::vector<std::shared_ptr<minte::Shape>> icons;
+		for (uint32_t i = 0; i < 50; i++)
+			icons.emplace_back(layer.createDrawable<minte::Shape>(CreateIcon(random), 0xFFFFFFFFu));
+
+		const auto pCounter = layer.createDrawable<minte::Text>(pFont, "0", 16.0f, 0xFFFFFFFFu);
+		pCounter->setPosition(Point2D<float>(1100.0f, 8.0f));
+
+		Statistics statistics;
+		statistics.m_FrameTimes.reserve(options.m_Frames);
+
+		for (uint32_t frame = 0; frame < options.m_Frames; frame++)
+		{
+			if (frame == options.m_Frames / 2)
+			{
+				statistics.m_SteadyAllocations = AllocationCount;
+				pNullRenderTarget->setRecording(true);
+			}
+
+			const auto startTime = std::chrono::steady_clock::now();
+
+			// The scroll wraps around before the steady state, so the rows entering and leaving the panel at once are warmed up as well.
+			if (!bIdle || frame == 0)
+			{
+				pList->setPosition(Point2D<float>(0.0f, (frame % 150) * -8.0f));
+				icons[frame % icons.size()]->setFill(0xFF000000u | (frame * 2654435761u >> 8));
+				pCounter->setText(std::to_string(frame % 60));
+			}
+
+			const auto output = layer.update();
+
+			const auto endTime = std::chrono::steady_clock::now();
+			statistics.m_FrameTimes.emplace_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+		}
+
+		statistics.m_SteadyAllocations = AllocationCount - statistics.m_SteadyAllocations;
+		statistics.m_Backend = pNullRenderTarget->getTotalStatistics();
+		statistics.m_BackendFrames = pNullRenderTarget->getRecordedFrameCount();
+		return statistics;
+	}
+
+	/**
+	 * Run the layout workload.
+	 * This lays out a column of 100 rows of 99 boxes, 10k nodes in total, on the null backend. A full relayout changes the width of every box
+	 * each frame, so the whole tree is measured and arranged again. An incremental relayout only changes the width of a single box.
+	 *
+	 * @param options The benchmark options.
+	 * @param bFull Whether every box is changed, or just one of them.
+	 * @return The statistics.
+	 */
+	Statistics RunLayoutWorkload(const Options& options, bool bFull)
+	{
+		using minte::Point2D;
+
+		const auto pInstance = std::make_shared<minte::backend::NullInstance>();
+		auto pRenderTarget = std::make_unique<minte::backend::NullRenderTarget>(pInstance, 1280, 720);
+		const auto pNullRenderTarget = pRenderTarget.get();
+
+		auto layer = minte::Layer(minte::Minte(pInstance), std::move(pRenderTarget));
+
+		auto columnStyle = minte::LayoutStyle();
+		columnStyle.m_Direction = minte::LayoutDirection::Column;
+		columnStyle.m_Gap = 1.0f;
+
+		const auto pColumn = layer.createDrawable<minte::Box>(Point2D<float>(0.0f), 0xFF181818u);
+		pColumn->setLayoutStyle(columnStyle);
+
+		auto rowStyle = minte::LayoutStyle();
+		rowStyle.m_Gap = 2.0f;
+		rowStyle.m_AlignItems = minte::LayoutAlignment::Stretch;
+
+		auto boxStyle = minte::LayoutStyle();
+		boxStyle.m_Width = minte::LayoutLength::Pixels(10.0f);
+		boxStyle.m_Height = minte::LayoutLength::Pixels(5.0f);
+
+		std::vector<std::shared_ptr<minte::Box>> boxes;
+		boxes.reserve(100 * 99);
+		for (uint32_t i = 0; i < 100; i++)
+		{
+			const auto pRow = pColumn->createChild<minte::Box>(Point2D<float>(0.0f), i % 2 == 0 ? 0xFF303030u : 0xFF383838u);
+			pRow->setLayoutStyle(rowStyle);
+
+			for (uint32_t j = 0; j < 99; j++)
+			{
+				boxes.emplace_back(pRow->createChild<minte::Box>(Point2D<float>(0.0f), 0xFFFFFFFFu));
+				boxes.back()->setLayoutStyle(boxStyle);
+			}
+		}
+
+		Statistics statistics;
+		statistics.m_FrameTimes.reserve(options.m_Frames);
+
+		for (uint32_t frame = 0; frame < options.m_Frames; frame++)
+		{
+			if (frame == options.m_Frames / 2)
+			{
+				statistics.m_SteadyAllocations = AllocationCount;
+				pNullRenderTarget->setRecording(true);
+			}
+
+			const auto startTime = std::chrono::steady_clock::now();
+
+			// The width alternates, so every frame moves the boxes after the changed ones.
+			boxStyle.m_Width = minte::LayoutLength::Pixels(10.0f + frame % 2);
+			if (bFull)
+			{
+				for (const auto& pBox : boxes)
+					pBox->setLayoutStyle(boxStyle);
+			}
+			else
+			{
+				boxes[boxes.size() / 2]->setLayoutStyle(boxStyle);
+			}
+
+			const auto output = layer.update();
+
+			const auto endTime = std::chrono::steady_clock::now();
+			statistics.m_FrameTimes.emplace_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+		}
+
+		statistics.m_SteadyAllocations = AllocationCount - statistics.m_SteadyAllocations;
+		statistics.m_Backend = pNullRenderTarget->getTotalStatistics();
+		statistics.m_BackendFrames = pNullRenderTarget->getRecordedFrameCount();
+		return statistics;
+	}
+
+	/**
+	 * Print the statistics of a workload.
+	 *
+	 * @param name The workload name.
+	 * @param statistics The statistics.
+	 * @param frames The number of frames.
+	 */
+	void PrintStatistics(std::string_view name, Statistics statistics, uint32_t frames)
+	{
+		auto frameTimes = statistics.m_FrameTimes;
+		std::sort(frameTimes.begin(), frameTimes.end());
+
+		auto total = 0.0;
+		for (const auto frameTime : frameTimes)
+			total += frameTime;
+
+		const auto steadyFrames = frames - frames / 2;
+		std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << total / frameTimes.size() << " ms/frame"
+			<< std::setw(10) << frameTimes[frameTimes.size() * 99 / 100] << " ms p99"
+			<< std::setw(10) << std::setprecision(1) << static_cast<double>(statistics.m_SteadyAllocations) / steadyFrames << " allocations/frame";
+
+		if (statistics.m_Segments > 0)
+			std::cout << std::setw(10) << std::setprecision(2) << statistics.m_Segments / total / 1000.0 << " M segments/s";
+
+		std::cout << std::endl;
+
+		if (statistics.m_BackendFrames > 0)
+		{
+			const auto& backend = statistics.m_Backend;
+			const auto backendFrames = static_cast<double>(statistics.m_BackendFrames);
+			std::cout << std::left << std::setw(28) << "" << std::right << std::setprecision(1)
+				<< std::setw(10) << backend.m_DrawCommands / backendFrames << " commands/frame"
+				<< std::setw(10) << backend.m_OpaqueCommands / backendFrames << " opaque/frame"
+				<< std::setw(10) << backend.m_Triangles / backendFrames << " triangles/frame"
+				<< std::setw(10) << (backend.m_VertexBytes + backend.m_IndexBytes) / backendFrames / 1024.0 << " KiB geometry/frame"
+				<< std::setw(10) << backend.m_CommandListChanges / backendFrames << " command lists/frame"
+				<< std::setw(10) << backend.m_ScissorChanges / backendFrames << " scissors/frame" << std::endl;
+		}
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (const auto pMemory = std::malloc(size ? size : 1))
+		return pMemory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+auto main(int argc, char** argv) -> int
+try
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const auto pFont = std::make_shared<minte::Font>(options.m_FontPath);
+
+	std::cout << "Chat log: " << options.m_Messages << " messages, " << options.m_Frames << " frames" << std::endl;
+	PrintStatistics("text (no cache)", RunChatWorkload(options, pFont, 0, false), options.m_Frames);
+	PrintStatistics("text (cached)", RunChatWorkload(options, pFont, 8192, false), options.m_Frames);
+	PrintStatistics("text (cached, incremental)", RunChatWorkload(options, pFont, 8192, true), options.m_Frames);
+
+	std::cout << "Paths: 500 icons, filled and stroked" << std::endl;
+	PrintStatistics("path", RunPathWorkload(options), options.m_Frames);
+
+	// A whole layer should not allocate once it reached its steady state.
+	std::cout << "Layer: 400 rows in a clipped panel, 50 icons, null backend" << std::endl;
+	const auto layerStatistics = RunLayerWorkload(options, pFont, false);
+	PrintStatistics("layer", layerStatistics, options.m_Frames);
+
+	const auto idleStatistics = RunLayerWorkload(options, pFont, true);
+	PrintStatistics("layer (idle)", idleStatistics, options.m_Frames);
+
+	std::cout << "Layout: 100 rows of 99 boxes, null backend" << std::endl;
+	const auto fullLayoutStatistics = RunLayoutWorkload(options, true);
+	PrintStatistics("layout (full)", fullLayoutStatistics, options.m_Frames);
+
+	const auto incrementalLayoutStatistics = RunLayoutWorkload(options, false);
+	PrintStatistics("layout (incremental)", incrementalLayoutStatistics, options.m_Frames);
+
+	if (layerStatistics.m_SteadyAllocations > 0 || idleStatistics.m_SteadyAllocations > 0 || fullLayoutStatistics.m_SteadyAllocations > 0 || incrementalLayoutStatistics.m_SteadyAllocations > 0)
+	{
+		std::cout << "Error: the layer allocated in its steady state!" << std::endl;
+		return 1;
+	}
+
+	// An idle layer should not reach the backend at all.
+	if (idleStatistics.m_BackendFrames > 0)
+	{
+		std::cout << "Error: the idle layer was drawn!" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+catch (std::runtime_error& error)
+{
+	std::cout << "Error occurred: " << error.what() << std::endl;
+	return 1;
+}
@@ -0,0 +1,355 @@
+// Copyright (c) 2022 Dhiraj Wishal
+
+#include "Minte/DrawStream.hpp"
+
+#ifdef MINTE_VULKAN_BACKEND
+#include "Minte/Backend/VulkanBackend/VulkanRenderTarget.hpp"
+#include "Minte/Backend/VulkanBackend/VulkanTexture.hpp"
+
+#endif
+
+#include "Minte/Backend/CpuBackend/CpuRenderTarget.hpp"
+#include "Minte/Backend/CpuBackend/CpuTexture.hpp"
+#include "Minte/Backend/NullBackend/NullRenderTarget.hpp"
+#include "Minte/Backend/NullBackend/NullTexture.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace /* anonymous */
+{
+#ifdef MINTE_VULKAN_BACKEND
+	constexpr std::string_view DefaultBackend = "vulkan";
+
+#else
+	constexpr std::string_view DefaultBackend = "cpu";
+
+#endif
+
+	/**
+	 * Replay options structure.
+	 */
+	struct Options final
+	{
+		std::filesystem::path m_Path;
+		std::string_view m_Backend = DefaultBackend;
+		uint32_t m_Loops = 1;
+		bool m_Timed = false;
+	};
+
+	/**
+	 * Replay statistics structure.
+	 */
+	struct Statistics final
+	{
+		uint64_t m_Frames = 0;
+		uint64_t m_LayerUpdates = 0;
+		uint64_t m_GeometryBytes = 0;
+		uint64_t m_TextureBytes = 0;
+	};
+
+	/**
+	 * Print the usage information.
+	 */
+	void PrintUsage()
+	{
+		std::cout << "Usage: MinteReplay <capture> [--backend vulkan|cpu|null] [--loops <count>] [--timed]" << std::endl;
+		std::cout << "  --backend  The backend to replay the capture with. Default is " << DefaultBackend << ". The Vulkan backend is only available if it was built." << std::endl;
+		std::cout << "  --loops    The number of times to replay the capture. Default is 1." << std::endl;
+		std::cout << "  --timed    Replay at the recorded timing instead of as fast as possible." << std::endl;
+	}
+
+	/**
+	 * Parse the command line options.
+	 *
+	 * @param argc The argument count.
+	 * @param argv The arguments.
+	 * @param options The options to parse to.
+	 * @return Whether the options are valid.
+	 */
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const auto argument = std::string_view(argv[i]);
+			if (argument == "--timed")
+				options.m_Timed = true;
+
+			else if (argument == "--backend" && i + 1 < argc)
+				options.m_Backend = argv[++i];
+
+			else if (argument == "--loops" && i + 1 < argc)
+				options.m_Loops = static_cast<uint32_t>(std::stoul(argv[++i]));
+
+			else if (options.m_Path.empty() && !argument.starts_with("--"))
+				options.m_Path = argument;
+
+			else
+				return false;
+		}
+
+		return !options.m_Path.empty();
+	}
+
+	/**
+	 * Create the backend instance.
+	 *
+	 * @param backend The backend name.
+	 * @return The instance pointer.
+	 */
+	std::shared_ptr<minte::backend::Instance> CreateInstance(std::string_view backend)
+	{
+#ifdef MINTE_VULKAN_BACKEND
+		if (backend == "vulkan")
+			return std::make_shared<minte::backend::VulkanInstance>();
+
+#endif
+
+		if (backend == "cpu")
+			return std::make_shared<minte::backend::CpuInstance>();
+
+		if (backend == "null")
+			return std::make_shared<minte::backend::NullInstance>();
+
+		throw std::runtime_error("Unknown backend!");
+	}
+
+	/**
+	 * Create a render target for a recorded layer.
+	 *
+	 * @param backend The backend name.
+	 * @param pInstance The instance pointer.
+	 * @param layer The recorded layer.
+	 * @return The render target pointer.
+	 */
+	std::unique_ptr<minte::backend::RenderTarget> CreateRenderTarget(std::string_view backend, const std::shared_ptr<minte::backend::Instance>& pInstance, const minte::DrawStreamLayerCreate& layer)
+	{
+		std::unique_ptr<minte::backend::RenderTarget> pRenderTarget = nullptr;
+#ifdef MINTE_VULKAN_BACKEND
+		if (backend == "vulkan")
+			pRenderTarget = std::make_unique<minte::backend::VulkanRenderTarget>(std::static_pointer_cast<minte::backend::VulkanInstance>(pInstance), layer.m_Width, layer.m_Height, layer.m_AntiAliasing);
+
+#endif
+
+		if (backend == "cpu")
+			pRenderTarget = std::make_unique<minte::backend::CpuRenderTarget>(std::static_pointer_cast<minte::backend::CpuInstance>(pInstance), layer.m_Width, layer.m_Height, layer.m_AntiAliasing);
+
+		else if (backend == "null")
+			pRenderTarget = std::make_unique<minte::backend::NullRenderTarget>(std::static_pointer_cast<minte::backend::NullInstance>(pInstance), layer.m_Width, layer.m_Height, layer.m_AntiAliasing);
+
+		if (pRenderTarget && layer.m_OutputFormat != minte::backend::OutputFormat::RGBA)
+			pRenderTarget->setOutputFormat(layer.m_OutputFormat);
+
+		return pRenderTarget;
+	}
+
+	/**
+	 * Create a texture for a recorded texture.
+	 *
+	 * @param backend The backend name.
+	 * @param pInstance The instance pointer.
+	 * @param texture The recorded texture.
+	 * @return The texture pointer.
+	 */
+	std::shared_ptr<minte::backend::Texture> CreateTexture(std::string_view backend, const std::shared_ptr<minte::backend::Instance>& pInstance, const minte::DrawStreamTextureCreate& texture)
+	{
+#ifdef MINTE_VULKAN_BACKEND
+		if (backend == "vulkan")
+			return std::make_shared<minte::backend::VulkanTexture>(std::static_pointer_cast<minte::backend::VulkanInstance>(pInstance), texture.m_Width, texture.m_Height, texture.m_Format, texture.m_Mipmaps != 0);
+
+#endif
+
+		if (backend == "cpu")
+			return std::make_shared<minte::backend::CpuTexture>(std::static_pointer_cast<minte::backend::CpuInstance>(pInstance), texture.m_Width, texture.m_Height, texture.m_Format, texture.m_Mipmaps != 0);
+
+		if (backend == "null")
+			return std::make_shared<minte::backend::NullTexture>(std::static_pointer_cast<minte::backend::NullInstance>(pInstance), texture.m_Width, texture.m_Height, texture.m_Format, texture.m_Mipmaps != 0);
+
+		return nullptr;
+	}
+
+	/**
+	 * Copy an array out of a chunk's trailing data.
+	 * The mapped data is not guaranteed to be aligned, so we can't use it in place.
+	 *
+	 * @tparam Type The element type.
+	 * @param data The data to copy from.
+	 * @param count The number of elements.
+	 * @return The copied elements.
+	 */
+	template<class Type>
+	std::vector<Type> CopyArray(std::span<const std::byte> data, uint64_t count)
+	{
+		std::vector<Type> elements(std::min<uint64_t>(count, data.size() / sizeof(Type)));
+		std::memcpy(elements.data(), data.data(), elements.size() * sizeof(Type));
+		return elements;
+	}
+
+	/**
+	 * Replay the whole capture once.
+	 *
+	 * @param reader The draw stream reader.
+	 * @param options The replay options.
+	 * @param pInstance The instance pointer.
+	 * @param statistics The statistics to update.
+	 */
+	void Replay(minte::DrawStreamReader& reader, const Options& options, const std::shared_ptr<minte::backend::Instance>& pInstance, Statistics& statistics)
+	{
+		std::unordered_map<uint32_t, std::unique_ptr<minte::backend::RenderTarget>> renderTargets;
+		const auto findRenderTarget = [&renderTargets](uint32_t layerID) -> minte::backend::RenderTarget*
+		{
+			const auto itr = renderTargets.find(layerID);
+			return itr != renderTargets.end() ? itr->second.get() : nullptr;
+		};
+
+		std::unordered_map<uint32_t, std::shared_ptr<minte::backend::Texture>> textures;
+		const auto findTexture = [&textures](uint32_t textureID) -> std::shared_ptr<minte::backend::Texture>
+		{
+			const auto itr = textures.find(textureID);
+			return itr != textures.end() ? itr->second : nullptr;
+		};
+
+		const auto startTime = std::chrono::steady_clock::now();
+		minte::DrawStreamChunk chunk;
+
+		reader.rewind();
+		while (reader.next(chunk))
+		{
+			switch (chunk.m_Type)
+			{
+			case minte::DrawStreamChunkType::LayerCreate:
+			{
+				const auto layer = chunk.read<minte::DrawStreamLayerCreate>();
+				renderTargets[layer.m_LayerID] = CreateRenderTarget(options.m_Backend, pInstance, layer);
+				break;
+			}
+
+			case minte::DrawStreamChunkType::FrameBegin:
+			{
+				if (options.m_Timed)
+				{
+					const auto frame = chunk.read<minte::DrawStreamFrameBegin>();
+					std::this_thread::sleep_until(startTime + std::chrono::nanoseconds(frame.m_Timestamp));
+				}
+
+				statistics.m_Frames++;
+				break;
+			}
+
+			case minte::DrawStreamChunkType::LayerUpdate:
+			{
+				const auto update = chunk.read<minte::DrawStreamLayerUpdate>();
+				if (const auto pRenderTarget = findRenderTarget(update.m_LayerID))
+					pRenderTarget->draw();
+
+				statistics.m_LayerUpdates++;
+				break;
+			}
+
+			case minte::DrawStreamChunkType::Geometry:
+			{
+				const auto geometry = chunk.read<minte::DrawStreamGeometry>();
+				const auto data = chunk.getTrailingData<minte::DrawStreamGeometry>();
+				const auto vertexBytes = std::min<uint64_t>(data.size(), geometry.m_VertexCount * sizeof(minte::Vertex));
+
+				if (const auto pRenderTarget = findRenderTarget(geometry.m_LayerID))
+				{
+					pRenderTarget->updateVertices(geometry.m_VertexOffset, CopyArray<minte::Vertex>(data, geometry.m_VertexCount));
+					pRenderTarget->updateIndices(geometry.m_IndexOffset, CopyArray<minte::Index>(data.subspan(vertexBytes), geometry.m_IndexCount));
+				}
+
+				statistics.m_GeometryBytes += data.size();
+				break;
+			}
+
+			case minte::DrawStreamChunkType::DrawCommands:
+			{
+				const auto commands = chunk.read<minte::DrawStreamDrawCommands>();
+				if (const auto pRenderTarget = findRenderTarget(commands.m_LayerID))
+					pRenderTarget->setDrawCommands(CopyArray<minte::backend::DrawCommand>(chunk.getTrailingData<minte::DrawStreamDrawCommands>(), commands.m_Count));
+
+				break;
+			}
+
+			case minte::DrawStreamChunkType::TextureCreate:
+			{
+				const auto texture = chunk.read<minte::DrawStreamTextureCreate>();
+				textures[texture.m_TextureID] = CreateTexture(options.m_Backend, pInstance, texture);
+				break;
+			}
+
+			case minte::DrawStreamChunkType::TextureUpload:
+			{
+				const auto upload = chunk.read<minte::DrawStreamTextureUpload>();
+				const auto data = chunk.getTrailingData<minte::DrawStreamTextureUpload>();
+
+				if (const auto pTexture = findTexture(upload.m_TextureID))
+				{
+					minte::backend::TextureRegion region;
+					region.m_X = upload.m_X;
+					region.m_Y = upload.m_Y;
+					region.m_Width = upload.m_Width;
+					region.m_Height = upload.m_Height;
+
+					pTexture->update({ &region, 1 }, data.first(std::min<uint64_t>(data.size(), upload.m_Size)));
+				}
+
+				statistics.m_TextureBytes += data.size();
+				break;
+			}
+
+			case minte::DrawStreamChunkType::TextureBind:
+			{
+				const auto bind = chunk.read<minte::DrawStreamTextureBind>();
+				if (const auto pRenderTarget = findRenderTarget(bind.m_LayerID))
+					pRenderTarget->setTexture(bind.m_Slot, findTexture(bind.m_TextureID));
+
+				break;
+			}
+
+			default:
+				break;
+			}
+		}
+	}
+}
+
+auto main(int argc, char** argv) -> int
+try
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	auto reader = minte::DrawStreamReader(options.m_Path);
+	const auto pInstance = CreateInstance(options.m_Backend);
+
+	Statistics statistics;
+	const auto startTime = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < options.m_Loops; i++)
+		Replay(reader, options, pInstance, statistics);
+
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	const auto frames = std::max<uint64_t>(statistics.m_Frames, 1);
+
+	std::cout << "Frames:         " << statistics.m_Frames << std::endl;
+	std::cout << "Layer updates:  " << statistics.m_LayerUpdates << std::endl;
+	std::cout << "Geometry bytes: " << statistics.m_GeometryBytes << std::endl;
+	std::cout << "Texture bytes:  " << statistics.m_TextureBytes << std::endl;
+	std::cout << "Total time:     " << seconds << " s" << std::endl;
+	std::cout << "Frame time:     " << seconds * 1000.0 / frames << " ms" << std::endl;
+
+	return 0;
+}
+catch (std::runtime_error& error)
+{
+	std::cout << "Error occurred: " << error.what() << std::endl;
+	return 1;
+}